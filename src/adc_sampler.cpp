@@ -0,0 +1,89 @@
+#include "adc_sampler.h"
+#include "desk_types.h"
+
+#ifndef TESTENVIRONMENT
+#include <Arduino.h>
+#endif
+
+static const uint8_t FILTER_INDEX_MASK = static_cast<uint8_t>(ADC_FILTER_LENGTH - 1U);
+
+// Written by the ADC interrupt only; the main loop reads filtered_sum / conversion_count
+static DESK_THREAD_LOCAL uint16_t window[ADC_FILTER_LENGTH];
+static DESK_THREAD_LOCAL uint8_t window_index = 0U;
+static DESK_THREAD_LOCAL volatile uint16_t filtered_sum = 0U;
+static DESK_THREAD_LOCAL volatile uint16_t conversion_count = 0U;
+
+/**
+ * @brief Copy a 16-bit value shared with the ADC interrupt (two byte loads on AVR)
+ */
+static uint16_t read_shared_u16(const volatile uint16_t *value)
+{
+#ifdef TESTENVIRONMENT
+    return *value;
+#else
+    const uint8_t sreg = SREG;
+    cli();
+    const uint16_t copy = *value;
+    SREG = sreg;
+    return copy;
+#endif
+}
+
+void AdcSampler_init(uint8_t channel)
+{
+#ifndef TESTENVIRONMENT
+    ADCSRA = 0U;  // Stop any running conversion before the filter is reset
+#endif
+    for (uint8_t i = 0U; i < ADC_FILTER_LENGTH; i++)
+    {
+        window[i] = 0U;
+    }
+    window_index = 0U;
+    filtered_sum = 0U;
+    conversion_count = 0U;
+
+#ifdef TESTENVIRONMENT
+    (void)channel;  // The HAL feeds conversions from the mocked pin
+#else
+    // AVcc reference, right-adjusted result, single-ended channel
+    ADMUX = static_cast<uint8_t>((1U << REFS0) | (channel & 0x0FU));
+    // Auto trigger source: Timer/Counter0 overflow (the millis() tick, every 1.024 ms)
+    ADCSRB = static_cast<uint8_t>(1U << ADTS2);
+    // Enable, auto trigger, complete interrupt, prescaler 128 (125 kHz ADC clock at 16 MHz)
+    ADCSRA = static_cast<uint8_t>((1U << ADEN) | (1U << ADATE) | (1U << ADIE) |
+                                  (1U << ADPS2) | (1U << ADPS1) | (1U << ADPS0));
+#endif
+}
+
+void AdcSampler_conversionComplete(uint16_t counts)
+{
+    if (counts > ADC_FULL_SCALE_COUNTS)
+    {
+        counts = ADC_FULL_SCALE_COUNTS;  // Keeps the sum within ADC_FILTER_LENGTH * 1023
+    }
+
+    // Running sum: replace the oldest conversion, no loop over the window
+    const uint16_t oldest = window[window_index];
+    window[window_index] = counts;
+    window_index = static_cast<uint8_t>((window_index + 1U) & FILTER_INDEX_MASK);
+    filtered_sum = static_cast<uint16_t>((filtered_sum - oldest) + counts);
+    conversion_count = static_cast<uint16_t>(conversion_count + 1U);
+}
+
+uint16_t AdcSampler_filteredSum(void)
+{
+    return read_shared_u16(&filtered_sum);
+}
+
+uint16_t AdcSampler_conversionCount(void)
+{
+    return read_shared_u16(&conversion_count);
+}
+
+#ifndef TESTENVIRONMENT
+// ADC conversion complete: producer side of the filter (reading ADC reads ADCL then ADCH)
+ISR(ADC_vect)
+{
+    AdcSampler_conversionComplete(ADC);
+}
+#endif
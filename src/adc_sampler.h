@@ -0,0 +1,95 @@
+/**
+ * @file adc_sampler.h
+ * @brief Interrupt-driven motor current sampling (non-blocking ADC)
+ *
+ * @purpose
+ * analogRead() busy-waits ~104 us per conversion inside the control task and
+ * the mA conversion took a 32-bit multiply and two divisions. The sampler lets
+ * the ADC convert continuously in the background and keeps the latest
+ * filtered result ready, so reading the motor current costs a 16-bit load and
+ * one fixed-point multiply.
+ *
+ * @implementation
+ * - Target: ADC auto-triggered by the Timer0 overflow that drives millis()
+ *   (one conversion every 1.024 ms), result collected in ISR(ADC_vect)
+ * - Boxcar filter over the last ADC_FILTER_LENGTH conversions, kept as a
+ *   running sum (no division: the scale factor absorbs the length)
+ * - mA = (sum * ADC_SUM_TO_MA_Q16) >> 16, the multiplier derived at compile
+ *   time from ADC_REF_MV and SHUNT_MILLIOHMS (safety_config.h)
+ * - Host builds: the HAL feeds conversions through AdcSampler_conversionComplete()
+ *
+ * @thread_safety One producer (ADC interrupt) and any number of main-loop readers;
+ *   readers copy the 16-bit sum with interrupts masked
+ */
+
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <stdint.h>
+#include "safety_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint8_t ADC_FILTER_LENGTH = 4U;      // Power of two: ~4 ms window at the Timer0 trigger rate
+static const uint16_t ADC_FULL_SCALE_COUNTS = 1023U;
+static const uint8_t ADC_FIRST_PIN = 14U;         // Arduino UNO A0; channel = pin - ADC_FIRST_PIN
+
+/**
+ * @brief mA per filter-sum count in Q16, rounded up
+ *
+ * ADC_REF_MV / 1023 mV per count through SHUNT_MILLIOHMS, divided by the
+ * filter length. Rounding up keeps full scale (1023 counts) at exactly
+ * ADC_REF_MV / SHUNT_MILLIOHMS A.
+ */
+static const uint32_t ADC_SUM_TO_MA_Q16 =
+    static_cast<uint32_t>(((static_cast<uint64_t>(ADC_REF_MV) * 1000U * 65536U) +
+                           (static_cast<uint64_t>(ADC_FULL_SCALE_COUNTS) * SHUNT_MILLIOHMS * ADC_FILTER_LENGTH) - 1U) /
+                          (static_cast<uint64_t>(ADC_FULL_SCALE_COUNTS) * SHUNT_MILLIOHMS * ADC_FILTER_LENGTH));
+
+static_assert((ADC_FILTER_LENGTH & (ADC_FILTER_LENGTH - 1U)) == 0U, "Filter length must be a power of two");
+static_assert((static_cast<uint64_t>(ADC_FULL_SCALE_COUNTS) * ADC_FILTER_LENGTH * ADC_SUM_TO_MA_Q16) <= UINT32_MAX,
+              "Full-scale sum times the multiplier must fit 32 bits");
+
+/**
+ * @brief Reset the filter and start background conversions on an analog channel
+ *
+ * Target: Timer0-overflow auto trigger, ADC clock 125 kHz, AVcc reference,
+ * ADC-complete interrupt enabled. Host: filter reset only.
+ *
+ * @param channel - ADC input (0 = A0)
+ */
+void AdcSampler_init(uint8_t channel);
+
+/**
+ * @brief ADC-complete interrupt body: add one conversion result to the filter
+ *
+ * @param counts - 10-bit conversion result
+ * @safety_critical Producer side only - never call from the main loop on target
+ */
+void AdcSampler_conversionComplete(uint16_t counts);
+
+/**
+ * @brief Sum of the last ADC_FILTER_LENGTH conversions (non-blocking)
+ */
+uint16_t AdcSampler_filteredSum(void);
+
+/**
+ * @brief Conversions completed since AdcSampler_init() (wraps at 65536)
+ */
+uint16_t AdcSampler_conversionCount(void);
+
+/**
+ * @brief Convert a filter sum to mA with the precomputed fixed-point multiplier
+ */
+static inline uint16_t AdcSampler_toMilliamps(uint16_t filtered_sum)
+{
+    return static_cast<uint16_t>((static_cast<uint32_t>(filtered_sum) * ADC_SUM_TO_MA_Q16) >> 16);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADC_SAMPLER_H
@@ -0,0 +1,164 @@
+#include "current_baseline.h"
+#include <stddef.h>  // For NULL definition
+
+static const uint16_t BIN_MIN_SAMPLES = static_cast<uint16_t>(CURRENT_BASELINE_BIN_MS / 2U);
+
+static uint8_t direction_index(MotorDirection_t dir)
+{
+    return (dir == MOTOR_DOWN) ? 1U : 0U;
+}
+
+/**
+ * @brief Close the bin being accumulated into the stroke's levels
+ */
+static void close_bin(CurrentBaseline_t *baseline)
+{
+    if ((baseline->bin < CURRENT_BASELINE_BINS) && (baseline->bin_samples >= BIN_MIN_SAMPLES))
+    {
+        const uint32_t mean_ma = baseline->bin_sum_ma / baseline->bin_samples;
+        const uint32_t units = (mean_ma + (CURRENT_BASELINE_UNIT_MA / 2U)) / CURRENT_BASELINE_UNIT_MA;
+        // 0 units: no current sensing (MT_BASIC reports 0 mA) - nothing to learn
+        baseline->stroke_level[baseline->bin] = static_cast<uint8_t>((units > UINT8_MAX) ? UINT8_MAX : units);
+    }
+    baseline->bin_sum_ma = 0U;
+    baseline->bin_samples = 0U;
+}
+
+static void discard_stroke(CurrentBaseline_t *baseline)
+{
+    for (uint8_t i = 0U; i < CURRENT_BASELINE_BINS; i++)
+    {
+        baseline->stroke_level[i] = 0U;
+    }
+    baseline->stroke_dir = MOTOR_STOP;
+    baseline->bin = CURRENT_BASELINE_NO_POSITION;
+    baseline->bin_sum_ma = 0U;
+    baseline->bin_samples = 0U;
+}
+
+void CurrentBaseline_init(CurrentBaseline_t *baseline)
+{
+    if (baseline == NULL)
+    {
+        return;
+    }
+    for (uint8_t i = 0U; i < CURRENT_BASELINE_BINS; i++)
+    {
+        baseline->level[0][i] = 0U;
+        baseline->level[1][i] = 0U;
+    }
+    discard_stroke(baseline);
+}
+
+void CurrentBaseline_forget(CurrentBaseline_t *baseline, MotorDirection_t dir)
+{
+    if ((baseline == NULL) || (dir == MOTOR_STOP))
+    {
+        return;
+    }
+    for (uint8_t i = 0U; i < CURRENT_BASELINE_BINS; i++)
+    {
+        baseline->level[direction_index(dir)][i] = 0U;
+    }
+    discard_stroke(baseline);
+}
+
+bool CurrentBaseline_load(CurrentBaseline_t *baseline)
+{
+    if (baseline == NULL)
+    {
+        return false;
+    }
+    return NVM_readRecord(NVM_ADDR_CURRENT_BASELINE, NVM_ID_CURRENT_BASELINE,
+                          baseline->level, static_cast<uint8_t>(sizeof(baseline->level)));
+}
+
+bool CurrentBaseline_save(const CurrentBaseline_t *baseline)
+{
+    if (baseline == NULL)
+    {
+        return false;
+    }
+    return NVM_writeRecord(NVM_ADDR_CURRENT_BASELINE, NVM_ID_CURRENT_BASELINE,
+                           baseline->level, static_cast<uint8_t>(sizeof(baseline->level)));
+}
+
+void CurrentBaseline_addSample(CurrentBaseline_t *baseline, MotorDirection_t drive_dir, uint8_t bin, uint16_t current_ma)
+{
+    if ((baseline == NULL) || (drive_dir == MOTOR_STOP))
+    {
+        return;
+    }
+    if (drive_dir != baseline->stroke_dir)
+    {
+        discard_stroke(baseline);  // Reversal without a stop: the old stroke never finished
+        baseline->stroke_dir = drive_dir;
+    }
+    if (bin != baseline->bin)
+    {
+        close_bin(baseline);
+        baseline->bin = bin;
+    }
+    if (bin < CURRENT_BASELINE_BINS)
+    {
+        baseline->bin_sum_ma += current_ma;
+        if (baseline->bin_samples < UINT16_MAX)
+        {
+            baseline->bin_samples++;
+        }
+    }
+}
+
+bool CurrentBaseline_endStroke(CurrentBaseline_t *baseline, bool clean)
+{
+    if ((baseline == NULL) || (baseline->stroke_dir == MOTOR_STOP))
+    {
+        return false;
+    }
+
+    bool changed = false;
+    if (clean)
+    {
+        close_bin(baseline);
+        uint8_t *levels = baseline->level[direction_index(baseline->stroke_dir)];
+        for (uint8_t i = 0U; i < CURRENT_BASELINE_BINS; i++)
+        {
+            const uint8_t measured = baseline->stroke_level[i];
+            if (measured == 0U)
+            {
+                continue;
+            }
+            uint8_t next = measured;
+            if (levels[i] != 0U)
+            {
+                // Exponential average: one unusual stroke moves the level only part of the way
+                const int16_t delta = static_cast<int16_t>(static_cast<int16_t>(measured) - static_cast<int16_t>(levels[i]));
+                next = static_cast<uint8_t>(static_cast<int16_t>(levels[i]) + (delta / (1 << CURRENT_BASELINE_LEARN_SHIFT)));
+            }
+            if (next != levels[i])
+            {
+                levels[i] = next;
+                changed = true;
+            }
+        }
+    }
+    discard_stroke(baseline);
+    return changed;
+}
+
+uint16_t CurrentBaseline_limitMa(const CurrentBaseline_t *baseline, MotorDirection_t drive_dir, uint8_t bin)
+{
+    if ((baseline == NULL) || (drive_dir == MOTOR_STOP) || (bin >= CURRENT_BASELINE_BINS))
+    {
+        return 0U;
+    }
+    const uint8_t level = baseline->level[direction_index(drive_dir)][bin];
+    if (level == 0U)
+    {
+        return 0U;
+    }
+    const uint32_t level_ma = static_cast<uint32_t>(level) * CURRENT_BASELINE_UNIT_MA;
+    const uint32_t limit_ma = level_ma + (level_ma >> MOTOR_SENSE_BASELINE_MARGIN_SHIFT) + MOTOR_SENSE_BASELINE_MARGIN_MA;
+    // SAFETY-CRITICAL: the baseline only tightens the fixed obstruction threshold
+    return (limit_ma < MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA) ? static_cast<uint16_t>(limit_ma) : 0U;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file current_baseline.h
+ * @brief Learned motor current per stroke position and direction (adaptive obstruction limit)
+ *
+ * @purpose
+ * The fixed MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA has to clear the highest
+ * normal current of the stroke, so where the desk normally draws much less
+ * (travelling down, light sections of the frame) an obstruction has to push the
+ * current a long way before it trips. The baseline learns the normal current
+ * at each position from clean strokes and tightens the obstruction limit to
+ * the learned level plus a margin. It never loosens the fixed threshold.
+ *
+ * @implementation
+ * - CURRENT_BASELINE_BINS position bins per direction, one byte each
+ *   (CURRENT_BASELINE_UNIT_MA steps, 0 = not learned); 64 bytes persisted in NVM
+ * - A stroke accumulates the mean current of every bin it visits; only bins with
+ *   at least half a bin of samples count
+ * - CurrentBaseline_endStroke() merges a clean stroke into the levels: first
+ *   stroke sets a bin, later strokes move it by 1/2^CURRENT_BASELINE_LEARN_SHIFT
+ *   of the difference; a faulted stroke is discarded
+ * - Limit: level + level / 2^MOTOR_SENSE_BASELINE_MARGIN_SHIFT + MOTOR_SENSE_BASELINE_MARGIN_MA,
+ *   only where that is below the fixed obstruction threshold
+ * - Position is a bin index supplied by the caller. Without a height sensor
+ *   DeskControl uses travel time since the stroke left a limit switch
+ *   (CURRENT_BASELINE_BIN_MS per bin), so only open-loop strokes starting at a
+ *   limit learn or use the baseline
+ *
+ * @thread_safety NOT thread-safe; main loop only
+ */
+
+#ifndef CURRENT_BASELINE_H
+#define CURRENT_BASELINE_H
+
+#include <stdint.h>
+#include "desk_types.h"
+#include "nvm.h"
+#include "safety_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint8_t CURRENT_BASELINE_BINS = 32U;                // Bins per direction
+static const uint16_t CURRENT_BASELINE_BIN_MS = 1000U;           // Travel-time bin width (32 s > SysReq-004 stroke)
+static const uint8_t CURRENT_BASELINE_UNIT_MA = 4U;              // Level resolution (255 units = 1020 mA)
+static const uint8_t CURRENT_BASELINE_LEARN_SHIFT = 2U;          // Later strokes move a level by 1/4
+static const uint8_t CURRENT_BASELINE_NO_POSITION = UINT8_MAX;   // Position unknown: no bin
+
+static_assert((2U * CURRENT_BASELINE_BINS) <= NVM_MAX_PAYLOAD, "Baseline record exceeds the NVM payload");
+
+typedef struct
+{
+    uint8_t level[2][CURRENT_BASELINE_BINS];    ///< Learned level per [UP, DOWN] bin (units; 0 = not learned)
+    uint8_t stroke_level[CURRENT_BASELINE_BINS];  ///< Stroke in progress: mean per visited bin (0 = none)
+    MotorDirection_t stroke_dir;                ///< Direction of the stroke in progress (MOTOR_STOP = none)
+    uint8_t bin;                                ///< Bin being accumulated
+    uint32_t bin_sum_ma;                        ///< Sum of the bin's samples
+    uint16_t bin_samples;                       ///< Samples in the bin
+} CurrentBaseline_t;
+
+/**
+ * @brief Forget all levels and the stroke in progress
+ */
+void CurrentBaseline_init(CurrentBaseline_t *baseline);
+
+/**
+ * @brief Forget one direction's levels and the stroke in progress
+ *
+ * The next clean stroke in that direction sets its levels afresh (stroke calibration).
+ *
+ * @param dir - MOTOR_STOP: ignored
+ */
+void CurrentBaseline_forget(CurrentBaseline_t *baseline, MotorDirection_t dir);
+
+/**
+ * @brief Restore the levels from NVM
+ *
+ * @return bool - false if no valid record exists (levels stay unlearned)
+ */
+bool CurrentBaseline_load(CurrentBaseline_t *baseline);
+
+/**
+ * @brief Stage the levels for writing to NVM (see NVM_writeRecord())
+ *
+ * @return bool - false if NVM is busy; retry later
+ */
+bool CurrentBaseline_save(const CurrentBaseline_t *baseline);
+
+/**
+ * @brief Add one 1 kHz sample to the stroke in progress
+ *
+ * A new direction starts a new stroke and discards the unfinished one.
+ *
+ * @param drive_dir - Drive applied at the sample (MOTOR_STOP: ignored)
+ * @param bin - Position bin, or CURRENT_BASELINE_NO_POSITION
+ * @param current_ma - Sampled motor current
+ */
+void CurrentBaseline_addSample(CurrentBaseline_t *baseline, MotorDirection_t drive_dir, uint8_t bin, uint16_t current_ma);
+
+/**
+ * @brief Finish the stroke in progress
+ *
+ * @param clean - Stroke ended without a fault; otherwise it is discarded
+ * @return bool - true if any level changed (save it)
+ */
+bool CurrentBaseline_endStroke(CurrentBaseline_t *baseline, bool clean);
+
+/**
+ * @brief Adaptive obstruction limit at a position
+ *
+ * @return uint16_t - mA; 0 if the bin is not learned, the position is unknown
+ *         or the fixed obstruction threshold is already tighter
+ */
+uint16_t CurrentBaseline_limitMa(const CurrentBaseline_t *baseline, MotorDirection_t drive_dir, uint8_t bin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CURRENT_BASELINE_H
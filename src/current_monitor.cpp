@@ -0,0 +1,207 @@
+#include "current_monitor.h"
+#include <stddef.h>  // For NULL definition
+
+static const uint8_t HISTORY_MASK = static_cast<uint8_t>(CURRENT_MONITOR_HISTORY - 1U);
+
+static_assert((CURRENT_MONITOR_HISTORY & HISTORY_MASK) == 0U, "History size must be a power of two");
+
+static uint16_t saturating_increment(uint16_t value)
+{
+    return (value < UINT16_MAX) ? static_cast<uint16_t>(value + 1U) : value;
+}
+
+void CurrentMonitor_init(CurrentMonitor_t *monitor)
+{
+    if (monitor == NULL)
+    {
+        return;
+    }
+    for (uint8_t i = 0U; i < CURRENT_MONITOR_HISTORY; i++)
+    {
+        monitor->history[i] = 0U;
+    }
+    monitor->head = 0U;
+    monitor->sum_ma = 0U;
+    monitor->samples = 0U;
+    monitor->peak_ma = 0U;
+    monitor->stuck_run_ms = 0U;
+    monitor->obstruction_run_ms = 0U;
+    monitor->stuck_run_max_ms = 0U;
+    monitor->obstruction_run_max_ms = 0U;
+    monitor->obstruction_limit_ma = MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA;
+    monitor->deviation_limit_ma = 0U;
+    monitor->deviation_run_ms = 0U;
+    monitor->deviation_run_max_ms = 0U;
+    monitor->drive_dir = MOTOR_STOP;
+    monitor->driven_ms = 0U;
+    monitor->slope_confirm_ms = 0U;
+    monitor->slope_jam = false;
+    monitor->slope_jam_cycle = false;
+}
+
+/**
+ * @brief Slope jam detector: arm after the blanking time, confirm over consecutive samples
+ */
+static void update_slope_detector(CurrentMonitor_t *monitor, MotorDirection_t drive_dir)
+{
+    if ((drive_dir == MOTOR_STOP) || (drive_dir != monitor->drive_dir))
+    {
+        // Drive removed, started or reversed: inrush follows, nothing to compare against yet
+        monitor->driven_ms = 0U;
+        monitor->slope_confirm_ms = 0U;
+        monitor->slope_jam = false;
+    }
+    monitor->drive_dir = drive_dir;
+    if (drive_dir == MOTOR_STOP)
+    {
+        return;
+    }
+
+    monitor->driven_ms = saturating_increment(monitor->driven_ms);
+    if (monitor->driven_ms <= MOTOR_SENSE_SLOPE_BLANK_MS)
+    {
+        return;
+    }
+
+    if (CurrentMonitor_slopeQ4(monitor) >= static_cast<int32_t>(MOTOR_SENSE_SLOPE_THRESHOLD_Q4))
+    {
+        if (monitor->slope_confirm_ms < MOTOR_SENSE_SLOPE_CONFIRM_MS)
+        {
+            monitor->slope_confirm_ms++;
+        }
+    }
+    else
+    {
+        monitor->slope_confirm_ms = 0U;
+    }
+
+    // SAFETY-CRITICAL: latched until the drive is removed; the caller stops the motor
+    if (monitor->slope_confirm_ms >= MOTOR_SENSE_SLOPE_CONFIRM_MS)
+    {
+        monitor->slope_jam = true;
+        monitor->slope_jam_cycle = true;
+    }
+}
+
+void CurrentMonitor_addSample(CurrentMonitor_t *monitor, uint16_t current_ma, MotorDirection_t drive_dir)
+{
+    if (monitor == NULL)
+    {
+        return;
+    }
+
+    monitor->history[monitor->head] = current_ma;
+    monitor->head = static_cast<uint8_t>((monitor->head + 1U) & HISTORY_MASK);
+
+    // sum_ma cannot overflow: UINT16_MAX samples of UINT16_MAX mA fit 32 bits
+    if (monitor->samples < UINT16_MAX)
+    {
+        monitor->sum_ma += current_ma;
+        monitor->samples++;
+    }
+    if (current_ma > monitor->peak_ma)
+    {
+        monitor->peak_ma = current_ma;
+    }
+
+    // SAFETY-CRITICAL: runs restart on any sample below threshold or in the other drive state
+    const bool driven = (drive_dir != MOTOR_STOP);
+    const bool stuck_high = !driven && (current_ma > MOTOR_SENSE_THRESHOLD_MA);
+    const bool obstruction_high = driven && (current_ma > monitor->obstruction_limit_ma);
+    const bool deviation_high = driven && (monitor->deviation_limit_ma != 0U) && (current_ma > monitor->deviation_limit_ma);
+    monitor->stuck_run_ms = stuck_high ? saturating_increment(monitor->stuck_run_ms) : 0U;
+    monitor->obstruction_run_ms = obstruction_high ? saturating_increment(monitor->obstruction_run_ms) : 0U;
+    monitor->deviation_run_ms = deviation_high ? saturating_increment(monitor->deviation_run_ms) : 0U;
+    if (monitor->stuck_run_ms > monitor->stuck_run_max_ms)
+    {
+        monitor->stuck_run_max_ms = monitor->stuck_run_ms;
+    }
+    if (monitor->obstruction_run_ms > monitor->obstruction_run_max_ms)
+    {
+        monitor->obstruction_run_max_ms = monitor->obstruction_run_ms;
+    }
+    if (monitor->deviation_run_ms > monitor->deviation_run_max_ms)
+    {
+        monitor->deviation_run_max_ms = monitor->deviation_run_ms;
+    }
+
+    update_slope_detector(monitor, drive_dir);
+}
+
+uint16_t CurrentMonitor_obstructionLimitMa(MotorRampPhase_t phase, uint8_t pwm)
+{
+    if (phase != MOTOR_PHASE_RAMP_UP)
+    {
+        return MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA;
+    }
+    const uint32_t inrush_ma = (static_cast<uint32_t>(MOTOR_SENSE_INRUSH_ALLOWANCE_MA) * pwm) / UINT8_MAX;
+    return static_cast<uint16_t>(MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA + inrush_ma);
+}
+
+void CurrentMonitor_setObstructionLimit(CurrentMonitor_t *monitor, uint16_t limit_ma)
+{
+    if (monitor == NULL)
+    {
+        return;
+    }
+    monitor->obstruction_limit_ma = limit_ma;
+}
+
+void CurrentMonitor_setDeviationLimit(CurrentMonitor_t *monitor, uint16_t limit_ma)
+{
+    if (monitor == NULL)
+    {
+        return;
+    }
+    monitor->deviation_limit_ma = limit_ma;
+}
+
+void CurrentMonitor_takeSummary(CurrentMonitor_t *monitor, CurrentSummary_t *summary)
+{
+    if ((monitor == NULL) || (summary == NULL))
+    {
+        return;
+    }
+
+    summary->peak_ma = monitor->peak_ma;
+    summary->mean_ma = (monitor->samples > 0U) ? static_cast<uint16_t>(monitor->sum_ma / monitor->samples) : 0U;
+    summary->samples = monitor->samples;
+    summary->stuck_run_ms = monitor->stuck_run_max_ms;
+    summary->obstruction_run_ms = monitor->obstruction_run_max_ms;
+    summary->deviation_run_ms = monitor->deviation_run_max_ms;
+    summary->slope_jam = monitor->slope_jam_cycle;
+
+    // New cycle: a run still in progress counts towards the next summary from its full length
+    monitor->sum_ma = 0U;
+    monitor->samples = 0U;
+    monitor->peak_ma = 0U;
+    monitor->stuck_run_max_ms = monitor->stuck_run_ms;
+    monitor->obstruction_run_max_ms = monitor->obstruction_run_ms;
+    monitor->deviation_run_max_ms = monitor->deviation_run_ms;
+    monitor->slope_jam_cycle = monitor->slope_jam;
+}
+
+int32_t CurrentMonitor_slopeQ4(const CurrentMonitor_t *monitor)
+{
+    if ((monitor == NULL) || (monitor->driven_ms <= MOTOR_SENSE_SLOPE_WINDOW_MS))
+    {
+        return 0;
+    }
+    const int32_t rise_ma = static_cast<int32_t>(CurrentMonitor_history(monitor, 0U)) -
+                            static_cast<int32_t>(CurrentMonitor_history(monitor, MOTOR_SENSE_SLOPE_WINDOW_MS));
+    return (rise_ma * 16) / static_cast<int32_t>(MOTOR_SENSE_SLOPE_WINDOW_MS);
+}
+
+bool CurrentMonitor_slopeJam(const CurrentMonitor_t *monitor)
+{
+    return (monitor != NULL) && monitor->slope_jam;
+}
+
+uint16_t CurrentMonitor_history(const CurrentMonitor_t *monitor, uint8_t age)
+{
+    if ((monitor == NULL) || (age >= CURRENT_MONITOR_HISTORY))
+    {
+        return 0U;
+    }
+    return monitor->history[static_cast<uint8_t>((monitor->head - 1U - age) & HISTORY_MASK)];
+}
@@ -0,0 +1,140 @@
+/**
+ * @file current_monitor.h
+ * @brief 1 kHz motor current history and per-control-cycle statistics
+ *
+ * @purpose
+ * APP_Task() runs every 250 ms, so a single current reading per cycle misses
+ * any spike shorter than the cycle and stretches the MOTOR_SENSE_FAULT_TIME_MS
+ * debounce to 250-500 ms. The monitor takes every 1 kHz sample, keeps a short
+ * history for slope detectors and accumulates peak, mean and threshold runs
+ * until the control cycle collects them as a CurrentSummary_t.
+ *
+ * @implementation
+ * - History: power-of-two ring of the latest CURRENT_MONITOR_HISTORY samples
+ * - Statistics: running sum / peak / longest runs, reset by CurrentMonitor_takeSummary()
+ * - Runs are qualified by the drive state at the sample: above
+ *   MOTOR_SENSE_THRESHOLD_MA with drive off (stuck-on), above the obstruction
+ *   limit while driven (obstruction)
+ * - Obstruction limit: set per sample from the ramp phase and PWM
+ *   (CurrentMonitor_obstructionLimitMa()), so soft-start inrush is expected
+ *   instead of forcing a loose flat threshold or a slow ramp
+ * - Baseline deviation run: above the limit set by CurrentMonitor_setDeviationLimit()
+ *   (learned per position, current_baseline.h) while driven; no limit, no run
+ * - Slope (di/dt) jam detector: rise across MOTOR_SENSE_SLOPE_WINDOW_MS samples
+ *   in mA/ms Q4, compared with MOTOR_SENSE_SLOPE_THRESHOLD_Q4 for
+ *   MOTOR_SENSE_SLOPE_CONFIRM_MS samples; armed MOTOR_SENSE_SLOPE_BLANK_MS after
+ *   the drive starts or reverses, latched until the drive is removed
+ *
+ * @thread_safety NOT thread-safe; producer and consumer both run in the main loop
+ */
+
+#ifndef CURRENT_MONITOR_H
+#define CURRENT_MONITOR_H
+
+#include <stdint.h>
+#include "desk_types.h"
+#include "safety_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint8_t CURRENT_MONITOR_HISTORY = 32U;  // Samples kept (power of two, 32 ms at 1 kHz)
+
+static_assert(MOTOR_SENSE_SLOPE_WINDOW_MS < CURRENT_MONITOR_HISTORY, "Slope window must fit the history");
+static_assert(MOTOR_SENSE_SLOPE_WINDOW_MS > 0U, "Slope window must span at least one sample");
+
+typedef struct
+{
+    uint16_t history[CURRENT_MONITOR_HISTORY];  ///< Ring of samples (mA)
+    uint8_t head;                               ///< Next slot to write
+    uint32_t sum_ma;                            ///< Cycle: sum of samples
+    uint16_t samples;                           ///< Cycle: sample count (saturating)
+    uint16_t peak_ma;                           ///< Cycle: highest sample
+    uint16_t stuck_run_ms;                      ///< Ongoing run above the stuck-on threshold
+    uint16_t obstruction_run_ms;                ///< Ongoing run above the obstruction threshold
+    uint16_t stuck_run_max_ms;                  ///< Cycle: longest stuck-on run
+    uint16_t obstruction_run_max_ms;            ///< Cycle: longest obstruction run
+    uint16_t obstruction_limit_ma;              ///< Obstruction limit for the next samples
+    uint16_t deviation_limit_ma;                ///< Baseline limit for the next samples (0 = none)
+    uint16_t deviation_run_ms;                  ///< Ongoing run above the baseline limit
+    uint16_t deviation_run_max_ms;              ///< Cycle: longest baseline deviation run
+    MotorDirection_t drive_dir;                 ///< Drive at the latest sample
+    uint16_t driven_ms;                         ///< Samples since the drive started or reversed (saturating)
+    uint8_t slope_confirm_ms;                   ///< Consecutive samples at or above the slope threshold
+    bool slope_jam;                             ///< Slope jam latched for the current drive
+    bool slope_jam_cycle;                       ///< Cycle: slope jam seen
+} CurrentMonitor_t;
+
+/**
+ * @brief Clear history, statistics and runs
+ */
+void CurrentMonitor_init(CurrentMonitor_t *monitor);
+
+/**
+ * @brief Add one 1 kHz sample
+ *
+ * @param current_ma - Motor current
+ * @param drive_dir - Motor drive applied when the sample was taken (MOTOR_STOP = off)
+ */
+void CurrentMonitor_addSample(CurrentMonitor_t *monitor, uint16_t current_ma, MotorDirection_t drive_dir);
+
+/**
+ * @brief Obstruction limit envelope for the drive applied
+ *
+ * MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA, plus MOTOR_SENSE_INRUSH_ALLOWANCE_MA
+ * scaled by pwm / 255 during MOTOR_PHASE_RAMP_UP.
+ *
+ * @param phase - Ramp phase from MotorControllerOutput_t
+ * @param pwm - PWM applied
+ */
+uint16_t CurrentMonitor_obstructionLimitMa(MotorRampPhase_t phase, uint8_t pwm);
+
+/**
+ * @brief Set the obstruction limit for the following samples (after init: the flat threshold)
+ */
+void CurrentMonitor_setObstructionLimit(CurrentMonitor_t *monitor, uint16_t limit_ma);
+
+/**
+ * @brief Set the learned obstruction limit for the following samples
+ *
+ * @param limit_ma - Limit at the current position and direction (0 = none known:
+ *                   the deviation run restarts)
+ */
+void CurrentMonitor_setDeviationLimit(CurrentMonitor_t *monitor, uint16_t limit_ma);
+
+/**
+ * @brief Report the statistics since the previous call and start a new cycle
+ *
+ * Ongoing runs continue into the new cycle. With no samples since the previous
+ * call the summary is all zero (samples = 0).
+ */
+void CurrentMonitor_takeSummary(CurrentMonitor_t *monitor, CurrentSummary_t *summary);
+
+/**
+ * @brief Current slope across the last MOTOR_SENSE_SLOPE_WINDOW_MS samples
+ *
+ * @return int32_t - mA/ms in Q4 (16 = 1 mA/ms); 0 until the window holds samples of the current drive
+ */
+int32_t CurrentMonitor_slopeQ4(const CurrentMonitor_t *monitor);
+
+/**
+ * @brief Slope jam detected for the drive currently applied
+ *
+ * @safety_critical The caller removes drive; the flag clears with the first undriven sample
+ */
+bool CurrentMonitor_slopeJam(const CurrentMonitor_t *monitor);
+
+/**
+ * @brief Sample from the history
+ *
+ * @param age - 0 = newest, CURRENT_MONITOR_HISTORY - 1 = oldest kept
+ * @return uint16_t - Current in mA (0 before enough samples were taken or out of range)
+ */
+uint16_t CurrentMonitor_history(const CurrentMonitor_t *monitor, uint8_t age);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CURRENT_MONITOR_H
@@ -1,35 +1,40 @@
 #include "desk_app.h"
 #include "safety_config.h"
+#include "current_monitor.h"
 #include <stddef.h>  // For NULL definition
 
-static AppState_t current_state = APP_STATE_IDLE;
-static uint32_t state_entry_time = 0U;
-
-// Separate fault flags to prevent recovery race conditions
-static bool button_fault_latched = false;      // Dual button press fault
-static bool external_fault_latched = false;    // External fault input
-static bool current_fault_latched = false;     // Stuck-on or obstruction fault
-
-// Timers for current-based fault detection (UINT32_MAX = not running)
-static uint32_t stuck_on_timer_start_ms = UINT32_MAX;    // Stuck-on detection when motor should be stopped
-static uint32_t obstruction_timer_start_ms = UINT32_MAX; // Obstruction detection during motion
+// Default instance behind the single-desk API (APP_Init/APP_Task/APP_GetState)
+static DESK_THREAD_LOCAL AppContext_t default_context;
 
+static void transition_to(AppContext_t *ctx, AppState_t next_state, uint32_t now_ms)
+{
+    ctx->current_state = next_state;
+    ctx->state_entry_time = now_ms;
+}
 
-static void transition_to(AppState_t next_state, uint32_t now_ms)
+void APP_InitCtx(AppContext_t *ctx)
 {
-    current_state = next_state;
-    state_entry_time = now_ms;
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    ctx->current_state = APP_STATE_IDLE;
+    ctx->state_entry_time = 0U;
+    ctx->button_fault_latched = false;
+    ctx->external_fault_latched = false;
+    ctx->current_fault_latched = false;
+    ctx->stuck_on_timer_start_ms = UINT32_MAX;
+    ctx->obstruction_timer_start_ms = UINT32_MAX;
+    ctx->target_height_um = 0;
+    ctx->target_dir = MOTOR_STOP;
+    ctx->button_release_pending = false;
+    ctx->calibration_dir = MOTOR_STOP;
 }
 
 void APP_Init(void)
 {
-    current_state = APP_STATE_IDLE;
-    state_entry_time = 0U;
-    button_fault_latched = false;
-    external_fault_latched = false;
-    current_fault_latched = false;
-    stuck_on_timer_start_ms = UINT32_MAX;
-    obstruction_timer_start_ms = UINT32_MAX;
+    APP_InitCtx(&default_context);
 }
 
 /**
@@ -49,59 +54,141 @@ static void handle_fault(AppOutput_t *outputs)
     outputs->led_bt_down = LED_OFF;
     outputs->led_error = LED_ON;        // Activate error indicator
     outputs->fault_out = true;
+    outputs->soft_stop = false;         // SAFETY-CRITICAL: faults remove drive immediately
+    outputs->moving_to_target = false;
+    outputs->target_height_um = 0;
+    outputs->calibrating = false;
+    outputs->calibration_done = false;
 }
 
-void APP_Task(const AppInput_t *inputs, AppOutput_t *outputs)
+/**
+ * @brief Drive towards the target at full PWM; the caller brakes at the braking point
+ */
+static void set_target_outputs(const AppContext_t *ctx, AppOutput_t *outputs)
+{
+    outputs->motor_cmd = ctx->target_dir;
+    outputs->motor_speed = 255U;
+    outputs->led_bt_up = (ctx->target_dir == MOTOR_UP) ? LED_ON : LED_OFF;
+    outputs->led_bt_down = (ctx->target_dir == MOTOR_DOWN) ? LED_ON : LED_OFF;
+    outputs->led_error = LED_OFF;
+    outputs->soft_stop = false;
+    outputs->moving_to_target = true;
+    outputs->target_height_um = ctx->target_height_um;
+}
+
+/**
+ * @brief Start a requested move to target from IDLE
+ *
+ * Needs a referenced height estimate, a target beyond APP_TARGET_TOLERANCE_UM
+ * and no limit switch active in the direction of the target.
+ */
+static void start_move_to_target(AppContext_t *ctx, const AppInput_t *inputs, AppOutput_t *outputs)
+{
+    if (!inputs->position_estimate.referenced)
+    {
+        return;
+    }
+
+    const int32_t distance_um = inputs->target_height_um - inputs->position_estimate.height_um;
+    MotorDirection_t dir = MOTOR_STOP;
+    if ((distance_um > APP_TARGET_TOLERANCE_UM) && !inputs->limit_upper)
+    {
+        dir = MOTOR_UP;
+    }
+    else if ((distance_um < -APP_TARGET_TOLERANCE_UM) && !inputs->limit_lower)
+    {
+        dir = MOTOR_DOWN;
+    }
+
+    if (dir != MOTOR_STOP)
+    {
+        transition_to(ctx, APP_STATE_MOVING_TO_TARGET, inputs->timestamp_ms);
+        ctx->target_height_um = inputs->target_height_um;
+        ctx->target_dir = dir;
+        set_target_outputs(ctx, outputs);
+    }
+}
+
+/**
+ * @brief Drive the calibration leg at full PWM until its limit switch stops it
+ */
+static void set_calibration_outputs(const AppContext_t *ctx, AppOutput_t *outputs)
+{
+    outputs->motor_cmd = ctx->calibration_dir;
+    outputs->motor_speed = 255U;
+    outputs->led_bt_up = (ctx->calibration_dir == MOTOR_UP) ? LED_ON : LED_OFF;
+    outputs->led_bt_down = (ctx->calibration_dir == MOTOR_DOWN) ? LED_ON : LED_OFF;
+    outputs->led_error = LED_OFF;
+    outputs->soft_stop = false;
+    outputs->calibrating = true;
+}
+
+/**
+ * @brief Start a requested calibration from IDLE: home to the lower limit switch
+ *        unless already there, then stroke to the upper one
+ */
+static void start_calibration(AppContext_t *ctx, const AppInput_t *inputs, AppOutput_t *outputs)
 {
-    if (inputs == NULL || outputs == NULL)
+    transition_to(ctx, APP_STATE_CALIBRATING, inputs->timestamp_ms);
+    ctx->calibration_dir = inputs->limit_lower ? MOTOR_UP : MOTOR_DOWN;
+    set_calibration_outputs(ctx, outputs);
+}
+
+void APP_TaskCtx(AppContext_t *ctx, const AppInput_t *inputs, AppOutput_t *outputs)
+{
+    if (ctx == NULL || inputs == NULL || outputs == NULL)
     {
         return;
     }
 
     // SAFETY-CRITICAL: Fault recovery - only clear faults that can actually be cleared
-    if (current_state == APP_STATE_FAULT)
+    if (ctx->current_state == APP_STATE_FAULT)
     {
         const bool both_buttons_released = !inputs->button_up && !inputs->button_down;
         const bool no_external_fault = !inputs->fault_in;
         
         // Clear button fault only if buttons released
-        if (button_fault_latched && both_buttons_released)
+        if (ctx->button_fault_latched && both_buttons_released)
         {
-            button_fault_latched = false;
+            ctx->button_fault_latched = false;
         }
         
         // Clear external fault only if external source cleared
-        if (external_fault_latched && no_external_fault)
+        if (ctx->external_fault_latched && no_external_fault)
         {
-            external_fault_latched = false;
+            ctx->external_fault_latched = false;
         }
         
         // Clear current fault only if buttons released (user acknowledgment)
-        if (current_fault_latched && both_buttons_released)
+        if (ctx->current_fault_latched && both_buttons_released)
         {
-            current_fault_latched = false;
-            stuck_on_timer_start_ms = UINT32_MAX;     // Reset timers
-            obstruction_timer_start_ms = UINT32_MAX;
+            ctx->current_fault_latched = false;
+            ctx->stuck_on_timer_start_ms = UINT32_MAX;     // Reset timers
+            ctx->obstruction_timer_start_ms = UINT32_MAX;
         }
     }
 
     // SAFETY-CRITICAL: Simultaneous button press is a LATCHED fault condition
     if (inputs->button_up && inputs->button_down)
     {
-        button_fault_latched = true;
+        ctx->button_fault_latched = true;
     }
 
     // Propagate external fault to application layer (latched)
     if (inputs->fault_in)
     {
-        external_fault_latched = true;
+        ctx->external_fault_latched = true;
     }
 
     // SAFETY-CRITICAL: Both limit switches active is a TRANSIENT fault condition
     const bool dual_limit_fault = inputs->limit_upper && inputs->limit_lower;
 
     // Execute state machine logic to determine motor commands
-    switch (current_state)
+    outputs->moving_to_target = false;
+    outputs->target_height_um = 0;
+    outputs->calibrating = false;
+    outputs->calibration_done = false;
+    switch (ctx->current_state)
     {
         case APP_STATE_IDLE:
         default:
@@ -111,24 +198,42 @@ void APP_Task(const AppInput_t *inputs, AppOutput_t *outputs)
             outputs->led_bt_up = LED_OFF;
             outputs->led_bt_down = LED_OFF;
             outputs->led_error = LED_OFF;
+            outputs->soft_stop = true;   // Let a ramp-down begun by a button release finish
+
+            // The press that aborted a move to target must not start a manual move
+            if (ctx->button_release_pending && !inputs->button_up && !inputs->button_down)
+            {
+                ctx->button_release_pending = false;
+            }
+            const bool buttons_usable = !ctx->button_release_pending;
 
-            if (inputs->button_up && !inputs->limit_upper)
+            if (buttons_usable && inputs->button_up && !inputs->limit_upper)
             {
-                transition_to(APP_STATE_MOVING_UP, inputs->timestamp_ms);
+                transition_to(ctx, APP_STATE_MOVING_UP, inputs->timestamp_ms);
                 outputs->motor_cmd = MOTOR_UP;
                 outputs->motor_speed = 255U;
                 outputs->led_bt_up = LED_ON;
                 outputs->led_bt_down = LED_OFF;
                 outputs->led_error = LED_OFF;
+                outputs->soft_stop = false;
             }
-            else if (inputs->button_down && !inputs->limit_lower)
+            else if (buttons_usable && inputs->button_down && !inputs->limit_lower)
             {
-                transition_to(APP_STATE_MOVING_DOWN, inputs->timestamp_ms);
+                transition_to(ctx, APP_STATE_MOVING_DOWN, inputs->timestamp_ms);
                 outputs->motor_cmd = MOTOR_DOWN;
                 outputs->motor_speed = 255U;
                 outputs->led_bt_up = LED_OFF;
                 outputs->led_bt_down = LED_ON;
                 outputs->led_error = LED_OFF;
+                outputs->soft_stop = false;
+            }
+            else if (inputs->calibrate && !inputs->button_up && !inputs->button_down)
+            {
+                start_calibration(ctx, inputs, outputs);
+            }
+            else if (inputs->move_to_target && !inputs->button_up && !inputs->button_down)
+            {
+                start_move_to_target(ctx, inputs, outputs);
             }
             break;
         }
@@ -140,15 +245,18 @@ void APP_Task(const AppInput_t *inputs, AppOutput_t *outputs)
             outputs->led_bt_up = LED_ON;
             outputs->led_bt_down = LED_OFF;
             outputs->led_error = LED_OFF;
+            outputs->soft_stop = false;
 
             if (!inputs->button_up || inputs->limit_upper)
             {
-                transition_to(APP_STATE_IDLE, inputs->timestamp_ms);
+                transition_to(ctx, APP_STATE_IDLE, inputs->timestamp_ms);
                 outputs->motor_cmd = MOTOR_STOP;
                 outputs->motor_speed = 0U;
                 outputs->led_bt_up = LED_OFF;
                 outputs->led_bt_down = LED_OFF;
                 outputs->led_error = LED_OFF;
+                // SAFETY-CRITICAL: only a plain release may ramp down; a limit stops at once (SysReq-007)
+                outputs->soft_stop = !inputs->limit_upper;
             }
             break;
         }
@@ -160,15 +268,94 @@ void APP_Task(const AppInput_t *inputs, AppOutput_t *outputs)
             outputs->led_bt_up = LED_OFF;
             outputs->led_bt_down = LED_ON;
             outputs->led_error = LED_OFF;
+            outputs->soft_stop = false;
 
             if (!inputs->button_down || inputs->limit_lower)
             {
-                transition_to(APP_STATE_IDLE, inputs->timestamp_ms);
+                transition_to(ctx, APP_STATE_IDLE, inputs->timestamp_ms);
+                outputs->motor_cmd = MOTOR_STOP;
+                outputs->motor_speed = 0U;
+                outputs->led_bt_up = LED_OFF;
+                outputs->led_bt_down = LED_OFF;
+                outputs->led_error = LED_OFF;
+                // SAFETY-CRITICAL: only a plain release may ramp down; a limit stops at once (SysReq-007)
+                outputs->soft_stop = !inputs->limit_lower;
+            }
+            break;
+        }
+
+        case APP_STATE_MOVING_TO_TARGET:
+        {
+            set_target_outputs(ctx, outputs);
+
+            const bool up = (ctx->target_dir == MOTOR_UP);
+            const bool at_limit = up ? inputs->limit_upper : inputs->limit_lower;
+            const int32_t height_um = inputs->position_estimate.height_um;
+            const int32_t remaining_um = up ? (ctx->target_height_um - height_um) : (height_um - ctx->target_height_um);
+            const bool any_button = inputs->button_up || inputs->button_down;
+
+            // Any button aborts; the braking point (target_reached) normally ends the move,
+            // arriving within the tolerance or losing the height reference end it as well
+            if (any_button || at_limit || inputs->target_reached ||
+                !inputs->position_estimate.referenced || (remaining_um <= APP_TARGET_TOLERANCE_UM))
+            {
+                if (any_button)
+                {
+                    ctx->button_release_pending = true;
+                }
+                ctx->target_dir = MOTOR_STOP;
+                transition_to(ctx, APP_STATE_IDLE, inputs->timestamp_ms);
+                outputs->motor_cmd = MOTOR_STOP;
+                outputs->motor_speed = 0U;
+                outputs->led_bt_up = LED_OFF;
+                outputs->led_bt_down = LED_OFF;
+                outputs->led_error = LED_OFF;
+                outputs->moving_to_target = false;
+                outputs->target_height_um = 0;
+                // SAFETY-CRITICAL: a limit stops at once (SysReq-007); everything else ramps down
+                outputs->soft_stop = !at_limit;
+            }
+            break;
+        }
+
+        case APP_STATE_CALIBRATING:
+        {
+            set_calibration_outputs(ctx, outputs);
+
+            const bool up = (ctx->calibration_dir == MOTOR_UP);
+            const bool at_limit = up ? inputs->limit_upper : inputs->limit_lower;
+            const bool any_button = inputs->button_up || inputs->button_down;
+            const bool timed_out = (inputs->timestamp_ms - ctx->state_entry_time) >= APP_CALIBRATION_LEG_TIMEOUT_MS;
+            const bool aborted = any_button || timed_out;
+
+            // Each leg ends on its limit switch; any button or a leg that never gets there aborts
+            if (aborted || at_limit)
+            {
+                if (any_button)
+                {
+                    ctx->button_release_pending = true;
+                }
                 outputs->motor_cmd = MOTOR_STOP;
                 outputs->motor_speed = 0U;
                 outputs->led_bt_up = LED_OFF;
                 outputs->led_bt_down = LED_OFF;
                 outputs->led_error = LED_OFF;
+                // SAFETY-CRITICAL: a limit stops at once (SysReq-007), so does a leg that overran its time
+                outputs->soft_stop = !at_limit && !timed_out;
+
+                if (!aborted && !up)
+                {
+                    // Homed: the stroke to the upper limit switch starts next cycle, from rest
+                    ctx->calibration_dir = MOTOR_UP;
+                    transition_to(ctx, APP_STATE_CALIBRATING, inputs->timestamp_ms);
+                }
+                else
+                {
+                    ctx->calibration_dir = MOTOR_STOP;
+                    transition_to(ctx, APP_STATE_IDLE, inputs->timestamp_ms);
+                    outputs->calibrating = false;
+                    outputs->calibration_done = !aborted;
+                }
             }
             break;
         }
@@ -185,63 +372,81 @@ void APP_Task(const AppInput_t *inputs, AppOutput_t *outputs)
     // FEATURE SEPARATION: Current sensing fault detection (MT_ROBUST only)
     // Runs in ALL states including FAULT to monitor actual motor behavior
     // Current sensing only available when motor_type indicates MT_ROBUST driver
-    // MT_BASIC drivers do not support current sensing - behavior determined at runtime
+    // MT_BASIC drivers do not support current sensing - constant for the build
+    // unless DESK_MOTOR_RUNTIME_DISPATCH (MotorConfig_effectiveType)
     // ========================================================================
 
     // Check if current sensing is available based on motor type
-    const bool has_current_sensing = (inputs->motor_type == MT_ROBUST);
+    const bool has_current_sensing = (MotorConfig_effectiveType(inputs->motor_type) == MT_ROBUST);
     
     if (has_current_sensing)
     {
         // IBT_2 ROBUST DRIVER - Has integrated current sensing
-        if (outputs->motor_cmd == MOTOR_STOP)
+        const CurrentSummary_t *summary = &inputs->current_summary;
+        if (summary->samples > 0U)
+        {
+            // CASE 0: 1 kHz statistics - each sample was compared against the drive actually
+            // applied, so a spike between cycles still counts and the fault time is exact to 1 ms
+            ctx->stuck_on_timer_start_ms = UINT32_MAX;
+            ctx->obstruction_timer_start_ms = UINT32_MAX;
+
+            if ((summary->stuck_run_ms >= MOTOR_SENSE_FAULT_TIME_MS) ||
+                (summary->obstruction_run_ms >= MOTOR_SENSE_FAULT_TIME_MS) ||
+                (summary->deviation_run_ms >= MOTOR_SENSE_FAULT_TIME_MS) ||
+                summary->slope_jam)
+            {
+                ctx->current_fault_latched = true;
+            }
+        }
+        else if (outputs->motor_cmd == MOTOR_STOP)
         {
             // CASE 1: Stuck-on/runaway detection when STOP is commanded
             // Motor should draw minimal current when stopped
-            obstruction_timer_start_ms = UINT32_MAX;  // Reset obstruction timer (not moving)
+            ctx->obstruction_timer_start_ms = UINT32_MAX;  // Reset obstruction timer (not moving)
             
             if (inputs->motor_current_ma > MOTOR_SENSE_THRESHOLD_MA)
             {
                 // High current while stopped - start/continue timer
-                if (stuck_on_timer_start_ms == UINT32_MAX)
+                if (ctx->stuck_on_timer_start_ms == UINT32_MAX)
                 {
-                    stuck_on_timer_start_ms = inputs->timestamp_ms;
+                    ctx->stuck_on_timer_start_ms = inputs->timestamp_ms;
                 }
-                else if ((inputs->timestamp_ms - stuck_on_timer_start_ms) >= MOTOR_SENSE_FAULT_TIME_MS)
+                else if ((inputs->timestamp_ms - ctx->stuck_on_timer_start_ms) >= MOTOR_SENSE_FAULT_TIME_MS)
                 {
                     // Timeout expired - motor stuck on, latch fault
-                    current_fault_latched = true;
+                    ctx->current_fault_latched = true;
                 }
             }
             else
             {
                 // Current normal - reset stuck-on timer
-                stuck_on_timer_start_ms = UINT32_MAX;
+                ctx->stuck_on_timer_start_ms = UINT32_MAX;
             }
         }
         else  // outputs->motor_cmd == MOTOR_UP or MOTOR_DOWN
         {
             // CASE 2: Obstruction/jam detection during motion (SysReq-013, FSR-007)
-            // Motor should not draw excessive current during normal movement
-            stuck_on_timer_start_ms = UINT32_MAX;  // Reset stuck-on timer (motor is moving)
+            // Motor should not draw excessive current during normal movement; soft-start
+            // inrush is expected while the controller ramps up (PWM-dependent envelope)
+            ctx->stuck_on_timer_start_ms = UINT32_MAX;  // Reset stuck-on timer (motor is moving)
             
-            if (inputs->motor_current_ma > MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA)
+            if (inputs->motor_current_ma > CurrentMonitor_obstructionLimitMa(inputs->motor_phase, inputs->motor_pwm))
             {
                 // High current during motion - start/continue timer for debouncing
-                if (obstruction_timer_start_ms == UINT32_MAX)
+                if (ctx->obstruction_timer_start_ms == UINT32_MAX)
                 {
-                    obstruction_timer_start_ms = inputs->timestamp_ms;
+                    ctx->obstruction_timer_start_ms = inputs->timestamp_ms;
                 }
-                else if ((inputs->timestamp_ms - obstruction_timer_start_ms) >= MOTOR_SENSE_FAULT_TIME_MS)
+                else if ((inputs->timestamp_ms - ctx->obstruction_timer_start_ms) >= MOTOR_SENSE_FAULT_TIME_MS)
                 {
                     // Timeout expired - obstruction detected, latch fault
-                    current_fault_latched = true;
+                    ctx->current_fault_latched = true;
                 }
             }
             else
             {
                 // Current normal - reset obstruction timer
-                obstruction_timer_start_ms = UINT32_MAX;
+                ctx->obstruction_timer_start_ms = UINT32_MAX;
             }
         }
     }
@@ -250,37 +455,82 @@ void APP_Task(const AppInput_t *inputs, AppOutput_t *outputs)
         // MT_BASIC DRIVER - No current sensing available
         // Reset timers unconditionally to prevent any stale fault state
         // Never set current_fault_latched (hardware limitation)
-        stuck_on_timer_start_ms = UINT32_MAX;
-        obstruction_timer_start_ms = UINT32_MAX;
+        ctx->stuck_on_timer_start_ms = UINT32_MAX;
+        ctx->obstruction_timer_start_ms = UINT32_MAX;
     }
 
     // ========================================================================
     // SAFETY-CRITICAL: Consolidated fault handling
     // Combine all fault sources and transition to FAULT state if any active
     // ========================================================================
-    const bool any_latched_fault = button_fault_latched || external_fault_latched || current_fault_latched;
+    const bool any_latched_fault = ctx->button_fault_latched || ctx->external_fault_latched || ctx->current_fault_latched;
     const bool any_fault_active = any_latched_fault || dual_limit_fault;
     
     outputs->fault_out = any_fault_active;
 
     if (any_fault_active)
     {
-        current_state = APP_STATE_FAULT;
+        ctx->current_state = APP_STATE_FAULT;
+        ctx->target_dir = MOTOR_STOP;  // A fault ends any move to target or calibration for good
+        ctx->calibration_dir = MOTOR_STOP;
         handle_fault(outputs);
     }
-    else if (current_state == APP_STATE_FAULT)
+    else if (ctx->current_state == APP_STATE_FAULT)
     {
         // All faults cleared - transition back to IDLE
-        transition_to(APP_STATE_IDLE, inputs->timestamp_ms);
+        transition_to(ctx, APP_STATE_IDLE, inputs->timestamp_ms);
         outputs->motor_cmd = MOTOR_STOP;
         outputs->motor_speed = 0U;
         outputs->led_bt_up = LED_OFF;
         outputs->led_bt_down = LED_OFF;
         outputs->led_error = LED_OFF;
+        outputs->soft_stop = false;
+    }
+}
+
+AppSafetyStop_t APP_SafetyCheck(const AppInput_t *inputs, MotorDirection_t driven_dir)
+{
+    if (inputs == NULL)
+    {
+        return APP_SAFETY_INVALID_INPUT;
+    }
+    if (driven_dir == MOTOR_STOP)
+    {
+        return APP_SAFETY_OK;
+    }
+
+    // SAFETY-CRITICAL: same conditions as APP_TaskCtx(), most severe first
+    if (inputs->fault_in)
+    {
+        return APP_SAFETY_EXTERNAL_FAULT;
     }
+    if (inputs->limit_upper && inputs->limit_lower)
+    {
+        return APP_SAFETY_DUAL_LIMIT;
+    }
+    if (inputs->button_up && inputs->button_down)
+    {
+        return APP_SAFETY_DUAL_BUTTON;
+    }
+    if (((driven_dir == MOTOR_UP) && inputs->limit_upper) ||
+        ((driven_dir == MOTOR_DOWN) && inputs->limit_lower))
+    {
+        return APP_SAFETY_LIMIT;
+    }
+    return APP_SAFETY_OK;
+}
+
+void APP_Task(const AppInput_t *inputs, AppOutput_t *outputs)
+{
+    APP_TaskCtx(&default_context, inputs, outputs);
+}
+
+AppState_t APP_GetStateCtx(const AppContext_t *ctx)
+{
+    return (ctx != NULL) ? ctx->current_state : APP_STATE_FAULT;
 }
 
 AppState_t APP_GetState(void)
 {
-    return current_state;
+    return APP_GetStateCtx(&default_context);
 }
@@ -15,8 +15,17 @@ typedef struct
     bool limit_upper;
     bool limit_lower;
     bool fault_in;       // external fault input (e.g., motor controller)
-    MotorType_t motor_type; // motor driver type for current sensing
-    uint16_t motor_current_ma;
+    MotorType_t motor_type; // motor driver type for current sensing (build type unless DESK_MOTOR_RUNTIME_DISPATCH)
+    uint16_t motor_current_ma;        // latest sample; used when current_summary.samples is 0
+    MotorRampPhase_t motor_phase;     // ramp phase of the drive applied (MotorControllerOutput_t.phase)
+    uint8_t motor_pwm;                // PWM applied
+    CurrentSummary_t current_summary; // 1 kHz statistics since the previous cycle (HAL_takeMotorCurrentSummary)
+    EncoderState_t encoder;           // position / velocity from the quadrature encoder (HAL_readEncoder)
+    PositionEstimate_t position_estimate; // sensorless height from the drive applied (position_estimator.h)
+    bool move_to_target;              // request: move to target_height_um (one cycle, e.g. a preset recall)
+    int32_t target_height_um;         // requested height above the lower limit switch (position_estimate units)
+    bool target_reached;              // the 1 kHz path began the soft stop that ends on the target
+    bool calibrate;                   // request: run the stroke calibration (one cycle, desk_calibration.h)
     uint32_t timestamp_ms;
 } AppInput_t;
 
@@ -35,6 +44,15 @@ typedef struct
  * @field led_bt_down - DOWN button LED state (ON when DOWN button pressed)
  * @field led_error - ERROR LED state (ON when system in fault state)
  * @field fault_out - Latched fault condition flag
+ * @field soft_stop - STOP is an ordinary stop (button release) and may ramp down;
+ *                    false = remove drive immediately (faults, limits, conflicts)
+ * @field moving_to_target - Drive belongs to a move to target_height_um; the
+ *                    caller starts the soft stop at the braking point
+ * @field target_height_um - Target of the move (0 unless moving_to_target)
+ * @field calibrating - Drive (or the pause between the legs) belongs to the
+ *                    stroke calibration; the caller drives it open loop
+ * @field calibration_done - The calibration stroke reached the upper limit
+ *                    switch this cycle; the caller stores its measurements
  */
 typedef struct
 {
@@ -44,6 +62,11 @@ typedef struct
     LEDState_t led_bt_down;           ///< DOWN button indicator LED
     LEDState_t led_error;             ///< ERROR state indicator LED
     bool fault_out;                   ///< Latched fault state
+    bool soft_stop;                   ///< Controlled ramp-down allowed (MOTOR_STOP_SOFT)
+    bool moving_to_target;            ///< Move to target in progress
+    int32_t target_height_um;         ///< Target of the move
+    bool calibrating;                 ///< Stroke calibration in progress
+    bool calibration_done;            ///< Stroke calibration completed (one cycle)
 } AppOutput_t;
 
 typedef enum
@@ -51,13 +74,103 @@ typedef enum
     APP_STATE_IDLE = 0,
     APP_STATE_MOVING_UP = 1,
     APP_STATE_MOVING_DOWN = 2,
-    APP_STATE_FAULT = 3
+    APP_STATE_FAULT = 3,
+    APP_STATE_MOVING_TO_TARGET = 4,
+    APP_STATE_CALIBRATING = 5
 } AppState_t;
 
+/**
+ * @brief A move to target ends (and is not started) within this distance of the target
+ */
+static const int32_t APP_TARGET_TOLERANCE_UM = 2000;
+
+/**
+ * @brief A calibration leg that has not reached its limit switch by then is aborted
+ *        (1.5 x the SysReq-004 stroke time: the switch is missing or the desk is held)
+ */
+static const uint32_t APP_CALIBRATION_LEG_TIMEOUT_MS = 45000U;
+
+/**
+ * @brief Reason for a fast-path safety stop (APP_SafetyCheck)
+ */
+typedef enum
+{
+    APP_SAFETY_OK = 0,              ///< Drive may continue
+    APP_SAFETY_LIMIT = 1,           ///< Limit switch active in the driven direction (SWReq-005/006)
+    APP_SAFETY_DUAL_LIMIT = 2,      ///< Both limit switches active (SWReq-010)
+    APP_SAFETY_DUAL_BUTTON = 3,     ///< Both buttons pressed (SWReq-004)
+    APP_SAFETY_EXTERNAL_FAULT = 4,  ///< External fault input asserted (SWReq-010)
+    APP_SAFETY_INVALID_INPUT = 5    ///< NULL inputs (fail-safe)
+} AppSafetyStop_t;
+
+/**
+ * @struct AppContext_t
+ * @brief Complete state of one DeskApp instance
+ *
+ * Holds everything APP_Task() carries between calls, so independent desks can
+ * be stepped side by side (e.g. fleet simulation with contiguous arrays of
+ * contexts). The single-desk API (APP_Init/APP_Task/APP_GetState) operates on
+ * a module-internal default instance.
+ *
+ * @field current_state - State machine state
+ * @field state_entry_time - Timestamp of the last state transition (ms)
+ * @field button_fault_latched - Dual button press fault
+ * @field external_fault_latched - External fault input
+ * @field current_fault_latched - Stuck-on or obstruction fault
+ * @field stuck_on_timer_start_ms - Stuck-on detection timer (UINT32_MAX = not running)
+ * @field obstruction_timer_start_ms - Obstruction detection timer (UINT32_MAX = not running)
+ * @field target_height_um - Target of the latest move to target
+ * @field target_dir - Direction of the move to target (MOTOR_STOP = none)
+ * @field button_release_pending - A button aborted a move to target or a
+ *        calibration; buttons start nothing until both are released
+ * @field calibration_dir - Calibration leg in progress: MOTOR_DOWN homes to the
+ *        lower limit switch, MOTOR_UP strokes to the upper one (MOTOR_STOP = none)
+ */
+typedef struct
+{
+    AppState_t current_state;
+    uint32_t state_entry_time;
+    bool button_fault_latched;
+    bool external_fault_latched;
+    bool current_fault_latched;
+    uint32_t stuck_on_timer_start_ms;
+    uint32_t obstruction_timer_start_ms;
+    int32_t target_height_um;
+    MotorDirection_t target_dir;
+    bool button_release_pending;
+    MotorDirection_t calibration_dir;
+} AppContext_t;
+
 void APP_Init(void);
 void APP_Task(const AppInput_t *inputs, AppOutput_t *outputs);
 AppState_t APP_GetState(void);
 
+/**
+ * @brief Stateless subset of the APP_Task() stop rules for the fast safety path
+ *
+ * Evaluates the limit switch, dual-button and external-fault rules against the
+ * direction the motor is actually driven, without touching the state machine,
+ * so the caller can remove drive within a millisecond of an input edge while
+ * APP_Task() latches the fault and updates LEDs at its own 250 ms cadence.
+ * Button levels may be undebounced: stopping on a bounce is fail-safe.
+ * Reads only button_up/down, limit_upper/lower and fault_in.
+ *
+ * @param inputs - Current input levels
+ * @param driven_dir - Direction currently driven (MOTOR_STOP never needs a stop)
+ * @return AppSafetyStop_t - APP_SAFETY_OK, or the first rule that requires a stop
+ */
+AppSafetyStop_t APP_SafetyCheck(const AppInput_t *inputs, MotorDirection_t driven_dir);
+
+/**
+ * @brief Re-entrant variants operating on a caller-owned context
+ *
+ * Behave exactly like APP_Init/APP_Task/APP_GetState on the given instance.
+ * NULL ctx is ignored (APP_GetStateCtx reports APP_STATE_FAULT).
+ */
+void APP_InitCtx(AppContext_t *ctx);
+void APP_TaskCtx(AppContext_t *ctx, const AppInput_t *inputs, AppOutput_t *outputs);
+AppState_t APP_GetStateCtx(const AppContext_t *ctx);
+
 #ifdef __cplusplus
 }
 #endif
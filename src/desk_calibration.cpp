@@ -0,0 +1,143 @@
+#include "desk_calibration.h"
+#include "position_encoder.h"
+#include "position_estimator.h"
+#include <stddef.h>  // For NULL definition
+
+static const uint8_t UM_PER_COUNT_SHIFT = 4U;  // 1/16 um per count resolution
+
+static uint16_t saturate_u16(uint32_t value)
+{
+    return (value < UINT16_MAX) ? static_cast<uint16_t>(value) : UINT16_MAX;
+}
+
+void DeskCalibration_init(DeskCalibration_t *calibration)
+{
+    if (calibration == NULL)
+    {
+        return;
+    }
+    calibration->scale[0] = 0U;
+    calibration->scale[1] = 0U;
+    calibration->stroke_ms = 0U;
+    calibration->ramp_ms = 0U;
+    calibration->encoder_counts = 0U;
+    calibration->current_mean_ma = 0U;
+    calibration->current_peak_ma = 0U;
+}
+
+bool DeskCalibration_load(DeskCalibration_t *calibration)
+{
+    if (calibration == NULL)
+    {
+        return false;
+    }
+    return NVM_readRecord(NVM_ADDR_CALIBRATION, NVM_ID_CALIBRATION,
+                          calibration, static_cast<uint8_t>(sizeof(*calibration)));
+}
+
+bool DeskCalibration_save(const DeskCalibration_t *calibration)
+{
+    if (calibration == NULL)
+    {
+        return false;
+    }
+    return NVM_writeRecord(NVM_ADDR_CALIBRATION, NVM_ID_CALIBRATION,
+                           calibration, static_cast<uint8_t>(sizeof(*calibration)));
+}
+
+void DeskCalibration_beginStroke(DeskCalibrationStroke_t *stroke, uint32_t now_ms, int32_t encoder_counts)
+{
+    if (stroke == NULL)
+    {
+        return;
+    }
+    DeskCalibration_cancelStroke(stroke);
+    stroke->active = true;
+    stroke->start_ms = now_ms;
+    stroke->start_counts = encoder_counts;
+}
+
+void DeskCalibration_cancelStroke(DeskCalibrationStroke_t *stroke)
+{
+    if (stroke == NULL)
+    {
+        return;
+    }
+    stroke->active = false;
+    stroke->half_passed = false;
+    stroke->start_ms = 0U;
+    stroke->start_counts = 0;
+    stroke->half_ms = 0U;
+    stroke->half_counts = 0;
+    stroke->current_sum_ma = 0U;
+    stroke->current_samples = 0U;
+    stroke->current_peak_ma = 0U;
+}
+
+void DeskCalibration_sample(DeskCalibrationStroke_t *stroke, uint32_t now_ms, int32_t encoder_counts,
+                            int32_t height_um, bool cruising, uint16_t current_ma)
+{
+    if ((stroke == NULL) || !stroke->active)
+    {
+        return;
+    }
+    if (!stroke->half_passed && (height_um >= static_cast<int32_t>(POSITION_ESTIMATOR_STROKE_UM / 2U)))
+    {
+        stroke->half_passed = true;
+        stroke->half_ms = now_ms;
+        stroke->half_counts = encoder_counts;
+    }
+    if (cruising)
+    {
+        stroke->current_sum_ma += current_ma;
+        stroke->current_samples++;
+        if (current_ma > stroke->current_peak_ma)
+        {
+            stroke->current_peak_ma = current_ma;
+        }
+    }
+}
+
+bool DeskCalibration_endStroke(DeskCalibrationStroke_t *stroke, DeskCalibration_t *calibration,
+                               uint32_t now_ms, int32_t encoder_counts)
+{
+    if ((stroke == NULL) || (calibration == NULL) || !stroke->active)
+    {
+        return false;
+    }
+
+    const uint32_t stroke_ms = now_ms - stroke->start_ms;
+    const int32_t counts = encoder_counts - stroke->start_counts;
+    const bool has_encoder = counts >= static_cast<int32_t>(DESK_CALIBRATION_MIN_ENCODER_COUNTS);
+    calibration->stroke_ms = saturate_u16(stroke_ms);
+    calibration->encoder_counts = has_encoder ? saturate_u16(static_cast<uint32_t>(counts)) : 0U;
+    calibration->current_mean_ma = (stroke->current_samples > 0U) ?
+        saturate_u16(stroke->current_sum_ma / stroke->current_samples) : 0U;
+    calibration->current_peak_ma = stroke->current_peak_ma;
+
+    // Start lag: the second half runs at cruise speed; the whole stroke at that speed would be this much faster
+    calibration->ramp_ms = 0U;
+    const int32_t half_counts = encoder_counts - stroke->half_counts;
+    const uint32_t half_ms = now_ms - stroke->half_ms;
+    if (has_encoder && stroke->half_passed && (half_counts > 0) && (half_ms > 0U))
+    {
+        const uint32_t cruise_ms = (static_cast<uint32_t>(calibration->encoder_counts) * half_ms) /
+                                   static_cast<uint32_t>(half_counts);
+        calibration->ramp_ms = (stroke_ms > cruise_ms) ? saturate_u16(stroke_ms - cruise_ms) : 0U;
+    }
+
+    DeskCalibration_cancelStroke(stroke);
+    return true;
+}
+
+int32_t DeskCalibration_velocityUmS(const DeskCalibration_t *calibration, int16_t velocity_cps)
+{
+    if ((calibration == NULL) || (calibration->encoder_counts < DESK_CALIBRATION_MIN_ENCODER_COUNTS))
+    {
+        return (static_cast<int32_t>(velocity_cps) * 1000) / ENCODER_COUNTS_PER_MM;
+    }
+    // At least 1 count per mm keeps um per count <= 1000 << UM_PER_COUNT_SHIFT: the product fits 32 bits
+    const int32_t um_per_count = static_cast<int32_t>((POSITION_ESTIMATOR_STROKE_UM << UM_PER_COUNT_SHIFT) /
+                                                      calibration->encoder_counts);
+    return (static_cast<int32_t>(velocity_cps) * um_per_count) / (1 << UM_PER_COUNT_SHIFT);
+}
@@ -0,0 +1,129 @@
+/**
+ * @file desk_calibration.h
+ * @brief Stroke calibration (homing plus one measured stroke), persisted in NVM
+ *
+ * @purpose
+ * The position estimate, the current baseline and the braking point of a move
+ * to target all start from defaults and only converge stroke by stroke, and
+ * forget the estimator's learning at every power cycle. On request the desk
+ * homes to the lower limit switch and travels the full stroke up
+ * (APP_STATE_CALIBRATING); what that stroke measures is stored once and
+ * applied at every start-up.
+ *
+ * @implementation
+ * - Measured from the drive start at the lower limit switch to reaching the
+ *   upper one, sampled at 1 kHz by DeskControl_Poll():
+ *   - travel time at full PWM, soft-start ramp included
+ *   - encoder counts per stroke; fewer than DESK_CALIBRATION_MIN_ENCODER_COUNTS
+ *     means no encoder is fitted
+ *   - cruise current (mean and peak, ramps excluded)
+ *   - ramp response: the start lag, i.e. travel time minus the time the stroke
+ *     takes at the cruise speed of its second half (encoder only)
+ * - The caller adds the position estimator's upward scale of the stroke
+ *   (PositionEstimator_strokeScale()) and the downward scale learned so far
+ * - One NVM record (NVM_ADDR_CALIBRATION); 0 marks a value not measured
+ *
+ * @thread_safety NOT thread-safe; main loop only
+ */
+
+#ifndef DESK_CALIBRATION_H
+#define DESK_CALIBRATION_H
+
+#include <stdint.h>
+#include "nvm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint16_t DESK_CALIBRATION_MIN_ENCODER_COUNTS = 640U;  // Below 1 count per mm of stroke: no encoder
+
+typedef struct
+{
+    uint16_t scale[2];          ///< Position estimator speed scale per [UP, DOWN] (0 = not calibrated)
+    uint16_t stroke_ms;         ///< Travel time from the lower to the upper limit switch at full PWM
+    uint16_t ramp_ms;           ///< Start lag of the stroke (0 = not measured)
+    uint16_t encoder_counts;    ///< Encoder counts per stroke (0 = no encoder)
+    uint16_t current_mean_ma;   ///< Mean motor current at cruise
+    uint16_t current_peak_ma;   ///< Highest motor current sample at cruise
+} DeskCalibration_t;
+
+static_assert(sizeof(DeskCalibration_t) <= NVM_MAX_PAYLOAD, "Calibration record exceeds the NVM payload");
+
+typedef struct
+{
+    bool active;                ///< Stroke up from the lower limit switch in progress
+    bool half_passed;           ///< The height estimate passed half the stroke
+    uint32_t start_ms;          ///< Drive start at the lower limit switch
+    int32_t start_counts;       ///< Encoder position at the start
+    uint32_t half_ms;           ///< Time half the stroke was passed
+    int32_t half_counts;        ///< Encoder position there
+    uint32_t current_sum_ma;    ///< Sum of the cruise current samples
+    uint32_t current_samples;   ///< Cruise current samples
+    uint16_t current_peak_ma;   ///< Highest cruise current sample
+} DeskCalibrationStroke_t;
+
+/**
+ * @brief Mark every value as not measured
+ */
+void DeskCalibration_init(DeskCalibration_t *calibration);
+
+/**
+ * @brief Restore the record from NVM
+ *
+ * @return bool - false if no valid record exists (calibration stays not measured)
+ */
+bool DeskCalibration_load(DeskCalibration_t *calibration);
+
+/**
+ * @brief Stage the record for writing to NVM (see NVM_writeRecord())
+ *
+ * @return bool - false if NVM is busy; retry later
+ */
+bool DeskCalibration_save(const DeskCalibration_t *calibration);
+
+/**
+ * @brief Start measuring a stroke whose drive starts at the lower limit switch now
+ *
+ * @param encoder_counts - EncoderState_t.position_counts at the start
+ */
+void DeskCalibration_beginStroke(DeskCalibrationStroke_t *stroke, uint32_t now_ms, int32_t encoder_counts);
+
+/**
+ * @brief Drop the stroke in progress (calibration aborted)
+ */
+void DeskCalibration_cancelStroke(DeskCalibrationStroke_t *stroke);
+
+/**
+ * @brief Add one 1 kHz sample of the stroke in progress (ignored while none is)
+ *
+ * @param height_um - Position estimate (finds half the stroke)
+ * @param cruising - Ramp phase MOTOR_PHASE_CRUISE: the current sample counts
+ * @param current_ma - Sampled motor current
+ */
+void DeskCalibration_sample(DeskCalibrationStroke_t *stroke, uint32_t now_ms, int32_t encoder_counts,
+                            int32_t height_um, bool cruising, uint16_t current_ma);
+
+/**
+ * @brief Finish the stroke at the upper limit switch into a record
+ *
+ * Fills every value but scale[]; the stroke is no longer in progress afterwards.
+ *
+ * @return bool - false if no stroke was in progress (record unchanged)
+ */
+bool DeskCalibration_endStroke(DeskCalibrationStroke_t *stroke, DeskCalibration_t *calibration,
+                               uint32_t now_ms, int32_t encoder_counts);
+
+/**
+ * @brief Encoder velocity in um/s along the counts, from the calibrated counts per stroke
+ *
+ * @param velocity_cps - EncoderState_t.velocity_cps
+ * @return int32_t - ENCODER_COUNTS_PER_MM applies while no encoder was calibrated
+ */
+int32_t DeskCalibration_velocityUmS(const DeskCalibration_t *calibration, int16_t velocity_cps);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DESK_CALIBRATION_H
@@ -0,0 +1,593 @@
+#include "desk_control.h"
+#include "hal.h"
+#include "desk_app.h"
+#include "motor_controller.h"
+#include "motor_config.h"
+#include "task_profiler.h"
+#include "current_baseline.h"
+#include "current_monitor.h"
+#include "nvm.h"
+#include "position_encoder.h"
+#include "position_estimator.h"
+#include "desk_presets.h"
+#include "motion_profile.h"
+#include "speed_controller.h"
+#include "desk_calibration.h"
+
+// Non-blocking scheduler: run APP logic every 250 ms (SWReq-011: 250 ± 10 ms)
+static DESK_THREAD_LOCAL uint32_t last_app_run_ms = 0U;
+static DESK_THREAD_LOCAL uint32_t last_fast_run_ms = 0U;  // 1 kHz motor sub-task (PWM ramp)
+static DESK_THREAD_LOCAL uint32_t last_current_sample_ms = 0U;  // 1 kHz motor current sampling
+static DESK_THREAD_LOCAL AppOutput_t app_out_cached;
+static DESK_THREAD_LOCAL bool motor_fault_latched = false;  // Latch motor controller faults (prevent blink loop)
+static DESK_THREAD_LOCAL AppSafetyStop_t last_safety_stop = APP_SAFETY_OK;  // Diagnostics: latest fast-path stop
+static DESK_THREAD_LOCAL MotorControllerOutput_t applied_motor;  // Last output sent to HAL_setMotor() (inrush envelope)
+
+// Learned current baseline (current_baseline.h). No height sensor: the position is the
+// travel time since the stroke left the limit switch it started from
+static DESK_THREAD_LOCAL CurrentBaseline_t current_baseline;
+static DESK_THREAD_LOCAL bool baseline_save_pending = false;
+static DESK_THREAD_LOCAL MotorDirection_t stroke_ref_dir = MOTOR_STOP;  // Away from the last limit reached (STOP = unknown)
+static DESK_THREAD_LOCAL uint8_t stroke_bin = 0U;
+static DESK_THREAD_LOCAL uint16_t stroke_bin_ms = 0U;
+
+// Sensorless height (position_estimator.h), integrated from applied_motor at 1 kHz
+static DESK_THREAD_LOCAL PositionEstimator_t position_estimator;
+
+// Memory presets (desk_presets.h) and the move to target they start (motion_profile.h)
+static DESK_THREAD_LOCAL DeskPresets_t presets;
+static DESK_THREAD_LOCAL bool presets_save_pending = false;
+static DESK_THREAD_LOCAL bool target_requested = false;    // Recall waiting for the next control cycle
+static DESK_THREAD_LOCAL int32_t target_request_um = 0;
+static DESK_THREAD_LOCAL bool target_reached = false;      // Braking point passed; APP_Task ends the move
+static DESK_THREAD_LOCAL MotionProfile_t motion_profile;
+
+// Closed-loop speed (speed_controller.h); SPEED_FEEDBACK_OFF drives AppOutput_t.motor_speed open loop
+static DESK_THREAD_LOCAL SpeedController_t speed_controller;
+static DESK_THREAD_LOCAL SpeedFeedback_t speed_feedback = SPEED_FEEDBACK_OFF;
+static DESK_THREAD_LOCAL uint32_t speed_setpoint_um_s = 0U;
+
+// Stroke calibration (desk_calibration.h): measured on the way up, adopted once APP_Task() completes it
+static DESK_THREAD_LOCAL DeskCalibration_t calibration;           // Applied record
+static DESK_THREAD_LOCAL DeskCalibration_t calibration_measured;  // Stroke of the calibration in progress
+static DESK_THREAD_LOCAL DeskCalibrationStroke_t calibration_stroke;
+static DESK_THREAD_LOCAL bool calibration_save_pending = false;
+static DESK_THREAD_LOCAL bool calibration_requested = false;      // Request waiting for the next control cycle
+
+/**
+ * @brief Adopt the calibrated speed scales (0 = keep the estimator's own)
+ */
+static void apply_calibration(void)
+{
+    if (calibration.scale[0] != 0U)
+    {
+        PositionEstimator_setScale(&position_estimator, MOTOR_UP, calibration.scale[0]);
+    }
+    if (calibration.scale[1] != 0U)
+    {
+        PositionEstimator_setScale(&position_estimator, MOTOR_DOWN, calibration.scale[1]);
+    }
+}
+
+void DeskControl_Init(uint32_t now_ms)
+{
+    MotorController_init();
+    APP_Init();
+
+    // Initialize cached outputs (safe defaults)
+    app_out_cached.motor_cmd = MOTOR_STOP;
+    app_out_cached.motor_speed = 0U;
+    app_out_cached.led_bt_up = LED_OFF;
+    app_out_cached.led_bt_down = LED_OFF;
+    app_out_cached.led_error = LED_OFF;
+    app_out_cached.fault_out = false;
+    app_out_cached.soft_stop = false;
+    motor_fault_latched = false;  // Initialize motor fault latch
+    applied_motor = MotorControllerOutput_t();
+    last_safety_stop = APP_SAFETY_OK;
+    last_app_run_ms = now_ms;
+    last_fast_run_ms = now_ms;
+    last_current_sample_ms = now_ms;
+    CurrentBaseline_init(&current_baseline);
+    (void)CurrentBaseline_load(&current_baseline);  // No record yet: the fixed thresholds apply until learned
+    baseline_save_pending = false;
+    stroke_ref_dir = MOTOR_STOP;
+    stroke_bin = 0U;
+    stroke_bin_ms = 0U;
+    PositionEstimator_init(&position_estimator);
+    DeskPresets_init(&presets);
+    (void)DeskPresets_load(&presets);  // No record yet: every slot empty
+    presets_save_pending = false;
+    target_requested = false;
+    target_request_um = 0;
+    target_reached = false;
+    MotionProfile_init(&motion_profile);
+    SpeedController_init(&speed_controller);
+    speed_feedback = SPEED_FEEDBACK_OFF;
+    speed_setpoint_um_s = 0U;
+    DeskCalibration_init(&calibration);
+    if (DeskCalibration_load(&calibration))  // No record yet: the model defaults apply until calibrated
+    {
+        apply_calibration();
+    }
+    DeskCalibration_init(&calibration_measured);
+    DeskCalibration_cancelStroke(&calibration_stroke);
+    calibration_save_pending = false;
+    calibration_requested = false;
+    TaskProfiler_reset();
+}
+
+/**
+ * @brief External fault input level
+ *
+ * No fault input pin is assigned yet (pin_config.h); the control cycle and the
+ * safety path both read it here so wiring one up covers both at once.
+ */
+static bool read_external_fault(void)
+{
+    return false;
+}
+
+/**
+ * @brief Fast-path safety check (APP_SafetyCheck) for the direction actually driven
+ *
+ * Uses undebounced button levels and the latest limit edges, so a stop takes
+ * effect in the loop pass that consumes the edge instead of after debounce and
+ * the next 250 ms control cycle.
+ */
+static AppSafetyStop_t safety_check(MotorDirection_t driven_dir, const HALInputSnapshot_t *snapshot)
+{
+    AppInput_t inputs = AppInput_t();
+    inputs.button_up = snapshot->button_raw[BUTTON_UP];
+    inputs.button_down = snapshot->button_raw[BUTTON_DOWN];
+    inputs.limit_upper = snapshot->limit[LIMIT_UPPER];
+    inputs.limit_lower = snapshot->limit[LIMIT_LOWER];
+    inputs.fault_in = read_external_fault();
+    return APP_SafetyCheck(&inputs, driven_dir);
+}
+
+/**
+ * @brief The speed controller sets the drive rather than AppOutput_t.motor_speed alone
+ *
+ * A calibration stroke always runs open loop: it measures the drive at full PWM.
+ */
+static bool speed_controlled(void)
+{
+    return (speed_feedback != SPEED_FEEDBACK_OFF) && !app_out_cached.calibrating;
+}
+
+/**
+ * @brief Target PWM for the MotorController: AppOutput_t.motor_speed, or less to hold the speed setpoint
+ */
+static uint8_t target_pwm(uint32_t now_ms)
+{
+    const MotorDirection_t cmd = app_out_cached.motor_cmd;
+    if (!speed_controlled() || (cmd == MOTOR_STOP))
+    {
+        SpeedController_init(&speed_controller);
+        return app_out_cached.motor_speed;
+    }
+
+    const uint8_t feedforward = PositionEstimator_pwmForSpeed(&position_estimator, cmd, speed_setpoint_um_s);
+    uint8_t pwm = feedforward;
+    if (speed_feedback == SPEED_FEEDBACK_ENCODER)
+    {
+        EncoderState_t encoder;
+        HAL_readEncoder(&encoder);
+        const int32_t velocity_um_s = DeskCalibration_velocityUmS(&calibration, encoder.velocity_cps);
+        // Integrate while cruising only: during the ramps the MotorController scales the output
+        pwm = SpeedController_update(&speed_controller, cmd, speed_setpoint_um_s, feedforward,
+                                     (cmd == MOTOR_UP) ? velocity_um_s : -velocity_um_s,
+                                     applied_motor.phase == MOTOR_PHASE_CRUISE, now_ms);
+    }
+    return (pwm < app_out_cached.motor_speed) ? pwm : app_out_cached.motor_speed;
+}
+
+/**
+ * @brief Motor controller update for the cached application targets
+ *
+ * Ordinary releases ramp down (MOTOR_STOP_SOFT); faults, limits and conflicts
+ * stop immediately. Every update - control cycle, 1 kHz sub-task or input edge -
+ * passes the safety check before drive reaches the HAL, including a ramp-down
+ * that would run into an active limit switch.
+ */
+static MotorControllerOutput_t update_motor(uint32_t now_ms, const HALInputSnapshot_t *snapshot)
+{
+    // Move to target: begin the soft stop at the braking point, between control cycles
+    // if need be; APP_Task() ends the move once it sees target_reached
+    if (app_out_cached.moving_to_target && (app_out_cached.motor_cmd != MOTOR_STOP) &&
+        MotionProfile_atBrakingPoint(&motion_profile, &position_estimator, applied_motor.dir, applied_motor.pwm,
+                                     app_out_cached.target_height_um))
+    {
+        app_out_cached.motor_cmd = MOTOR_STOP;
+        app_out_cached.motor_speed = 0U;
+        app_out_cached.soft_stop = true;
+        target_reached = true;
+    }
+
+    const MotorStopMode_t stop_mode = app_out_cached.soft_stop ? MOTOR_STOP_SOFT : MOTOR_STOP_IMMEDIATE;
+    MotorControllerOutput_t mc_out =
+        MotorController_updateStop(app_out_cached.motor_cmd, target_pwm(now_ms), stop_mode, now_ms);
+
+    // SAFETY-CRITICAL: limit, dual-button and external-fault rules act on the outputs
+    // directly (SysReq-007); APP_Task() latches the fault at its own cadence
+    const AppSafetyStop_t stop = safety_check(mc_out.dir, snapshot);
+    if (stop != APP_SAFETY_OK)
+    {
+        mc_out = MotorController_update(MOTOR_STOP, 0U, now_ms);
+        last_safety_stop = stop;
+    }
+    return mc_out;
+}
+
+/**
+ * @brief Apply a motor controller output and remember its ramp phase for current sensing
+ */
+static void apply_motor(const MotorControllerOutput_t *mc_out)
+{
+    HAL_setMotor(mc_out->dir, mc_out->pwm);
+    applied_motor = *mc_out;
+}
+
+/**
+ * @brief SAFETY-CRITICAL: remove drive and show the fault (every pin re-asserted)
+ */
+static void apply_fault_outputs(void)
+{
+    HAL_refreshOutputs();  // Do not trust the shadow
+    HAL_setMotor(MOTOR_STOP, 0U);
+    applied_motor = MotorControllerOutput_t();
+    HAL_setLED(LED_BT_UP, LED_OFF);
+    HAL_setLED(LED_BT_DOWN, LED_OFF);
+    HAL_setLED(LED_ERROR, LED_ON);
+}
+
+/**
+ * @brief Stroke position bin for the 1 kHz sample (travel time since leaving a limit switch)
+ *
+ * A limit switch references the position; stopping or reversing away from the
+ * referenced direction loses it until the next limit is reached. So does speed
+ * control: travel time only maps to a position at the open-loop speed.
+ *
+ * @param elapsed_ms - Time since the previous sample (a late loop pass advances by the whole gap)
+ */
+static uint8_t stroke_position_bin(MotorDirection_t drive_dir, uint32_t elapsed_ms)
+{
+    if (HAL_readLimitSensor(LIMIT_LOWER) || HAL_readLimitSensor(LIMIT_UPPER))
+    {
+        stroke_ref_dir = HAL_readLimitSensor(LIMIT_LOWER) ? MOTOR_UP : MOTOR_DOWN;
+        stroke_bin = 0U;
+        stroke_bin_ms = 0U;
+    }
+
+    if ((drive_dir == MOTOR_STOP) && (stroke_bin == 0U) && (stroke_bin_ms == 0U))
+    {
+        return CURRENT_BASELINE_NO_POSITION;  // Waiting at the reference
+    }
+    if ((drive_dir != stroke_ref_dir) || (stroke_bin >= CURRENT_BASELINE_BINS) || speed_controlled())
+    {
+        stroke_ref_dir = MOTOR_STOP;
+        return CURRENT_BASELINE_NO_POSITION;
+    }
+
+    const uint8_t bin = stroke_bin;
+    uint32_t bin_ms = stroke_bin_ms + elapsed_ms;
+    while ((bin_ms >= CURRENT_BASELINE_BIN_MS) && (stroke_bin < CURRENT_BASELINE_BINS))
+    {
+        bin_ms -= CURRENT_BASELINE_BIN_MS;
+        stroke_bin++;
+    }
+    stroke_bin_ms = (bin_ms < CURRENT_BASELINE_BIN_MS) ? static_cast<uint16_t>(bin_ms) : 0U;
+    return bin;
+}
+
+/**
+ * @brief Learn the sample into the baseline; a stop ends the stroke and persists what changed
+ */
+static void learn_current_baseline(MotorDirection_t drive_dir, uint8_t bin, uint16_t current_ma)
+{
+    if (drive_dir == MOTOR_STOP)
+    {
+        // Strokes ended by a fault (obstruction, stall, jam) must not teach the baseline
+        const bool clean = !(motor_fault_latched || app_out_cached.fault_out);
+        if (CurrentBaseline_endStroke(&current_baseline, clean))
+        {
+            baseline_save_pending = true;
+        }
+    }
+    else
+    {
+        CurrentBaseline_addSample(&current_baseline, drive_dir, bin, current_ma);
+    }
+
+    if (baseline_save_pending && CurrentBaseline_save(&current_baseline))
+    {
+        baseline_save_pending = false;
+    }
+    NVM_service();
+}
+
+/**
+ * @brief Measure the calibration stroke in progress; the upper limit switch ends it
+ */
+static void measure_calibration_stroke(uint32_t now_ms, uint16_t current_ma)
+{
+    if (!calibration_stroke.active)
+    {
+        return;
+    }
+    EncoderState_t encoder;
+    HAL_readEncoder(&encoder);
+    if (HAL_readLimitSensor(LIMIT_UPPER))
+    {
+        (void)DeskCalibration_endStroke(&calibration_stroke, &calibration_measured, now_ms, encoder.position_counts);
+    }
+    else
+    {
+        DeskCalibration_sample(&calibration_stroke, now_ms, encoder.position_counts,
+                               PositionEstimator_estimate(&position_estimator).height_um,
+                               applied_motor.phase == MOTOR_PHASE_CRUISE, current_ma);
+    }
+}
+
+/**
+ * @brief Follow the calibration APP_Task() runs: start measuring with the stroke up, adopt it once completed
+ */
+static void track_calibration(const AppOutput_t *new_out, uint32_t now_ms)
+{
+    const bool stroke_starts = new_out->calibrating && (new_out->motor_cmd == MOTOR_UP) &&
+                               !(app_out_cached.calibrating && (app_out_cached.motor_cmd == MOTOR_UP));
+    if (stroke_starts)
+    {
+        EncoderState_t encoder;
+        HAL_readEncoder(&encoder);
+        DeskCalibration_init(&calibration_measured);
+        DeskCalibration_beginStroke(&calibration_stroke, now_ms, encoder.position_counts);
+        CurrentBaseline_forget(&current_baseline, MOTOR_UP);  // The clean stroke sets the upward levels afresh
+    }
+    else if (new_out->calibration_done && !calibration_stroke.active && (calibration_measured.stroke_ms != 0U))
+    {
+        // The estimator learned a quarter of the stroke's scale; the calibration adopts all of it
+        PositionEstimator_setScale(&position_estimator, MOTOR_UP,
+                                   PositionEstimator_strokeScale(&position_estimator, MOTOR_UP));
+        calibration_measured.scale[0] = position_estimator.scale[0];
+        calibration_measured.scale[1] = position_estimator.scale[1];
+        calibration = calibration_measured;
+        calibration_save_pending = true;  // Programmed in the background by DeskControl_Poll()
+    }
+    else if (!new_out->calibrating)
+    {
+        DeskCalibration_cancelStroke(&calibration_stroke);  // Aborted or never started
+    }
+}
+
+AppSafetyStop_t DeskControl_getLastSafetyStop(void)
+{
+    return last_safety_stop;
+}
+
+PositionEstimate_t DeskControl_getPositionEstimate(void)
+{
+    return PositionEstimator_estimate(&position_estimator);
+}
+
+void DeskControl_setSpeedControl(SpeedFeedback_t feedback, uint16_t speed_mm_s)
+{
+    const bool valid = (feedback == SPEED_FEEDBACK_ESTIMATE) || (feedback == SPEED_FEEDBACK_ENCODER);
+    speed_feedback = (valid && (speed_mm_s > 0U)) ? feedback : SPEED_FEEDBACK_OFF;
+    speed_setpoint_um_s = static_cast<uint32_t>(speed_mm_s) * 1000U;
+}
+
+void DeskControl_startCalibration(void)
+{
+    calibration_requested = true;
+}
+
+DeskCalibration_t DeskControl_getCalibration(void)
+{
+    return calibration;
+}
+
+bool DeskControl_storePreset(uint8_t slot)
+{
+    const PositionEstimate_t estimate = PositionEstimator_estimate(&position_estimator);
+    if (!estimate.referenced || !DeskPresets_set(&presets, slot, estimate.height_um))
+    {
+        return false;
+    }
+    presets_save_pending = true;  // Programmed in the background by DeskControl_Poll()
+    return true;
+}
+
+bool DeskControl_recallPreset(uint8_t slot)
+{
+    int32_t height_um = 0;
+    if (!DeskPresets_get(&presets, slot, &height_um))
+    {
+        return false;
+    }
+    target_requested = true;
+    target_request_um = height_um;
+    return true;
+}
+
+void DeskControl_Poll(uint32_t now_ms)
+{
+    // Input edges captured by the pin-change interrupt: react in this loop pass
+    const bool input_edge = HAL_pollInputEvents();
+
+    // Current statistics and positions for the next control cycle: one sample per millisecond
+    if (now_ms != last_current_sample_ms)
+    {
+        // Drive applied since the previous sample (a late loop pass integrates the whole gap)
+        const uint32_t elapsed_ms = now_ms - last_current_sample_ms;
+        PositionEstimator_update(&position_estimator, applied_motor.dir, applied_motor.pwm,
+                                 HAL_readLimitSensor(LIMIT_LOWER), HAL_readLimitSensor(LIMIT_UPPER), elapsed_ms);
+        const MotorDirection_t drive_dir = HAL_getMotorDirection();
+        const uint8_t bin = stroke_position_bin(drive_dir, elapsed_ms);
+        HAL_setMotorCurrentObstructionLimit(CurrentMonitor_obstructionLimitMa(applied_motor.phase, applied_motor.pwm));
+        HAL_setMotorCurrentDeviationLimit(CurrentBaseline_limitMa(&current_baseline, drive_dir, bin));
+        if (presets_save_pending && DeskPresets_save(&presets))
+        {
+            presets_save_pending = false;
+        }
+        if (calibration_save_pending && DeskCalibration_save(&calibration))
+        {
+            calibration_save_pending = false;
+        }
+        const uint16_t current_ma = HAL_sampleMotorCurrent();
+        measure_calibration_stroke(now_ms, current_ma);
+        learn_current_baseline(drive_dir, bin, current_ma);
+        HAL_sampleEncoder();
+        last_current_sample_ms = now_ms;
+
+        // SAFETY-CRITICAL: current slope jam - stop within the sample, latch like a stall
+        if (HAL_motorCurrentSlopeJam() && !motor_fault_latched)
+        {
+            motor_fault_latched = true;
+            apply_fault_outputs();
+        }
+    }
+
+    // Time-based schedule: update application at 250 ms cadence
+    if ((now_ms - last_app_run_ms) >= DESK_CONTROL_APP_PERIOD_MS)
+    {
+        DeskControl_Task(now_ms);
+        last_app_run_ms = now_ms;
+        last_fast_run_ms = now_ms;  // The control cycle already updated the motor
+    }
+    else if (input_edge || ((now_ms - last_fast_run_ms) >= DESK_CONTROL_FAST_PERIOD_MS))
+    {
+        DeskControl_FastTask(now_ms);
+        last_fast_run_ms = now_ms;
+    }
+}
+
+void DeskControl_Task(uint32_t now_ms)
+{
+    TaskProfiler_beginTask();
+
+    // ========================================================================
+    // Task: Read all hardware inputs and pass to application layer
+    // HAL abstraction handles motor type differences internally:
+    // - MT_BASIC: HAL_readMotorCurrent() always returns 0U (no hardware)
+    // - MT_ROBUST: HAL_readMotorCurrent() returns actual current
+    // ========================================================================
+    HALInputSnapshot_t snapshot;
+    HAL_readInputs(&snapshot);
+
+    AppInput_t inputs;
+    inputs.button_up = snapshot.button[BUTTON_UP];
+    inputs.button_down = snapshot.button[BUTTON_DOWN];
+    inputs.limit_upper = snapshot.limit[LIMIT_UPPER];
+    inputs.limit_lower = snapshot.limit[LIMIT_LOWER];
+    inputs.fault_in = read_external_fault();
+    inputs.motor_type = MotorConfig_getMotorType();  // Pass motor type to app layer for runtime decisions
+    inputs.timestamp_ms = now_ms;
+    
+    // Always read motor current - HAL handles motor type transparency
+    // For MT_BASIC: Returns 0U (no hardware)
+    // For MT_ROBUST: Returns actual current from sensor
+    inputs.motor_current_ma = HAL_readMotorCurrent();
+    inputs.motor_phase = applied_motor.phase;  // Drive the reading was taken under
+    inputs.motor_pwm = applied_motor.pwm;
+    HAL_takeMotorCurrentSummary(&inputs.current_summary);  // Everything sampled since the last cycle
+    HAL_readEncoder(&inputs.encoder);
+    inputs.position_estimate = PositionEstimator_estimate(&position_estimator);
+    inputs.move_to_target = target_requested;
+    inputs.target_height_um = target_request_um;
+    inputs.target_reached = target_reached;
+    inputs.calibrate = calibration_requested;
+    TaskProfiler_endPhase(PROFILE_PHASE_INPUT);
+
+    AppOutput_t new_out;
+    APP_Task(&inputs, &new_out);
+    target_requested = false;  // One cycle: APP_Task() started the move or declined it
+    calibration_requested = false;
+    track_calibration(&new_out, now_ms);
+    if (new_out.moving_to_target && !app_out_cached.moving_to_target)
+    {
+        MotionProfile_init(&motion_profile);  // The speed model may have learned since the last move
+    }
+    if (!new_out.moving_to_target)
+    {
+        target_reached = false;
+    }
+    app_out_cached = new_out;
+    TaskProfiler_endPhase(PROFILE_PHASE_APP);
+
+    // Motor control (ramp + soft stop + stall detection)
+    const MotorControllerOutput_t mc_out = update_motor(now_ms, &snapshot);
+
+    // ========================================================================
+    // Stall detection: Motor controller provides fault signal when stall detected
+    // Application layer decides whether to latch based on motor type capabilities
+    // ========================================================================
+    if (mc_out.fault)
+    {
+        motor_fault_latched = true;  // Latch any identified fault
+    }
+    
+    // Allow fault recovery when buttons released
+    const bool both_buttons_released = !inputs.button_up && !inputs.button_down;
+    if (motor_fault_latched && both_buttons_released)
+    {
+        motor_fault_latched = false;
+        MotorController_init();  // Reset motor controller state
+    }
+    TaskProfiler_endPhase(PROFILE_PHASE_MOTOR);
+
+    // Fault propagation and output application
+    const bool fault_active = app_out_cached.fault_out || motor_fault_latched;
+    if (fault_active)
+    {
+        apply_fault_outputs();
+    }
+    else
+    {
+        apply_motor(&mc_out);
+        HAL_setLED(LED_BT_UP, app_out_cached.led_bt_up);
+        HAL_setLED(LED_BT_DOWN, app_out_cached.led_bt_down);
+        HAL_setLED(LED_ERROR, app_out_cached.led_error);
+    }
+    TaskProfiler_endPhase(PROFILE_PHASE_OUTPUT);
+    TaskProfiler_endTask();
+}
+
+void DeskControl_FastTask(uint32_t now_ms)
+{
+    // Faulted: the control cycle already removed drive and owns recovery
+    if (app_out_cached.fault_out || motor_fault_latched)
+    {
+        return;
+    }
+
+    HALInputSnapshot_t snapshot;
+    HAL_readInputs(&snapshot);
+
+    // Button released between control cycles: begin the soft stop now instead of up to
+    // 250 ms later, so release -> rest stays within SysReq-003 (debounce + STOP_RAMP_TIME_MS)
+    // A move to target or a calibration runs without a button; pressing any button aborts it the same way
+    const MotorDirection_t cmd = app_out_cached.motor_cmd;
+    const bool released = (app_out_cached.moving_to_target || app_out_cached.calibrating) ?
+        (snapshot.button[BUTTON_UP] || snapshot.button[BUTTON_DOWN]) :
+        (((cmd == MOTOR_UP) && !snapshot.button[BUTTON_UP]) || ((cmd == MOTOR_DOWN) && !snapshot.button[BUTTON_DOWN]));
+    if ((cmd != MOTOR_STOP) && released)
+    {
+        app_out_cached.motor_cmd = MOTOR_STOP;
+        app_out_cached.motor_speed = 0U;
+        app_out_cached.soft_stop = true;
+    }
+
+    // Ramp towards the targets of the last control cycle (SysReq-006); safety-checked
+    const MotorControllerOutput_t mc_out = update_motor(now_ms, &snapshot);
+    if (mc_out.fault)
+    {
+        // SAFETY-CRITICAL: stall detected between control cycles - stop now, latch for the next cycle
+        motor_fault_latched = true;
+        apply_fault_outputs();
+        return;
+    }
+
+    apply_motor(&mc_out);
+}
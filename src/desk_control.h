@@ -0,0 +1,161 @@
+/**
+ * @file desk_control.h
+ * @brief Control task integration: HAL inputs -> DeskApp -> MotorController -> HAL outputs
+ *
+ * Owns the periodic control cycle that used to live in src.ino so that the
+ * identical code runs on the Arduino target and in host simulations:
+ * - DeskControl_Init(): resets application, motor controller and cached outputs
+ * - DeskControl_Poll(): non-blocking scheduler, called from loop() as often as possible
+ * - DeskControl_Task(): one 250 ms control cycle (SWReq-011: 250 ± 10 ms)
+ * - DeskControl_FastTask(): 1 kHz motor sub-task that generates the soft-start
+ *   ramp and soft stop from the targets set by the last control cycle (SysReq-006)
+ *
+ * @preconditions HAL_setMotorType() and HAL_init() have been called
+ * @thread_safety NOT thread-safe (single-threaded main loop)
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+#ifndef DESK_CONTROL_H
+#define DESK_CONTROL_H
+
+#include <stdint.h>
+#include "desk_app.h"
+#include "speed_controller.h"
+#include "desk_calibration.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Application scheduling period (SWReq-011: 250 ± 10 ms)
+ */
+static const uint32_t DESK_CONTROL_APP_PERIOD_MS = 250U;
+
+/**
+ * @brief Motor sub-task period: 1 kHz ramp update (500 steps over RAMP_TIME_MS)
+ */
+static const uint32_t DESK_CONTROL_FAST_PERIOD_MS = 1U;
+
+/**
+ * @brief Initialize application, motor controller and cached outputs
+ *
+ * @param now_ms - Current time; the first control cycle runs one period later
+ */
+void DeskControl_Init(uint32_t now_ms);
+
+/**
+ * @brief Non-blocking scheduler entry point (call every loop() iteration)
+ *
+ * Samples the motor current and the encoder and integrates the sensorless
+ * height estimate once per millisecond (HAL_sampleMotorCurrent(),
+ * HAL_sampleEncoder(), PositionEstimator_update()) and
+ * removes drive at once on a current slope jam (latched like a stall), then
+ * runs DeskControl_Task() whenever APP_PERIOD_MS has elapsed since the last run,
+ * otherwise DeskControl_FastTask() whenever FAST_PERIOD_MS has elapsed or the
+ * pin-change interrupt queued an input edge (a limit hit stops the motor in the
+ * same loop pass). A control cycle includes a motor update, so both never run
+ * in the same call.
+ *
+ * @param now_ms - Current time in milliseconds (HAL_getTime())
+ */
+void DeskControl_Poll(uint32_t now_ms);
+
+/**
+ * @brief Execute one control cycle
+ *
+ * Reads all hardware inputs and the motor current statistics sampled since the
+ * previous cycle, runs APP_Task() and MotorController_update(),
+ * latches motor controller faults and applies motor and LED outputs.
+ *
+ * @param now_ms - Current time in milliseconds
+ */
+void DeskControl_Task(uint32_t now_ms);
+
+/**
+ * @brief Execute one motor sub-task step
+ *
+ * Advances the motor controller towards the direction and speed commanded
+ * by the last DeskControl_Task() and applies the ramped PWM. Releasing the
+ * button of the direction of travel starts the soft stop (MOTOR_STOP_SOFT)
+ * right away. This is also the safety path: while the motor is driven, the
+ * limit switch, dual-button (undebounced) and external-fault rules of
+ * APP_SafetyCheck() remove drive in the same call, and stall faults are latched
+ * with drive removed immediately; everything else (fault latching in the state
+ * machine, LEDs) is left to the control cycle. With the edge-triggered schedule
+ * of DeskControl_Poll() an input edge reaches the motor outputs within one loop
+ * pass. Cost: one HAL_readInputs() snapshot, one motor controller update and
+ * one HAL_setMotor().
+ *
+ * @param now_ms - Current time in milliseconds
+ */
+void DeskControl_FastTask(uint32_t now_ms);
+
+/**
+ * @brief Most recent fast-path safety stop since DeskControl_Init()
+ *
+ * @return AppSafetyStop_t - APP_SAFETY_OK if the safety check never removed drive
+ */
+AppSafetyStop_t DeskControl_getLastSafetyStop(void);
+
+/**
+ * @brief Sensorless height estimate as of the latest 1 kHz sample (also AppInput_t.position_estimate)
+ */
+PositionEstimate_t DeskControl_getPositionEstimate(void);
+
+/**
+ * @brief Hold a travel speed in both directions instead of driving the PWM open loop (speed_controller.h)
+ *
+ * Keep speed_mm_s below what the desk reaches at full PWM lifting its heaviest
+ * load; above it the PWM saturates at 255 as open loop. The current baseline
+ * (current_baseline.h) indexes the stroke by open-loop travel time, so it
+ * neither learns nor tightens the obstruction limit meanwhile.
+ * DeskControl_Init() returns to open loop.
+ *
+ * @param feedback - Velocity source; SPEED_FEEDBACK_OFF (or speed_mm_s 0) for open loop
+ * @param speed_mm_s - Speed to hold
+ */
+void DeskControl_setSpeedControl(SpeedFeedback_t feedback, uint16_t speed_mm_s);
+
+/**
+ * @brief Store the current height in a memory preset (desk_presets.h), persisted in NVM
+ *
+ * @return bool - false if the slot does not exist or the height estimate is not referenced
+ */
+bool DeskControl_storePreset(uint8_t slot);
+
+/**
+ * @brief Move to a memory preset on its own (APP_STATE_MOVING_TO_TARGET) from the next control cycle
+ *
+ * APP_Task() declines the move unless the desk is idle with a referenced height
+ * estimate away from the preset; any button aborts it.
+ *
+ * @return bool - false if the slot does not exist or is empty
+ */
+bool DeskControl_recallPreset(uint8_t slot);
+
+/**
+ * @brief Calibrate the stroke on its own (APP_STATE_CALIBRATING) from the next control cycle
+ *
+ * Homes to the lower limit switch, then travels the full stroke up at full PWM
+ * and stores what it measured (desk_calibration.h) in NVM: the position
+ * estimator adopts the stroke's speed scale, the upward current baseline is
+ * relearned from the stroke and the encoder velocity uses the counts per
+ * stroke. APP_Task() declines unless the desk is idle with no button pressed.
+ * Any button or fault aborts it: the stored calibration stays, the upward
+ * baseline relearns over the next clean strokes.
+ */
+void DeskControl_startCalibration(void);
+
+/**
+ * @brief Calibration in use (restored from NVM by DeskControl_Init(); all 0 if none)
+ */
+DeskCalibration_t DeskControl_getCalibration(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DESK_CONTROL_H
@@ -0,0 +1,62 @@
+#include "desk_presets.h"
+#include <stddef.h>  // For NULL definition
+
+static const int32_t UM_PER_MM = 1000;
+
+void DeskPresets_init(DeskPresets_t *presets)
+{
+    if (presets == NULL)
+    {
+        return;
+    }
+    for (uint8_t i = 0U; i < DESK_PRESET_COUNT; i++)
+    {
+        presets->height_mm[i] = DESK_PRESET_EMPTY;
+    }
+}
+
+bool DeskPresets_load(DeskPresets_t *presets)
+{
+    if (presets == NULL)
+    {
+        return false;
+    }
+    return NVM_readRecord(NVM_ADDR_PRESETS, NVM_ID_PRESETS,
+                          presets->height_mm, static_cast<uint8_t>(sizeof(presets->height_mm)));
+}
+
+bool DeskPresets_save(const DeskPresets_t *presets)
+{
+    if (presets == NULL)
+    {
+        return false;
+    }
+    return NVM_writeRecord(NVM_ADDR_PRESETS, NVM_ID_PRESETS,
+                           presets->height_mm, static_cast<uint8_t>(sizeof(presets->height_mm)));
+}
+
+bool DeskPresets_set(DeskPresets_t *presets, uint8_t slot, int32_t height_um)
+{
+    if ((presets == NULL) || (slot >= DESK_PRESET_COUNT) || (height_um < 0))
+    {
+        return false;
+    }
+    const int32_t height_mm = (height_um + (UM_PER_MM / 2)) / UM_PER_MM;
+    if (height_mm >= static_cast<int32_t>(DESK_PRESET_EMPTY))
+    {
+        return false;
+    }
+    presets->height_mm[slot] = static_cast<uint16_t>(height_mm);
+    return true;
+}
+
+bool DeskPresets_get(const DeskPresets_t *presets, uint8_t slot, int32_t *height_um)
+{
+    if ((presets == NULL) || (height_um == NULL) || (slot >= DESK_PRESET_COUNT) ||
+        (presets->height_mm[slot] == DESK_PRESET_EMPTY))
+    {
+        return false;
+    }
+    *height_um = static_cast<int32_t>(presets->height_mm[slot]) * UM_PER_MM;
+    return true;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file desk_presets.h
+ * @brief Stored desk heights (memory presets), persisted in NVM
+ *
+ * @purpose
+ * Travelling the stroke means holding a button for up to 30 s (SysReq-004).
+ * A preset stores a height once; recalling it moves the desk there on its own
+ * (APP_STATE_MOVING_TO_TARGET).
+ *
+ * @implementation
+ * - DESK_PRESET_COUNT heights in mm above the lower limit switch (the
+ *   position_estimator.h reference), DESK_PRESET_EMPTY = not stored
+ * - One NVM record of 2 bytes per preset (NVM_ADDR_PRESETS)
+ *
+ * @thread_safety NOT thread-safe; main loop only
+ */
+
+#ifndef DESK_PRESETS_H
+#define DESK_PRESETS_H
+
+#include <stdint.h>
+#include "nvm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint8_t DESK_PRESET_COUNT = 4U;
+static const uint16_t DESK_PRESET_EMPTY = UINT16_MAX;
+
+typedef struct
+{
+    uint16_t height_mm[DESK_PRESET_COUNT];  ///< Stored height per slot (DESK_PRESET_EMPTY = none)
+} DeskPresets_t;
+
+static_assert(sizeof(DeskPresets_t) <= NVM_MAX_PAYLOAD, "Preset record exceeds the NVM payload");
+
+/**
+ * @brief Empty every slot
+ */
+void DeskPresets_init(DeskPresets_t *presets);
+
+/**
+ * @brief Restore the slots from NVM
+ *
+ * @return bool - false if no valid record exists (slots stay empty)
+ */
+bool DeskPresets_load(DeskPresets_t *presets);
+
+/**
+ * @brief Stage the slots for writing to NVM (see NVM_writeRecord())
+ *
+ * @return bool - false if NVM is busy; retry later
+ */
+bool DeskPresets_save(const DeskPresets_t *presets);
+
+/**
+ * @brief Store a height (rounded to mm) in a slot
+ *
+ * @return bool - false if the slot does not exist or the height is negative or out of range
+ */
+bool DeskPresets_set(DeskPresets_t *presets, uint8_t slot, int32_t height_um);
+
+/**
+ * @brief Height stored in a slot
+ *
+ * @param height_um - Receives the height; unchanged if the slot is empty
+ * @return bool - false if the slot does not exist or is empty
+ */
+bool DeskPresets_get(const DeskPresets_t *presets, uint8_t slot, int32_t *height_um);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DESK_PRESETS_H
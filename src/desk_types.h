@@ -24,6 +24,19 @@ typedef enum
     MOTOR_DOWN = 2
 } MotorDirection_t;
 
+/**
+ * @brief Phase of the drive applied by MotorController (MotorControllerOutput_t.phase)
+ *
+ * Current sensing uses it to expect soft-start inrush only while ramping up.
+ */
+typedef enum
+{
+    MOTOR_PHASE_IDLE = 0,       ///< No drive
+    MOTOR_PHASE_RAMP_UP = 1,    ///< Soft-start ramp towards the target PWM
+    MOTOR_PHASE_CRUISE = 2,     ///< Target PWM reached
+    MOTOR_PHASE_RAMP_DOWN = 3   ///< Soft stop still driving the direction of travel
+} MotorRampPhase_t;
+
 /**
  * @brief LED identifier for independent LED control
  * 
@@ -51,4 +64,61 @@ typedef enum
     LED_ON = 1          ///< LED turned on
 } LEDState_t;
 
+/**
+ * @brief Motor current over one control cycle, from the 1 kHz sample stream
+ *
+ * Runs count consecutive samples (ms at 1 kHz) above a sense threshold with
+ * the motor in the matching drive state; a run that spans control cycles keeps
+ * counting. samples = 0 means no high-rate data for this cycle.
+ */
+typedef struct
+{
+    uint16_t peak_ma;             ///< Highest sample in the cycle
+    uint16_t mean_ma;             ///< Mean of the cycle's samples
+    uint16_t samples;             ///< Samples in the cycle (saturates at UINT16_MAX)
+    uint16_t stuck_run_ms;        ///< Longest run above MOTOR_SENSE_THRESHOLD_MA, drive off
+    uint16_t obstruction_run_ms;  ///< Longest run above the obstruction limit (threshold + inrush envelope), driven
+    uint16_t deviation_run_ms;    ///< Longest run above the learned baseline limit, driven (current_baseline.h)
+    bool slope_jam;               ///< Current slope (di/dt) jam detected while driven
+} CurrentSummary_t;
+
+/**
+ * @brief Desk travel from the quadrature encoder (position_encoder.h)
+ *
+ * Counts rise moving up (ENCODER_COUNTS_PER_MM); position 0 is where the HAL
+ * started, not a limit switch.
+ */
+typedef struct
+{
+    int32_t position_counts;   ///< Travel since HAL_init()
+    int16_t velocity_cps;      ///< Counts per second, positive moving up
+    uint16_t decode_errors;    ///< Skipped quadrature states since HAL_init() (saturates)
+    bool direction_error;      ///< Position ran against the drive applied (latched until the drive changes)
+} EncoderState_t;
+
+/**
+ * @brief Desk height estimated from the drive applied (position_estimator.h)
+ *
+ * Needs no sensor: approximate, referenced at the limit switches.
+ */
+typedef struct
+{
+    int32_t height_um;     ///< Above the lower limit switch (travel since start-up while not referenced)
+    uint32_t error_um;     ///< Bound on the drift since the last limit switch
+    bool referenced;       ///< A limit switch was reached since start-up
+} PositionEstimate_t;
+
+/**
+ * @brief Storage class for module-private state
+ *
+ * On target this expands to nothing. Host test builds make module state
+ * thread-local so each simulation worker thread (FleetSimulation) owns an
+ * independent HAL / DeskApp / MotorController / DeskControl instance.
+ */
+#if defined(TESTENVIRONMENT) && defined(__cplusplus)
+#define DESK_THREAD_LOCAL thread_local
+#else
+#define DESK_THREAD_LOCAL
+#endif
+
 #endif // DESK_TYPES_H
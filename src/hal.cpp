@@ -1,31 +1,90 @@
 #include "hal.h"
+#include "current_monitor.h"
+#include "position_encoder.h"
+#include "nvm.h"
+#include "input_events.h"
+#include "port_io.h"
+#include "motor_driver.h"
 #include "safety_config.h"
+#include <stddef.h>  // For NULL definition
 
-#ifdef TESTENVIRONMENT
-#include "hal_mock/HALMock.h"
+
+#ifdef DESK_MOTOR_RUNTIME_DISPATCH
+// Motor type: Set at runtime via HAL_setMotorType(); every motor call dispatches on it
+static DESK_THREAD_LOCAL MotorType_t g_motor_type = MT_BASIC;  // Default to MT_BASIC if not explicitly set
 #else
-#include <Arduino.h>
+// Motor driver bound at compile time: no dispatch, the other driver is never emitted
+typedef MotorDriverFor<MOTOR_CONFIG_BUILD_TYPE>::Type ActiveMotorDriver;
 #endif
 
-// Motor type: Set at runtime via HAL_setMotorType()
-// Allows HAL to adapt pin initialization and control based on actual motor driver
-static MotorType_t g_motor_type = MT_BASIC;  // Default to MT_BASIC if not explicitly set
+// Output shadow: what was last applied to the pins; HAL_setMotor() / HAL_setLED() write deltas only
+static DESK_THREAD_LOCAL MotorDirection_t shadow_motor_dir = MOTOR_STOP;
+static DESK_THREAD_LOCAL uint8_t shadow_motor_speed = 0U;      // 0 whenever shadow_motor_dir is MOTOR_STOP
+static DESK_THREAD_LOCAL bool shadow_motor_valid = false;      // false: next HAL_setMotor() writes every pin
+static DESK_THREAD_LOCAL uint8_t shadow_led_valid = 0U;        // Bit per LEDID_t: shadow_led_on is current
+static DESK_THREAD_LOCAL uint8_t shadow_led_on = 0U;           // Bit per LEDID_t: LED applied ON
 
 void HAL_setMotorType(MotorType_t motor_type)
 {
+#ifdef DESK_MOTOR_RUNTIME_DISPATCH
     g_motor_type = motor_type;
+    shadow_motor_valid = false;  // Shadow describes the other driver's pins
+#else
+    (void)motor_type;  // Fixed by the build (MOTOR_CONFIG_BUILD_TYPE)
+#endif
 }
 
-// Debounce configuration (SWReq-009: 20ms ± 5ms)
-static const uint32_t DEBOUNCE_MS = 20U;
+void HAL_refreshOutputs(void)
+{
+    shadow_motor_valid = false;
+    shadow_led_valid = 0U;
+}
+
+// 1 kHz motor current samples -> per-control-cycle statistics (current_monitor.h)
+static DESK_THREAD_LOCAL CurrentMonitor_t current_monitor;
+
+// Quadrature encoder: decoded in PCINT1, folded into position / velocity at 1 kHz (position_encoder.h)
+static DESK_THREAD_LOCAL PositionEncoder_t position_encoder;
 
-static uint32_t last_button_time[BUTTON_COUNT] = {0, 0};
-static bool button_raw_state[BUTTON_COUNT] = {false, false};
-static bool button_stable_state[BUTTON_COUNT] = {false, false};
+// Debounce configuration (SWReq-009: 20ms ± 5ms), measured from interrupt edge timestamps
+static const uint32_t DEBOUNCE_US = 20000U;
 
-static const uint8_t button_pins[BUTTON_COUNT] = {PIN_BUTTON_UP, PIN_BUTTON_DOWN};
-static const uint8_t limit_pins[LIMIT_COUNT] = {PIN_LIMIT_UPPER, PIN_LIMIT_LOWER};
+static DESK_THREAD_LOCAL uint32_t last_button_edge_us[BUTTON_COUNT] = {0, 0};
+static DESK_THREAD_LOCAL bool button_raw_state[BUTTON_COUNT] = {false, false};
+static DESK_THREAD_LOCAL bool button_stable_state[BUTTON_COUNT] = {false, false};
+static DESK_THREAD_LOCAL bool limit_state[LIMIT_COUNT] = {false, false};
 
+// Pin-change interrupt -> main loop edge queue (input_events.h)
+static DESK_THREAD_LOCAL InputEventQueue_t input_queue;
+static DESK_THREAD_LOCAL uint8_t isr_input_levels = 0U;   // ISR-private: active bit per InputSource_t
+static DESK_THREAD_LOCAL uint8_t dropped_seen = 0U;       // Consumer copy of input_queue.dropped
+
+// Indexed by InputSource_t; buttons first, then limits, in ButtonID_t / LimitID_t order
+static const uint8_t input_pins[INPUT_SOURCE_COUNT] = {PIN_BUTTON_UP, PIN_BUTTON_DOWN, PIN_LIMIT_UPPER, PIN_LIMIT_LOWER};
+
+static_assert((INPUT_SOURCE_BUTTON_UP == static_cast<int>(BUTTON_UP)) &&
+              (INPUT_SOURCE_BUTTON_DOWN == static_cast<int>(BUTTON_DOWN)) &&
+              (INPUT_SOURCE_LIMIT_UPPER == static_cast<int>(BUTTON_COUNT) + static_cast<int>(LIMIT_UPPER)) &&
+              (INPUT_SOURCE_LIMIT_LOWER == static_cast<int>(BUTTON_COUNT) + static_cast<int>(LIMIT_LOWER)),
+              "InputSource_t must map onto ButtonID_t / LimitID_t");
+
+// One PIND and one PINB read capture every button and limit switch
+static_assert(((PortIO_port(PIN_BUTTON_UP) == PORT_IO_D) || (PortIO_port(PIN_BUTTON_UP) == PORT_IO_B)) &&
+              ((PortIO_port(PIN_BUTTON_DOWN) == PORT_IO_D) || (PortIO_port(PIN_BUTTON_DOWN) == PORT_IO_B)) &&
+              ((PortIO_port(PIN_LIMIT_UPPER) == PORT_IO_D) || (PortIO_port(PIN_LIMIT_UPPER) == PORT_IO_B)) &&
+              ((PortIO_port(PIN_LIMIT_LOWER) == PORT_IO_D) || (PortIO_port(PIN_LIMIT_LOWER) == PORT_IO_B)),
+              "Input pins must be on PORTB or PORTD");
+// One PINC read gives A and B as adjacent bits; no button or limit shares their PCINT1 vector
+static_assert((PortIO_port(PIN_ENCODER_A) == PORT_IO_C) && (PortIO_port(PIN_ENCODER_B) == PORT_IO_C) &&
+              (PortIO_mask(PIN_ENCODER_B) == static_cast<uint8_t>(PortIO_mask(PIN_ENCODER_A) << 1)) &&
+              (PIN_ENCODER_A != PIN_MOTOR_SENSE) && (PIN_ENCODER_B != PIN_MOTOR_SENSE) &&
+              (PIN_ENCODER_A != PIN_MOTOR_CIN) && (PIN_ENCODER_B != PIN_MOTOR_CIN),
+              "Encoder A/B must be adjacent PORTC bits clear of the analog inputs");
+static_assert(PortIO_isTimer1Pwm(PIN_MOTOR_PWM) && PortIO_isTimer1Pwm(PIN_MOTOR_LPWM) &&
+              PortIO_isTimer1Pwm(PIN_MOTOR_RPWM),
+              "Motor PWM pins must be Timer1 compare outputs (OCR1A / OCR1B)");
+static_assert((PIN_MOTOR_SENSE >= ADC_FIRST_PIN) && (PortIO_port(PIN_MOTOR_SENSE) == PORT_IO_C),
+              "Current sense pin must be an analog input (A0-A5)");
 
 static void init_inputs(void)
 {
@@ -33,209 +92,514 @@ static void init_inputs(void)
     pinMode(PIN_BUTTON_DOWN, INPUT_PULLUP);
     pinMode(PIN_LIMIT_UPPER, INPUT_PULLUP);
     pinMode(PIN_LIMIT_LOWER, INPUT_PULLUP);
+    pinMode(PIN_ENCODER_A, INPUT_PULLUP);  // Open-collector Hall outputs
+    pinMode(PIN_ENCODER_B, INPUT_PULLUP);
+}
 
-    // Initialize motor current sensing pin (MT_ROBUST only)
+static void init_outputs(void)
+{
+    // Motor driver pins (and IBT_2 current sense input), motor stopped
+#ifdef DESK_MOTOR_RUNTIME_DISPATCH
     if (g_motor_type == MT_ROBUST)
     {
-        // IBT_2 Driver - Has integrated current sensing via shunt resistor
-        pinMode(PIN_MOTOR_SENSE, INPUT);
+        IBT2Driver::init();
     }
-    // MT_BASIC: PIN_MOTOR_SENSE not used (no current sensing hardware)
-}
+    else
+    {
+        L298NDriver::init();
+    }
+#else
+    ActiveMotorDriver::init();
+#endif
 
-static void init_outputs(void)
-{
-    if (g_motor_type == MT_BASIC)
-    {
-        // ========================================================================
-        // L298N INITIALIZATION (3-pin control)
-        // ========================================================================
-        pinMode(PIN_MOTOR_EN1, OUTPUT);
-        pinMode(PIN_MOTOR_EN2, OUTPUT);
-        pinMode(PIN_MOTOR_PWM, OUTPUT);
-        
-        // Safe defaults: Motor stopped
-        digitalWrite(PIN_MOTOR_EN1, LOW);
-        digitalWrite(PIN_MOTOR_EN2, LOW);
-        analogWrite(PIN_MOTOR_PWM, 0);
-    }
-    else if (g_motor_type == MT_ROBUST)
-    {
-        // ========================================================================
-        // IBT_2 INITIALIZATION (2-pin PWM control)
-        // ========================================================================
-        pinMode(PIN_MOTOR_LPWM, OUTPUT);
-        pinMode(PIN_MOTOR_RPWM, OUTPUT);
-        
-        // Optional: Configure diagnostic input
-        pinMode(PIN_MOTOR_CIN, INPUT);
-        
-        // Safe defaults: Motor stopped
-        analogWrite(PIN_MOTOR_LPWM, 0);
-        analogWrite(PIN_MOTOR_RPWM, 0);
-    }
-    
     // Initialize 3 status LEDs (common to all motor types)
     pinMode(PIN_LED_BT_UP, OUTPUT);
     pinMode(PIN_LED_BT_DOWN, OUTPUT);
     pinMode(PIN_LED_ERROR, OUTPUT);
 
     // Safe defaults: all LEDs off
-    digitalWrite(PIN_LED_BT_UP, LOW);
-    digitalWrite(PIN_LED_BT_DOWN, LOW);
-    digitalWrite(PIN_LED_ERROR, LOW);
+    PortIO_writePin(PIN_LED_BT_UP, false);
+    PortIO_writePin(PIN_LED_BT_DOWN, false);
+    PortIO_writePin(PIN_LED_ERROR, false);
+
+    // Shadow now matches the pins
+    shadow_motor_dir = MOTOR_STOP;
+    shadow_motor_speed = 0U;
+    shadow_motor_valid = true;
+    shadow_led_on = 0U;
+    shadow_led_valid = static_cast<uint8_t>((1U << LED_COUNT) - 1U);
+}
+
+/**
+ * @brief True if an active-low input pin reads LOW in the given PINB / PIND snapshot
+ */
+static inline bool input_active(uint8_t pin, uint8_t port_b, uint8_t port_d)
+{
+    const uint8_t levels = (PortIO_port(pin) == PORT_IO_B) ? port_b : port_d;
+    return (levels & PortIO_mask(pin)) == 0U;
+}
+
+/**
+ * @brief Active bit per InputSource_t (buttons and limits are active LOW with pull-ups)
+ *
+ * Both ports are read back to back, so all four inputs come from one instant.
+ */
+static uint8_t sample_inputs(void)
+{
+    const uint8_t port_d = PortIO_read(PORT_IO_D);
+    const uint8_t port_b = PortIO_read(PORT_IO_B);
+
+    uint8_t levels = 0U;
+    if (input_active(PIN_BUTTON_UP, port_b, port_d))
+    {
+        levels = static_cast<uint8_t>(levels | (1U << INPUT_SOURCE_BUTTON_UP));
+    }
+    if (input_active(PIN_BUTTON_DOWN, port_b, port_d))
+    {
+        levels = static_cast<uint8_t>(levels | (1U << INPUT_SOURCE_BUTTON_DOWN));
+    }
+    if (input_active(PIN_LIMIT_UPPER, port_b, port_d))
+    {
+        levels = static_cast<uint8_t>(levels | (1U << INPUT_SOURCE_LIMIT_UPPER));
+    }
+    if (input_active(PIN_LIMIT_LOWER, port_b, port_d))
+    {
+        levels = static_cast<uint8_t>(levels | (1U << INPUT_SOURCE_LIMIT_LOWER));
+    }
+    return levels;
+}
+
+/**
+ * @brief Encoder A (bit 0) and B (bit 1) from one PINC read
+ */
+static inline uint8_t encoder_levels(void)
+{
+    const uint8_t port_c = PortIO_read(PORT_IO_C);
+    return static_cast<uint8_t>((port_c & (PortIO_mask(PIN_ENCODER_A) | PortIO_mask(PIN_ENCODER_B))) /
+                                PortIO_mask(PIN_ENCODER_A));
+}
+
+#ifndef TESTENVIRONMENT
+static void enable_pin_change_interrupt(uint8_t pin)
+{
+    *digitalPinToPCMSK(pin) |= static_cast<uint8_t>(1U << digitalPinToPCMSKbit(pin));
+    *digitalPinToPCICR(pin) |= static_cast<uint8_t>(1U << digitalPinToPCICRbit(pin));
+}
+#endif
+
+/**
+ * @brief Enable PCINT on every button / limit pin (PCINT0: pin 8; PCINT2: pins 2, 3, 7)
+ * and on both encoder channels (PCINT1: A2, A3)
+ */
+static void enable_pin_change_interrupts(void)
+{
+#ifndef TESTENVIRONMENT
+    for (uint8_t source = 0U; source < INPUT_SOURCE_COUNT; ++source)
+    {
+        enable_pin_change_interrupt(input_pins[source]);
+    }
+    enable_pin_change_interrupt(PIN_ENCODER_A);
+    enable_pin_change_interrupt(PIN_ENCODER_B);
+#endif
+}
+
+/**
+ * @brief Host builds have no pin-change hardware: sample the pins as the interrupt would
+ *
+ * Tests that write pin_states[] directly then see each edge at the next HAL input
+ * access, exactly like the former polling HAL. Harnesses that call
+ * HAL_inputChangeIsr() themselves get edge-exact timestamps.
+ */
+static void emulate_pin_change_interrupt(void)
+{
+#ifdef TESTENVIRONMENT
+    HAL_inputChangeIsr();
+#endif
+}
+
+/**
+ * @brief Host builds: decode the encoder pins as PCINT1 would (edges since the last access)
+ *
+ * Harnesses that move the pins by more than one state between accesses must
+ * call HAL_encoderIsr() after every state, as the simulator does.
+ */
+static void emulate_encoder_interrupt(void)
+{
+#ifdef TESTENVIRONMENT
+    HAL_encoderIsr();
+#endif
+}
+
+/**
+ * @brief Host builds have no free-running ADC: convert the mocked sense pin as it would
+ *
+ * The pin holds one value between HAL accesses, so a full filter window of
+ * conversions reproduces the settled hardware result (the target converts
+ * every 1.024 ms in the background).
+ */
+static void emulate_adc_conversions(void)
+{
+#ifdef TESTENVIRONMENT
+    for (uint8_t i = 0U; i < ADC_FILTER_LENGTH; i++)
+    {
+        AdcSampler_conversionComplete(static_cast<uint16_t>(analogRead(PIN_MOTOR_SENSE)));
+    }
+#endif
+}
+
+static void apply_input(uint8_t source, bool active, uint32_t timestamp_us)
+{
+    if (source < static_cast<uint8_t>(BUTTON_COUNT))
+    {
+        // Every raw edge restarts the debounce window from its interrupt timestamp
+        if (active != button_raw_state[source])
+        {
+            button_raw_state[source] = active;
+            last_button_edge_us[source] = timestamp_us;
+        }
+    }
+    else if (source < static_cast<uint8_t>(INPUT_SOURCE_COUNT))
+    {
+        limit_state[source - static_cast<uint8_t>(BUTTON_COUNT)] = active;
+    }
+}
+
+/**
+ * @brief Consume queued edges; resync from the pins if the queue overflowed
+ *
+ * @return bool - true if any input changed
+ */
+static bool drain_input_events(void)
+{
+    emulate_pin_change_interrupt();
+
+    bool changed = false;
+    InputEvent_t event;
+    while (InputEventQueue_pop(&input_queue, &event))
+    {
+        apply_input(event.source, event.active, event.timestamp_us);
+        changed = true;
+    }
+
+    // SAFETY-CRITICAL: lost edges could leave a limit looking inactive - reread every pin
+    const uint8_t dropped = input_queue.dropped;
+    if (dropped != dropped_seen)
+    {
+        dropped_seen = dropped;
+        const uint8_t levels = sample_inputs();
+        const uint32_t now_us = HAL_getTimeUs();
+        for (uint8_t source = 0U; source < INPUT_SOURCE_COUNT; ++source)
+        {
+            apply_input(source, (levels & (1U << source)) != 0U, now_us);
+        }
+        changed = true;
+    }
+    return changed;
 }
 
 void HAL_init(void)
 {
+#ifndef TESTENVIRONMENT
+    noInterrupts();
+#endif
     init_inputs();
     init_outputs();
     for (uint8_t i = 0; i < BUTTON_COUNT; ++i)
     {
         button_raw_state[i] = false;
         button_stable_state[i] = false;
-        last_button_time[i] = 0U;
+        last_button_edge_us[i] = 0U;
+    }
+    for (uint8_t i = 0; i < LIMIT_COUNT; ++i)
+    {
+        limit_state[i] = false;
     }
+
+    CurrentMonitor_init(&current_monitor);
+    PositionEncoder_init(&position_encoder, encoder_levels(), HAL_getTime());
+    NVM_init();
+
+    // Start from "all released"; inputs already active at power-on queue as edges now
+    InputEventQueue_init(&input_queue);
+    dropped_seen = 0U;
+    isr_input_levels = 0U;
+    HAL_inputChangeIsr();
+    enable_pin_change_interrupts();
+#ifndef TESTENVIRONMENT
+    interrupts();
+#endif
 }
 
-bool HAL_readButton(ButtonID_t button)
+void HAL_inputChangeIsr(void)
 {
-    const uint32_t now = millis();
-    const bool raw_pressed = (digitalRead(button_pins[button]) == LOW);
+    const uint8_t levels = sample_inputs();
+    const uint8_t changed = static_cast<uint8_t>(levels ^ isr_input_levels);
+    if (changed == 0U)
+    {
+        return;
+    }
 
-    if (raw_pressed != button_raw_state[button])
+    const uint32_t now_us = HAL_getTimeUs();
+    for (uint8_t source = 0U; source < INPUT_SOURCE_COUNT; ++source)
     {
-        button_raw_state[button] = raw_pressed;
-        last_button_time[button] = now;
+        if ((changed & (1U << source)) != 0U)
+        {
+            InputEvent_t event;
+            event.timestamp_us = now_us;
+            event.source = source;
+            event.active = (levels & (1U << source)) != 0U;
+            (void)InputEventQueue_push(&input_queue, &event);  // Full: counted, consumer resyncs
+        }
     }
+    isr_input_levels = levels;
+}
+
+void HAL_encoderIsr(void)
+{
+    PositionEncoder_edge(&position_encoder, encoder_levels());
+}
+
+bool HAL_pollInputEvents(void)
+{
+    return drain_input_events();
+}
 
-    const uint32_t elapsed = now - last_button_time[button];
-    if (elapsed >= DEBOUNCE_MS)
+/**
+ * @brief Debounced level of one button at now_us (SWReq-009)
+ */
+static bool debounced_button(uint8_t button, uint32_t now_us)
+{
+    const uint32_t elapsed_us = now_us - last_button_edge_us[button];
+    if (elapsed_us >= DEBOUNCE_US)
     {
         button_stable_state[button] = button_raw_state[button];
     }
-
     return button_stable_state[button];
 }
 
+void HAL_readInputs(HALInputSnapshot_t *snapshot)
+{
+    if (snapshot == NULL)
+    {
+        return;
+    }
+
+    (void)drain_input_events();
+    const uint32_t now_us = HAL_getTimeUs();
+    for (uint8_t i = 0U; i < BUTTON_COUNT; ++i)
+    {
+        snapshot->button[i] = debounced_button(i, now_us);
+        snapshot->button_raw[i] = button_raw_state[i];
+    }
+    for (uint8_t i = 0U; i < LIMIT_COUNT; ++i)
+    {
+        snapshot->limit[i] = limit_state[i];
+    }
+    snapshot->timestamp_us = now_us;
+}
+
+bool HAL_readButton(ButtonID_t button)
+{
+    (void)drain_input_events();
+    return debounced_button(static_cast<uint8_t>(button), HAL_getTimeUs());
+}
+
+bool HAL_readButtonRaw(ButtonID_t button)
+{
+    (void)drain_input_events();
+    return button_raw_state[button];
+}
+
 bool HAL_readLimitSensor(LimitID_t sensor)
 {
-    // Active-low sensors with pull-ups
-    return (digitalRead(limit_pins[sensor]) == LOW);
+    // Level from the latest edge event (active-low sensors with pull-ups)
+    (void)drain_input_events();
+    return limit_state[sensor];
 }
 
 uint16_t HAL_readMotorCurrent(void)
 {
-    if (g_motor_type == MT_ROBUST)
-    {
-        // IBT_2 Driver - Has integrated current sensing via shunt resistor
-        const uint16_t adc = static_cast<uint16_t>(analogRead(PIN_MOTOR_SENSE));
-        const uint32_t voltage_mv = (static_cast<uint32_t>(adc) * ADC_REF_MV) / 1023U;
-        const uint32_t current_ma = (voltage_mv * 1000U) / SHUNT_MILLIOHMS;
-        return static_cast<uint16_t>(current_ma);
-    }
-    else
+    emulate_adc_conversions();
+
+    // MT_BASIC has no current sensing and reports 0 mA (see motor_driver.h)
+#ifdef DESK_MOTOR_RUNTIME_DISPATCH
+    return (g_motor_type == MT_ROBUST) ? IBT2Driver::readCurrentMa() : L298NDriver::readCurrentMa();
+#else
+    return ActiveMotorDriver::readCurrentMa();
+#endif
+}
+
+uint16_t HAL_sampleMotorCurrent(void)
+{
+    // The shadow holds the drive last applied: it qualifies the sample as stuck-on or obstruction
+    const uint16_t current_ma = HAL_readMotorCurrent();
+    CurrentMonitor_addSample(&current_monitor, current_ma, shadow_motor_dir);
+    return current_ma;
+}
+
+void HAL_sampleEncoder(void)
+{
+    emulate_encoder_interrupt();
+    // The shadow holds the drive last applied: the direction check compares the travel with it
+    PositionEncoder_update(&position_encoder, shadow_motor_dir, HAL_getTime());
+}
+
+void HAL_readEncoder(EncoderState_t *state)
+{
+    if (state == NULL)
     {
-        // MT_BASIC Driver - No current sensing available
-        // PIN_MOTOR_SENSE not connected to current sensor, return safe default
-        return 0U;
+        return;
     }
+    *state = PositionEncoder_state(&position_encoder);
+}
+
+void HAL_setMotorCurrentObstructionLimit(uint16_t limit_ma)
+{
+    CurrentMonitor_setObstructionLimit(&current_monitor, limit_ma);
+}
+
+void HAL_setMotorCurrentDeviationLimit(uint16_t limit_ma)
+{
+    CurrentMonitor_setDeviationLimit(&current_monitor, limit_ma);
+}
+
+bool HAL_motorCurrentSlopeJam(void)
+{
+    return CurrentMonitor_slopeJam(&current_monitor);
+}
+
+void HAL_takeMotorCurrentSummary(CurrentSummary_t *summary)
+{
+    CurrentMonitor_takeSummary(&current_monitor, summary);
 }
 
 void HAL_setMotor(MotorDirection_t dir, uint8_t speed)
 {
-    if (g_motor_type == MT_BASIC)
+    const uint8_t duty = (dir == MOTOR_STOP) ? 0U : speed;
+    if (shadow_motor_valid && (dir == shadow_motor_dir) && (duty == shadow_motor_speed))
     {
-        // ========================================================================
-        // L298N MOTOR CONTROL (3-pin: EN1, EN2, PWM)
-        // ========================================================================
-        // Direction via EN1/EN2 (mutually exclusive)
-        // Speed via PWM on PIN_MOTOR_PWM
-        
-        switch (dir)
+        return;  // Already applied
+    }
+
+#ifdef DESK_MOTOR_RUNTIME_DISPATCH
+    if (g_motor_type == MT_ROBUST)
+    {
+        if (shadow_motor_valid)
+        {
+            IBT2Driver::update(shadow_motor_dir, shadow_motor_speed, dir, duty);
+        }
+        else
         {
-            case MOTOR_STOP:
-            default:
-                digitalWrite(PIN_MOTOR_EN1, LOW);
-                digitalWrite(PIN_MOTOR_EN2, LOW);
-                analogWrite(PIN_MOTOR_PWM, 0);
-                break;
-            case MOTOR_UP:
-                digitalWrite(PIN_MOTOR_EN1, HIGH);
-                digitalWrite(PIN_MOTOR_EN2, LOW);
-                analogWrite(PIN_MOTOR_PWM, speed);
-                break;
-            case MOTOR_DOWN:
-                digitalWrite(PIN_MOTOR_EN1, LOW);
-                digitalWrite(PIN_MOTOR_EN2, HIGH);
-                analogWrite(PIN_MOTOR_PWM, speed);
-                break;
+            IBT2Driver::set(dir, duty);
         }
     }
-    else if (g_motor_type == MT_ROBUST)
-    {
-        // ========================================================================
-        // IBT_2 MOTOR CONTROL (2-pin PWM: LPWM, RPWM)
-        // ========================================================================
-        // Direction and speed controlled by PWM ratio:
-        // - UP:   LPWM=255 (full), RPWM=0   (ramp down as needed for speed)
-        // - DOWN: LPWM=0,   RPWM=255 (full, ramp down as needed for speed)
-        // - STOP: LPWM=0,   RPWM=0
-        
-        switch (dir)
+    else
+    {
+        if (shadow_motor_valid)
         {
-            case MOTOR_STOP:
-            default:
-                analogWrite(PIN_MOTOR_LPWM, 0);
-                analogWrite(PIN_MOTOR_RPWM, 0);
-                break;
-            case MOTOR_UP:
-                // Left PWM high (counterclockwise = up), Right PWM for speed control
-                analogWrite(PIN_MOTOR_LPWM, 255);
-                analogWrite(PIN_MOTOR_RPWM, 255 - speed);
-                break;
-            case MOTOR_DOWN:
-                // Right PWM high (clockwise = down), Left PWM for speed control
-                analogWrite(PIN_MOTOR_LPWM, 255 - speed);
-                analogWrite(PIN_MOTOR_RPWM, 255);
-                break;
+            L298NDriver::update(shadow_motor_dir, shadow_motor_speed, dir, duty);
         }
+        else
+        {
+            L298NDriver::set(dir, duty);
+        }
+    }
+#else
+    if (shadow_motor_valid)
+    {
+        ActiveMotorDriver::update(shadow_motor_dir, shadow_motor_speed, dir, duty);
+    }
+    else
+    {
+        ActiveMotorDriver::set(dir, duty);
     }
+#endif
+
+    shadow_motor_dir = dir;
+    shadow_motor_speed = duty;
+    shadow_motor_valid = true;
+}
+
+MotorDirection_t HAL_getMotorDirection(void)
+{
+    return shadow_motor_dir;
 }
 
-/**
- * @brief Set individual LED state
- * 
- * Controls one of the 3 independent status LEDs:
- * - LED_BT_UP (Pin 11): UP button pressed indicator
- * - LED_BT_DOWN (Pin 12): DOWN button pressed indicator  
- * - LED_ERROR (Pin 13): Error/fault state indicator
- * 
- * @param led - LED identifier (LED_BT_UP, LED_BT_DOWN, LED_ERROR)
- * @param state - LED state (LED_OFF=0 or LED_ON=1)
- */
 void HAL_setLED(LEDID_t led, LEDState_t state)
 {
-    const bool level = (state == LED_ON) ? HIGH : LOW;
-    
+    if (static_cast<uint8_t>(led) >= static_cast<uint8_t>(LED_COUNT))
+    {
+        return;  // Invalid LED ID - do nothing
+    }
+
+    const uint8_t bit = static_cast<uint8_t>(1U << led);
+    const bool level = (state == LED_ON);
+    if (((shadow_led_valid & bit) != 0U) && (((shadow_led_on & bit) != 0U) == level))
+    {
+        return;  // Already applied
+    }
+
     switch (led)
     {
         case LED_BT_UP:
-            digitalWrite(PIN_LED_BT_UP, level);
+            PortIO_writePin(PIN_LED_BT_UP, level);
             break;
         case LED_BT_DOWN:
-            digitalWrite(PIN_LED_BT_DOWN, level);
+            PortIO_writePin(PIN_LED_BT_DOWN, level);
             break;
         case LED_ERROR:
-            digitalWrite(PIN_LED_ERROR, level);
-            break;
         default:
-            // Invalid LED ID - do nothing
+            PortIO_writePin(PIN_LED_ERROR, level);
             break;
     }
+    shadow_led_on = level ? static_cast<uint8_t>(shadow_led_on | bit)
+                          : static_cast<uint8_t>(shadow_led_on & static_cast<uint8_t>(~bit));
+    shadow_led_valid = static_cast<uint8_t>(shadow_led_valid | bit);
 }
 
 uint32_t HAL_getTime(void)
 {
-    return millis();
+    // millis() is 32 bits on AVR; the cast keeps host builds wrapping identically
+    return static_cast<uint32_t>(millis());
+}
+
+uint32_t HAL_getTimeUs(void)
+{
+    return static_cast<uint32_t>(micros());
+}
+
+void HAL_debugInit(uint32_t baud)
+{
+    Serial.begin(static_cast<unsigned long>(baud));
+}
+
+void HAL_debugPrint(const char *text)
+{
+    if (text != NULL)
+    {
+        Serial.print(text);
+    }
+}
+
+void HAL_debugPrintU32(uint32_t value)
+{
+    Serial.print(static_cast<unsigned long>(value));
+}
+
+#ifndef TESTENVIRONMENT
+// Pin-change interrupt vectors: producer side of the input edge queue
+ISR(PCINT0_vect)
+{
+    HAL_inputChangeIsr();  // Pin 8: lower limit
 }
+
+ISR(PCINT1_vect)
+{
+    HAL_encoderIsr();  // A2, A3: encoder A / B
+}
+
+ISR(PCINT2_vect)
+{
+    HAL_inputChangeIsr();  // Pins 2, 3, 7: buttons, upper limit
+}
+#endif
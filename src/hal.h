@@ -5,9 +5,16 @@
  * Provides hardware-independent interface for:
  * - Button input reading (UP/DOWN rocker switch)
  * - Limit sensor reading (upper/lower mechanical limits)
+ * - Pin-change interrupt capture of input edges with micros() timestamps
+ *   (lock-free ISR -> main loop queue, input_events.h)
+ * - Single-snapshot input reads and direct port register outputs (port_io.h)
  * - Motor control (configurable driver: L298N or IBT_2)
+ * - Quadrature encoder position / velocity (PCINT1 decoding, position_encoder.h)
+ * - 1 kHz motor current sampling with per-control-cycle statistics (current_monitor.h)
+ * - Non-volatile record storage (nvm.h, initialized here)
  * - LED status indicators (3× independent LEDs)
- * - System timing (millisecond counter)
+ * - System timing (millisecond and microsecond counters)
+ * - Diagnostic serial output (profiling reports)
  * 
  * @motor_driver Configurable via motor_config.h MOTOR_TYPE:
  *   - MT_BASIC: L298N dual H-bridge (3-pin control: EN1, EN2, PWM)
@@ -52,23 +59,100 @@ void HAL_init(void);
  * Must be called before HAL_init() or immediately after if motor type
  * needs to change at runtime.
  * 
+ * Only builds defining DESK_MOTOR_RUNTIME_DISPATCH honour the argument; all
+ * others bind the MOTOR_CONFIG_BUILD_TYPE driver policy (motor_driver.h) at
+ * compile time and ignore it.
+ * 
  * @param motor_type - Motor type identifier (MT_BASIC for L298N, MT_ROBUST for IBT_2)
  * 
  * @postconditions HAL functions adapt to specified motor driver hardware
  */
 void HAL_setMotorType(MotorType_t motor_type);
 
+/**
+ * @brief Pin-change interrupt body: queue an event for every input that changed
+ * 
+ * Runs from PCINT0_vect / PCINT2_vect on target. Host harnesses call it right
+ * after changing an input pin to give the edge an exact timestamp; without
+ * that, host builds sample the pins on every HAL input access instead.
+ * 
+ * @safety_critical Producer side only - never call from the main loop on target
+ */
+void HAL_inputChangeIsr(void);
+
+/**
+ * @brief Encoder pin-change interrupt body: decode the step to the new A/B levels
+ * 
+ * Runs from PCINT1_vect on target. Host builds decode once per
+ * HAL_sampleEncoder(); harnesses that move the encoder faster call it after
+ * every A/B change.
+ * 
+ * @safety_critical Producer side only - never call from the main loop on target
+ */
+void HAL_encoderIsr(void);
+
+/**
+ * @brief Consume queued input edges
+ * 
+ * @return bool - true if any button or limit changed level since the last call;
+ *         the caller can react to a limit hit without waiting for its schedule
+ */
+bool HAL_pollInputEvents(void);
+
+/**
+ * @struct HALInputSnapshot_t
+ * @brief All digital inputs at one instant (HAL_readInputs)
+ *
+ * @field button - Debounced button levels (SWReq-009), indexed by ButtonID_t
+ * @field button_raw - Undebounced levels, for stop decisions only (see HAL_readButtonRaw)
+ * @field limit - Limit switch levels, indexed by LimitID_t
+ * @field timestamp_us - Single time base used for all debounce decisions
+ */
+typedef struct
+{
+    bool button[BUTTON_COUNT];
+    bool button_raw[BUTTON_COUNT];
+    bool limit[LIMIT_COUNT];
+    uint32_t timestamp_us;
+} HALInputSnapshot_t;
+
+/**
+ * @brief Read every button and limit switch with one queue drain and one timestamp
+ * 
+ * Equivalent to HAL_readButton / HAL_readButtonRaw / HAL_readLimitSensor for
+ * each input, without repeating the queue drain and micros() per input.
+ * 
+ * @param snapshot - Filled with the current levels (NULL is ignored)
+ */
+void HAL_readInputs(HALInputSnapshot_t *snapshot);
+
 /**
  * @brief Read button state (UP or DOWN)
  * 
+ * Debounced from interrupt edge timestamps: stable once 20 ms (SWReq-009)
+ * have passed since the last edge, independent of when this is called.
+ * 
  * @param button - Button identifier (BUTTON_UP or BUTTON_DOWN)
  * @return bool - true if pressed (active LOW), false if released
  */
 bool HAL_readButton(ButtonID_t button);
 
+/**
+ * @brief Read undebounced button level (UP or DOWN)
+ * 
+ * Level of the most recent edge event. Only for stop decisions: stopping on a
+ * contact bounce is fail-safe, starting motion must use HAL_readButton().
+ * 
+ * @param button - Button identifier (BUTTON_UP or BUTTON_DOWN)
+ * @return bool - true if the contact is closed (active LOW)
+ */
+bool HAL_readButtonRaw(ButtonID_t button);
+
 /**
  * @brief Read limit sensor state (upper or lower)
  * 
+ * Level of the most recent edge event (no debounce: a limit acts at once).
+ * 
  * @param sensor - Sensor identifier (LIMIT_UPPER or LIMIT_LOWER)
  * @return bool - true if triggered (active LOW), false if open
  */
@@ -81,6 +165,68 @@ bool HAL_readLimitSensor(LimitID_t sensor);
  */
 uint16_t HAL_readMotorCurrent(void);
 
+/**
+ * @brief Take one motor current sample for the high-rate statistics (call at 1 kHz)
+ * 
+ * Adds HAL_readMotorCurrent() to the current monitor together with the drive
+ * state last applied by HAL_setMotor().
+ * 
+ * @return uint16_t - The sample (mA)
+ */
+uint16_t HAL_sampleMotorCurrent(void);
+
+/**
+ * @brief Fold the decoded encoder counts into position, velocity and the direction check (call at 1 kHz)
+ * 
+ * The direction check compares the travel with the drive last applied by HAL_setMotor().
+ */
+void HAL_sampleEncoder(void);
+
+/**
+ * @brief Encoder state as of the last HAL_sampleEncoder()
+ * 
+ * @param state - Position since HAL_init(), velocity, decode errors and
+ *                direction error (NULL is ignored)
+ */
+void HAL_readEncoder(EncoderState_t *state);
+
+/**
+ * @brief Obstruction limit for the following samples (CurrentMonitor_obstructionLimitMa())
+ * 
+ * HAL_init() starts from the flat MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA.
+ */
+void HAL_setMotorCurrentObstructionLimit(uint16_t limit_ma);
+
+/**
+ * @brief Learned obstruction limit for the following samples (0 = none)
+ * 
+ * Samples above it while driven form the summary's deviation run (current_baseline.h).
+ */
+void HAL_setMotorCurrentDeviationLimit(uint16_t limit_ma);
+
+/**
+ * @brief Current slope (di/dt) jam detected by the 1 kHz samples for the drive applied
+ * 
+ * @return bool - true until drive is removed (see current_monitor.h)
+ */
+bool HAL_motorCurrentSlopeJam(void);
+
+/**
+ * @brief Collect the current statistics since the previous call (once per control cycle)
+ * 
+ * @param summary - Peak, mean and threshold runs; samples = 0 if
+ *                  HAL_sampleMotorCurrent() was not called in between
+ */
+void HAL_takeMotorCurrentSummary(CurrentSummary_t *summary);
+
+/**
+ * @brief Invalidate the output shadow: the next HAL_setMotor() / HAL_setLED() rewrite their pins
+ * 
+ * For paths that must not rely on the shadow matching the pins, e.g. a fault
+ * stop that re-asserts every drive pin.
+ */
+void HAL_refreshOutputs(void);
+
 /**
  * @brief Set motor direction and speed
  * 
@@ -91,18 +237,29 @@ uint16_t HAL_readMotorCurrent(void);
  * - L298N (MT_BASIC): Controls via EN1, EN2 (direction) and PWM (speed)
  * - IBT_2 (MT_ROBUST): Controls via LPWM, RPWM (direction and speed)
  * 
+ * Writes only what differs from the last applied direction and speed (output
+ * shadow): an unchanged request touches no pin, a speed change only the PWM
+ * pin(s). Direction changes release the old direction before the new one is
+ * driven, so no intermediate pin state drives against both.
+ * 
  * @param dir - Motor direction (MOTOR_STOP, MOTOR_UP, MOTOR_DOWN)
- * @param speed - PWM duty cycle (0-255, where 0=stop, 255=full speed)
+ * @param speed - PWM duty cycle (0-255, where 0=stop, 255=full speed; ignored for MOTOR_STOP)
  * 
  * @note This function provides a unified interface. The actual driver
  *       implementation is selected at compile-time via MOTOR_TYPE.
  */
 void HAL_setMotor(MotorDirection_t dir, uint8_t speed);
 
+/**
+ * @brief Direction last applied by HAL_setMotor() (MOTOR_STOP after HAL_init())
+ */
+MotorDirection_t HAL_getMotorDirection(void);
+
 /**
  * @brief Set individual LED state
  * 
- * Controls one of the 3 status LEDs independently.
+ * Controls one of the 3 status LEDs independently. The pin is written only
+ * when the state differs from the last applied one (output shadow).
  * 
  * @param led - LED identifier (LED_BT_UP, LED_BT_DOWN, LED_ERROR)
  * @param state - LED state (LED_OFF or LED_ON)
@@ -123,6 +280,29 @@ void HAL_setLED(LEDID_t led, LEDState_t state);
  */
 uint32_t HAL_getTime(void);
 
+/**
+ * @brief Get system time in microseconds
+ * 
+ * @return uint32_t - Microseconds since system startup (wraps after ~71 minutes;
+ *         4 µs resolution on a 16 MHz UNO)
+ */
+uint32_t HAL_getTimeUs(void);
+
+/**
+ * @brief Open the diagnostic serial port
+ * 
+ * @param baud - Serial baud rate
+ */
+void HAL_debugInit(uint32_t baud);
+
+/**
+ * @brief Write text / an unsigned decimal to the diagnostic serial port
+ * 
+ * Blocking on target; call outside the control task.
+ */
+void HAL_debugPrint(const char *text);
+void HAL_debugPrintU32(uint32_t value);
+
 #ifdef __cplusplus
 }
 #endif
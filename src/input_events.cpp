@@ -0,0 +1,82 @@
+#include "input_events.h"
+#include <stddef.h>  // For NULL definition
+
+#ifdef TESTENVIRONMENT
+#include <atomic>
+#endif
+
+static const uint8_t INDEX_MASK = static_cast<uint8_t>(INPUT_EVENT_QUEUE_SIZE - 1U);
+
+static_assert((INPUT_EVENT_QUEUE_SIZE & INDEX_MASK) == 0U, "Queue size must be a power of two");
+static_assert((256U % INPUT_EVENT_QUEUE_SIZE) == 0U, "8-bit counters must wrap on a slot boundary");
+
+/**
+ * @brief Keep slot accesses on the correct side of the head/tail publication
+ *
+ * The producer is an interrupt on the consumer's core, so ordering against the
+ * compiler is sufficient (no hardware memory barrier on AVR).
+ */
+static inline void compiler_barrier(void)
+{
+#ifdef TESTENVIRONMENT
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+void InputEventQueue_init(InputEventQueue_t *queue)
+{
+    if (queue == NULL)
+    {
+        return;
+    }
+    queue->head = 0U;
+    queue->tail = 0U;
+    queue->dropped = 0U;
+}
+
+bool InputEventQueue_push(InputEventQueue_t *queue, const InputEvent_t *event)
+{
+    if ((queue == NULL) || (event == NULL))
+    {
+        return false;
+    }
+
+    const uint8_t head = queue->head;
+    if (static_cast<uint8_t>(head - queue->tail) >= INPUT_EVENT_QUEUE_SIZE)
+    {
+        queue->dropped = static_cast<uint8_t>(queue->dropped + 1U);
+        return false;
+    }
+
+    queue->slots[head & INDEX_MASK] = *event;
+    compiler_barrier();  // Slot complete before the consumer can see it
+    queue->head = static_cast<uint8_t>(head + 1U);
+    return true;
+}
+
+bool InputEventQueue_pop(InputEventQueue_t *queue, InputEvent_t *event)
+{
+    if ((queue == NULL) || (event == NULL))
+    {
+        return false;
+    }
+
+    const uint8_t tail = queue->tail;
+    if (tail == queue->head)
+    {
+        return false;
+    }
+
+    compiler_barrier();  // Read the slot only after seeing it published
+    *event = queue->slots[tail & INDEX_MASK];
+    compiler_barrier();  // Slot copied before the producer may reuse it
+    queue->tail = static_cast<uint8_t>(tail + 1U);
+    return true;
+}
+
+bool InputEventQueue_isEmpty(const InputEventQueue_t *queue)
+{
+    return (queue == NULL) || (queue->tail == queue->head);
+}
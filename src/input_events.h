@@ -0,0 +1,96 @@
+/**
+ * @file input_events.h
+ * @brief Lock-free single-producer / single-consumer queue of input edges
+ *
+ * @purpose
+ * Carries button and limit switch edges from the pin-change interrupt
+ * (producer) to the HAL in the main loop (consumer) together with the
+ * micros() timestamp taken in the interrupt, so edge timing no longer depends
+ * on when the control task happens to poll (SWReq-009 debounce, SysReq-007).
+ *
+ * @implementation
+ * - Fixed ring of INPUT_EVENT_QUEUE_SIZE slots, no dynamic memory
+ * - head is written only by the producer, tail only by the consumer; both are
+ *   free-running 8-bit counters (single-byte stores are atomic on AVR), the
+ *   slot index is counter & (size - 1)
+ * - The producer fills the slot before publishing head, the consumer copies
+ *   the slot before publishing tail; a compiler barrier keeps that order
+ * - A full queue drops the new event and counts it in `dropped` (producer-owned,
+ *   never cleared); the consumer compares it against its own copy to resync
+ *
+ * @thread_safety One producer (ISR) and one consumer (main loop) at a time
+ */
+
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+#include <stdint.h>
+#include "desk_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    INPUT_SOURCE_BUTTON_UP = 0,
+    INPUT_SOURCE_BUTTON_DOWN = 1,
+    INPUT_SOURCE_LIMIT_UPPER = 2,
+    INPUT_SOURCE_LIMIT_LOWER = 3,
+    INPUT_SOURCE_COUNT = 4
+} InputSource_t;
+
+/**
+ * @struct InputEvent_t
+ * @brief One input edge
+ *
+ * @field timestamp_us - micros() when the interrupt saw the edge
+ * @field source - InputSource_t of the pin that changed
+ * @field active - New level: true = pressed / triggered (pin LOW, active-low inputs)
+ */
+typedef struct
+{
+    uint32_t timestamp_us;
+    uint8_t source;
+    bool active;
+} InputEvent_t;
+
+static const uint8_t INPUT_EVENT_QUEUE_SIZE = 16U;   // Power of two; ~4 bounce edges per input
+
+typedef struct
+{
+    InputEvent_t slots[INPUT_EVENT_QUEUE_SIZE];
+    volatile uint8_t head;      ///< Next slot to write (producer)
+    volatile uint8_t tail;      ///< Next slot to read (consumer)
+    volatile uint8_t dropped;   ///< Events lost to a full queue (producer, wraps)
+} InputEventQueue_t;
+
+/**
+ * @brief Empty the queue and clear the drop counter (no producer may be active)
+ */
+void InputEventQueue_init(InputEventQueue_t *queue);
+
+/**
+ * @brief Producer side: append an event
+ *
+ * @return bool - false if the queue was full (event dropped and counted)
+ */
+bool InputEventQueue_push(InputEventQueue_t *queue, const InputEvent_t *event);
+
+/**
+ * @brief Consumer side: remove the oldest event
+ *
+ * @return bool - false if the queue was empty (*event untouched)
+ */
+bool InputEventQueue_pop(InputEventQueue_t *queue, InputEvent_t *event);
+
+/**
+ * @brief Consumer side: true if no event is waiting
+ */
+bool InputEventQueue_isEmpty(const InputEventQueue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INPUT_EVENTS_H
@@ -0,0 +1,66 @@
+#include "motion_profile.h"
+#include "motor_controller.h"
+#include <stddef.h>  // For NULL definition
+
+static const uint32_t UM_S_MS_PER_UM = 1000U;  // um/s * ms per um
+
+void MotionProfile_init(MotionProfile_t *profile)
+{
+    if (profile == NULL)
+    {
+        return;
+    }
+    profile->dir = MOTOR_STOP;
+    profile->pwm = 0U;
+    profile->braking_um = 0U;
+}
+
+uint32_t MotionProfile_brakingDistanceUm(const PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint8_t pwm)
+{
+    if ((estimator == NULL) || (drive_dir == MOTOR_STOP))
+    {
+        return 0U;
+    }
+
+    uint32_t travel = 0U;  // um/s * ms
+    for (uint16_t ms = 0U; ms < MOTION_PROFILE_MAX_STOP_MS; ms++)
+    {
+        const uint8_t stop_pwm = MotorController_stopPwm(pwm, ms);
+        if (stop_pwm == 0U)
+        {
+            break;
+        }
+        travel += PositionEstimator_speedUmS(estimator, drive_dir, stop_pwm);
+    }
+    return travel / UM_S_MS_PER_UM;
+}
+
+bool MotionProfile_atBrakingPoint(MotionProfile_t *profile, const PositionEstimator_t *estimator,
+                                  MotorDirection_t drive_dir, uint8_t pwm, int32_t target_height_um)
+{
+    if ((profile == NULL) || (estimator == NULL) || (drive_dir == MOTOR_STOP))
+    {
+        return false;
+    }
+
+    const int32_t height_um = estimator->estimate.height_um;
+    const int32_t remaining_um = (drive_dir == MOTOR_UP) ? (target_height_um - height_um) : (height_um - target_height_um);
+    if (remaining_um <= 0)
+    {
+        return true;
+    }
+
+    // More than a second of travel away: no soft stop is that long, skip the sum
+    const uint32_t speed_um_s = PositionEstimator_speedUmS(estimator, drive_dir, pwm);
+    if (static_cast<uint32_t>(remaining_um) > speed_um_s)
+    {
+        return false;
+    }
+    if ((drive_dir != profile->dir) || (pwm != profile->pwm))
+    {
+        profile->dir = drive_dir;
+        profile->pwm = pwm;
+        profile->braking_um = MotionProfile_brakingDistanceUm(estimator, drive_dir, pwm);
+    }
+    return static_cast<uint32_t>(remaining_um) <= profile->braking_um;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file motion_profile.h
+ * @brief Braking point of a move to target (time-optimal trapezoid)
+ *
+ * @purpose
+ * A move to a preset height runs the fastest profile the drive allows: the
+ * MotorController soft-start ramp, full PWM cruise, and the soft stop begun at
+ * the last moment that still ends on the target. Braking earlier wastes time,
+ * braking later overshoots. Short moves brake during the ramp-up (triangle).
+ *
+ * @implementation
+ * - Braking distance: the position_estimator.h speed model summed over the
+ *   MotorController soft-stop PWM (MotorController_stopPwm()) from the PWM
+ *   applied, in 1 ms steps; speed the model rates as 0 (PWM below the load)
+ *   adds nothing
+ * - Braking point: remaining distance to the target <= braking distance.
+ *   Checked every 1 ms; the sum only runs within one second of travel of the
+ *   target (longer than any soft stop) and is cached until the drive changes,
+ *   so at cruise it runs once per move
+ * - SysReq-006 (< 0.5 g): deceleration is the cruise speed over
+ *   STOP_RAMP_TIME_MS, 60 mm/s / 200 ms = 0.03 g for the standard actuator
+ *
+ * @thread_safety NOT thread-safe; main loop only
+ */
+
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+#include <stdint.h>
+#include "desk_types.h"
+#include "position_estimator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint16_t MOTION_PROFILE_MAX_STOP_MS = 1000U;  // Longest soft stop summed
+
+typedef struct
+{
+    MotorDirection_t dir;   ///< Drive of the cached braking distance (MOTOR_STOP = none)
+    uint8_t pwm;            ///< PWM of the cached braking distance
+    uint32_t braking_um;    ///< Cached MotionProfile_brakingDistanceUm()
+} MotionProfile_t;
+
+/**
+ * @brief Forget the cached braking distance (call when the speed model changes)
+ */
+void MotionProfile_init(MotionProfile_t *profile);
+
+/**
+ * @brief Travel of a soft stop from pwm in drive_dir (um)
+ */
+uint32_t MotionProfile_brakingDistanceUm(const PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint8_t pwm);
+
+/**
+ * @brief The soft stop must begin now to end on target_height_um
+ *
+ * @param drive_dir - Drive applied (MOTOR_STOP: false)
+ * @param pwm - PWM applied (the soft stop starts from it)
+ * @param target_height_um - Target in position estimate units
+ * @return bool - true at or past the braking point
+ */
+bool MotionProfile_atBrakingPoint(MotionProfile_t *profile, const PositionEstimator_t *estimator,
+                                  MotorDirection_t drive_dir, uint8_t pwm, int32_t target_height_um);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOTION_PROFILE_H
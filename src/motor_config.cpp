@@ -2,8 +2,8 @@
  * @file motor_config.cpp
  * @brief Motor Configuration Implementation - Encapsulated Motor Type
  * 
- * Implements the motor type configuration and accessor function. This file
- * encapsulates the MOTOR_TYPE macro, enabling:
+ * Implements the motor type accessor function and validates the MOTOR_TYPE
+ * selection from motor_config.h, enabling:
  * - Controlled access via MotorConfig_getMotorType() getter function
  * - Future NVM (non-volatile memory) integration for runtime configuration
  * - Test environment overrides via TEST_MOTOR_TYPE preprocessor define
@@ -29,7 +29,8 @@
 /**
  * @brief Active motor driver type (compile-time configuration)
  * 
- * Current behavior: Compile-time macro definition (default: MT_BASIC)
+ * Current behavior: Compile-time MOTOR_TYPE (default MT_BASIC in motor_config.h,
+ * also visible there as MOTOR_CONFIG_BUILD_TYPE for compile-time driver binding)
  * Future behavior: Will read from NVM for runtime configuration
  * 
  * Affects:
@@ -42,7 +43,6 @@
  * 2. Future: Create NVM_getMotorType() function
  * 3. Eventually: Replace #define with read from NVM
  */
-#define MOTOR_TYPE MT_BASIC
 
 // ============================================================================
 // COMPILE-TIME VALIDATION
@@ -51,9 +51,9 @@
     #error "MOTOR_TYPE must be defined as MT_BASIC or MT_ROBUST"
 #endif
 
-#if (MOTOR_TYPE != MT_BASIC) && (MOTOR_TYPE != MT_ROBUST)
-    #error "MOTOR_TYPE must be MT_BASIC (0u) or MT_ROBUST (1u)"
-#endif
+// MT_BASIC / MT_ROBUST are enumerators, invisible to #if: check in the compiler
+static_assert((MOTOR_CONFIG_BUILD_TYPE == MT_BASIC) || (MOTOR_CONFIG_BUILD_TYPE == MT_ROBUST),
+              "MOTOR_TYPE must be MT_BASIC (0u) or MT_ROBUST (1u)");
 
 // ============================================================================
 // ACCESSOR FUNCTION IMPLEMENTATION
@@ -88,9 +88,9 @@ MotorType_t MotorConfig_getMotorType(void)
     // without recompilation. TEST_MOTOR_TYPE is set during compilation.
     return TEST_MOTOR_TYPE;
 #else
-    // Production: Use compile-time MOTOR_TYPE macro encapsulated in this file
+    // Production: Use compile-time MOTOR_TYPE selection (motor_config.h)
     // Future: Replace with NVM_getMotorType() call for runtime configuration
-    return MOTOR_TYPE;
+    return MOTOR_CONFIG_BUILD_TYPE;
 #endif
 }
 
@@ -15,6 +15,14 @@
  * 2. Function is implemented in motor_config.cpp 
  * 3. Returns compile-time MOTOR_TYPE value (or test override via TEST_MOTOR_TYPE)
  * 4. Future: Will read from NVM instead of compile-time macro
+ *
+ * Compile-time binding:
+ * - MOTOR_CONFIG_BUILD_TYPE exposes MOTOR_TYPE as a constant so the HAL binds
+ *   its driver policy (motor_driver.h) and DeskApp its current-sense branch at
+ *   compile time
+ * - Builds that must switch drivers at runtime (host simulations with mixed
+ *   fleets) define DESK_MOTOR_RUNTIME_DISPATCH; MotorConfig_effectiveType() then
+ *   honours the runtime value
  * 
  * Encapsulation Benefits:
  * - Single point of control for motor type determination
@@ -46,6 +54,31 @@ typedef enum
     MT_ROBUST = 1u      ///< IBT_2 Intelligent Motor Driver
 } MotorType_t;
 
+/**
+ * @brief Build-time motor driver selection (MOTOR_TYPE, default MT_BASIC)
+ */
+#ifndef MOTOR_TYPE
+#define MOTOR_TYPE MT_BASIC
+#endif
+static const MotorType_t MOTOR_CONFIG_BUILD_TYPE = MOTOR_TYPE;
+
+/**
+ * @brief Motor type a component must act on
+ *
+ * @param runtime_type - Type reported at runtime (HAL_setMotorType(), AppInput_t)
+ * @return MotorType_t - runtime_type with DESK_MOTOR_RUNTIME_DISPATCH, otherwise
+ *         the constant MOTOR_CONFIG_BUILD_TYPE, so branches on it fold away
+ */
+static inline MotorType_t MotorConfig_effectiveType(MotorType_t runtime_type)
+{
+#ifdef DESK_MOTOR_RUNTIME_DISPATCH
+    return runtime_type;
+#else
+    (void)runtime_type;
+    return MOTOR_CONFIG_BUILD_TYPE;
+#endif
+}
+
 // ============================================================================
 // MOTOR DRIVER FEATURE MATRIX
 // ============================================================================
@@ -11,12 +11,14 @@
  * 1. **Linear PWM Ramping**: pwm(t) = min(target × t / T_ramp, target)
  * 2. **Direction Change Detection**: Reset ramp timers when cmd_dir ≠ last_dir
  * 3. **Stall Detection**: Fault if (pwm ≤ MIN_ACTIVE_PWM) for > STALL_TIMEOUT_MS
+ * 4. **Soft Stop**: pwm(t) = start × (1 - f(t / T_stop)) on MOTOR_STOP_SOFT, immediate otherwise
  * 
  * @state_variables
  * - last_dir: Previous direction (for change detection)
  * - dir_start_time: Timestamp when current direction started (for ramping)
  * - last_update_time: Timestamp of most recent update (unused, reserved for future)
  * - low_pwm_start_time: Timestamp when PWM dropped below threshold (for stall detection)
+ * - last_pwm, stop_dir, stop_start_pwm, stop_start_time: soft stop in progress
  * 
  * @constants_rationale
  * - RAMP_TIME_MS (500 ms): Balances smooth acceleration vs. stroke time performance
@@ -25,7 +27,8 @@
  * 
  * @requirements_coverage
  * - SysReq-006 (Smooth Motion): RAMP_TIME_MS = 500 ms ensures < 0.5 g acceleration
- * - SysReq-003 (Motion Halt): MOTOR_STOP returns PWM=0 immediately (no ramp-down)
+ * - SysReq-003 (Motion Halt): MOTOR_STOP returns PWM=0 immediately (no ramp-down);
+ *   MOTOR_STOP_SOFT ramps down within STOP_RAMP_TIME_MS (200 ms)
  * - SysReq-010 (Fault Detection): STALL_TIMEOUT_MS enables mechanical failure detection
  * 
  * @version 1.0
@@ -33,6 +36,7 @@
  */
 
 #include "motor_controller.h"
+#include <stddef.h>  // For NULL definition
 
 // ============================================================================
 // CONFIGURATION CONSTANTS
@@ -53,6 +57,31 @@
  */
 static const uint32_t RAMP_TIME_MS = 500U;
 
+/**
+ * @brief Fixed-point reciprocal of RAMP_TIME_MS for the ramp table position
+ * 
+ * position_q8 = (elapsed_ms × RAMP_POSITION_SCALE) >> RAMP_POSITION_SHIFT
+ *             ≈ elapsed_ms × (RAMP_TABLE_SEGMENTS << 8) / RAMP_TIME_MS
+ * Rounded down so the position never reaches the last segment before RAMP_TIME_MS.
+ */
+static const uint32_t RAMP_POSITION_SHIFT = 16U;
+static const uint32_t RAMP_POSITION_SCALE =
+    ((static_cast<uint32_t>(RAMP_TABLE_SEGMENTS) << RAMP_TABLE_FRAC_BITS) << RAMP_POSITION_SHIFT) / RAMP_TIME_MS;
+
+/**
+ * @brief Soft-stop ramp-down duration (last PWM → 0) for MOTOR_STOP_SOFT
+ * 
+ * @rationale
+ * - Long enough to take the step out of an ordinary stop (worm-gear shock,
+ *   back-EMF current spike)
+ * - Short enough that release detection (20 ms debounce + 1 ms motor sub-task)
+ *   plus the ramp-down stays far inside the SysReq-003 500 ms halt budget
+ * - Extra travel at full speed: ≤ 57 mm/s × 0.2 s / 2 ≈ 6 mm (linear profile)
+ */
+static const uint32_t STOP_RAMP_TIME_MS = 200U;
+static const uint32_t STOP_POSITION_SCALE =
+    ((static_cast<uint32_t>(RAMP_TABLE_SEGMENTS) << RAMP_TABLE_FRAC_BITS) << RAMP_POSITION_SHIFT) / STOP_RAMP_TIME_MS;
+
 /**
  * @brief Stall detection timeout (motor stuck at low PWM)
  * 
@@ -77,50 +106,22 @@ static const uint8_t MIN_ACTIVE_PWM = 10U;
 // MODULE STATE VARIABLES (static/private)
 // ============================================================================
 
-// ============================================================================
-// MODULE STATE VARIABLES (static/private)
-// ============================================================================
-
-/**
- * @brief Last commanded direction (for change detection)
- * 
- * Initialized to MOTOR_STOP (safe initial state).
- * Updated on every direction change to enable ramp reset logic.
- */
-static MotorDirection_t last_dir = MOTOR_STOP;
-
 /**
- * @brief Timestamp when current direction started (milliseconds)
- * 
- * Used to calculate elapsed time for PWM ramping:
- * - elapsed_ms = now_ms - dir_start_time
- * - pwm(t) = target × elapsed_ms / RAMP_TIME_MS
- * 
- * Reset to current time on every direction change.
+ * @brief Default instance behind MotorController_init()/MotorController_update()
+ * 
+ * Field semantics (see MotorControllerContext_t):
+ * - last_dir: initialized to MOTOR_STOP; updated on every direction change (ramp reset)
+ * - dir_start_time: ramp origin, elapsed_ms = now_ms - dir_start_time
+ * - last_update_time: reserved for future use (e.g., watchdog timeout detection)
+ * - low_pwm_start_time: stall timer, reset when PWM rises above MIN_ACTIVE_PWM,
+ *   on direction change and on MOTOR_STOP
  */
-static uint32_t dir_start_time = 0U;
+static DESK_THREAD_LOCAL MotorControllerContext_t default_context = {MOTOR_STOP, 0U, 0U, 0U, 0U, MOTOR_STOP, 0U, 0U};
 
 /**
- * @brief Timestamp of most recent update call (milliseconds)
- * 
- * Reserved for future use (e.g., watchdog timeout detection).
- * Currently unused in algorithm.
+ * @brief Ramp shape shared by all instances (configuration, not reset by init)
  */
-static uint32_t last_update_time = 0U;
-
-/**
- * @brief Timestamp when PWM first dropped below MIN_ACTIVE_PWM (milliseconds)
- * 
- * Used for stall detection:
- * - If (pwm ≤ MIN_ACTIVE_PWM) for (now_ms - low_pwm_start_time) > STALL_TIMEOUT_MS:
- *   → Set fault flag (motor stalled)
- * 
- * Reset to current time when:
- * - PWM rises above MIN_ACTIVE_PWM (normal operation resumed)
- * - Direction changes (new ramp starts)
- * - Motor stops (MOTOR_STOP command)
- */
-static uint32_t low_pwm_start_time = 0U;
+static DESK_THREAD_LOCAL RampProfile_t ramp_profile = RAMP_PROFILE_DEFAULT;
 
 // ============================================================================
 // PUBLIC FUNCTIONS
@@ -135,17 +136,32 @@ static uint32_t low_pwm_start_time = 0U;
  * - No active ramp (dir_start_time = 0)
  * - No update history (last_update_time = 0)
  * - No stall detection active (low_pwm_start_time = 0)
+ * - No soft stop in progress (stop_dir = MOTOR_STOP, last_pwm = 0)
  * 
  * @safety_critical
  * MUST be called during system initialization before any update calls.
  * Ensures predictable behavior from power-on state.
  */
+void MotorController_initCtx(MotorControllerContext_t *ctx)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    ctx->last_dir = MOTOR_STOP;
+    ctx->dir_start_time = 0U;
+    ctx->last_update_time = 0U;
+    ctx->low_pwm_start_time = 0U;
+    ctx->last_pwm = 0U;
+    ctx->stop_dir = MOTOR_STOP;
+    ctx->stop_start_pwm = 0U;
+    ctx->stop_start_time = 0U;
+}
+
 void MotorController_init(void)
 {
-    last_dir = MOTOR_STOP;
-    dir_start_time = 0U;
-    last_update_time = 0U;
-    low_pwm_start_time = 0U;
+    MotorController_initCtx(&default_context);
 }
 
 // ============================================================================
@@ -157,7 +173,18 @@ void MotorController_init(void)
 // ============================================================================
 
 /**
- * @brief Calculate ramped PWM value using linear interpolation
+ * @brief Ramp profile value f(t / T) in Q15 for a compile-time reciprocal of T
+ * 
+ * Time -> table position by multiply + shift: position_scale = (64 << 8 << 16) / T
+ */
+static uint16_t profile_fraction(uint32_t elapsed_ms, uint32_t position_scale)
+{
+    const uint16_t position_q8 = static_cast<uint16_t>((elapsed_ms * position_scale) >> RAMP_POSITION_SHIFT);
+    return RampProfile_lookup(ramp_profile, position_q8);
+}
+
+/**
+ * @brief Calculate ramped PWM value from the selected ramp profile table
  * 
  * @param target_pwm - Final target PWM value (0-255)
  * @param elapsed_ms - Time elapsed since ramp started (milliseconds)
@@ -165,37 +192,37 @@ void MotorController_init(void)
  * @return uint8_t - Ramped PWM value (0-255)
  * 
  * @algorithm
- * Linear ramp function:
- *   pwm(t) = min(target × t / T_ramp, target)
+ * Table-driven ramp (see ramp_profile.h):
+ *   pwm(t) = target × f(t / T_ramp)          for t < T_ramp
+ *   pwm(t) = target                          for t ≥ T_ramp
  * 
- * Where:
- *   t = elapsed_ms (time since ramp start)
- *   T_ramp = RAMP_TIME_MS (500 ms)
- *   target = target_pwm (0-255)
+ * Fixed-point evaluation (no division at runtime):
+ *   position_q8 = (t × RAMP_POSITION_SCALE) >> RAMP_POSITION_SHIFT   (table segments, Q8)
+ *   f_q15       = RampProfile_lookup(profile, position_q8)
+ *   pwm         = (target × f_q15) >> 15
  * 
  * @example
  * ```
- * target_pwm = 255, RAMP_TIME_MS = 500 ms:
- *   t=0 ms:   pwm = (255 × 0) / 500 = 0
- *   t=100 ms: pwm = (255 × 100) / 500 = 51
- *   t=250 ms: pwm = (255 × 250) / 500 = 127.5 → 127
- *   t=500 ms: pwm = (255 × 500) / 500 = 255 (ramp complete)
+ * target_pwm = 255, RAMP_TIME_MS = 500 ms, RAMP_PROFILE_LINEAR:
+ *   t=0 ms:   pwm = 0
+ *   t=100 ms: pwm = 50 (51.0 exact, rounded down by the table interpolation)
+ *   t=250 ms: pwm = 127
+ *   t=500 ms: pwm = 255 (ramp complete)
  *   t>500 ms: pwm = 255 (clamped at target)
  * ```
  * 
  * @rationale
- * - Linear ramp: Simple, predictable, smooth acceleration
- * - Integer math: Avoids floating-point overhead on microcontroller
- * - Early exit: target=0 or elapsed≥T_ramp optimizations for efficiency
+ * - Division-free: one 32-bit multiply for the position, one 16x8 multiply
+ *   for interpolation, one for scaling (a 32-bit divide costs ~600 cycles on AVR)
+ * - Result never exceeds target_pwm (f ≤ 1.0 in Q15)
  * 
  * @overflow_protection
- * Cast to uint32_t before multiplication prevents overflow:
- *   Max value: 255 × 4,294,967,295 ms = fits in uint32_t before division
+ * elapsed_ms < RAMP_TIME_MS here, so elapsed_ms × RAMP_POSITION_SCALE < 2^31
  * 
  * @edge_cases
- * - target_pwm = 0: Returns 0 immediately (no division by zero)
+ * - target_pwm = 0: Returns 0 immediately
  * - elapsed_ms ≥ RAMP_TIME_MS: Returns target_pwm (ramp complete)
- * - elapsed_ms = 0: Returns 0 (ramp just started)
+ * - elapsed_ms = 0: Returns 0 (every profile starts at f(0) = 0)
  */
 static uint8_t ramp_pwm(uint8_t target_pwm, uint32_t elapsed_ms)
 {
@@ -211,15 +238,57 @@ static uint8_t ramp_pwm(uint8_t target_pwm, uint32_t elapsed_ms)
         return target_pwm;
     }
     
-    // Linear interpolation: pwm(t) = target × (t / T_ramp)
-    // Rearranged for integer math: pwm(t) = (target × t) / T_ramp
-    // Widen to uint32_t to prevent overflow during multiplication
-    const uint32_t scaled = (static_cast<uint32_t>(target_pwm) * elapsed_ms) / RAMP_TIME_MS;
-    
-    // Cast back to uint8_t (safe: result ≤ target_pwm ≤ 255)
+    // Scale to target (safe: fraction ≤ 1.0, result ≤ target_pwm ≤ 255)
+    const uint16_t fraction_q15 = profile_fraction(elapsed_ms, RAMP_POSITION_SCALE);
+    const uint32_t scaled = (static_cast<uint32_t>(target_pwm) * fraction_q15) >> 15U;
     return static_cast<uint8_t>(scaled);
 }
 
+/**
+ * @brief Calculate soft-stop PWM: the soft-start profile mirrored over STOP_RAMP_TIME_MS
+ * 
+ *   pwm(t) = start × (1 - f(t / T_stop))     for t < T_stop
+ *   pwm(t) = 0                               for t ≥ T_stop
+ * 
+ * @overflow_protection
+ * elapsed_ms < STOP_RAMP_TIME_MS here, so elapsed_ms × STOP_POSITION_SCALE < 2^31
+ */
+static uint8_t stop_pwm(uint8_t start_pwm, uint32_t elapsed_ms)
+{
+    if ((start_pwm == 0U) || (elapsed_ms >= STOP_RAMP_TIME_MS))
+    {
+        return 0U;
+    }
+
+    const uint16_t fraction_q15 = profile_fraction(elapsed_ms, STOP_POSITION_SCALE);
+    const uint32_t removed = (static_cast<uint32_t>(start_pwm) * fraction_q15) >> 15U;
+    return static_cast<uint8_t>(start_pwm - removed);
+}
+
+uint8_t MotorController_rampPwm(uint8_t target_pwm, uint32_t elapsed_ms)
+{
+    return ramp_pwm(target_pwm, elapsed_ms);
+}
+
+uint8_t MotorController_stopPwm(uint8_t start_pwm, uint32_t elapsed_ms)
+{
+    return stop_pwm(start_pwm, elapsed_ms);
+}
+
+void MotorController_setRampProfile(RampProfile_t profile)
+{
+    // Invalid values keep the current shape
+    if (profile < RAMP_PROFILE_COUNT)
+    {
+        ramp_profile = profile;
+    }
+}
+
+RampProfile_t MotorController_getRampProfile(void)
+{
+    return ramp_profile;
+}
+
 /**
  * @brief Main update function - processes command and returns ramped output
  * 
@@ -238,6 +307,8 @@ static uint8_t ramp_pwm(uint8_t target_pwm, uint32_t elapsed_ms)
  * - If cmd_dir == MOTOR_STOP: Return PWM=0 immediately (no ramp-down)
  * - Reset low_pwm_start_time (no stall detection during intentional stop)
  * - Rationale: Emergency halt requires instant response (SysReq-003: < 500 ms)
+ * - MOTOR_STOP_SOFT after motion: keep the previous direction while stop_pwm()
+ *   ramps down from last_pwm; ends at MIN_ACTIVE_PWM or STOP_RAMP_TIME_MS
  * 
  * **Step 4: Active Motion Processing**
  * - Calculate elapsed time: Δt = now_ms - dir_start_time
@@ -266,31 +337,52 @@ static uint8_t ramp_pwm(uint8_t target_pwm, uint32_t elapsed_ms)
  *      +--pwm≤10 for >2s--> [FAULT]
  * ```
  */
-MotorControllerOutput_t MotorController_update(MotorDirection_t cmd_dir, uint8_t target_pwm, uint32_t now_ms)
+MotorControllerOutput_t MotorController_updateStopCtx(MotorControllerContext_t *ctx, MotorDirection_t cmd_dir, uint8_t target_pwm, MotorStopMode_t stop_mode, uint32_t now_ms)
 {
     // Step 1: Initialize output structure with safe defaults
     MotorControllerOutput_t out = {};
     out.dir = cmd_dir;      // Echo commanded direction
     out.pwm = 0U;           // Default to stopped (will be overridden below)
     out.fault = false;      // Assume no fault unless detected
+    out.phase = MOTOR_PHASE_IDLE;
+
+    if (ctx == NULL)
+    {
+        out.dir = MOTOR_STOP;
+        return out;
+    }
+
+    // Soft stop bookkeeping (before direction change detection overwrites last_dir)
+    // Only an ordinary stop of a driven motor ramps down; anything else cancels a ramp-down
+    const bool soft_stop = (cmd_dir == MOTOR_STOP) && (stop_mode == MOTOR_STOP_SOFT);
+    if (!soft_stop)
+    {
+        ctx->stop_dir = MOTOR_STOP;
+    }
+    else if ((ctx->stop_dir == MOTOR_STOP) && (ctx->last_dir != MOTOR_STOP) && (ctx->last_pwm > MIN_ACTIVE_PWM))
+    {
+        ctx->stop_dir = ctx->last_dir;
+        ctx->stop_start_pwm = ctx->last_pwm;
+        ctx->stop_start_time = now_ms;
+    }
 
     // Step 2: Direction Change Detection
     // If direction changed (including transitions to/from STOP), reset ramp timers
-    if (cmd_dir != last_dir)
+    if (cmd_dir != ctx->last_dir)
     {
-        dir_start_time = now_ms;       // Start new ramp from t=0
-        low_pwm_start_time = now_ms;   // Reset stall detection timer
-        last_dir = cmd_dir;            // Update last direction for next comparison
+        ctx->dir_start_time = now_ms;       // Start new ramp from t=0
+        ctx->low_pwm_start_time = now_ms;   // Reset stall detection timer
+        ctx->last_dir = cmd_dir;            // Update last direction for next comparison
         // SAFETY: This prevents high PWM in opposite direction immediately after reversal
     }
 
     // Step 2: Direction Change Detection
     // If direction changed (including transitions to/from STOP), reset ramp timers
-    if (cmd_dir != last_dir)
+    if (cmd_dir != ctx->last_dir)
     {
-        dir_start_time = now_ms;       // Start new ramp from t=0
-        low_pwm_start_time = now_ms;   // Reset stall detection timer
-        last_dir = cmd_dir;            // Update last direction for next comparison
+        ctx->dir_start_time = now_ms;       // Start new ramp from t=0
+        ctx->low_pwm_start_time = now_ms;   // Reset stall detection timer
+        ctx->last_dir = cmd_dir;            // Update last direction for next comparison
         // SAFETY: This prevents high PWM in opposite direction immediately after reversal
     }
 
@@ -300,20 +392,40 @@ MotorControllerOutput_t MotorController_update(MotorDirection_t cmd_dir, uint8_t
         // Immediate halt: No ramping down (emergency stop requirement)
         out.dir = MOTOR_STOP;
         out.pwm = 0U;  // PWM=0 immediately (no delay)
-        low_pwm_start_time = now_ms;  // Reset stall timer (intentional stop, not stall)
+        ctx->low_pwm_start_time = now_ms;  // Reset stall timer (intentional stop, not stall)
         // SAFETY: SysReq-003 requires motion halt < 500 ms; instant PWM=0 ensures compliance
+
+        // Soft stop: keep driving the previous direction while PWM ramps down
+        if (ctx->stop_dir != MOTOR_STOP)
+        {
+            const uint8_t decel_pwm = stop_pwm(ctx->stop_start_pwm, now_ms - ctx->stop_start_time);
+            if (decel_pwm > MIN_ACTIVE_PWM)
+            {
+                out.dir = ctx->stop_dir;
+                out.pwm = decel_pwm;
+                out.phase = MOTOR_PHASE_RAMP_DOWN;
+            }
+            else
+            {
+                ctx->stop_dir = MOTOR_STOP;  // Ramp-down complete: motor no longer turns below MIN_ACTIVE_PWM
+            }
+        }
     }
     else
     {
         // Step 4: Active Motion Processing (UP or DOWN command)
         
         // Calculate time elapsed since ramp started
-        const uint32_t elapsed = now_ms - dir_start_time;
+        const uint32_t elapsed = now_ms - ctx->dir_start_time;
         
         // Apply soft-start ramping algorithm
         const uint8_t effective_pwm = ramp_pwm(target_pwm, elapsed);
         out.pwm = effective_pwm;
-        // Result: PWM ramps linearly from 0→target over RAMP_TIME_MS (500 ms)
+        if (effective_pwm > 0U)
+        {
+            out.phase = (elapsed < RAMP_TIME_MS) ? MOTOR_PHASE_RAMP_UP : MOTOR_PHASE_CRUISE;
+        }
+        // Result: PWM follows the selected ramp profile from 0→target over RAMP_TIME_MS (500 ms)
         // This implements SysReq-006 smooth motion requirement
 
         // Step 5: Stall Detection Logic
@@ -322,13 +434,13 @@ MotorControllerOutput_t MotorController_update(MotorDirection_t cmd_dir, uint8_t
             // PWM is below active threshold - motor may be stalled
             
             // Start stall timer if not already running
-            if (low_pwm_start_time == 0U)
+            if (ctx->low_pwm_start_time == 0U)
             {
-                low_pwm_start_time = now_ms;  // Begin tracking low-PWM duration
+                ctx->low_pwm_start_time = now_ms;  // Begin tracking low-PWM duration
             }
             
             // Check if motor has been stuck at low PWM for too long
-            const uint32_t low_elapsed = now_ms - low_pwm_start_time;
+            const uint32_t low_elapsed = now_ms - ctx->low_pwm_start_time;
             if (low_elapsed >= STALL_TIMEOUT_MS)
             {
                 // Fault detected: Motor commanded to move but PWM remains low
@@ -340,13 +452,29 @@ MotorControllerOutput_t MotorController_update(MotorDirection_t cmd_dir, uint8_t
         else
         {
             // PWM above threshold - motor operating normally
-            low_pwm_start_time = now_ms;  // Reset stall timer (no fault condition)
+            ctx->low_pwm_start_time = now_ms;  // Reset stall timer (no fault condition)
         }
     }
 
     // Step 6: Update State & Return
-    last_update_time = now_ms;  // Record timestamp (reserved for future watchdog use)
+    ctx->last_update_time = now_ms;  // Record timestamp (reserved for future watchdog use)
+    ctx->last_pwm = out.pwm;         // Starting point for a soft stop
     return out;
     // Output contains: ramped PWM, effective direction, fault status
     // Caller (typically DeskApp) passes this to HAL for physical motor control
 }
+
+MotorControllerOutput_t MotorController_updateCtx(MotorControllerContext_t *ctx, MotorDirection_t cmd_dir, uint8_t target_pwm, uint32_t now_ms)
+{
+    return MotorController_updateStopCtx(ctx, cmd_dir, target_pwm, MOTOR_STOP_IMMEDIATE, now_ms);
+}
+
+MotorControllerOutput_t MotorController_update(MotorDirection_t cmd_dir, uint8_t target_pwm, uint32_t now_ms)
+{
+    return MotorController_updateStopCtx(&default_context, cmd_dir, target_pwm, MOTOR_STOP_IMMEDIATE, now_ms);
+}
+
+MotorControllerOutput_t MotorController_updateStop(MotorDirection_t cmd_dir, uint8_t target_pwm, MotorStopMode_t stop_mode, uint32_t now_ms)
+{
+    return MotorController_updateStopCtx(&default_context, cmd_dir, target_pwm, stop_mode, now_ms);
+}
@@ -59,7 +59,7 @@
  * // Initialization (once at startup)
  * MotorController_init();
  * 
- * // Periodic update (e.g., every 250 ms in main loop)
+ * // Periodic update (every 1 ms from the DeskControl motor sub-task)
  * MotorDirection_t desired_dir = MOTOR_UP;
  * uint8_t target_speed = 255; // full speed
  * uint32_t current_time_ms = HAL_get_time_ms();
@@ -85,6 +85,8 @@
  * - TC-MC-RAMP-001: PWM ramps 0→255 over 500 ms
  * - TC-MC-RAMP-002: Direction change resets ramp
  * - TC-MC-STOP-001: Stop command → PWM=0 immediately
+ * - TC-MC-STOP-002: Soft stop ramps PWM down within STOP_RAMP_TIME_MS
+ * - TC-MC-STOP-003: Immediate stop overrides a soft stop in progress
  * - TC-MC-TARGET-001: Variable target PWM (0-255 range)
  * 
  * @version 1.0
@@ -95,11 +97,27 @@
 #define MOTOR_CONTROLLER_H
 
 #include "desk_types.h"
+#include "ramp_profile.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @enum MotorStopMode_t
+ * @brief How a MOTOR_STOP command removes drive
+ * 
+ * - MOTOR_STOP_IMMEDIATE: PWM=0 on the same update (faults, limits, conflicts)
+ * - MOTOR_STOP_SOFT: PWM ramps down from its last value over at most
+ *   STOP_RAMP_TIME_MS in the direction of travel (ordinary button release);
+ *   reduces worm-gear shock and the current spike of an abrupt stop
+ */
+typedef enum
+{
+    MOTOR_STOP_IMMEDIATE = 0,
+    MOTOR_STOP_SOFT = 1
+} MotorStopMode_t;
+
 /**
  * @struct MotorControllerOutput_t
  * @brief Output structure containing ramped motor control signals
@@ -107,6 +125,7 @@ extern "C" {
  * @field dir - Effective motor direction (MOTOR_UP, MOTOR_DOWN, MOTOR_STOP)
  * @field pwm - Ramped PWM duty cycle (0-255, where 0=stopped, 255=full speed)
  * @field fault - Fault detection flag (true=stall/error detected, false=normal operation)
+ * @field phase - Ramp phase of the output (soft-start, cruise, soft stop) for current sensing
  * 
  * @notes
  * - PWM value is AFTER ramping (not raw target value)
@@ -118,8 +137,38 @@ typedef struct
     MotorDirection_t dir;  ///< Motor direction command (post-processing)
     uint8_t pwm;           ///< Ramped PWM value (0-255)
     bool fault;            ///< Fault detection: true=stall/error, false=normal
+    MotorRampPhase_t phase;  ///< MOTOR_PHASE_IDLE whenever pwm is 0
 } MotorControllerOutput_t;
 
+/**
+ * @struct MotorControllerContext_t
+ * @brief Complete state of one motor controller instance
+ * 
+ * @field last_dir - Previous commanded direction (for change detection)
+ * @field dir_start_time - Timestamp when the current direction started (ramp origin, ms)
+ * @field last_update_time - Timestamp of the most recent update (reserved for watchdog use)
+ * @field low_pwm_start_time - Timestamp when PWM dropped to/below MIN_ACTIVE_PWM (stall timer)
+ * @field last_pwm - PWM of the most recent output (soft stop starting point)
+ * @field stop_dir - Direction still driven by a soft stop (MOTOR_STOP = none in progress)
+ * @field stop_start_pwm - PWM when the soft stop began
+ * @field stop_start_time - Timestamp when the soft stop began (ms)
+ * 
+ * @notes
+ * - MotorController_init()/MotorController_update() operate on a module-internal default instance
+ * - The *Ctx variants let callers own any number of independent instances
+ */
+typedef struct
+{
+    MotorDirection_t last_dir;
+    uint32_t dir_start_time;
+    uint32_t last_update_time;
+    uint32_t low_pwm_start_time;
+    uint8_t last_pwm;
+    MotorDirection_t stop_dir;
+    uint8_t stop_start_pwm;
+    uint32_t stop_start_time;
+} MotorControllerContext_t;
+
 /**
  * @brief Initialize motor controller signal processing module
  * 
@@ -157,6 +206,7 @@ void MotorController_init(void);
  * 2. **Stop Command Handling:**
  *    - If cmd_dir == MOTOR_STOP: Return PWM=0 immediately (no ramp-down)
  *    - Rationale: Emergency halt requires instant response (SysReq-003: < 500 ms)
+ *    - Controlled ramp-down for ordinary stops: MotorController_updateStop()
  * 
  * 3. **Active Motion Ramping:**
  *    - Calculate elapsed time since direction start: Δt = now_ms - dir_start_time
@@ -174,7 +224,7 @@ void MotorController_init(void);
  * 
  * @timing
  * - Ramp duration: 500 ms (RAMP_TIME_MS constant)
- * - Update frequency: Typically 4 Hz (250 ms per DeskApp loop)
+ * - Update frequency: 1 kHz (DeskControl_FastTask), plus once per 250 ms control cycle
  * - Stall timeout: 2000 ms (STALL_TIMEOUT_MS constant)
  * 
  * @safety_critical
@@ -200,6 +250,69 @@ void MotorController_init(void);
  */
 MotorControllerOutput_t MotorController_update(MotorDirection_t cmd_dir, uint8_t target_pwm, uint32_t now_ms);
 
+/**
+ * @brief Re-entrant variants operating on a caller-owned context
+ * 
+ * Identical behavior to MotorController_init()/MotorController_update() on the
+ * given instance. A NULL ctx is ignored (update returns a stopped output).
+ */
+void MotorController_initCtx(MotorControllerContext_t *ctx);
+MotorControllerOutput_t MotorController_updateCtx(MotorControllerContext_t *ctx, MotorDirection_t cmd_dir, uint8_t target_pwm, uint32_t now_ms);
+
+/**
+ * @brief Update with an explicit stop mode (soft stop for ordinary releases)
+ * 
+ * Same as MotorController_update() except for MOTOR_STOP with MOTOR_STOP_SOFT:
+ * if the motor was driven on the previous update, the output keeps that
+ * direction and the PWM falls from its last value to 0 along the selected
+ * ramp profile, mirrored, within STOP_RAMP_TIME_MS (200 ms). The ramp-down ends
+ * early once PWM falls to MIN_ACTIVE_PWM, since the motor no longer turns there.
+ * 
+ * - Repeated soft STOP commands continue the ramp-down already in progress
+ * - MOTOR_STOP_IMMEDIATE cancels it: PWM=0 on the same update
+ * - A new UP/DOWN command cancels it and starts a fresh soft-start ramp from 0
+ * - No stall detection while ramping down (intentional stop)
+ * 
+ * @requirements
+ * - SysReq-003: halt < 500 ms - the ramp-down adds at most STOP_RAMP_TIME_MS to
+ *   release detection; the caller must keep detection + ramp-down under the budget
+ * - SysReq-006: smooth motion also when stopping
+ * 
+ * @safety_critical
+ * Faults, limit switches and conflicting inputs MUST use MOTOR_STOP_IMMEDIATE.
+ * The caller also owns limit protection while a soft stop still drives the
+ * motor (output dir ≠ MOTOR_STOP).
+ */
+MotorControllerOutput_t MotorController_updateStop(MotorDirection_t cmd_dir, uint8_t target_pwm, MotorStopMode_t stop_mode, uint32_t now_ms);
+MotorControllerOutput_t MotorController_updateStopCtx(MotorControllerContext_t *ctx, MotorDirection_t cmd_dir, uint8_t target_pwm, MotorStopMode_t stop_mode, uint32_t now_ms);
+
+/**
+ * @brief Soft-start ramp profile used by MotorController_update()
+ * 
+ * Pure function of the selected ramp profile: PWM after elapsed_ms of a ramp
+ * towards target_pwm (0 at elapsed_ms = 0, target_pwm from RAMP_TIME_MS on).
+ * Exposed for benchmarks and profile checks; no state is touched.
+ */
+uint8_t MotorController_rampPwm(uint8_t target_pwm, uint32_t elapsed_ms);
+
+/**
+ * @brief Soft-stop profile: PWM after elapsed_ms of a ramp-down from start_pwm
+ * 
+ * Mirror of the soft-start ramp over STOP_RAMP_TIME_MS (start_pwm at
+ * elapsed_ms = 0, 0 from STOP_RAMP_TIME_MS on). Pure function, no state.
+ */
+uint8_t MotorController_stopPwm(uint8_t start_pwm, uint32_t elapsed_ms);
+
+/**
+ * @brief Select the soft-start ramp shape (ramp_profile.h)
+ * 
+ * The soft stop uses the same shape, mirrored. Applies to every instance from the next update on. Configuration, not state:
+ * MotorController_init() does not reset it. Invalid values are ignored.
+ * Default: RAMP_PROFILE_DEFAULT (linear).
+ */
+void MotorController_setRampProfile(RampProfile_t profile);
+RampProfile_t MotorController_getRampProfile(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,247 @@
+/**
+ * @file motor_driver.h
+ * @brief Motor driver policies: L298N (MT_BASIC) and IBT_2 (MT_ROBUST)
+ *
+ * @purpose
+ * Each driver is a stateless policy type with the same static interface, so
+ * the HAL can bind the build's driver at compile time
+ * (MotorDriverFor<MOTOR_CONFIG_BUILD_TYPE>::Type): every call inlines into a
+ * few port / OCR stores and the other driver's code is never emitted.
+ * Builds defining DESK_MOTOR_RUNTIME_DISPATCH select the policy per call from
+ * HAL_setMotorType() instead (host simulations with mixed fleets).
+ *
+ * @interface (all static)
+ * - TYPE: MotorType_t served by the policy
+ * - HAS_CURRENT_SENSE: true if readCurrentMa() measures the motor current
+ * - init(): configure pins, motor stopped
+ * - set(dir, speed): apply direction and PWM duty (0-255), writing every pin
+ * - update(from_dir, from_speed, to_dir, to_speed): move from the applied state
+ *   to a new one writing only the pins that change, in a glitch-free order
+ *   (speed is 0 for MOTOR_STOP; the caller skips identical states)
+ * - readCurrentMa(): motor current in mA (0 without current sensing), non-blocking
+ *
+ * @note Internal to hal.cpp; include after the HAL pin and port headers
+ */
+
+#ifndef MOTOR_DRIVER_H
+#define MOTOR_DRIVER_H
+
+#include <stdint.h>
+#include "adc_sampler.h"
+#include "desk_types.h"
+#include "motor_config.h"
+#include "pin_config.h"
+#include "port_io.h"
+#include "safety_config.h"
+
+/**
+ * @brief L298N dual H-bridge: direction via EN1/EN2, speed via PWM
+ */
+struct L298NDriver
+{
+    static constexpr MotorType_t TYPE = MT_BASIC;
+    static constexpr bool HAS_CURRENT_SENSE = false;
+
+    static inline void init(void)
+    {
+        pinMode(PIN_MOTOR_EN1, OUTPUT);
+        pinMode(PIN_MOTOR_EN2, OUTPUT);
+        pinMode(PIN_MOTOR_PWM, OUTPUT);
+
+        // Safe defaults: Motor stopped
+        PortIO_writePin(PIN_MOTOR_EN1, false);
+        PortIO_writePin(PIN_MOTOR_EN2, false);
+        PortIO_enablePwm(PIN_MOTOR_PWM);
+    }
+
+    static inline void set(MotorDirection_t dir, uint8_t speed)
+    {
+        // Direction via EN1/EN2 (mutually exclusive), speed via PWM on PIN_MOTOR_PWM
+        switch (dir)
+        {
+            case MOTOR_STOP:
+            default:
+                PortIO_writePin(PIN_MOTOR_EN1, false);
+                PortIO_writePin(PIN_MOTOR_EN2, false);
+                PortIO_writePwm(PIN_MOTOR_PWM, 0U);
+                break;
+            case MOTOR_UP:
+                PortIO_writePin(PIN_MOTOR_EN1, true);
+                PortIO_writePin(PIN_MOTOR_EN2, false);
+                PortIO_writePwm(PIN_MOTOR_PWM, speed);
+                break;
+            case MOTOR_DOWN:
+                PortIO_writePin(PIN_MOTOR_EN1, false);
+                PortIO_writePin(PIN_MOTOR_EN2, true);
+                PortIO_writePwm(PIN_MOTOR_PWM, speed);
+                break;
+        }
+    }
+
+    static inline void update(MotorDirection_t from_dir, uint8_t from_speed,
+                              MotorDirection_t to_dir, uint8_t to_speed)
+    {
+        // Release the enable that turns off first: drive is removed before the duty changes
+        if ((from_dir == MOTOR_UP) && (to_dir != MOTOR_UP))
+        {
+            PortIO_writePin(PIN_MOTOR_EN1, false);
+        }
+        if ((from_dir == MOTOR_DOWN) && (to_dir != MOTOR_DOWN))
+        {
+            PortIO_writePin(PIN_MOTOR_EN2, false);
+        }
+        if (from_speed != to_speed)
+        {
+            PortIO_writePwm(PIN_MOTOR_PWM, to_speed);
+        }
+        // Assert the new enable last: it never sees the old duty or the opposite enable
+        if ((to_dir == MOTOR_UP) && (from_dir != MOTOR_UP))
+        {
+            PortIO_writePin(PIN_MOTOR_EN1, true);
+        }
+        if ((to_dir == MOTOR_DOWN) && (from_dir != MOTOR_DOWN))
+        {
+            PortIO_writePin(PIN_MOTOR_EN2, true);
+        }
+    }
+
+    static inline uint16_t readCurrentMa(void)
+    {
+        // PIN_MOTOR_SENSE not connected to a current sensor, return safe default
+        return 0U;
+    }
+};
+
+/**
+ * @brief IBT_2 driver: direction and speed via the LPWM / RPWM ratio, shunt current sense
+ */
+struct IBT2Driver
+{
+    static constexpr MotorType_t TYPE = MT_ROBUST;
+    static constexpr bool HAS_CURRENT_SENSE = true;
+
+    static inline void init(void)
+    {
+        pinMode(PIN_MOTOR_SENSE, INPUT);  // Integrated current sensing via shunt resistor
+        pinMode(PIN_MOTOR_LPWM, OUTPUT);
+        pinMode(PIN_MOTOR_RPWM, OUTPUT);
+
+        // Optional: Configure diagnostic input
+        pinMode(PIN_MOTOR_CIN, INPUT);
+
+        // Shunt current converted in the background (adc_sampler.h)
+        AdcSampler_init(static_cast<uint8_t>(PIN_MOTOR_SENSE - ADC_FIRST_PIN));
+
+        // Safe defaults: Motor stopped
+        PortIO_enablePwm(PIN_MOTOR_LPWM);
+        PortIO_enablePwm(PIN_MOTOR_RPWM);
+    }
+
+    static inline void set(MotorDirection_t dir, uint8_t speed)
+    {
+        // - UP:   LPWM=255 (full), RPWM=0   (ramp down as needed for speed)
+        // - DOWN: LPWM=0,   RPWM=255 (full, ramp down as needed for speed)
+        // - STOP: LPWM=0,   RPWM=0
+        switch (dir)
+        {
+            case MOTOR_STOP:
+            default:
+                PortIO_writePwm(PIN_MOTOR_LPWM, 0U);
+                PortIO_writePwm(PIN_MOTOR_RPWM, 0U);
+                break;
+            case MOTOR_UP:
+                // Left PWM high (counterclockwise = up), Right PWM for speed control
+                PortIO_writePwm(PIN_MOTOR_LPWM, 255U);
+                PortIO_writePwm(PIN_MOTOR_RPWM, static_cast<uint8_t>(255U - speed));
+                break;
+            case MOTOR_DOWN:
+                // Right PWM high (clockwise = down), Left PWM for speed control
+                PortIO_writePwm(PIN_MOTOR_LPWM, static_cast<uint8_t>(255U - speed));
+                PortIO_writePwm(PIN_MOTOR_RPWM, 255U);
+                break;
+        }
+    }
+
+    static inline void update(MotorDirection_t from_dir, uint8_t from_speed,
+                              MotorDirection_t to_dir, uint8_t to_speed)
+    {
+        uint8_t lpwm = lpwmDuty(from_dir, from_speed);
+        uint8_t rpwm = rpwmDuty(from_dir, from_speed);
+
+        if (from_dir != to_dir)
+        {
+            // Leave the old direction through STOP, speed side first: the intermediate
+            // state is full drive in the old direction, never drive in the opposite one
+            if (from_dir == MOTOR_UP)
+            {
+                writeDuty(PIN_MOTOR_RPWM, &rpwm, 0U);
+                writeDuty(PIN_MOTOR_LPWM, &lpwm, 0U);
+            }
+            else if (from_dir == MOTOR_DOWN)
+            {
+                writeDuty(PIN_MOTOR_LPWM, &lpwm, 0U);
+                writeDuty(PIN_MOTOR_RPWM, &rpwm, 0U);
+            }
+            // Enter the new direction driving side first, for the same reason
+            if (to_dir == MOTOR_UP)
+            {
+                writeDuty(PIN_MOTOR_LPWM, &lpwm, 255U);
+            }
+            else if (to_dir == MOTOR_DOWN)
+            {
+                writeDuty(PIN_MOTOR_RPWM, &rpwm, 255U);
+            }
+        }
+        writeDuty(PIN_MOTOR_LPWM, &lpwm, lpwmDuty(to_dir, to_speed));
+        writeDuty(PIN_MOTOR_RPWM, &rpwm, rpwmDuty(to_dir, to_speed));
+    }
+
+    static inline uint16_t readCurrentMa(void)
+    {
+        // Latest filtered conversion: no busy-wait, one fixed-point multiply
+        return AdcSampler_toMilliamps(AdcSampler_filteredSum());
+    }
+
+private:
+    static inline uint8_t lpwmDuty(MotorDirection_t dir, uint8_t speed)
+    {
+        return (dir == MOTOR_UP) ? 255U : ((dir == MOTOR_DOWN) ? static_cast<uint8_t>(255U - speed) : 0U);
+    }
+
+    static inline uint8_t rpwmDuty(MotorDirection_t dir, uint8_t speed)
+    {
+        return (dir == MOTOR_DOWN) ? 255U : ((dir == MOTOR_UP) ? static_cast<uint8_t>(255U - speed) : 0U);
+    }
+
+    /**
+     * @brief Write a PWM pin only if its duty changes; *applied tracks the pin
+     */
+    static inline void writeDuty(uint8_t pin, uint8_t *applied, uint8_t duty)
+    {
+        if (*applied != duty)
+        {
+            PortIO_writePwm(pin, duty);
+            *applied = duty;
+        }
+    }
+};
+
+/**
+ * @brief Policy type for a motor type known at compile time
+ */
+template <MotorType_t type>
+struct MotorDriverFor;
+
+template <>
+struct MotorDriverFor<MT_BASIC>
+{
+    typedef L298NDriver Type;
+};
+
+template <>
+struct MotorDriverFor<MT_ROBUST>
+{
+    typedef IBT2Driver Type;
+};
+
+#endif // MOTOR_DRIVER_H
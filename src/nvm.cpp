@@ -0,0 +1,186 @@
+#include "nvm.h"
+#include "desk_types.h"
+#include <stddef.h>  // For NULL definition
+
+#ifndef TESTENVIRONMENT
+#include <avr/eeprom.h>
+#endif
+
+static const uint8_t RECORD_BYTES_MAX = static_cast<uint8_t>(NVM_MAX_PAYLOAD + NVM_RECORD_OVERHEAD);
+
+// Staged record: staging[0 .. staged_length) goes to staged_addr, one byte per NVM_service()
+static DESK_THREAD_LOCAL uint8_t staging[RECORD_BYTES_MAX];
+static DESK_THREAD_LOCAL uint16_t staged_addr = 0U;
+static DESK_THREAD_LOCAL uint8_t staged_length = 0U;
+static DESK_THREAD_LOCAL uint8_t staged_next = 0U;
+
+#ifdef TESTENVIRONMENT
+static DESK_THREAD_LOCAL uint8_t eeprom[NVM_SIZE];
+static DESK_THREAD_LOCAL uint32_t program_count = 0U;
+
+static uint8_t eeprom_read(uint16_t addr)
+{
+    return eeprom[addr];
+}
+
+static bool eeprom_ready(void)
+{
+    return true;
+}
+
+static void eeprom_program(uint16_t addr, uint8_t value)
+{
+    eeprom[addr] = value;
+    program_count++;
+}
+#else
+static uint8_t eeprom_read(uint16_t addr)
+{
+    return eeprom_read_byte(reinterpret_cast<const uint8_t *>(addr));
+}
+
+static bool eeprom_ready(void)
+{
+    return eeprom_is_ready() != 0;
+}
+
+static void eeprom_program(uint16_t addr, uint8_t value)
+{
+    // Starts the ~3.3 ms erase/write cycle and returns; eeprom_ready() gates the next byte
+    eeprom_write_byte(reinterpret_cast<uint8_t *>(addr), value);
+}
+#endif
+
+/**
+ * @brief Fletcher-16 over the record header and payload
+ */
+static uint16_t record_checksum(uint8_t id, uint8_t length, const uint8_t *payload)
+{
+    uint16_t sum1 = static_cast<uint16_t>(id % 255U);
+    uint16_t sum2 = sum1;
+    sum1 = static_cast<uint16_t>((sum1 + length) % 255U);
+    sum2 = static_cast<uint16_t>((sum2 + sum1) % 255U);
+    for (uint8_t i = 0U; i < length; i++)
+    {
+        sum1 = static_cast<uint16_t>((sum1 + payload[i]) % 255U);
+        sum2 = static_cast<uint16_t>((sum2 + sum1) % 255U);
+    }
+    return static_cast<uint16_t>((sum2 << 8) | sum1);
+}
+
+void NVM_init(void)
+{
+    staged_length = 0U;
+    staged_next = 0U;
+#ifdef TESTENVIRONMENT
+    for (uint16_t i = 0U; i < NVM_SIZE; i++)
+    {
+        eeprom[i] = 0xFFU;  // Erased cells
+    }
+    program_count = 0U;
+#endif
+}
+
+bool NVM_readRecord(uint16_t addr, uint8_t id, void *payload, uint8_t length)
+{
+    if ((payload == NULL) || (length > NVM_MAX_PAYLOAD) ||
+        ((static_cast<uint32_t>(addr) + length + NVM_RECORD_OVERHEAD) > NVM_SIZE))
+    {
+        return false;
+    }
+    if ((eeprom_read(addr) != id) || (eeprom_read(static_cast<uint16_t>(addr + 1U)) != length))
+    {
+        return false;
+    }
+
+    uint8_t buffer[NVM_MAX_PAYLOAD];
+    for (uint8_t i = 0U; i < length; i++)
+    {
+        buffer[i] = eeprom_read(static_cast<uint16_t>(addr + 2U + i));
+    }
+    const uint16_t checksum_addr = static_cast<uint16_t>(addr + 2U + length);
+    const uint16_t stored = static_cast<uint16_t>(eeprom_read(checksum_addr) |
+                                                  (eeprom_read(static_cast<uint16_t>(checksum_addr + 1U)) << 8));
+    if (stored != record_checksum(id, length, buffer))
+    {
+        return false;
+    }
+
+    uint8_t *out = static_cast<uint8_t *>(payload);
+    for (uint8_t i = 0U; i < length; i++)
+    {
+        out[i] = buffer[i];
+    }
+    return true;
+}
+
+bool NVM_writeRecord(uint16_t addr, uint8_t id, const void *payload, uint8_t length)
+{
+    if (NVM_busy() || (payload == NULL) || (length > NVM_MAX_PAYLOAD) ||
+        ((static_cast<uint32_t>(addr) + length + NVM_RECORD_OVERHEAD) > NVM_SIZE))
+    {
+        return false;
+    }
+
+    const uint8_t *in = static_cast<const uint8_t *>(payload);
+    staging[0] = id;
+    staging[1] = length;
+    for (uint8_t i = 0U; i < length; i++)
+    {
+        staging[2U + i] = in[i];
+    }
+    const uint16_t checksum = record_checksum(id, length, in);
+    staging[2U + length] = static_cast<uint8_t>(checksum & 0xFFU);
+    staging[3U + length] = static_cast<uint8_t>(checksum >> 8);
+
+    staged_addr = addr;
+    staged_length = static_cast<uint8_t>(length + NVM_RECORD_OVERHEAD);
+    staged_next = 0U;
+    return true;
+}
+
+void NVM_service(void)
+{
+    if (!NVM_busy() || !eeprom_ready())
+    {
+        return;
+    }
+
+    // Skip bytes that already hold their value; program the first one that differs
+    while (staged_next < staged_length)
+    {
+        const uint16_t addr = static_cast<uint16_t>(staged_addr + staged_next);
+        const uint8_t value = staging[staged_next];
+        staged_next++;
+        if (eeprom_read(addr) != value)
+        {
+            eeprom_program(addr, value);
+            break;
+        }
+    }
+}
+
+bool NVM_busy(void)
+{
+    return staged_next < staged_length;
+}
+
+#ifdef TESTENVIRONMENT
+uint32_t NVM_mockProgramCount(void)
+{
+    return program_count;
+}
+
+uint8_t NVM_mockRead(uint16_t addr)
+{
+    return (addr < NVM_SIZE) ? eeprom[addr] : 0xFFU;
+}
+
+void NVM_mockWrite(uint16_t addr, uint8_t value)
+{
+    if (addr < NVM_SIZE)
+    {
+        eeprom[addr] = value;
+    }
+}
+#endif
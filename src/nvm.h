@@ -0,0 +1,100 @@
+/**
+ * @file nvm.h
+ * @brief Non-volatile storage: checksummed records in the ATmega328P EEPROM
+ *
+ * @purpose
+ * Learned and calibrated data (current baselines, later presets and stroke
+ * calibration) must survive a power cycle. An EEPROM byte write takes ~3.3 ms,
+ * so a record written in one go would stall the 1 kHz loop for hundreds of
+ * milliseconds; records are therefore staged and programmed one byte per
+ * NVM_service() call instead.
+ *
+ * @implementation
+ * - Record: [id][length][payload...][Fletcher-16 over id, length and payload]
+ * - Fixed addresses per record (layout below); the id carries the layout version
+ * - NVM_writeRecord() copies the record into a staging buffer and returns
+ * - NVM_service() programs at most one byte, skipping bytes that already hold
+ *   the value (EEPROM endurance), and only once the previous write finished
+ * - A record interrupted by a reset fails its checksum and reads as absent
+ * - Host builds keep the EEPROM in RAM; HAL_init() -> NVM_init() erases it so
+ *   every test starts on a fresh board
+ *
+ * @thread_safety NOT thread-safe; main loop only
+ */
+
+#ifndef NVM_H
+#define NVM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint16_t NVM_SIZE = 1024U;              // ATmega328P EEPROM bytes
+static const uint8_t NVM_RECORD_OVERHEAD = 4U;       // id, length, 16-bit checksum
+static const uint8_t NVM_MAX_PAYLOAD = 64U;          // Largest record payload (staging buffer)
+
+// Record layout: addresses never move; a changed payload layout takes a new id
+static const uint16_t NVM_ADDR_CURRENT_BASELINE = 0U;   // current_baseline.h
+static const uint8_t NVM_ID_CURRENT_BASELINE = 0x11U;
+static const uint16_t NVM_ADDR_PRESETS = NVM_ADDR_CURRENT_BASELINE + NVM_MAX_PAYLOAD + NVM_RECORD_OVERHEAD;  // desk_presets.h
+static const uint8_t NVM_ID_PRESETS = 0x21U;
+static const uint16_t NVM_ADDR_CALIBRATION = NVM_ADDR_PRESETS + NVM_MAX_PAYLOAD + NVM_RECORD_OVERHEAD;  // desk_calibration.h
+static const uint8_t NVM_ID_CALIBRATION = 0x31U;
+
+static_assert((NVM_ADDR_CALIBRATION + NVM_MAX_PAYLOAD + NVM_RECORD_OVERHEAD) <= NVM_SIZE,
+              "Record layout exceeds the EEPROM");
+
+/**
+ * @brief Drop any staged write (host builds: erase the whole EEPROM)
+ */
+void NVM_init(void);
+
+/**
+ * @brief Read a record
+ *
+ * @param addr - Record address from the layout above
+ * @param id - Expected record id
+ * @param payload - Receives length bytes; left unchanged if the record is invalid
+ * @param length - Expected payload length
+ * @return bool - true if id, length and checksum match
+ */
+bool NVM_readRecord(uint16_t addr, uint8_t id, void *payload, uint8_t length);
+
+/**
+ * @brief Stage a record for background programming by NVM_service()
+ *
+ * @return bool - false if another record is still being written or the
+ *         record does not fit (nothing staged; retry later)
+ */
+bool NVM_writeRecord(uint16_t addr, uint8_t id, const void *payload, uint8_t length);
+
+/**
+ * @brief Program at most one staged byte (call every main loop pass or every 1 ms)
+ */
+void NVM_service(void);
+
+/**
+ * @brief A staged record has bytes left to program
+ */
+bool NVM_busy(void);
+
+#ifdef TESTENVIRONMENT
+/**
+ * @brief Host builds: bytes actually programmed since NVM_init() (unchanged bytes are skipped)
+ */
+uint32_t NVM_mockProgramCount(void);
+
+/**
+ * @brief Host builds: raw EEPROM byte access for corruption tests
+ */
+uint8_t NVM_mockRead(uint16_t addr);
+void NVM_mockWrite(uint16_t addr, uint8_t value);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NVM_H
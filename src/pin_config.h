@@ -10,6 +10,7 @@
  * - Digital pins 6-7: Motor driver signals (varies by driver type)
  * - PWM pins 9-10: Motor driver PWM control
  * - Digital pins 11-13: Status LEDs (visual feedback)
+ * - Analog pins A2-A3: Quadrature encoder / Hall sensor A and B (digital inputs)
  * 
  * @motor_type_pinouts
  * L298N (MT_BASIC):
@@ -51,7 +52,7 @@ const uint8_t PIN_LIMIT_LOWER = 8;     // Digital input with internal pull-up (S
 // ============================================================================
 // MOTOR DRIVER PINS - CONFIGURABLE (All pins defined for both motor types)
 // ============================================================================
-// Note: HAL now determines which pins to use at runtime via motor_type input
+// Note: The HAL driver policy (motor_driver.h) for the build's motor type decides which pins are used
 //       Comment next to each pin indicates primary motor type usage
 
 // L298N (MT_BASIC) pins:
@@ -65,6 +66,14 @@ const uint8_t PIN_MOTOR_RPWM = 10;      // Right PWM (clockwise, DOWN direction)
 const uint8_t PIN_MOTOR_CIN = 15;       // Current Input for diagnostics (optional) - Analog pin A1 - MT_ROBUST
 const uint8_t PIN_MOTOR_SENSE = 14;     // Analog pin A0 (current sensing) - MT_ROBUST only
 
+// ============================================================================
+// POSITION ENCODER PINS (Actuator Hall sensor, quadrature A/B, pull-ups)
+// ============================================================================
+// Adjacent PORTC bits on their own pin-change vector (PCINT1): the encoder
+// interrupt never runs for a button or limit edge (position_encoder.h)
+const uint8_t PIN_ENCODER_A = 16;       // Analog pin A2 used as digital input
+const uint8_t PIN_ENCODER_B = 17;       // Analog pin A3 used as digital input
+
 
 
 
@@ -0,0 +1,162 @@
+/**
+ * @file port_io.h
+ * @brief Direct AVR port register access for the HAL (Arduino UNO / ATmega328P)
+ *
+ * @purpose
+ * digitalRead()/digitalWrite()/analogWrite() look up port, bit and timer for
+ * the pin on every call. The HAL pins are compile-time constants
+ * (pin_config.h), so their port and bit mask are computed once here and
+ * every access becomes a single register read or an SBI/CBI/OCR store.
+ *
+ * @implementation
+ * - UNO mapping: pins 0-7 = PORTD, 8-13 = PORTB, 14-19 (A0-A5) = PORTC,
+ *   bit = pin offset within the port
+ * - PWM on pins 9 and 10 drives the Timer1 compare registers OCR1A / OCR1B
+ *   directly; PortIO_enablePwm() connects the compare output once. The core's
+ *   init() runs Timer1 in 8-bit phase-correct mode, where OCR = 0 holds the pin
+ *   LOW and OCR = 255 holds it HIGH, matching analogWrite() at both ends
+ * - TESTENVIRONMENT: the same calls go to the HAL mock, which models the
+ *   registers on top of pin_states[] (hal_mock/HALMock.h)
+ *
+ * @thread_safety Single-bit set/clear are single instructions (SBI/CBI) on
+ *   ports B-D; no interrupt writes the output ports
+ */
+
+#ifndef PORT_IO_H
+#define PORT_IO_H
+
+#include <stdint.h>
+
+#ifdef TESTENVIRONMENT
+#include "hal_mock/HALMock.h"
+#else
+#include <Arduino.h>
+#endif
+
+typedef enum
+{
+    PORT_IO_B = 0,
+    PORT_IO_C = 1,
+    PORT_IO_D = 2
+} PortIOPort_t;
+
+/**
+ * @brief Port of an Arduino UNO pin number
+ */
+static constexpr PortIOPort_t PortIO_port(uint8_t pin)
+{
+    return (pin < 8U) ? PORT_IO_D : ((pin < 14U) ? PORT_IO_B : PORT_IO_C);
+}
+
+/**
+ * @brief Bit mask of an Arduino UNO pin number within its port
+ */
+static constexpr uint8_t PortIO_mask(uint8_t pin)
+{
+    return static_cast<uint8_t>(1U << ((pin < 8U) ? pin : ((pin < 14U) ? (pin - 8U) : (pin - 14U))));
+}
+
+/**
+ * @brief True if the pin is a Timer1 compare output (OCR1A / OCR1B)
+ */
+static constexpr bool PortIO_isTimer1Pwm(uint8_t pin)
+{
+    return (pin == 9U) || (pin == 10U);
+}
+
+/**
+ * @brief Read all input levels of a port at once (PINx)
+ */
+static inline uint8_t PortIO_read(PortIOPort_t port)
+{
+#ifdef TESTENVIRONMENT
+    return MockPort_read(static_cast<uint8_t>(port));
+#else
+    switch (port)
+    {
+        case PORT_IO_B:
+            return PINB;
+        case PORT_IO_C:
+            return PINC;
+        case PORT_IO_D:
+        default:
+            return PIND;
+    }
+#endif
+}
+
+/**
+ * @brief Drive the masked output bits of a port HIGH or LOW (PORTx)
+ */
+static inline void PortIO_write(PortIOPort_t port, uint8_t mask, bool high)
+{
+#ifdef TESTENVIRONMENT
+    MockPort_write(static_cast<uint8_t>(port), mask, high);
+#else
+    // Constant port and single-bit mask after inlining: one SBI / CBI
+    const uint8_t clear = static_cast<uint8_t>(~mask);
+    switch (port)
+    {
+        case PORT_IO_B:
+            PORTB = high ? static_cast<uint8_t>(PORTB | mask) : static_cast<uint8_t>(PORTB & clear);
+            break;
+        case PORT_IO_C:
+            PORTC = high ? static_cast<uint8_t>(PORTC | mask) : static_cast<uint8_t>(PORTC & clear);
+            break;
+        case PORT_IO_D:
+        default:
+            PORTD = high ? static_cast<uint8_t>(PORTD | mask) : static_cast<uint8_t>(PORTD & clear);
+            break;
+    }
+#endif
+}
+
+/**
+ * @brief Drive one output pin through its precomputed port and bit mask
+ */
+static inline void PortIO_writePin(uint8_t pin, bool high)
+{
+    PortIO_write(PortIO_port(pin), PortIO_mask(pin), high);
+}
+
+/**
+ * @brief Connect the Timer1 compare output of a PWM pin (call once at init, duty 0)
+ */
+static inline void PortIO_enablePwm(uint8_t pin)
+{
+#ifdef TESTENVIRONMENT
+    MockPort_writePwm(pin, 0U);
+#else
+    if (pin == 9U)
+    {
+        OCR1A = 0U;
+        TCCR1A = static_cast<uint8_t>(TCCR1A | (1U << COM1A1));
+    }
+    else if (pin == 10U)
+    {
+        OCR1B = 0U;
+        TCCR1A = static_cast<uint8_t>(TCCR1A | (1U << COM1B1));
+    }
+#endif
+}
+
+/**
+ * @brief Set the PWM duty of a pin enabled with PortIO_enablePwm() (0-255)
+ */
+static inline void PortIO_writePwm(uint8_t pin, uint8_t duty)
+{
+#ifdef TESTENVIRONMENT
+    MockPort_writePwm(pin, duty);
+#else
+    if (pin == 9U)
+    {
+        OCR1A = duty;
+    }
+    else if (pin == 10U)
+    {
+        OCR1B = duty;
+    }
+#endif
+}
+
+#endif // PORT_IO_H
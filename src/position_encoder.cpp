@@ -0,0 +1,168 @@
+#include "position_encoder.h"
+#include <stddef.h>  // For NULL definition
+
+#ifndef TESTENVIRONMENT
+#include <Arduino.h>
+#endif
+
+static const uint8_t SLOT_MASK = static_cast<uint8_t>(ENCODER_VELOCITY_SLOTS - 1U);
+static const int32_t VELOCITY_WINDOW_MS = static_cast<int32_t>(ENCODER_VELOCITY_SLOTS) * ENCODER_VELOCITY_SLOT_MS;
+static const int8_t DECODE_ERROR = 2;
+
+/**
+ * @brief Count step per (previous levels << 2) | new levels
+ *
+ * Gray sequence 00 -> 01 -> 11 -> 10 -> 00 (B:A) counts up; both channels
+ * changing at once is DECODE_ERROR.
+ */
+static const int8_t QUADRATURE_STEP[16] = {
+    0, 1, -1, DECODE_ERROR,
+    -1, 0, DECODE_ERROR, 1,
+    1, DECODE_ERROR, 0, -1,
+    DECODE_ERROR, -1, 1, 0
+};
+
+/**
+ * @brief Copy the 16-bit count shared with the interrupt (two byte loads on AVR)
+ */
+static uint16_t read_shared_u16(const volatile uint16_t *value)
+{
+#ifdef TESTENVIRONMENT
+    return *value;
+#else
+    const uint8_t sreg = SREG;
+    cli();
+    const uint16_t copy = *value;
+    SREG = sreg;
+    return copy;
+#endif
+}
+
+void PositionEncoder_init(PositionEncoder_t *encoder, uint8_t levels, uint32_t now_ms)
+{
+    if (encoder == NULL)
+    {
+        return;
+    }
+    encoder->count = 0U;
+    encoder->decode_errors = 0U;
+    encoder->levels = static_cast<uint8_t>(levels & 0x03U);
+    encoder->count_seen = 0U;
+    encoder->decode_errors_seen = 0U;
+    encoder->position = 0;
+    for (uint8_t i = 0U; i < ENCODER_VELOCITY_SLOTS; i++)
+    {
+        encoder->slot_position[i] = 0;
+    }
+    encoder->slot = 0U;
+    encoder->slot_start_ms = now_ms;
+    encoder->drive_dir = MOTOR_STOP;
+    encoder->drive_start_position = 0;
+    encoder->state.position_counts = 0;
+    encoder->state.velocity_cps = 0;
+    encoder->state.decode_errors = 0U;
+    encoder->state.direction_error = false;
+}
+
+void PositionEncoder_edge(PositionEncoder_t *encoder, uint8_t levels)
+{
+    // Keep this short: it runs on every Hall edge at full motor speed
+    const uint8_t current = static_cast<uint8_t>(levels & 0x03U);
+    const int8_t step = QUADRATURE_STEP[static_cast<uint8_t>(encoder->levels << 2) | current];
+    encoder->levels = current;
+    if (step == DECODE_ERROR)
+    {
+        encoder->decode_errors = static_cast<uint8_t>(encoder->decode_errors + 1U);
+    }
+    else
+    {
+        encoder->count = static_cast<uint16_t>(encoder->count + static_cast<uint16_t>(step));
+    }
+}
+
+/**
+ * @brief Velocity over the slot window, refreshed when a slot ends
+ */
+static void update_velocity(PositionEncoder_t *encoder, uint32_t now_ms)
+{
+    if ((now_ms - encoder->slot_start_ms) < ENCODER_VELOCITY_SLOT_MS)
+    {
+        return;
+    }
+
+    const int32_t moved = encoder->position - encoder->slot_position[encoder->slot];
+    int32_t velocity_cps = (moved * 1000) / VELOCITY_WINDOW_MS;
+    if (velocity_cps > INT16_MAX)
+    {
+        velocity_cps = INT16_MAX;
+    }
+    else if (velocity_cps < INT16_MIN)
+    {
+        velocity_cps = INT16_MIN;
+    }
+    encoder->state.velocity_cps = static_cast<int16_t>(velocity_cps);
+
+    encoder->slot_position[encoder->slot] = encoder->position;
+    encoder->slot = static_cast<uint8_t>((encoder->slot + 1U) & SLOT_MASK);
+    encoder->slot_start_ms = now_ms;  // A late update starts the next slot late instead of catching up
+}
+
+/**
+ * @brief SAFETY: latch a direction error once the position runs against the drive
+ */
+static void update_direction_check(PositionEncoder_t *encoder, MotorDirection_t drive_dir)
+{
+    if (drive_dir != encoder->drive_dir)
+    {
+        encoder->drive_dir = drive_dir;
+        encoder->drive_start_position = encoder->position;
+        encoder->state.direction_error = false;
+        return;
+    }
+
+    const int32_t moved = encoder->position - encoder->drive_start_position;
+    const int32_t limit = static_cast<int32_t>(ENCODER_DIRECTION_ERROR_COUNTS);
+    if (((drive_dir == MOTOR_UP) && (moved <= -limit)) ||
+        ((drive_dir == MOTOR_DOWN) && (moved >= limit)))
+    {
+        encoder->state.direction_error = true;
+    }
+}
+
+void PositionEncoder_update(PositionEncoder_t *encoder, MotorDirection_t drive_dir, uint32_t now_ms)
+{
+    if (encoder == NULL)
+    {
+        return;
+    }
+
+    // Signed 16-bit difference: the free-running count may wrap between updates
+    const uint16_t count = read_shared_u16(&encoder->count);
+    const int16_t delta = static_cast<int16_t>(static_cast<uint16_t>(count - encoder->count_seen));
+    encoder->count_seen = count;
+    encoder->position += delta;
+
+    const uint8_t decode_errors = encoder->decode_errors;  // Single byte: atomic
+    const uint16_t new_errors = static_cast<uint8_t>(decode_errors - encoder->decode_errors_seen);
+    encoder->decode_errors_seen = decode_errors;
+    const uint32_t total_errors = static_cast<uint32_t>(encoder->state.decode_errors) + new_errors;
+    encoder->state.decode_errors = (total_errors > UINT16_MAX) ? UINT16_MAX : static_cast<uint16_t>(total_errors);
+
+    update_velocity(encoder, now_ms);
+    update_direction_check(encoder, drive_dir);
+    encoder->state.position_counts = encoder->position;
+}
+
+EncoderState_t PositionEncoder_state(const PositionEncoder_t *encoder)
+{
+    if (encoder == NULL)
+    {
+        EncoderState_t none;
+        none.position_counts = 0;
+        none.velocity_cps = 0;
+        none.decode_errors = 0U;
+        none.direction_error = false;
+        return none;
+    }
+    return encoder->state;
+}
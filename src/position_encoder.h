@@ -0,0 +1,97 @@
+/**
+ * @file position_encoder.h
+ * @brief Quadrature encoder / Hall sensor position and velocity tracking
+ *
+ * @purpose
+ * The desk only knew whether it sat on a limit switch. The actuator's two
+ * Hall channels (A/B, 90 degrees apart) give its travel in counts; the
+ * interrupt decodes every edge, the main loop turns the counts into a
+ * position, a velocity and a direction check against the drive applied.
+ *
+ * @implementation
+ * - Producer (pin-change interrupt on A or B): one 16-entry table lookup on
+ *   the previous and current A/B levels, +1 / -1 added to a free-running
+ *   16-bit count; a jump over a state (both channels changed, an edge was
+ *   missed) is counted as a decode error instead of guessed
+ * - Consumer (1 kHz, PositionEncoder_update()): extends the 16-bit count to
+ *   a 32-bit position through the signed 16-bit difference since the last
+ *   update, so the count may wrap freely as long as fewer than 32768 counts
+ *   pass between updates
+ * - Velocity: position change over ENCODER_VELOCITY_SLOTS slots of
+ *   ENCODER_VELOCITY_SLOT_MS, refreshed every slot
+ * - Direction error: the position moved ENCODER_DIRECTION_ERROR_COUNTS
+ *   against the drive since the drive started (reversed wiring, back-driven
+ *   gear, lost channel); latched until the drive changes
+ * - Counts rise moving up; position 0 is where PositionEncoder_init() ran
+ *
+ * @thread_safety One producer (interrupt) and one consumer (main loop); the
+ *   consumer copies the 16-bit count with interrupts masked
+ */
+
+#ifndef POSITION_ENCODER_H
+#define POSITION_ENCODER_H
+
+#include <stdint.h>
+#include "desk_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static const uint8_t ENCODER_COUNTS_PER_MM = 4U;            // 1 Hall pulse per mm and channel, 4 edges
+static const uint8_t ENCODER_VELOCITY_SLOTS = 4U;           // Power of two
+static const uint8_t ENCODER_VELOCITY_SLOT_MS = 16U;        // Window: 64 ms, refreshed every 16 ms
+static const uint16_t ENCODER_DIRECTION_ERROR_COUNTS = 8U;  // 2 mm against the drive
+
+static_assert((ENCODER_VELOCITY_SLOTS & (ENCODER_VELOCITY_SLOTS - 1U)) == 0U, "Velocity slots must be a power of two");
+
+typedef struct
+{
+    volatile uint16_t count;           ///< Producer: free-running count (wraps)
+    volatile uint8_t decode_errors;    ///< Producer: skipped states (wraps)
+    uint8_t levels;                    ///< Producer: A (bit 0) / B (bit 1) at the last edge
+    uint16_t count_seen;               ///< Consumer: count at the last update
+    uint8_t decode_errors_seen;        ///< Consumer: decode_errors at the last update
+    int32_t position;                  ///< Consumer: extended count
+    int32_t slot_position[ENCODER_VELOCITY_SLOTS];  ///< Consumer: position at each slot start
+    uint8_t slot;                      ///< Consumer: oldest slot (next to overwrite)
+    uint32_t slot_start_ms;            ///< Consumer: start of the current slot
+    MotorDirection_t drive_dir;        ///< Consumer: drive of the current direction check
+    int32_t drive_start_position;      ///< Consumer: position when drive_dir started
+    EncoderState_t state;              ///< Consumer: latest published state
+} PositionEncoder_t;
+
+/**
+ * @brief Start at position 0 from the current A/B levels (no producer may be active)
+ *
+ * @param levels - A in bit 0, B in bit 1
+ * @param now_ms - Start of the first velocity slot
+ */
+void PositionEncoder_init(PositionEncoder_t *encoder, uint8_t levels, uint32_t now_ms);
+
+/**
+ * @brief Pin-change interrupt body: decode the step to the new A/B levels
+ *
+ * @param levels - A in bit 0, B in bit 1
+ * @safety_critical Producer side only - never call from the main loop on target
+ */
+void PositionEncoder_edge(PositionEncoder_t *encoder, uint8_t levels);
+
+/**
+ * @brief Consumer side (1 kHz): fold new counts into position, velocity and the direction check
+ *
+ * @param drive_dir - Drive applied (HAL_getMotorDirection())
+ * @param now_ms - Current time
+ */
+void PositionEncoder_update(PositionEncoder_t *encoder, MotorDirection_t drive_dir, uint32_t now_ms);
+
+/**
+ * @brief Latest state published by PositionEncoder_update() (zeros for NULL)
+ */
+EncoderState_t PositionEncoder_state(const PositionEncoder_t *encoder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POSITION_ENCODER_H
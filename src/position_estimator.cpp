@@ -0,0 +1,235 @@
+#include "position_estimator.h"
+#include <stddef.h>  // For NULL definition
+
+static const uint32_t UM_S_MS_PER_UM = 1000U;  // um/s * ms per um
+
+static uint8_t direction_index(MotorDirection_t dir)
+{
+    return (dir == MOTOR_DOWN) ? 1U : 0U;
+}
+
+/**
+ * @brief Model speed before the learned scale (um/s)
+ */
+static uint32_t model_speed_um_s(MotorDirection_t drive_dir, uint8_t pwm)
+{
+    if (drive_dir == MOTOR_STOP)
+    {
+        return 0U;
+    }
+    const uint32_t no_load = static_cast<uint32_t>(POSITION_ESTIMATOR_SPEED_PER_PWM_UM_S) * pwm;
+    const uint32_t load = (drive_dir == MOTOR_UP) ? POSITION_ESTIMATOR_LOAD_UP_UM_S : POSITION_ESTIMATOR_LOAD_DOWN_UM_S;
+    return (no_load > load) ? (no_load - load) : 0U;  // Below the load: the motor cannot move the desk
+}
+
+static uint16_t clamp_scale(uint16_t scale)
+{
+    if (scale < POSITION_ESTIMATOR_SCALE_MIN)
+    {
+        return POSITION_ESTIMATOR_SCALE_MIN;
+    }
+    return (scale > POSITION_ESTIMATOR_SCALE_MAX) ? POSITION_ESTIMATOR_SCALE_MAX : scale;
+}
+
+/**
+ * @brief Move a direction's scale towards the ratio of the stroke to its modelled travel
+ */
+static void learn_scale(PositionEstimator_t *estimator, MotorDirection_t dir)
+{
+    const uint32_t model_um = estimator->stroke_model_nm / UM_S_MS_PER_UM;
+    if (model_um == 0U)
+    {
+        return;
+    }
+    const uint32_t ratio = (POSITION_ESTIMATOR_STROKE_UM * POSITION_ESTIMATOR_SCALE_UNITY) / model_um;
+    const uint16_t target = clamp_scale((ratio < UINT16_MAX) ? static_cast<uint16_t>(ratio) : UINT16_MAX);
+    estimator->stroke_scale[direction_index(dir)] = target;
+    uint16_t *scale = &estimator->scale[direction_index(dir)];
+    const int32_t difference = static_cast<int32_t>(target) - static_cast<int32_t>(*scale);
+    *scale = static_cast<uint16_t>(static_cast<int32_t>(*scale) + (difference / (1 << POSITION_ESTIMATOR_LEARN_SHIFT)));
+}
+
+/**
+ * @brief Re-reference at a limit switch; the first update at the switch ends a full stroke
+ */
+static void reference(PositionEstimator_t *estimator, int32_t height_um, MotorDirection_t away_dir)
+{
+    if (!estimator->at_limit)
+    {
+        if (estimator->estimate.referenced)
+        {
+            const int32_t error = estimator->estimate.height_um - height_um;
+            estimator->last_correction_um = static_cast<uint32_t>((error < 0) ? -error : error);
+        }
+        const MotorDirection_t arrived_dir = (away_dir == MOTOR_UP) ? MOTOR_DOWN : MOTOR_UP;
+        if (estimator->stroke_dir == arrived_dir)
+        {
+            learn_scale(estimator, arrived_dir);
+        }
+    }
+    estimator->estimate.height_um = height_um;
+    estimator->estimate.referenced = true;
+    estimator->remainder = 0U;
+    estimator->travel_um = 0U;
+    estimator->drive_changes = 0U;
+    estimator->stroke_dir = away_dir;
+    estimator->stroke_model_nm = 0U;
+    estimator->at_limit = true;
+}
+
+void PositionEstimator_init(PositionEstimator_t *estimator)
+{
+    if (estimator == NULL)
+    {
+        return;
+    }
+    estimator->estimate.height_um = 0;
+    estimator->estimate.error_um = 0U;
+    estimator->estimate.referenced = false;
+    estimator->remainder = 0U;
+    estimator->travel_um = 0U;
+    estimator->drive_changes = 0U;
+    estimator->drive_dir = MOTOR_STOP;
+    estimator->scale[0] = POSITION_ESTIMATOR_SCALE_UNITY;
+    estimator->scale[1] = POSITION_ESTIMATOR_SCALE_UNITY;
+    estimator->stroke_scale[0] = 0U;
+    estimator->stroke_scale[1] = 0U;
+    estimator->stroke_dir = MOTOR_STOP;
+    estimator->stroke_model_nm = 0U;
+    estimator->last_correction_um = 0U;
+    estimator->at_limit = false;
+}
+
+uint32_t PositionEstimator_speedUmS(const PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint8_t pwm)
+{
+    if (estimator == NULL)
+    {
+        return 0U;
+    }
+    return (model_speed_um_s(drive_dir, pwm) * estimator->scale[direction_index(drive_dir)]) / POSITION_ESTIMATOR_SCALE_UNITY;
+}
+
+uint8_t PositionEstimator_pwmForSpeed(const PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint32_t speed_um_s)
+{
+    if ((estimator == NULL) || (drive_dir == MOTOR_STOP) || (speed_um_s == 0U))
+    {
+        return 0U;
+    }
+    const uint32_t scale = estimator->scale[direction_index(drive_dir)];
+    const uint32_t load = (drive_dir == MOTOR_UP) ? POSITION_ESTIMATOR_LOAD_UP_UM_S : POSITION_ESTIMATOR_LOAD_DOWN_UM_S;
+    const uint32_t max_speed = model_speed_um_s(drive_dir, UINT8_MAX);
+    if (speed_um_s > ((max_speed * scale) / POSITION_ESTIMATOR_SCALE_UNITY))
+    {
+        return UINT8_MAX;
+    }
+    // Round up at both divisions: the PWM returned is never rated slower than speed_um_s
+    const uint32_t model = ((speed_um_s * POSITION_ESTIMATOR_SCALE_UNITY) + scale - 1U) / scale;
+    const uint32_t pwm = (model + load + POSITION_ESTIMATOR_SPEED_PER_PWM_UM_S - 1U) / POSITION_ESTIMATOR_SPEED_PER_PWM_UM_S;
+    return static_cast<uint8_t>((pwm < UINT8_MAX) ? pwm : UINT8_MAX);
+}
+
+void PositionEstimator_update(PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint8_t pwm,
+                              bool limit_lower, bool limit_upper, uint32_t elapsed_ms)
+{
+    if (estimator == NULL)
+    {
+        return;
+    }
+
+    if (drive_dir != estimator->drive_dir)
+    {
+        estimator->drive_dir = drive_dir;
+        if (estimator->drive_changes < UINT16_MAX)
+        {
+            estimator->drive_changes++;
+        }
+    }
+    if ((drive_dir != MOTOR_STOP) && (drive_dir != estimator->stroke_dir))
+    {
+        estimator->stroke_dir = MOTOR_STOP;  // Reversed before reaching the other switch: not a full stroke
+    }
+
+    // Travel over the elapsed time; the sub-um remainder carries into the next update
+    const uint32_t travel = PositionEstimator_speedUmS(estimator, drive_dir, pwm) * elapsed_ms + estimator->remainder;
+    const uint32_t travel_um = travel / UM_S_MS_PER_UM;
+    estimator->remainder = static_cast<uint16_t>(travel % UM_S_MS_PER_UM);
+    estimator->travel_um += travel_um;
+    if (estimator->stroke_dir != MOTOR_STOP)
+    {
+        const uint32_t model_nm = model_speed_um_s(drive_dir, pwm) * elapsed_ms;
+        estimator->stroke_model_nm = (model_nm > (UINT32_MAX - estimator->stroke_model_nm)) ?
+                                     UINT32_MAX : (estimator->stroke_model_nm + model_nm);
+    }
+    if (drive_dir == MOTOR_UP)
+    {
+        estimator->estimate.height_um += static_cast<int32_t>(travel_um);
+    }
+    else if (drive_dir == MOTOR_DOWN)
+    {
+        estimator->estimate.height_um -= static_cast<int32_t>(travel_um);
+    }
+
+    if (limit_lower && !limit_upper)
+    {
+        reference(estimator, 0, MOTOR_UP);
+    }
+    else if (limit_upper && !limit_lower)
+    {
+        reference(estimator, static_cast<int32_t>(POSITION_ESTIMATOR_STROKE_UM), MOTOR_DOWN);
+    }
+    else
+    {
+        estimator->at_limit = false;  // Both active is a wiring fault: reference neither
+    }
+
+    uint32_t error_um = (estimator->travel_um >> POSITION_ESTIMATOR_TOLERANCE_SHIFT) +
+                        (static_cast<uint32_t>(estimator->drive_changes) * POSITION_ESTIMATOR_START_ERROR_UM);
+    if (estimator->estimate.referenced)
+    {
+        // The desk cannot leave the switches' range, nor can the estimate's drift exceed it
+        if (estimator->estimate.height_um < 0)
+        {
+            estimator->estimate.height_um = 0;
+        }
+        else if (estimator->estimate.height_um > static_cast<int32_t>(POSITION_ESTIMATOR_STROKE_UM))
+        {
+            estimator->estimate.height_um = static_cast<int32_t>(POSITION_ESTIMATOR_STROKE_UM);
+        }
+        if (error_um > POSITION_ESTIMATOR_STROKE_UM)
+        {
+            error_um = POSITION_ESTIMATOR_STROKE_UM;
+        }
+    }
+    estimator->estimate.error_um = error_um;
+}
+
+uint16_t PositionEstimator_strokeScale(const PositionEstimator_t *estimator, MotorDirection_t drive_dir)
+{
+    if ((estimator == NULL) || (drive_dir == MOTOR_STOP))
+    {
+        return 0U;
+    }
+    return estimator->stroke_scale[direction_index(drive_dir)];
+}
+
+void PositionEstimator_setScale(PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint16_t scale)
+{
+    if ((estimator == NULL) || (drive_dir == MOTOR_STOP))
+    {
+        return;
+    }
+    estimator->scale[direction_index(drive_dir)] = clamp_scale(scale);
+}
+
+PositionEstimate_t PositionEstimator_estimate(const PositionEstimator_t *estimator)
+{
+    if (estimator == NULL)
+    {
+        PositionEstimate_t none;
+        none.height_um = 0;
+        none.error_um = 0U;
+        none.referenced = false;
+        return none;
+    }
+    return estimator->estimate;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file position_estimator.h
+ * @brief Sensorless desk height from the drive applied (dead reckoning)
+ *
+ * @purpose
+ * Desks without an encoder (position_encoder.h) still want an approximate
+ * height: for presets, for stroke positions and for diagnostics. The
+ * estimator integrates the speed the motor model predicts for the PWM and
+ * direction applied, re-references at every limit switch and reports how far
+ * off the estimate may have drifted since.
+ *
+ * @implementation
+ * - Speed model per direction: POSITION_ESTIMATOR_SPEED_PER_PWM_UM_S * pwm
+ *   minus the speed the load costs in that direction (UP lifts it, DOWN is
+ *   helped by it), never below 0, times a learned scale (1/256 units)
+ * - Height in um above the lower limit switch, integrated once per 1 kHz
+ *   sample with the sub-um remainder carried over
+ * - Lower limit switch: height 0; upper limit switch: POSITION_ESTIMATOR_STROKE_UM.
+ *   Both reference the estimate and reset the error bound
+ * - Error bound: 1/2^POSITION_ESTIMATOR_TOLERANCE_SHIFT of the travel since
+ *   the reference (model accuracy) plus POSITION_ESTIMATOR_START_ERROR_UM per
+ *   drive change (motor inertia and the ramp lag the model ignores)
+ * - Calibration: a stroke from one limit switch to the other compares the
+ *   modelled travel with the stroke and moves that direction's scale by
+ *   1/2^POSITION_ESTIMATOR_LEARN_SHIFT of the difference (load, supply and
+ *   gear wear); reversing on the way discards the stroke. The ratio itself is
+ *   kept for the stroke calibration (desk_calibration.h), which adopts it at once
+ *
+ * @thread_safety NOT thread-safe; main loop only
+ */
+
+#ifndef POSITION_ESTIMATOR_H
+#define POSITION_ESTIMATOR_H
+
+#include <stdint.h>
+#include "desk_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Model defaults for the standard 24 V actuator with a 25 kg moving mass:
+// 60 mm/s no-load at full PWM, ~32 mm/s up and ~57 mm/s down
+static const uint16_t POSITION_ESTIMATOR_SPEED_PER_PWM_UM_S = 235U;   // No-load speed per PWM step
+static const uint16_t POSITION_ESTIMATOR_LOAD_UP_UM_S = 27600U;       // Speed lost lifting the load
+static const uint16_t POSITION_ESTIMATOR_LOAD_DOWN_UM_S = 3100U;      // Speed lost to friction net of the load
+static const uint32_t POSITION_ESTIMATOR_STROKE_UM = 640000UL;        // Lower to upper limit switch
+static const uint8_t POSITION_ESTIMATOR_TOLERANCE_SHIFT = 3U;         // Model error: 1/8 of the travel
+static const uint16_t POSITION_ESTIMATOR_START_ERROR_UM = 1000U;      // Per start, stop or reversal
+static const uint16_t POSITION_ESTIMATOR_SCALE_UNITY = 256U;          // Learned scale 1.0
+static const uint16_t POSITION_ESTIMATOR_SCALE_MIN = 128U;            // 0.5: a worse model is a fault, not load
+static const uint16_t POSITION_ESTIMATOR_SCALE_MAX = 512U;            // 2.0
+static const uint8_t POSITION_ESTIMATOR_LEARN_SHIFT = 2U;             // Each full stroke moves the scale by 1/4
+
+typedef struct
+{
+    PositionEstimate_t estimate;          ///< Latest published estimate
+    uint16_t remainder;                   ///< Travel below 1 um (um/s * ms, < 1000)
+    uint32_t travel_um;                   ///< Travel since the reference (error bound)
+    uint16_t drive_changes;               ///< Starts, stops and reversals since the reference (saturates)
+    MotorDirection_t drive_dir;           ///< Drive of the previous update
+    uint16_t scale[2];                    ///< Learned speed scale per [UP, DOWN] (POSITION_ESTIMATOR_SCALE_UNITY = 1.0)
+    uint16_t stroke_scale[2];             ///< Scale the latest full stroke per [UP, DOWN] measured (0 = none)
+    MotorDirection_t stroke_dir;          ///< Full stroke in progress: direction away from the limit (STOP = none)
+    uint32_t stroke_model_nm;             ///< Unscaled model travel of the stroke in progress (saturates)
+    uint32_t last_correction_um;          ///< Estimate error found at the latest limit switch reached
+    bool at_limit;                        ///< A limit switch was active at the previous update
+} PositionEstimator_t;
+
+/**
+ * @brief Start unreferenced at height 0 with the default model (scale 1.0)
+ */
+void PositionEstimator_init(PositionEstimator_t *estimator);
+
+/**
+ * @brief Model speed for a drive (um/s, always >= 0)
+ *
+ * @param drive_dir - MOTOR_STOP: 0
+ * @param pwm - PWM applied
+ */
+uint32_t PositionEstimator_speedUmS(const PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint8_t pwm);
+
+/**
+ * @brief Lowest PWM the model rates at speed_um_s or faster (inverse of PositionEstimator_speedUmS())
+ *
+ * @param drive_dir - MOTOR_STOP: 0
+ * @param speed_um_s - Speed wanted; 0: 0
+ * @return uint8_t - 255 if the model rates no PWM that fast
+ */
+uint8_t PositionEstimator_pwmForSpeed(const PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint32_t speed_um_s);
+
+/**
+ * @brief Integrate the drive applied over the elapsed time (1 kHz sample)
+ *
+ * @param drive_dir - Drive applied since the previous update
+ * @param pwm - PWM applied since the previous update
+ * @param limit_lower - Lower limit switch active (references height 0)
+ * @param limit_upper - Upper limit switch active (references POSITION_ESTIMATOR_STROKE_UM)
+ * @param elapsed_ms - Time since the previous update
+ */
+void PositionEstimator_update(PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint8_t pwm,
+                              bool limit_lower, bool limit_upper, uint32_t elapsed_ms);
+
+/**
+ * @brief Scale the latest full stroke in a direction measured, before learning smoothed it
+ *
+ * @return uint16_t - POSITION_ESTIMATOR_SCALE_UNITY units; 0 if no full stroke yet or drive_dir is MOTOR_STOP
+ */
+uint16_t PositionEstimator_strokeScale(const PositionEstimator_t *estimator, MotorDirection_t drive_dir);
+
+/**
+ * @brief Replace a direction's speed scale (calibration), clamped to SCALE_MIN..SCALE_MAX
+ *
+ * @param drive_dir - MOTOR_STOP: ignored
+ * @param scale - POSITION_ESTIMATOR_SCALE_UNITY units
+ */
+void PositionEstimator_setScale(PositionEstimator_t *estimator, MotorDirection_t drive_dir, uint16_t scale);
+
+/**
+ * @brief Latest estimate published by PositionEstimator_update() (unreferenced zeros for NULL)
+ */
+PositionEstimate_t PositionEstimator_estimate(const PositionEstimator_t *estimator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POSITION_ESTIMATOR_H
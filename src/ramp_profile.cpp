@@ -0,0 +1,142 @@
+#include "ramp_profile.h"
+
+#ifdef TESTENVIRONMENT
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#else
+#include <avr/pgmspace.h>
+#endif
+
+// ============================================================================
+// COMPILE-TIME TABLE GENERATION (C++11 constexpr, also used by the AVR toolchain)
+// ============================================================================
+
+namespace
+{
+/**
+ * @brief e-folds over the ramp for RAMP_PROFILE_EXPONENTIAL (98% of the way at x = 1 before normalization)
+ */
+constexpr double EXPONENTIAL_RATE = 4.0;
+constexpr unsigned EXP_SERIES_TERMS = 40U;
+
+/**
+ * @brief e^x by Taylor series, evaluated by the compiler only
+ */
+constexpr double exp_series(double x, unsigned n, double term, double sum)
+{
+    return (n > EXP_SERIES_TERMS) ? sum
+                                  : exp_series(x, n + 1U, term * x / static_cast<double>(n),
+                                               sum + term * x / static_cast<double>(n));
+}
+
+constexpr double const_exp(double x)
+{
+    return exp_series(x, 1U, 1.0, 1.0);
+}
+
+struct LinearShape
+{
+    static constexpr double at(double x) { return x; }
+};
+
+struct SCurveShape
+{
+    static constexpr double at(double x) { return x * x * (3.0 - 2.0 * x); }
+};
+
+struct ExponentialShape
+{
+    static constexpr double at(double x)
+    {
+        return (1.0 - const_exp(-EXPONENTIAL_RATE * x)) / (1.0 - const_exp(-EXPONENTIAL_RATE));
+    }
+};
+
+constexpr uint16_t to_q15(double fraction)
+{
+    return static_cast<uint16_t>(fraction * static_cast<double>(RAMP_FRACTION_ONE) + 0.5);
+}
+
+struct RampTable
+{
+    uint16_t entry[RAMP_TABLE_SEGMENTS + 1U];
+};
+
+template <unsigned... I>
+struct IndexList
+{
+};
+
+template <unsigned N, unsigned... I>
+struct MakeIndexList : MakeIndexList<N - 1U, N - 1U, I...>
+{
+};
+
+template <unsigned... I>
+struct MakeIndexList<0U, I...>
+{
+    typedef IndexList<I...> type;
+};
+
+template <typename Shape, unsigned... I>
+constexpr RampTable build_table(IndexList<I...>)
+{
+    return RampTable{{to_q15(Shape::at(static_cast<double>(I) / static_cast<double>(RAMP_TABLE_SEGMENTS)))...}};
+}
+
+typedef MakeIndexList<RAMP_TABLE_SEGMENTS + 1U>::type TableIndices;
+
+constexpr RampTable LINEAR_TABLE = build_table<LinearShape>(TableIndices());
+constexpr RampTable SCURVE_TABLE = build_table<SCurveShape>(TableIndices());
+constexpr RampTable EXPONENTIAL_TABLE = build_table<ExponentialShape>(TableIndices());
+
+static_assert(LINEAR_TABLE.entry[0] == 0U && LINEAR_TABLE.entry[RAMP_TABLE_SEGMENTS] == RAMP_FRACTION_ONE,
+              "Linear ramp must span 0..1");
+static_assert(SCURVE_TABLE.entry[0] == 0U && SCURVE_TABLE.entry[RAMP_TABLE_SEGMENTS] == RAMP_FRACTION_ONE,
+              "S-curve ramp must span 0..1");
+static_assert(EXPONENTIAL_TABLE.entry[0] == 0U && EXPONENTIAL_TABLE.entry[RAMP_TABLE_SEGMENTS] == RAMP_FRACTION_ONE,
+              "Exponential ramp must span 0..1");
+static_assert(SCURVE_TABLE.entry[RAMP_TABLE_SEGMENTS / 2U] == RAMP_FRACTION_ONE / 2U,
+              "S-curve must be symmetric about the ramp midpoint");
+} // namespace
+
+/**
+ * @brief Flash-resident copies, indexed by RampProfile_t
+ */
+static const RampTable ramp_tables[RAMP_PROFILE_COUNT] PROGMEM = {
+    LINEAR_TABLE,
+    SCURVE_TABLE,
+    EXPONENTIAL_TABLE
+};
+
+static inline uint16_t read_entry(const uint16_t *entry)
+{
+#ifdef TESTENVIRONMENT
+    return *entry;
+#else
+    return pgm_read_word(entry);
+#endif
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+uint16_t RampProfile_lookup(RampProfile_t profile, uint16_t position_q8)
+{
+    const RampTable *table = (profile < RAMP_PROFILE_COUNT) ? &ramp_tables[profile]
+                                                            : &ramp_tables[RAMP_PROFILE_LINEAR];
+    const uint16_t index = static_cast<uint16_t>(position_q8 >> RAMP_TABLE_FRAC_BITS);
+    if (index >= RAMP_TABLE_SEGMENTS)
+    {
+        return read_entry(&table->entry[RAMP_TABLE_SEGMENTS]);
+    }
+
+    // Linear interpolation inside the segment; tables are non-decreasing so the step is >= 0
+    const uint16_t fraction = static_cast<uint16_t>(position_q8 & 0xFFU);
+    const uint16_t lower = read_entry(&table->entry[index]);
+    const uint16_t upper = read_entry(&table->entry[index + 1U]);
+    const uint32_t step = static_cast<uint32_t>(upper - lower) * fraction;
+    return static_cast<uint16_t>(lower + (step >> RAMP_TABLE_FRAC_BITS));
+}
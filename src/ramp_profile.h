@@ -0,0 +1,66 @@
+/**
+ * @file ramp_profile.h
+ * @brief Soft-start ramp shapes as compile-time fixed-point lookup tables
+ *
+ * @purpose
+ * Provides the normalized ramp curve f(x), x = elapsed / RAMP_TIME_MS in [0, 1],
+ * used by MotorController to scale target_pwm during soft-start (SysReq-006).
+ *
+ * @profiles
+ * - RAMP_PROFILE_LINEAR:      f(x) = x (original ramp, constant acceleration step at start/end)
+ * - RAMP_PROFILE_SCURVE:      f(x) = 3x² - 2x³ (smoothstep; zero slope at both ends,
+ *                             so acceleration is continuous and jerk is bounded)
+ * - RAMP_PROFILE_EXPONENTIAL: f(x) = (1 - e^(-4x)) / (1 - e^(-4)) (fast rise, soft arrival)
+ *
+ * @implementation
+ * - Each table holds RAMP_TABLE_SEGMENTS + 1 samples of f in Q15 (32768 = 1.0),
+ *   generated by constexpr functions at compile time (no runtime math, no RAM)
+ * - Tables live in flash on AVR (PROGMEM) and are read with pgm_read_word()
+ * - Lookup position is Q8 in table segments; linear interpolation between
+ *   samples uses one 16x8-bit multiply and a shift - no division
+ *
+ * @thread_safety Re-entrant (read-only tables)
+ */
+
+#ifndef RAMP_PROFILE_H
+#define RAMP_PROFILE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    RAMP_PROFILE_LINEAR = 0,
+    RAMP_PROFILE_SCURVE = 1,
+    RAMP_PROFILE_EXPONENTIAL = 2,
+    RAMP_PROFILE_COUNT = 3
+} RampProfile_t;
+
+/**
+ * @brief Profile used after power-on (linear keeps the original ramp timing)
+ */
+static const RampProfile_t RAMP_PROFILE_DEFAULT = RAMP_PROFILE_LINEAR;
+
+static const uint8_t RAMP_TABLE_SEGMENTS = 64U;      // Samples at x = i / 64, i = 0..64
+static const uint8_t RAMP_TABLE_FRAC_BITS = 8U;      // Q8 position within a segment
+static const uint16_t RAMP_FRACTION_ONE = 32768U;    // Q15 1.0
+
+/**
+ * @brief Normalized ramp value at a table position
+ *
+ * @param profile - Ramp shape; invalid values fall back to RAMP_PROFILE_LINEAR
+ * @param position_q8 - x * RAMP_TABLE_SEGMENTS in Q8; positions at or beyond
+ *                      RAMP_TABLE_SEGMENTS << 8 return RAMP_FRACTION_ONE
+ *
+ * @return uint16_t - f(x) in Q15 (0 .. RAMP_FRACTION_ONE), non-decreasing in position
+ */
+uint16_t RampProfile_lookup(RampProfile_t profile, uint16_t position_q8);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RAMP_PROFILE_H
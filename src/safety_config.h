@@ -8,6 +8,22 @@ static const uint16_t MOTOR_SENSE_THRESHOLD_MA = 150U;     // Stuck-on detection
 static const uint16_t MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA = 200U;  // Jam/obstruction detection (SysReq-013, FSR-007)
 static const uint32_t MOTOR_SENSE_FAULT_TIME_MS = 100U;
 
+// Soft-start inrush envelope (current_monitor.h): while MotorController ramps up, the obstruction
+// limit rises by MOTOR_SENSE_INRUSH_ALLOWANCE_MA * pwm / 255 - the speed lags the PWM, and so the
+// back-EMF lags the drive voltage. Flat MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA once cruising.
+static const uint16_t MOTOR_SENSE_INRUSH_ALLOWANCE_MA = 80U;
+
+// Current slope (di/dt) jam detection on the 1 kHz samples (current_monitor.h)
+static const uint8_t MOTOR_SENSE_SLOPE_WINDOW_MS = 16U;         // Rise measured across this many samples (< history)
+static const uint16_t MOTOR_SENSE_SLOPE_THRESHOLD_Q4 = 96U;      // Sensitivity in mA/ms, Q4 (96 = 6.0 mA/ms); lower trips earlier
+static const uint8_t MOTOR_SENSE_SLOPE_CONFIRM_MS = 4U;          // Consecutive samples at or above the slope
+static const uint16_t MOTOR_SENSE_SLOPE_BLANK_MS = 600U;         // Not armed after drive starts (500 ms soft-start inrush)
+
+// Learned current baseline per stroke position (current_baseline.h): obstruction limit =
+// level + level / 2^SHIFT + MARGIN, used only where it is below MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA
+static const uint16_t MOTOR_SENSE_BASELINE_MARGIN_MA = 40U;      // Absolute headroom over the learned level
+static const uint8_t MOTOR_SENSE_BASELINE_MARGIN_SHIFT = 3U;     // Proportional headroom (level / 8)
+
 // ADC conversion parameters
 static const uint16_t ADC_REF_MV = 5000U;
 static const uint16_t SHUNT_MILLIOHMS = 500U;
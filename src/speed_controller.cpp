@@ -0,0 +1,94 @@
+#include "speed_controller.h"
+#include <stddef.h>  // For NULL definition
+
+static const int32_t PWM_FULL = static_cast<int32_t>(UINT8_MAX) << SPEED_CONTROL_GAIN_SHIFT;
+static const uint32_t MAX_STEP_MS = 16U;  // A late loop pass integrates at most this much
+
+static int32_t clamp(int32_t value, int32_t low, int32_t high)
+{
+    return (value < low) ? low : ((value > high) ? high : value);
+}
+
+/**
+ * @brief Sum of the terms (PWM << SPEED_CONTROL_GAIN_SHIFT), not yet clamped
+ */
+static int32_t control_sum(const SpeedController_t *controller, uint8_t feedforward_pwm, int32_t error_um_s, int32_t d_term)
+{
+    return (static_cast<int32_t>(feedforward_pwm) << SPEED_CONTROL_GAIN_SHIFT) + (SPEED_CONTROL_KP * error_um_s) +
+           controller->integral + d_term;
+}
+
+static uint8_t to_pwm(int32_t sum)
+{
+    return static_cast<uint8_t>(clamp(sum, 0, PWM_FULL) >> SPEED_CONTROL_GAIN_SHIFT);
+}
+
+void SpeedController_init(SpeedController_t *controller)
+{
+    if (controller == NULL)
+    {
+        return;
+    }
+    controller->dir = MOTOR_STOP;
+    controller->integral = 0;
+    controller->last_measured_um_s = 0;
+    controller->last_ms = 0U;
+    controller->pwm = 0U;
+}
+
+uint8_t SpeedController_update(SpeedController_t *controller, MotorDirection_t drive_dir, uint32_t setpoint_um_s,
+                               uint8_t feedforward_pwm, int32_t measured_um_s, bool integrate, uint32_t now_ms)
+{
+    if (controller == NULL)
+    {
+        return 0U;
+    }
+
+    const int32_t max_um_s = static_cast<int32_t>(SPEED_CONTROL_MAX_UM_S);
+    const int32_t setpoint = static_cast<int32_t>((setpoint_um_s < SPEED_CONTROL_MAX_UM_S) ? setpoint_um_s : SPEED_CONTROL_MAX_UM_S);
+    const int32_t measured = clamp(measured_um_s, -max_um_s, max_um_s);
+
+    if (drive_dir != controller->dir)
+    {
+        SpeedController_init(controller);
+        controller->dir = drive_dir;
+        controller->last_measured_um_s = measured;
+        controller->last_ms = now_ms;
+    }
+    if (drive_dir == MOTOR_STOP)
+    {
+        return 0U;
+    }
+
+    uint32_t elapsed_ms = now_ms - controller->last_ms;
+    if (elapsed_ms > MAX_STEP_MS)
+    {
+        elapsed_ms = MAX_STEP_MS;
+    }
+    const int32_t error = setpoint - measured;
+
+    // D on the measurement: only once time has passed, so a repeated call adds no kick
+    int32_t d_term = 0;
+    if (elapsed_ms > 0U)
+    {
+        d_term = (SPEED_CONTROL_KD * (controller->last_measured_um_s - measured)) / static_cast<int32_t>(elapsed_ms);
+    }
+
+    // Anti-windup: integrate unless the clamp already holds the output against the error
+    const int32_t sum = control_sum(controller, feedforward_pwm, error, d_term);
+    const bool held_high = (sum >= PWM_FULL) && (error > 0);
+    const bool held_low = (sum <= 0) && (error < 0);
+    if (integrate && (elapsed_ms > 0U) && !held_high && !held_low)
+    {
+        controller->integral = clamp(controller->integral + (SPEED_CONTROL_KI * error * static_cast<int32_t>(elapsed_ms)),
+                                     -PWM_FULL, PWM_FULL);
+    }
+
+    if (elapsed_ms > 0U)
+    {
+        controller->last_measured_um_s = measured;
+        controller->last_ms = now_ms;
+    }
+    controller->pwm = to_pwm(control_sum(controller, feedforward_pwm, error, d_term));
+    return controller->pwm;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file speed_controller.h
+ * @brief Closed-loop desk speed (fixed-point PID on top of the MotorController ramps)
+ *
+ * @purpose
+ * Open loop, PWM 255 lifts at ~32 mm/s and lowers at ~57 mm/s, and both
+ * change with the load on the desk. The speed controller picks the PWM that
+ * holds a commanded speed instead, so both directions travel alike and a
+ * stroke takes a predictable time.
+ *
+ * @implementation
+ * - PWM = feedforward (position_estimator.h speed model inverted) + P + I + D
+ *   on the speed error, all in 1/2^SPEED_CONTROL_GAIN_SHIFT PWM units
+ * - Speeds in um/s along the drive (positive = moving the way it is driven)
+ * - D acts on the measurement, not the error, so a setpoint change does not kick
+ * - Anti-windup: the output is clamped to 0..255 and the integral only moves
+ *   while the caller allows it (cruise) and the clamp does not hold the
+ *   output against the error; the integral alone never exceeds full PWM
+ * - The MotorController still ramps the PWM returned (soft start, soft stop)
+ * - A change of drive direction starts from the feedforward again
+ *
+ * @thread_safety NOT thread-safe; main loop only
+ */
+
+#ifndef SPEED_CONTROLLER_H
+#define SPEED_CONTROLLER_H
+
+#include <stdint.h>
+#include "desk_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Gains for the standard actuator (235 um/s per PWM step, ~20 ms mechanical time constant,
+// encoder velocity over 64 ms): loop gain 0.5, integral time 200 ms, no D on the coarse velocity
+static const uint8_t SPEED_CONTROL_GAIN_SHIFT = 20U;
+static const int32_t SPEED_CONTROL_KP = 2231;  // PWM / (um/s) << 20
+static const int32_t SPEED_CONTROL_KI = 11;    // PWM / (um/s * ms) << 20
+static const int32_t SPEED_CONTROL_KD = 0;     // PWM * ms / (um/s) << 20
+static const uint32_t SPEED_CONTROL_MAX_UM_S = 100000UL;  // Setpoints above are clamped (keeps the products in 32 bits)
+
+/**
+ * @brief Velocity the speed controller closes the loop on (DeskControl_setSpeedControl())
+ */
+typedef enum
+{
+    SPEED_FEEDBACK_OFF = 0,       ///< Open loop: PWM = AppOutput_t.motor_speed
+    SPEED_FEEDBACK_ESTIMATE = 1,  ///< Feedforward only: the estimate is the model, feeding it back adds nothing
+    SPEED_FEEDBACK_ENCODER = 2    ///< PID on the quadrature encoder velocity
+} SpeedFeedback_t;
+
+typedef struct
+{
+    MotorDirection_t dir;         ///< Drive of the previous update (MOTOR_STOP = none)
+    int32_t integral;             ///< I term (PWM << SPEED_CONTROL_GAIN_SHIFT)
+    int32_t last_measured_um_s;   ///< Measurement of the previous update (D term)
+    uint32_t last_ms;             ///< Time of the previous update
+    uint8_t pwm;                  ///< Output of the previous update
+} SpeedController_t;
+
+/**
+ * @brief Forget the integral and the previous drive
+ */
+void SpeedController_init(SpeedController_t *controller);
+
+/**
+ * @brief One controller step (1 kHz; repeated calls within the same ms only recompute the output)
+ *
+ * @param drive_dir - Drive commanded (MOTOR_STOP: resets, returns 0)
+ * @param setpoint_um_s - Speed to hold
+ * @param feedforward_pwm - PWM expected to hold the setpoint (PositionEstimator_pwmForSpeed())
+ * @param measured_um_s - Speed along drive_dir
+ * @param integrate - false holds the integral (ramps, where the MotorController scales the output)
+ * @param now_ms - Current time
+ * @return uint8_t - Target PWM for the MotorController
+ */
+uint8_t SpeedController_update(SpeedController_t *controller, MotorDirection_t drive_dir, uint32_t setpoint_um_s,
+                               uint8_t feedforward_pwm, int32_t measured_um_s, bool integrate, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPEED_CONTROLLER_H
@@ -0,0 +1,170 @@
+#include "task_profiler.h"
+
+#if DESK_ENABLE_PROFILING
+
+#include "hal.h"
+
+static DESK_THREAD_LOCAL TaskProfile_t profile;
+static DESK_THREAD_LOCAL bool have_previous_start = false;
+static DESK_THREAD_LOCAL uint32_t previous_start_us = 0U;
+static DESK_THREAD_LOCAL uint32_t task_start_us = 0U;
+static DESK_THREAD_LOCAL uint32_t phase_mark_us = 0U;
+static DESK_THREAD_LOCAL uint32_t last_report_ms = 0U;
+
+static const char *const phase_names[PROFILE_PHASE_COUNT] = {"input", "app", "motor", "output", "total"};
+
+/**
+ * @brief Map a duration to its log2 histogram bucket (see task_profiler.h)
+ */
+static uint8_t bucket_of(uint32_t duration_us)
+{
+    uint8_t bucket = 0U;
+    while ((duration_us != 0U) && (bucket < (PROFILE_HISTOGRAM_BUCKETS - 1U)))
+    {
+        duration_us >>= 1U;
+        ++bucket;
+    }
+    return bucket;
+}
+
+static void record(ProfilePhase_t phase, uint32_t duration_us)
+{
+    ProfilePhaseStats_t *stats = &profile.phase[phase];
+    const uint8_t bucket = bucket_of(duration_us);
+    if (stats->histogram[bucket] < UINT16_MAX)
+    {
+        ++stats->histogram[bucket];
+    }
+    if (duration_us > stats->wcet_us)
+    {
+        stats->wcet_us = duration_us;
+    }
+    stats->last_us = duration_us;
+}
+
+void TaskProfiler_init(void)
+{
+    HAL_debugInit(PROFILE_SERIAL_BAUD);
+    TaskProfiler_reset();
+    last_report_ms = HAL_getTime();
+}
+
+void TaskProfiler_reset(void)
+{
+    for (uint8_t p = 0U; p < static_cast<uint8_t>(PROFILE_PHASE_COUNT); ++p)
+    {
+        for (uint8_t b = 0U; b < PROFILE_HISTOGRAM_BUCKETS; ++b)
+        {
+            profile.phase[p].histogram[b] = 0U;
+        }
+        profile.phase[p].wcet_us = 0U;
+        profile.phase[p].last_us = 0U;
+    }
+    profile.ticks = 0U;
+    profile.overruns = 0U;
+    profile.late_starts = 0U;
+    profile.max_late_us = 0U;
+    profile.max_early_us = 0U;
+    have_previous_start = false;
+}
+
+void TaskProfiler_beginTask(void)
+{
+    const uint32_t now_us = HAL_getTimeUs();
+    if (have_previous_start)
+    {
+        // Unsigned interval is wrap-safe; compare against the nominal period
+        const uint32_t interval_us = now_us - previous_start_us;
+        const uint32_t deviation_us = (interval_us >= PROFILE_TASK_PERIOD_US)
+                                          ? (interval_us - PROFILE_TASK_PERIOD_US)
+                                          : (PROFILE_TASK_PERIOD_US - interval_us);
+        if (interval_us >= PROFILE_TASK_PERIOD_US)
+        {
+            profile.max_late_us = (deviation_us > profile.max_late_us) ? deviation_us : profile.max_late_us;
+        }
+        else
+        {
+            profile.max_early_us = (deviation_us > profile.max_early_us) ? deviation_us : profile.max_early_us;
+        }
+        if (deviation_us > PROFILE_JITTER_TOLERANCE_US)
+        {
+            ++profile.late_starts;
+        }
+    }
+    have_previous_start = true;
+    previous_start_us = now_us;
+    task_start_us = now_us;
+    phase_mark_us = now_us;
+}
+
+void TaskProfiler_endPhase(ProfilePhase_t phase)
+{
+    const uint32_t now_us = HAL_getTimeUs();
+    if (phase < PROFILE_PHASE_TOTAL)
+    {
+        record(phase, now_us - phase_mark_us);
+    }
+    phase_mark_us = now_us;
+}
+
+void TaskProfiler_endTask(void)
+{
+    const uint32_t total_us = HAL_getTimeUs() - task_start_us;
+    record(PROFILE_PHASE_TOTAL, total_us);
+    if (total_us > PROFILE_TASK_BUDGET_US)
+    {
+        ++profile.overruns;
+    }
+    ++profile.ticks;
+}
+
+const TaskProfile_t *TaskProfiler_get(void)
+{
+    return &profile;
+}
+
+static void print_field(const char *name, uint32_t value)
+{
+    HAL_debugPrint(name);
+    HAL_debugPrintU32(value);
+}
+
+void TaskProfiler_report(void)
+{
+    print_field("PROFILE ticks=", profile.ticks);
+    print_field(" overruns=", profile.overruns);
+    print_field(" late_starts=", profile.late_starts);
+    print_field(" max_late_us=", profile.max_late_us);
+    print_field(" max_early_us=", profile.max_early_us);
+    HAL_debugPrint("\n");
+
+    for (uint8_t p = 0U; p < static_cast<uint8_t>(PROFILE_PHASE_COUNT); ++p)
+    {
+        const ProfilePhaseStats_t *stats = &profile.phase[p];
+        HAL_debugPrint("PHASE ");
+        HAL_debugPrint(phase_names[p]);
+        print_field(" wcet_us=", stats->wcet_us);
+        print_field(" last_us=", stats->last_us);
+        HAL_debugPrint(" hist=");
+        for (uint8_t b = 0U; b < PROFILE_HISTOGRAM_BUCKETS; ++b)
+        {
+            if (b > 0U)
+            {
+                HAL_debugPrint(",");
+            }
+            HAL_debugPrintU32(stats->histogram[b]);
+        }
+        HAL_debugPrint("\n");
+    }
+}
+
+void TaskProfiler_reportIfDue(uint32_t now_ms)
+{
+    if ((now_ms - last_report_ms) >= PROFILE_REPORT_PERIOD_MS)
+    {
+        last_report_ms = now_ms;
+        TaskProfiler_report();
+    }
+}
+
+#endif // DESK_ENABLE_PROFILING
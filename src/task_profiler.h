@@ -0,0 +1,141 @@
+/**
+ * @file task_profiler.h
+ * @brief Control task execution-time and start-jitter instrumentation
+ *
+ * Measures every DeskControl_Task() cycle with HAL_getTimeUs() timestamps:
+ * - Per-phase durations (input read, APP_Task, MotorController_update,
+ *   HAL apply) and the whole task, each as a fixed-size log2 histogram
+ *   plus worst-case execution time (WCET) and the last sample
+ * - Start-time jitter against the 250 ms schedule (SWReq-011: 250 ± 10 ms):
+ *   largest late / early start and the number of starts outside tolerance
+ * - Overruns: cycles whose execution time exceeds PROFILE_TASK_BUDGET_US
+ *
+ * @compile_time_switch
+ * DESK_ENABLE_PROFILING = 0 (default on target): every TaskProfiler_*
+ * function is an empty inline stub, so instrumentation points cost nothing
+ * and no RAM is reserved. Set to 1 here or with -DDESK_ENABLE_PROFILING=1
+ * (host builds enable it via CMake) to collect statistics.
+ *
+ * @readout
+ * - Host tests: TaskProfiler_get()
+ * - Target: TaskProfiler_reportIfDue() prints a text report over the
+ *   diagnostic serial port every PROFILE_REPORT_PERIOD_MS
+ *
+ * @histogram_buckets
+ * Bucket 0 counts 0 µs samples; bucket k (k ≥ 1) counts [2^(k-1), 2^k) µs;
+ * the last bucket collects everything from 2^(BUCKETS-2) µs (16.4 ms) up.
+ *
+ * @thread_safety NOT thread-safe (single-threaded main loop)
+ */
+
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "desk_control.h"
+
+#ifndef DESK_ENABLE_PROFILING
+#define DESK_ENABLE_PROFILING 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    PROFILE_PHASE_INPUT = 0,    ///< HAL input reads (buttons, limits, current)
+    PROFILE_PHASE_APP = 1,      ///< APP_Task()
+    PROFILE_PHASE_MOTOR = 2,    ///< MotorController_update() and fault latch
+    PROFILE_PHASE_OUTPUT = 3,   ///< HAL_setMotor() / HAL_setLED()
+    PROFILE_PHASE_TOTAL = 4,    ///< Whole DeskControl_Task() cycle
+    PROFILE_PHASE_COUNT = 5
+} ProfilePhase_t;
+
+static const uint8_t PROFILE_HISTOGRAM_BUCKETS = 16U;
+static const uint32_t PROFILE_TASK_PERIOD_US = DESK_CONTROL_APP_PERIOD_MS * 1000U;
+static const uint32_t PROFILE_JITTER_TOLERANCE_US = 10000U;   // SWReq-011: ± 10 ms
+static const uint32_t PROFILE_TASK_BUDGET_US = 10000U;        // Longer cycles push the next start out of tolerance
+static const uint32_t PROFILE_REPORT_PERIOD_MS = 10000U;
+static const uint32_t PROFILE_SERIAL_BAUD = 115200U;
+
+typedef struct
+{
+    uint16_t histogram[PROFILE_HISTOGRAM_BUCKETS];  ///< Saturating sample counts
+    uint32_t wcet_us;                               ///< Longest sample
+    uint32_t last_us;                               ///< Most recent sample
+} ProfilePhaseStats_t;
+
+typedef struct
+{
+    ProfilePhaseStats_t phase[PROFILE_PHASE_COUNT];
+    uint32_t ticks;            ///< Completed task cycles
+    uint32_t overruns;         ///< Cycles longer than PROFILE_TASK_BUDGET_US
+    uint32_t late_starts;      ///< Starts outside ± PROFILE_JITTER_TOLERANCE_US
+    uint32_t max_late_us;      ///< Largest start delay against previous start + period
+    uint32_t max_early_us;     ///< Largest start advance against previous start + period
+} TaskProfile_t;
+
+#if DESK_ENABLE_PROFILING
+
+/**
+ * @brief Open the diagnostic serial port and clear all statistics
+ */
+void TaskProfiler_init(void);
+
+/**
+ * @brief Clear all statistics; the next task start sets the jitter reference
+ */
+void TaskProfiler_reset(void);
+
+/**
+ * @brief Mark the start of a control cycle (records start jitter)
+ */
+void TaskProfiler_beginTask(void);
+
+/**
+ * @brief Close a phase: records the time since the previous mark
+ *
+ * @param phase - PROFILE_PHASE_INPUT..PROFILE_PHASE_OUTPUT
+ */
+void TaskProfiler_endPhase(ProfilePhase_t phase);
+
+/**
+ * @brief Mark the end of the control cycle (records total time and overruns)
+ */
+void TaskProfiler_endTask(void);
+
+/**
+ * @brief Read the collected statistics
+ */
+const TaskProfile_t *TaskProfiler_get(void);
+
+/**
+ * @brief Print the statistics over the diagnostic serial port
+ */
+void TaskProfiler_report(void);
+
+/**
+ * @brief Print a report when PROFILE_REPORT_PERIOD_MS has passed (call from loop())
+ */
+void TaskProfiler_reportIfDue(uint32_t now_ms);
+
+#else
+
+static inline void TaskProfiler_init(void) {}
+static inline void TaskProfiler_reset(void) {}
+static inline void TaskProfiler_beginTask(void) {}
+static inline void TaskProfiler_endPhase(ProfilePhase_t phase) { (void)phase; }
+static inline void TaskProfiler_endTask(void) {}
+static inline const TaskProfile_t *TaskProfiler_get(void) { return NULL; }
+static inline void TaskProfiler_report(void) {}
+static inline void TaskProfiler_reportIfDue(uint32_t now_ms) { (void)now_ms; }
+
+#endif // DESK_ENABLE_PROFILING
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_PROFILER_H
@@ -2,6 +2,7 @@
 #include "desk_app.h"
 #include "desk_types.h"
 #include "motor_config.h"
+#include "current_monitor.h"
 
 // ============================================================================
 // TEST CASE SPECIFICATION: Application Layer Component Tests
@@ -1100,4 +1101,647 @@ TEST_F(DeskAppComponentTest, TC_SWReq014_003_ObstructionDetectionDuringMovingDow
             << "MT_BASIC: No fault detection (no current sensing)";
     }
 #endif
-}
\ No newline at end of file
+}
+// ============================================================================
+// TEST CASE: TC-APP-CTX-001 - Independent Application Contexts
+// ============================================================================
+// Requirement: Re-entrant DeskApp instances (many desks per process)
+//
+// Test Objective:
+//   Verify that caller-owned AppContext_t instances keep fully independent
+//   state and that the context API matches the default-instance API.
+//
+// Test Steps:
+//   1. Initialize two contexts
+//   2. Drive context A into MOVING_UP and context B into a latched button fault
+//   3. Run the same input sequence through APP_Task() (default instance)
+//
+// Expected Results:
+//   - Context A: MOVING_UP, no fault; context B: FAULT with error LED
+//   - Default instance output and state match context A for identical inputs
+//
+// Rationale:
+//   - Fleet simulation steps thousands of controllers without shared statics
+// ============================================================================
+TEST_F(DeskAppComponentTest, TC_APP_CTX_001_IndependentContexts)
+{
+    AppContext_t ctx_a;
+    AppContext_t ctx_b;
+    APP_InitCtx(&ctx_a);
+    APP_InitCtx(&ctx_b);
+
+    AppInput_t up_inputs = {0};
+    up_inputs.motor_type = MotorConfig_getMotorType();
+    up_inputs.button_up = true;
+    up_inputs.timestamp_ms = 0U;
+
+    AppInput_t conflict_inputs = up_inputs;
+    conflict_inputs.button_down = true;
+
+    AppOutput_t out_a;
+    AppOutput_t out_b;
+    APP_TaskCtx(&ctx_a, &up_inputs, &out_a);
+    APP_TaskCtx(&ctx_b, &conflict_inputs, &out_b);
+
+    EXPECT_EQ(APP_GetStateCtx(&ctx_a), APP_STATE_MOVING_UP);
+    EXPECT_EQ(out_a.motor_cmd, MOTOR_UP);
+    EXPECT_FALSE(out_a.fault_out);
+    EXPECT_EQ(APP_GetStateCtx(&ctx_b), APP_STATE_FAULT);
+    EXPECT_EQ(out_b.motor_cmd, MOTOR_STOP);
+    EXPECT_EQ(out_b.led_error, LED_ON);
+
+    // Default instance is untouched by context calls and behaves identically
+    EXPECT_EQ(APP_GetState(), APP_STATE_IDLE);
+    AppOutput_t out_default;
+    APP_Task(&up_inputs, &out_default);
+    EXPECT_EQ(APP_GetState(), APP_GetStateCtx(&ctx_a));
+    EXPECT_EQ(out_default.motor_cmd, out_a.motor_cmd);
+    EXPECT_EQ(out_default.motor_speed, out_a.motor_speed);
+    EXPECT_EQ(out_default.led_bt_up, out_a.led_bt_up);
+}
+
+// ============================================================================
+// TEST CASE: TC-APP-SAFETY-001 - Fast-Path Safety Check Mirrors Stop Rules
+// ============================================================================
+// Requirement: SWReq-004, SWReq-005, SWReq-006, SWReq-010
+//
+// Test Objective:
+//   Verify that APP_SafetyCheck() requests a stop for exactly the conditions
+//   under which APP_Task() removes drive, without changing application state.
+//
+// Test Steps:
+//   1. Evaluate each stop condition for MOTOR_UP, MOTOR_DOWN and MOTOR_STOP
+//   2. Evaluate NULL inputs
+//
+// Expected Results:
+//   - Limit only stops the direction running into it
+//   - Dual limit, dual button and external fault stop both directions
+//   - MOTOR_STOP never needs a stop; NULL inputs always do
+//   - Application state remains IDLE
+// ============================================================================
+TEST_F(DeskAppComponentTest, TC_APP_SAFETY_001_SafetyCheckMirrorsStopRules)
+{
+    AppInput_t inputs = {0};
+    inputs.motor_type = MotorConfig_getMotorType();
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_UP), APP_SAFETY_OK);
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_DOWN), APP_SAFETY_OK);
+
+    inputs.limit_upper = true;
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_UP), APP_SAFETY_LIMIT);
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_DOWN), APP_SAFETY_OK) << "Driving away from the limit is allowed";
+
+    inputs.limit_lower = true;
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_DOWN), APP_SAFETY_DUAL_LIMIT);
+    inputs.limit_upper = false;
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_DOWN), APP_SAFETY_LIMIT);
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_UP), APP_SAFETY_OK);
+    inputs.limit_lower = false;
+
+    inputs.button_up = true;
+    inputs.button_down = true;
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_UP), APP_SAFETY_DUAL_BUTTON);
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_DOWN), APP_SAFETY_DUAL_BUTTON);
+
+    inputs.fault_in = true;
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_UP), APP_SAFETY_EXTERNAL_FAULT) << "Most severe rule reported first";
+    EXPECT_EQ(APP_SafetyCheck(&inputs, MOTOR_STOP), APP_SAFETY_OK);
+
+    EXPECT_EQ(APP_SafetyCheck(NULL, MOTOR_STOP), APP_SAFETY_INVALID_INPUT);
+    EXPECT_EQ(APP_GetState(), APP_STATE_IDLE);
+}
+
+// ============================================================================
+// TEST CASE: TC-SWReq014-004 - 1 kHz Current Summary Catches Inter-Cycle Jams
+// ============================================================================
+// Requirement ID: SWReq-014, SysReq-013 (Jam/obstruction detection - FSR-007)
+//
+// Test Objective:
+//   Verify that APP_Task() latches the current fault from the 1 kHz summary
+//   (CurrentSummary_t) even when the single reading at the cycle is normal,
+//   and that runs shorter than MOTOR_SENSE_FAULT_TIME_MS are tolerated.
+//
+// Test Steps:
+//   1. Start moving up with a summary of normal current
+//   2. Next cycle: 60 ms obstruction run, normal reading at the cycle
+//   3. Next cycle: 150 ms obstruction run, normal reading at the cycle
+//   4. Repeat with a 120 ms stuck-on run while STOP is commanded
+//   5. Repeat with a 120 ms run above the learned baseline limit while moving
+//
+// Expected Results:
+//   - Step 2 keeps moving; steps 3-5 latch FAULT (current sensing builds)
+//   - Without current sensing no summary ever latches a fault
+// ============================================================================
+TEST_F(DeskAppComponentTest, TC_SWReq014_004_CurrentSummaryCatchesInterCycleJam)
+{
+    const bool sensing = (MotorConfig_effectiveType(MT_ROBUST) == MT_ROBUST);
+    AppContext_t ctx;
+    APP_InitCtx(&ctx);
+
+    AppInput_t inputs = {0};
+    inputs.motor_type = MT_ROBUST;
+    inputs.button_up = true;
+    inputs.motor_current_ma = 100U;
+    inputs.current_summary.samples = 250U;
+    inputs.current_summary.peak_ma = 110U;
+    inputs.current_summary.mean_ma = 100U;
+    inputs.timestamp_ms = 250U;
+    AppOutput_t outputs;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    ASSERT_EQ(APP_GetStateCtx(&ctx), APP_STATE_MOVING_UP);
+
+    inputs.current_summary.peak_ma = 300U;
+    inputs.current_summary.obstruction_run_ms = 60U;
+    inputs.timestamp_ms = 500U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_MOVING_UP) << "60 ms run is a transient";
+    EXPECT_EQ(ctx.obstruction_timer_start_ms, UINT32_MAX) << "Summary path needs no cycle timer";
+
+    inputs.current_summary.obstruction_run_ms = 150U;
+    inputs.timestamp_ms = 750U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), sensing ? APP_STATE_FAULT : APP_STATE_MOVING_UP);
+    EXPECT_EQ(outputs.fault_out, sensing);
+
+    // Stuck-on: current with drive off, reading at the cycle already back to normal
+    APP_InitCtx(&ctx);
+    inputs.button_up = false;
+    inputs.current_summary.obstruction_run_ms = 0U;
+    inputs.current_summary.stuck_run_ms = 120U;
+    inputs.timestamp_ms = 1000U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), sensing ? APP_STATE_FAULT : APP_STATE_IDLE);
+
+    // Baseline deviation: below the fixed threshold, above the level learned for this position
+    APP_InitCtx(&ctx);
+    inputs.button_up = true;
+    inputs.current_summary.stuck_run_ms = 0U;
+    inputs.current_summary.deviation_run_ms = 120U;
+    inputs.timestamp_ms = 1250U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), sensing ? APP_STATE_FAULT : APP_STATE_MOVING_UP);
+}
+
+// ============================================================================
+// TEST CASE: TC-SWReq014-005 - Soft-Start Inrush Envelope
+// ============================================================================
+// Requirement ID: SWReq-014, SysReq-013 (Jam/obstruction detection - FSR-007)
+//
+// Test Objective:
+//   Verify that the obstruction limit follows the ramp phase of the drive
+//   applied: inrush above MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA is tolerated
+//   while MotorController ramps up, the same current faults once cruising.
+//
+// Test Steps:
+//   1. Move up, 250 mA for 150 ms while MOTOR_PHASE_RAMP_UP at PWM 255
+//   2. Same current for 150 ms while MOTOR_PHASE_CRUISE
+//   3. Check the envelope: flat outside the ramp-up, scaled by PWM within it
+//
+// Expected Results:
+//   - Step 1 keeps moving; step 2 latches FAULT (current sensing builds)
+// ============================================================================
+TEST_F(DeskAppComponentTest, TC_SWReq014_005_InrushEnvelopeDuringRampUp)
+{
+    const bool sensing = (MotorConfig_effectiveType(MT_ROBUST) == MT_ROBUST);
+    AppContext_t ctx;
+    APP_InitCtx(&ctx);
+
+    AppInput_t inputs = {0};
+    inputs.motor_type = MT_ROBUST;
+    inputs.button_up = true;
+    inputs.motor_current_ma = 250U;
+    inputs.motor_phase = MOTOR_PHASE_RAMP_UP;
+    inputs.motor_pwm = 255U;
+    AppOutput_t outputs;
+    for (uint32_t t = 0U; t <= 150U; t += 10U)
+    {
+        inputs.timestamp_ms = t;
+        APP_TaskCtx(&ctx, &inputs, &outputs);
+    }
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_MOVING_UP) << "Inrush within the envelope";
+    EXPECT_EQ(ctx.obstruction_timer_start_ms, UINT32_MAX);
+
+    inputs.motor_phase = MOTOR_PHASE_CRUISE;
+    for (uint32_t t = 160U; t <= 310U; t += 10U)
+    {
+        inputs.timestamp_ms = t;
+        APP_TaskCtx(&ctx, &inputs, &outputs);
+    }
+    EXPECT_EQ(APP_GetStateCtx(&ctx), sensing ? APP_STATE_FAULT : APP_STATE_MOVING_UP);
+
+    EXPECT_EQ(CurrentMonitor_obstructionLimitMa(MOTOR_PHASE_CRUISE, 255U), MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA);
+    EXPECT_EQ(CurrentMonitor_obstructionLimitMa(MOTOR_PHASE_RAMP_DOWN, 255U), MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA);
+    EXPECT_EQ(CurrentMonitor_obstructionLimitMa(MOTOR_PHASE_RAMP_UP, 0U), MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA);
+    EXPECT_EQ(CurrentMonitor_obstructionLimitMa(MOTOR_PHASE_RAMP_UP, 255U),
+              MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA + MOTOR_SENSE_INRUSH_ALLOWANCE_MA);
+}
+
+// ============================================================================
+// TEST CASE: TC-APP-TARGET-001 - Move To Target Starts And Ends
+// ============================================================================
+// Test Objective:
+//   Verify that a move_to_target request drives towards target_height_um in
+//   APP_STATE_MOVING_TO_TARGET and that the move ends on the braking point,
+//   on arrival within APP_TARGET_TOLERANCE_UM and on the limit switch.
+//
+// Test Steps:
+//   1. Request a move without a referenced estimate, then within the tolerance
+//   2. Request a move 100 mm up; hold it for a cycle without the request
+//   3. Report target_reached
+//   4. Request a move 100 mm down; reach the tolerance
+//   5. Request a move down; activate the lower limit switch
+//
+// Expected Results:
+//   - Step 1 stays IDLE
+//   - Step 2 drives up at full speed with moving_to_target and the target set
+//   - Steps 3 and 4 return to IDLE with a soft stop
+//   - Step 5 returns to IDLE without a soft stop (SysReq-007)
+// ============================================================================
+TEST_F(DeskAppComponentTest, TC_APP_TARGET_001_MoveToTargetStartsAndEnds)
+{
+    AppContext_t ctx;
+    APP_InitCtx(&ctx);
+
+    AppInput_t inputs = {0};
+    inputs.motor_type = MT_BASIC;
+    inputs.position_estimate.height_um = 300000;
+    inputs.move_to_target = true;
+    inputs.target_height_um = 400000;
+    AppOutput_t outputs;
+
+    // Step 1: no reference, then already there
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE) << "Unreferenced estimate: no target move";
+    inputs.position_estimate.referenced = true;
+    inputs.target_height_um = 300000 + APP_TARGET_TOLERANCE_UM;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE) << "Target within the tolerance";
+
+    // Step 2: start, then keep going without the request
+    inputs.target_height_um = 400000;
+    inputs.timestamp_ms = 10U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_MOVING_TO_TARGET);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_UP);
+    EXPECT_EQ(outputs.motor_speed, 255U);
+    EXPECT_EQ(outputs.led_bt_up, LED_ON);
+    EXPECT_TRUE(outputs.moving_to_target);
+    EXPECT_EQ(outputs.target_height_um, 400000);
+    EXPECT_FALSE(outputs.soft_stop);
+    EXPECT_EQ(ctx.state_entry_time, 10U);
+
+    inputs.move_to_target = false;
+    inputs.position_estimate.height_um = 350000;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_MOVING_TO_TARGET);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_UP);
+
+    // Step 3: braking point passed on the 1 kHz path
+    inputs.target_reached = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+    EXPECT_FALSE(outputs.moving_to_target);
+    EXPECT_EQ(outputs.target_height_um, 0);
+    EXPECT_TRUE(outputs.soft_stop);
+    EXPECT_EQ(ctx.target_dir, MOTOR_STOP);
+    inputs.target_reached = false;
+
+    // Step 4: down, ends within the tolerance
+    inputs.move_to_target = true;
+    inputs.target_height_um = 250000;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_DOWN);
+    EXPECT_EQ(outputs.led_bt_down, LED_ON);
+    inputs.move_to_target = false;
+    inputs.position_estimate.height_um = 250000 + APP_TARGET_TOLERANCE_UM;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    EXPECT_TRUE(outputs.soft_stop);
+
+    // Step 5: lower limit switch ends the move without a ramp
+    inputs.move_to_target = true;
+    inputs.target_height_um = 0;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_DOWN);
+    inputs.move_to_target = false;
+    inputs.limit_lower = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+    EXPECT_FALSE(outputs.soft_stop) << "SAFETY: limit stop must not ramp";
+
+    // Already at the lower limit: a target below is refused
+    inputs.move_to_target = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+}
+
+// ============================================================================
+// TEST CASE: TC-APP-TARGET-002 - Buttons Abort And Faults Latch
+// ============================================================================
+// Test Objective:
+//   Verify that any button aborts a move to target without starting a manual
+//   move until all buttons are released, and that the fault latches end a
+//   move to target as they end a manual move.
+//
+// Test Steps:
+//   1. Start a move up; press DOWN; hold DOWN; release; press DOWN again
+//   2. Start a move up; assert fault_in
+//   3. Release fault_in; request the move again while the fault is cleared
+//
+// Expected Results:
+//   - Step 1 stops on the press (soft stop), stays IDLE while DOWN is held,
+//     then moves down on the new press
+//   - Step 2 latches FAULT, removes drive at once and clears moving_to_target
+//   - Step 3 recovers to IDLE without resuming the move; the new request starts it
+// ============================================================================
+TEST_F(DeskAppComponentTest, TC_APP_TARGET_002_ButtonsAbortAndFaultsLatch)
+{
+    AppContext_t ctx;
+    APP_InitCtx(&ctx);
+
+    AppInput_t inputs = {0};
+    inputs.motor_type = MT_BASIC;
+    inputs.position_estimate.referenced = true;
+    inputs.position_estimate.height_um = 100000;
+    inputs.target_height_um = 500000;
+    AppOutput_t outputs;
+
+    // Step 1: DOWN aborts, must be released before it moves the desk
+    inputs.move_to_target = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    ASSERT_EQ(APP_GetStateCtx(&ctx), APP_STATE_MOVING_TO_TARGET);
+    inputs.move_to_target = false;
+    inputs.button_down = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+    EXPECT_TRUE(outputs.soft_stop);
+    EXPECT_TRUE(ctx.button_release_pending);
+
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE) << "The aborting press must not start a manual move";
+    inputs.move_to_target = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE) << "No target move while a button is held";
+    inputs.move_to_target = false;
+
+    inputs.button_down = false;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_FALSE(ctx.button_release_pending);
+    inputs.button_down = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_MOVING_DOWN);
+    inputs.button_down = false;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    ASSERT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+
+    // Step 2: external fault during the move
+    inputs.move_to_target = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    ASSERT_EQ(APP_GetStateCtx(&ctx), APP_STATE_MOVING_TO_TARGET);
+    inputs.move_to_target = false;
+    inputs.fault_in = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_FAULT);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+    EXPECT_FALSE(outputs.soft_stop) << "SAFETY: faults remove drive immediately";
+    EXPECT_FALSE(outputs.moving_to_target);
+    EXPECT_TRUE(outputs.fault_out);
+    EXPECT_EQ(ctx.target_dir, MOTOR_STOP);
+
+    // Step 3: recovery does not resume the move
+    inputs.fault_in = false;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    inputs.move_to_target = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_MOVING_TO_TARGET);
+}
+
+// ============================================================================
+// TEST CASE: TC-APP-CAL-001 - Calibration Homes Then Strokes Up
+// ============================================================================
+// Test Objective:
+//   Verify that a calibrate request runs APP_STATE_CALIBRATING as two legs:
+//   down to the lower limit switch, then up to the upper one, reporting
+//   calibration_done once, and that a leg which never reaches its switch is
+//   aborted after APP_CALIBRATION_LEG_TIMEOUT_MS.
+//
+// Test Steps:
+//   1. Request a calibration away from the switches; hold a cycle without the request
+//   2. Activate the lower limit switch
+//   3. Run a cycle at the lower limit, then release it and activate the upper one
+//   4. Request a calibration at the lower limit switch
+//   5. Let the leg run APP_CALIBRATION_LEG_TIMEOUT_MS without reaching the switch
+//
+// Expected Results:
+//   - Step 1 drives down at full speed with calibrating set
+//   - Step 2 stops without a ramp and stays CALIBRATING
+//   - Step 3 drives up, then stops without a ramp in IDLE with calibration_done
+//   - Step 4 starts with the stroke up
+//   - Step 5 stops at once in IDLE without calibration_done
+// ============================================================================
+TEST_F(DeskAppComponentTest, TC_APP_CAL_001_HomesThenStrokesUp)
+{
+    AppContext_t ctx;
+    APP_InitCtx(&ctx);
+
+    AppInput_t inputs = {0};
+    inputs.motor_type = MT_BASIC;
+    inputs.calibrate = true;
+    inputs.timestamp_ms = 10U;
+    AppOutput_t outputs;
+
+    // Step 1: homing leg
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_CALIBRATING);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_DOWN);
+    EXPECT_EQ(outputs.motor_speed, 255U);
+    EXPECT_EQ(outputs.led_bt_down, LED_ON);
+    EXPECT_TRUE(outputs.calibrating);
+    EXPECT_FALSE(outputs.calibration_done);
+    EXPECT_FALSE(outputs.soft_stop);
+    EXPECT_EQ(ctx.calibration_dir, MOTOR_DOWN);
+
+    inputs.calibrate = false;
+    inputs.timestamp_ms = 260U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_DOWN);
+
+    // Step 2: homed
+    inputs.limit_lower = true;
+    inputs.timestamp_ms = 510U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_CALIBRATING);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+    EXPECT_FALSE(outputs.soft_stop) << "SAFETY: limit stop must not ramp";
+    EXPECT_TRUE(outputs.calibrating);
+    EXPECT_EQ(ctx.calibration_dir, MOTOR_UP);
+    EXPECT_EQ(ctx.state_entry_time, 510U) << "The stroke leg gets its own timeout";
+
+    // Step 3: stroke up
+    inputs.timestamp_ms = 760U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_UP);
+    EXPECT_EQ(outputs.led_bt_up, LED_ON);
+    EXPECT_TRUE(outputs.calibrating);
+    inputs.limit_lower = false;
+    inputs.timestamp_ms = 20760U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_UP);
+    inputs.limit_upper = true;
+    inputs.timestamp_ms = 21010U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+    EXPECT_FALSE(outputs.soft_stop) << "SAFETY: limit stop must not ramp";
+    EXPECT_FALSE(outputs.calibrating);
+    EXPECT_TRUE(outputs.calibration_done);
+    EXPECT_EQ(ctx.calibration_dir, MOTOR_STOP);
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_FALSE(outputs.calibration_done) << "Reported for one cycle";
+
+    // Step 4: already homed
+    inputs.limit_upper = false;
+    inputs.limit_lower = true;
+    inputs.calibrate = true;
+    inputs.timestamp_ms = 30000U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_CALIBRATING);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_UP);
+    inputs.calibrate = false;
+
+    // Step 5: the upper switch never comes
+    inputs.limit_lower = false;
+    inputs.timestamp_ms = 30000U + APP_CALIBRATION_LEG_TIMEOUT_MS - 1U;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_UP);
+    inputs.timestamp_ms = 30000U + APP_CALIBRATION_LEG_TIMEOUT_MS;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+    EXPECT_FALSE(outputs.soft_stop) << "An overrun leg stops at once";
+    EXPECT_FALSE(outputs.calibration_done);
+}
+
+// ============================================================================
+// TEST CASE: TC-APP-CAL-002 - Buttons And Faults Abort Calibration
+// ============================================================================
+// Test Objective:
+//   Verify that any button aborts a calibration in either leg without starting
+//   a manual move, and that every fault path (external, current, dual limit)
+//   ends it for good.
+//
+// Test Steps:
+//   1. Calibrate; press UP during the homing leg; hold; release
+//   2. Calibrate from the lower limit; press DOWN during the stroke up
+//   3. Calibrate; assert fault_in; clear it
+//   4. Calibrate (MT_ROBUST); report an obstruction run; release (current
+//      sensing builds)
+//   5. Calibrate; activate both limit switches; release them
+//
+// Expected Results:
+//   - Steps 1 and 2 stop with a soft stop in IDLE, start nothing while the
+//     button is held and never report calibration_done
+//   - Steps 3 to 5 latch FAULT with drive removed at once, clear calibrating
+//     and return to IDLE without resuming the calibration
+// ============================================================================
+TEST_F(DeskAppComponentTest, TC_APP_CAL_002_ButtonsAndFaultsAbort)
+{
+    AppContext_t ctx;
+    APP_InitCtx(&ctx);
+
+    AppInput_t inputs = {0};
+    inputs.motor_type = MT_BASIC;
+    AppOutput_t outputs;
+
+    // Step 1: UP aborts the homing leg
+    inputs.calibrate = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    ASSERT_EQ(APP_GetStateCtx(&ctx), APP_STATE_CALIBRATING);
+    inputs.calibrate = false;
+    inputs.button_up = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+    EXPECT_TRUE(outputs.soft_stop);
+    EXPECT_FALSE(outputs.calibrating);
+    EXPECT_FALSE(outputs.calibration_done);
+    EXPECT_TRUE(ctx.button_release_pending);
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE) << "The aborting press must not start a manual move";
+    inputs.button_up = false;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+
+    // Step 2: DOWN aborts the stroke up
+    inputs.limit_lower = true;
+    inputs.calibrate = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    ASSERT_EQ(outputs.motor_cmd, MOTOR_UP);
+    inputs.calibrate = false;
+    inputs.limit_lower = false;
+    inputs.button_down = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    EXPECT_TRUE(outputs.soft_stop);
+    EXPECT_FALSE(outputs.calibration_done);
+    inputs.button_down = false;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+
+    // Step 3: external fault
+    inputs.calibrate = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    ASSERT_EQ(APP_GetStateCtx(&ctx), APP_STATE_CALIBRATING);
+    inputs.calibrate = false;
+    inputs.fault_in = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_FAULT);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+    EXPECT_FALSE(outputs.soft_stop) << "SAFETY: faults remove drive immediately";
+    EXPECT_FALSE(outputs.calibrating);
+    EXPECT_EQ(ctx.calibration_dir, MOTOR_STOP);
+    inputs.fault_in = false;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE) << "Recovery does not resume the calibration";
+
+    // Step 4: obstruction during the homing leg
+    if (MotorConfig_effectiveType(MT_ROBUST) == MT_ROBUST)  // Builds without current sensing ignore it
+    {
+        inputs.motor_type = MT_ROBUST;
+        inputs.calibrate = true;
+        APP_TaskCtx(&ctx, &inputs, &outputs);
+        ASSERT_EQ(APP_GetStateCtx(&ctx), APP_STATE_CALIBRATING);
+        inputs.calibrate = false;
+        inputs.current_summary.samples = 250U;
+        inputs.current_summary.obstruction_run_ms = MOTOR_SENSE_FAULT_TIME_MS;
+        APP_TaskCtx(&ctx, &inputs, &outputs);
+        EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_FAULT);
+        EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+        EXPECT_EQ(ctx.calibration_dir, MOTOR_STOP);
+        inputs.current_summary = CurrentSummary_t();
+        APP_TaskCtx(&ctx, &inputs, &outputs);
+        APP_TaskCtx(&ctx, &inputs, &outputs);
+        EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    }
+
+    // Step 5: dual limit (transient fault)
+    inputs.calibrate = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    ASSERT_EQ(APP_GetStateCtx(&ctx), APP_STATE_CALIBRATING);
+    inputs.calibrate = false;
+    inputs.limit_upper = true;
+    inputs.limit_lower = true;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_FAULT);
+    EXPECT_FALSE(outputs.calibration_done);
+    inputs.limit_upper = false;
+    inputs.limit_lower = false;
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    APP_TaskCtx(&ctx, &inputs, &outputs);
+    EXPECT_EQ(APP_GetStateCtx(&ctx), APP_STATE_IDLE);
+    EXPECT_EQ(outputs.motor_cmd, MOTOR_STOP);
+}
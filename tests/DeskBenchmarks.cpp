@@ -0,0 +1,229 @@
+// ============================================================================
+// CONTROL HOT-PATH MICRO-BENCHMARKS
+// ============================================================================
+// PURPOSE: Track the cost of every code path executed per control tick so a
+//          regression in ns/tick, or a change in which path a scenario takes,
+//          shows up between commits.
+//
+// COVERAGE:
+//   - APP_Task: each state and each fault path
+//   - MotorController_update: ramping, steady, stop and stall paths
+//   - MotorController_rampPwm: soft-start profile
+//   - HAL_readButton: stable and bouncing debounce paths
+//   - HAL_readMotorCurrent: filtered ADC sample (MT_ROBUST, host includes the emulated conversions) and no-sensor (MT_BASIC)
+//   - DeskControl_Task: full read -> APP_Task -> MotorController -> HAL cycle
+//   - DeskControl_FastTask: 1 kHz motor sub-task at steady speed
+//
+// OUTPUT COST: control task benchmarks report pin_writes_per_tick (HAL mock
+//   write counter), which the output shadow keeps at 0 for unchanged outputs.
+// PATH COUNTERS: each benchmark reports the state/PWM/fault it ended in, so
+//   the JSON output also records which code path was measured.
+//
+// USAGE:
+//   DeskBenchmarks --benchmark_out=desk_benchmarks.json --benchmark_out_format=json
+//   or build the run_benchmarks target (writes desk_benchmarks.json in the build dir)
+// ============================================================================
+
+#include <benchmark/benchmark.h>
+#include "desk_app.h"
+#include "desk_control.h"
+#include "hal.h"
+#include "motor_controller.h"
+#include "pin_config.h"
+#include "hal_mock/HALMock.h"
+
+namespace
+{
+const uint32_t APP_TICK_MS = 250U;
+
+/* Power-on board: all pins LOW, buttons released and limits inactive (active LOW) */
+void reset_board(MotorType_t motor_type)
+{
+    MockClock_reset();
+    for (int pin = 0; pin < 64; ++pin)
+    {
+        pin_states[pin] = LOW;
+    }
+    pin_states[PIN_BUTTON_UP] = HIGH;
+    pin_states[PIN_BUTTON_DOWN] = HIGH;
+    pin_states[PIN_LIMIT_UPPER] = HIGH;
+    pin_states[PIN_LIMIT_LOWER] = HIGH;
+    HAL_setMotorType(motor_type);
+    HAL_init();
+}
+
+AppInput_t app_inputs(bool up, bool down, bool limit_upper, bool limit_lower, bool fault_in,
+                      MotorType_t motor_type, uint16_t current_ma)
+{
+    AppInput_t inputs = AppInput_t();  // No high-rate data, encoder or target: single-sample path
+    inputs.button_up = up;
+    inputs.button_down = down;
+    inputs.limit_upper = limit_upper;
+    inputs.limit_lower = limit_lower;
+    inputs.fault_in = fault_in;
+    inputs.motor_type = motor_type;
+    inputs.motor_current_ma = current_ma;
+    inputs.motor_phase = MOTOR_PHASE_CRUISE;
+    inputs.motor_pwm = 255U;
+    return inputs;
+}
+} // namespace
+
+// ----------------------------------------------------------------------------
+// APP_Task - one benchmark per state / fault path
+// ----------------------------------------------------------------------------
+static void BM_APP_Task(benchmark::State &state, AppInput_t inputs)
+{
+    APP_Init();
+    AppOutput_t outputs;
+    uint32_t now_ms = 0U;
+    for (auto _ : state)
+    {
+        inputs.timestamp_ms = now_ms;
+        now_ms += APP_TICK_MS;
+        APP_Task(&inputs, &outputs);
+        benchmark::DoNotOptimize(outputs);
+    }
+    state.counters["state"] = static_cast<double>(APP_GetState());
+    state.counters["fault_out"] = outputs.fault_out ? 1.0 : 0.0;
+}
+BENCHMARK_CAPTURE(BM_APP_Task, idle, app_inputs(false, false, false, false, false, MT_BASIC, 0U));
+BENCHMARK_CAPTURE(BM_APP_Task, moving_up, app_inputs(true, false, false, false, false, MT_BASIC, 0U));
+BENCHMARK_CAPTURE(BM_APP_Task, moving_down, app_inputs(false, true, false, false, false, MT_BASIC, 0U));
+BENCHMARK_CAPTURE(BM_APP_Task, up_at_upper_limit, app_inputs(true, false, true, false, false, MT_BASIC, 0U));
+BENCHMARK_CAPTURE(BM_APP_Task, fault_dual_button, app_inputs(true, true, false, false, false, MT_BASIC, 0U));
+BENCHMARK_CAPTURE(BM_APP_Task, fault_external, app_inputs(false, false, false, false, true, MT_BASIC, 0U));
+BENCHMARK_CAPTURE(BM_APP_Task, fault_dual_limit, app_inputs(false, false, true, true, false, MT_BASIC, 0U));
+BENCHMARK_CAPTURE(BM_APP_Task, robust_moving_nominal_current, app_inputs(true, false, false, false, false, MT_ROBUST, 120U));
+BENCHMARK_CAPTURE(BM_APP_Task, fault_current_obstruction, app_inputs(true, false, false, false, false, MT_ROBUST, 300U));
+BENCHMARK_CAPTURE(BM_APP_Task, fault_current_stuck_on, app_inputs(false, false, false, false, false, MT_ROBUST, 300U));
+
+// ----------------------------------------------------------------------------
+// MotorController_update - ramping, steady, stop and stall paths
+// ----------------------------------------------------------------------------
+static void BM_MotorController_update(benchmark::State &state, MotorDirection_t dir, uint8_t target_pwm,
+                                      uint32_t first_ms, uint32_t step_ms)
+{
+    MotorController_init();
+    MotorControllerOutput_t out = MotorController_update(dir, target_pwm, 0U);
+    uint32_t now_ms = first_ms;
+    for (auto _ : state)
+    {
+        out = MotorController_update(dir, target_pwm, now_ms);
+        now_ms += step_ms;
+        benchmark::DoNotOptimize(out);
+    }
+    state.counters["pwm"] = static_cast<double>(out.pwm);
+    state.counters["fault"] = out.fault ? 1.0 : 0.0;
+}
+// Time frozen mid-ramp so every iteration takes the interpolation path
+BENCHMARK_CAPTURE(BM_MotorController_update, ramping, MOTOR_UP, static_cast<uint8_t>(255U), 250U, 0U);
+BENCHMARK_CAPTURE(BM_MotorController_update, steady, MOTOR_UP, static_cast<uint8_t>(255U), 1000U, APP_TICK_MS);
+BENCHMARK_CAPTURE(BM_MotorController_update, stop, MOTOR_STOP, static_cast<uint8_t>(0U), 0U, APP_TICK_MS);
+// Target below MIN_ACTIVE_PWM: stall timer runs and trips after 2 s
+BENCHMARK_CAPTURE(BM_MotorController_update, stall, MOTOR_UP, static_cast<uint8_t>(5U), 0U, APP_TICK_MS);
+
+// ----------------------------------------------------------------------------
+// Soft-start ramp profile
+// ----------------------------------------------------------------------------
+static void BM_MotorController_rampPwm(benchmark::State &state)
+{
+    uint32_t elapsed_ms = 0U;
+    for (auto _ : state)
+    {
+        uint8_t pwm = MotorController_rampPwm(255U, elapsed_ms);
+        benchmark::DoNotOptimize(pwm);
+        elapsed_ms = (elapsed_ms + 1U) % 600U;  // Covers ramp and clamped region
+    }
+}
+BENCHMARK(BM_MotorController_rampPwm);
+
+// ----------------------------------------------------------------------------
+// HAL_readButton debouncing
+// ----------------------------------------------------------------------------
+static void BM_HAL_readButton(benchmark::State &state, bool bouncing)
+{
+    reset_board(MT_BASIC);
+    pin_states[PIN_BUTTON_UP] = LOW;
+    bool pressed = false;
+    for (auto _ : state)
+    {
+        if (bouncing)
+        {
+            pin_states[PIN_BUTTON_UP] = (pin_states[PIN_BUTTON_UP] == LOW) ? HIGH : LOW;
+        }
+        MockClock_advanceUs(1000U);
+        pressed = HAL_readButton(BUTTON_UP);
+        benchmark::DoNotOptimize(pressed);
+    }
+    state.counters["pressed"] = pressed ? 1.0 : 0.0;
+}
+BENCHMARK_CAPTURE(BM_HAL_readButton, stable, false);
+BENCHMARK_CAPTURE(BM_HAL_readButton, bouncing, true);
+
+// ----------------------------------------------------------------------------
+// HAL_readMotorCurrent conversion
+// ----------------------------------------------------------------------------
+static void BM_HAL_readMotorCurrent(benchmark::State &state, MotorType_t motor_type)
+{
+    reset_board(motor_type);
+    pin_states[PIN_MOTOR_SENSE] = 512;
+    uint16_t current_ma = 0U;
+    for (auto _ : state)
+    {
+        current_ma = HAL_readMotorCurrent();
+        benchmark::DoNotOptimize(current_ma);
+    }
+    state.counters["current_ma"] = static_cast<double>(current_ma);
+}
+BENCHMARK_CAPTURE(BM_HAL_readMotorCurrent, robust_adc, MT_ROBUST);
+BENCHMARK_CAPTURE(BM_HAL_readMotorCurrent, basic_no_sensor, MT_BASIC);
+
+// ----------------------------------------------------------------------------
+// Full DeskControl_Task cycle against the HAL mock
+// ----------------------------------------------------------------------------
+static void BM_DeskControl_Task(benchmark::State &state, MotorType_t motor_type, bool hold_up)
+{
+    reset_board(motor_type);
+    DeskControl_Init(HAL_getTime());
+    pin_states[PIN_BUTTON_UP] = hold_up ? LOW : HIGH;
+    pin_write_count = 0U;
+    for (auto _ : state)
+    {
+        MockClock_advanceMs(APP_TICK_MS);
+        DeskControl_Task(HAL_getTime());
+    }
+    state.counters["state"] = static_cast<double>(APP_GetState());
+    state.counters["pin_writes_per_tick"] =
+        benchmark::Counter(static_cast<double>(pin_write_count), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_CAPTURE(BM_DeskControl_Task, basic_idle, MT_BASIC, false);
+BENCHMARK_CAPTURE(BM_DeskControl_Task, basic_moving_up, MT_BASIC, true);
+BENCHMARK_CAPTURE(BM_DeskControl_Task, robust_moving_up, MT_ROBUST, true);
+
+// ----------------------------------------------------------------------------
+// DeskControl_FastTask - 1 kHz motor sub-task
+// ----------------------------------------------------------------------------
+static void BM_DeskControl_FastTask(benchmark::State &state, MotorType_t motor_type)
+{
+    reset_board(motor_type);
+    DeskControl_Init(HAL_getTime());
+    pin_states[PIN_BUTTON_UP] = LOW;
+    MockClock_advanceMs(APP_TICK_MS);
+    DeskControl_Task(HAL_getTime());  // Commands MOTOR_UP
+    MockClock_advanceMs(1000U);       // Past the soft-start ramp: steady full speed
+    DeskControl_FastTask(HAL_getTime());
+    pin_write_count = 0U;
+    for (auto _ : state)
+    {
+        MockClock_advanceUs(1000U);
+        DeskControl_FastTask(HAL_getTime());
+    }
+    state.counters["pin_writes_per_tick"] =
+        benchmark::Counter(static_cast<double>(pin_write_count), benchmark::Counter::kAvgIterations);
+}
+// Steady full speed: the shadow leaves every pin alone
+BENCHMARK_CAPTURE(BM_DeskControl_FastTask, basic_steady, MT_BASIC);
+BENCHMARK_CAPTURE(BM_DeskControl_FastTask, robust_steady, MT_ROBUST);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+// ============================================================================
+// FLEET SIMULATION RUNNER
+// ============================================================================
+// PURPOSE: Run a large, seeded mix of closed-loop desk scenarios (loads,
+//          start heights, button timings, obstructions, dual-button faults)
+//          across all cores and print an aggregate report.
+//
+// USAGE:   FleetSimulation [--scenarios N] [--threads T] [--seed S]
+//            --scenarios  number of scenarios (default 1000)
+//            --threads    worker threads (default: hardware concurrency)
+//            --seed       scenario generator seed (default 1)
+//
+// Exit code is non-zero if any scenario failed to come to rest after release.
+// ============================================================================
+
+#include "FleetRunner.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+bool parse_arg(int argc, char **argv, int &i, const char *name, unsigned long &value)
+{
+    if ((std::strcmp(argv[i], name) != 0) || (i + 1 >= argc))
+    {
+        return false;
+    }
+    value = std::strtoul(argv[++i], nullptr, 10);
+    return true;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned long scenario_count = 1000UL;
+    unsigned long threads = std::thread::hardware_concurrency();
+    unsigned long seed = 1UL;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!parse_arg(argc, argv, i, "--scenarios", scenario_count) &&
+            !parse_arg(argc, argv, i, "--threads", threads) &&
+            !parse_arg(argc, argv, i, "--seed", seed))
+        {
+            std::fprintf(stderr, "usage: %s [--scenarios N] [--threads T] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (threads == 0UL)
+    {
+        threads = 1UL;
+    }
+
+    const std::vector<FleetScenario> scenarios =
+        FleetRunner_makeScenarios(static_cast<size_t>(scenario_count), static_cast<uint32_t>(seed));
+    std::vector<FleetScenarioResult> results;
+    FleetAggregate aggregate;
+    FleetAggregate_reset(aggregate);
+
+    const auto start = std::chrono::steady_clock::now();
+    const WorkStealingStats stats = FleetRunner_run(scenarios, static_cast<unsigned>(threads), results, aggregate);
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const uint32_t run = aggregate.scenarios.load();
+    const uint32_t reached = aggregate.limit_reached.load();
+    const uint32_t stopped = aggregate.stop_samples.load();
+
+    std::printf("Fleet simulation: %u scenarios, %lu threads, seed %lu, %.2f s wall\n",
+                run, threads, seed, wall_s);
+    std::printf("  limit reached      : %u\n", reached);
+    if (reached > 0U)
+    {
+        std::printf("  stroke time        : mean %.0f ms, max %u ms\n",
+                    static_cast<double>(aggregate.stroke_ms_sum.load()) / reached,
+                    aggregate.stroke_ms_max.load());
+    }
+    std::printf("  faults latched     : %u\n", aggregate.faults_latched.load());
+    std::printf("  peak sense current : %u mA\n", aggregate.max_current_ma.load());
+    if (stopped > 0U)
+    {
+        std::printf("  stop latency       : mean %.0f ms, max %u ms\n",
+                    static_cast<double>(aggregate.stop_latency_sum_ms.load()) / stopped,
+                    aggregate.stop_latency_max_ms.load());
+        std::printf("  stop distance      : mean %.1f mm, max %.1f mm\n",
+                    static_cast<double>(aggregate.stop_distance_sum_um.load()) / 1000.0 / stopped,
+                    static_cast<double>(aggregate.stop_distance_max_um.load()) / 1000.0);
+    }
+    std::printf("  stop latency histogram (%u ms buckets):\n", FLEET_LATENCY_BUCKET_MS);
+    for (size_t bucket = 0U; bucket < FLEET_LATENCY_BUCKETS; ++bucket)
+    {
+        const uint32_t count = aggregate.stop_latency_histogram[bucket].load();
+        if (count > 0U)
+        {
+            std::printf("    %4zu ms%s : %u\n", bucket * FLEET_LATENCY_BUCKET_MS,
+                        (bucket + 1U == FLEET_LATENCY_BUCKETS) ? "+" : " ", count);
+        }
+    }
+    for (size_t worker = 0U; worker < stats.executed.size(); ++worker)
+    {
+        std::printf("  worker %zu: %u scenarios (%u stolen)\n",
+                    worker, stats.executed[worker], stats.stolen[worker]);
+    }
+
+    return (stopped == run) ? 0 : 1;
+}
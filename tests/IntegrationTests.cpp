@@ -5,6 +5,25 @@
 #include "desk_types.h"
 #include "motor_config.h"
 #include "hal_mock/HALMock.h"
+#include "desk_control.h"
+#include "task_profiler.h"
+#include "input_events.h"
+#include "port_io.h"
+#include "motor_driver.h"
+#include "adc_sampler.h"
+#include "current_monitor.h"
+#include "current_baseline.h"
+#include "position_encoder.h"
+#include "position_estimator.h"
+#include "desk_presets.h"
+#include "motion_profile.h"
+#include "speed_controller.h"
+#include "desk_calibration.h"
+#include "nvm.h"
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <type_traits>
 
 // ============================================================================
 // INTEGRATION TESTS: HAL/Signal Layer + Motor Controller
@@ -92,6 +111,1724 @@ TEST_F(HALIntegrationTest, TimeReturnsMonotonicallyIncreasing)
     EXPECT_GE(time2, time1);
 }
 
+// ============================================================================
+// INTEGRATION TEST: Virtual Clock (HAL mock time source)
+// Verifies that millis()/delay() and every HAL consumer run on harness-controlled
+// time, so long operating sequences simulate without waiting in real time
+// ============================================================================
+
+class HALVirtualClockTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        MockClock_reset();
+        pin_states[PIN_BUTTON_UP] = HIGH;    // Released (active LOW with pull-up)
+        pin_states[PIN_BUTTON_DOWN] = HIGH;
+        HAL_init();
+        HAL_setMotorType(MotorConfig_getMotorType());
+    }
+
+    void TearDown() override
+    {
+        MockClock_reset();
+    }
+};
+
+static void press_up_button(void *context)
+{
+    (void)context;
+    pin_states[PIN_BUTTON_UP] = LOW;
+}
+
+// REQ-HAL-006: Debounce window (SWReq-009, 20 ms) elapses on virtual time only
+TEST_F(HALVirtualClockTest, ButtonDebounceConsumesVirtualTime)
+{
+    pin_states[PIN_BUTTON_UP] = LOW;
+    EXPECT_FALSE(HAL_readButton(BUTTON_UP)) << "Edge just seen, debounce window open";
+
+    MockClock_advanceMs(19U);
+    EXPECT_FALSE(HAL_readButton(BUTTON_UP)) << "19 ms < 20 ms debounce";
+
+    MockClock_advanceMs(1U);
+    EXPECT_TRUE(HAL_readButton(BUTTON_UP)) << "Stable after 20 ms of virtual time";
+}
+
+// REQ-HAL-007: Debounce and HAL_getTime() keep working across the 32-bit millis() wrap
+TEST_F(HALVirtualClockTest, DebounceAcrossMillisWraparound)
+{
+    MockClock_reset((static_cast<uint64_t>(UINT32_MAX) - 5U) * 1000U);
+    HAL_init();
+    const uint32_t before_wrap = HAL_getTime();
+
+    pin_states[PIN_BUTTON_UP] = LOW;
+    EXPECT_FALSE(HAL_readButton(BUTTON_UP));
+
+    MockClock_advanceMs(25U);
+    EXPECT_LT(HAL_getTime(), before_wrap) << "millis() must wrap at 2^32 like the AVR core";
+    EXPECT_EQ(static_cast<uint32_t>(HAL_getTime() - before_wrap), 25U);
+    EXPECT_TRUE(HAL_readButton(BUTTON_UP)) << "Unsigned elapsed time must survive the wrap";
+}
+
+// REQ-HAL-008: delay() advances virtual time without sleeping
+TEST_F(HALVirtualClockTest, DelayAdvancesVirtualTimeInstantly)
+{
+    const auto wall_start = std::chrono::steady_clock::now();
+    const uint32_t start = HAL_getTime();
+
+    delay(30000U);  // Full 30 s stroke (SysReq-004)
+
+    EXPECT_EQ(HAL_getTime() - start, 30000U);
+    EXPECT_LT(std::chrono::steady_clock::now() - wall_start, std::chrono::seconds(1))
+        << "Virtual delay must not consume wall time";
+}
+
+// REQ-HAL-009: Stepping to the next scheduled event lands exactly on its timestamp
+TEST_F(HALVirtualClockTest, StepToNextEventDrivesScheduledInput)
+{
+    MockClock_schedule(250000U, press_up_button, nullptr);
+    ASSERT_EQ(MockClock_pendingEvents(), 1U);
+
+    EXPECT_TRUE(MockClock_stepToNextEvent());
+    EXPECT_EQ(HAL_getTime(), 250U);
+    EXPECT_EQ(pin_states[PIN_BUTTON_UP], LOW);
+    EXPECT_FALSE(MockClock_stepToNextEvent()) << "No events left";
+}
+
+// REQ-HAL-010: Free-run mode advances on every read so polling loops terminate
+TEST_F(HALVirtualClockTest, FreeRunAdvancesOnEachRead)
+{
+    MockClock_setMode(MOCK_CLOCK_FREE_RUN);
+    MockClock_setFreeRunStep(1000U);
+
+    const uint32_t first = HAL_getTime();
+    const uint32_t second = HAL_getTime();
+    EXPECT_EQ(second - first, 1U);
+}
+
+// ============================================================================
+// INTEGRATION TEST: Interrupt-Driven Input Capture
+// Verifies the ISR -> main loop edge queue and that the HAL times debounce and
+// reacts to limit switches from the interrupt edge, not from the poll
+// ============================================================================
+
+class InputEventIntegrationTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        MockClock_reset();
+        for (int pin = 0; pin < 64; ++pin)
+        {
+            pin_states[pin] = LOW;
+        }
+        pin_states[PIN_BUTTON_UP] = HIGH;    // Released / open (active LOW with pull-ups)
+        pin_states[PIN_BUTTON_DOWN] = HIGH;
+        pin_states[PIN_LIMIT_UPPER] = HIGH;
+        pin_states[PIN_LIMIT_LOWER] = HIGH;
+        HAL_setMotorType(MT_BASIC);
+        HAL_init();
+    }
+
+    void TearDown() override
+    {
+        MockClock_reset();
+    }
+};
+
+// REQ-IRQ-001: Queue delivers events in order with their timestamps across index wrap
+TEST_F(InputEventIntegrationTest, QueuePreservesOrderAcrossWrap)
+{
+    InputEventQueue_t queue;
+    InputEventQueue_init(&queue);
+    EXPECT_TRUE(InputEventQueue_isEmpty(&queue));
+
+    uint32_t next_pushed = 0U;
+    uint32_t next_popped = 0U;
+    for (int round = 0; round < 40; ++round)
+    {
+        // Fill 5, drain 5: head/tail pass the 8-bit wrap several times
+        for (int i = 0; i < 5; ++i)
+        {
+            InputEvent_t event = {next_pushed, static_cast<uint8_t>(next_pushed % INPUT_SOURCE_COUNT), (next_pushed % 2U) == 0U};
+            ASSERT_TRUE(InputEventQueue_push(&queue, &event));
+            ++next_pushed;
+        }
+        InputEvent_t event;
+        while (InputEventQueue_pop(&queue, &event))
+        {
+            ASSERT_EQ(event.timestamp_us, next_popped);
+            ASSERT_EQ(event.source, next_popped % INPUT_SOURCE_COUNT);
+            ASSERT_EQ(event.active, (next_popped % 2U) == 0U);
+            ++next_popped;
+        }
+    }
+    EXPECT_EQ(next_popped, 200U);
+    EXPECT_EQ(queue.dropped, 0U);
+}
+
+// REQ-IRQ-002: Overflow drops new events, counts them, and the HAL resyncs from the pins
+TEST_F(InputEventIntegrationTest, OverflowResyncsLimitState)
+{
+    // 21 limit edges without the main loop running: 16 queued, 5 dropped
+    for (int edge = 1; edge <= 21; ++edge)
+    {
+        pin_states[PIN_LIMIT_UPPER] = ((edge % 2) == 1) ? LOW : HIGH;
+        HAL_inputChangeIsr();
+        MockClock_advanceUs(50U);
+    }
+    ASSERT_EQ(pin_states[PIN_LIMIT_UPPER], LOW);
+    EXPECT_TRUE(HAL_readLimitSensor(LIMIT_UPPER))
+        << "Last queued edge says open; the resync after the overflow must report the active limit";
+    EXPECT_FALSE(HAL_pollInputEvents()) << "Queue drained, nothing new";
+}
+
+// REQ-IRQ-003: Debounce runs from the interrupt timestamp, not from the first poll
+TEST_F(InputEventIntegrationTest, DebounceTimedFromEdge)
+{
+    MockClock_advanceUs(1000U);
+    pin_states[PIN_BUTTON_UP] = LOW;
+    HAL_inputChangeIsr();  // Edge at t = 1 ms
+
+    MockClock_advanceUs(19999U);
+    EXPECT_FALSE(HAL_readButton(BUTTON_UP)) << "19.999 ms after the edge";
+    MockClock_advanceUs(1U);
+    EXPECT_TRUE(HAL_readButton(BUTTON_UP)) << "20 ms after the edge, although first polled at 20.999 ms";
+}
+
+// REQ-IRQ-004: A limit edge stops the motor in the same loop pass, between 1 ms ticks
+TEST_F(InputEventIntegrationTest, LimitEdgeStopsMotorBeforeNextTick)
+{
+    DeskControl_Init(HAL_getTime());
+    pin_states[PIN_BUTTON_UP] = LOW;
+    HAL_inputChangeIsr();
+    for (int ms = 0; ms < 1000; ++ms)
+    {
+        MockClock_advanceUs(1000U);
+        DeskControl_Poll(HAL_getTime());
+    }
+    ASSERT_EQ(pin_states[PIN_MOTOR_EN1], HIGH) << "Moving up";
+    ASSERT_GT(pin_states[PIN_MOTOR_PWM], 0);
+
+    MockClock_advanceUs(300U);               // Mid-tick: no periodic task is due
+    pin_states[PIN_LIMIT_UPPER] = LOW;
+    HAL_inputChangeIsr();
+    DeskControl_Poll(HAL_getTime());
+
+    EXPECT_EQ(pin_states[PIN_MOTOR_EN1], LOW) << "Drive removed on the edge, not on the next tick";
+    EXPECT_EQ(pin_states[PIN_MOTOR_PWM], 0);
+}
+
+// ============================================================================
+// INTEGRATION TEST: Port Register I/O
+// Verifies the UNO pin -> port/bit mapping behind the direct register HAL and
+// that the input snapshot matches the per-input reads
+// ============================================================================
+
+class PortIOIntegrationTest : public InputEventIntegrationTest
+{
+};
+
+// REQ-PIO-001: Pin numbers map onto PORTD (0-7), PORTB (8-13) and PORTC (A0-A5) bits
+TEST_F(PortIOIntegrationTest, PinMappingMatchesUnoPorts)
+{
+    static_assert(PortIO_port(PIN_BUTTON_UP) == PORT_IO_D, "pin 2 is PD2");
+    static_assert(PortIO_mask(PIN_BUTTON_UP) == 0x04U, "pin 2 is PD2");
+    static_assert(PortIO_port(PIN_LIMIT_LOWER) == PORT_IO_B, "pin 8 is PB0");
+    static_assert(PortIO_mask(PIN_LIMIT_LOWER) == 0x01U, "pin 8 is PB0");
+    static_assert(PortIO_port(PIN_LED_BT_UP) == PORT_IO_B, "pin 11 is PB3");
+    static_assert(PortIO_mask(PIN_LED_BT_UP) == 0x08U, "pin 11 is PB3");
+    static_assert(PortIO_port(PIN_MOTOR_SENSE) == PORT_IO_C, "A0 is PC0");
+    static_assert(PortIO_mask(PIN_MOTOR_SENSE) == 0x01U, "A0 is PC0");
+
+    pin_states[PIN_LIMIT_LOWER] = LOW;
+    EXPECT_EQ(PortIO_read(PORT_IO_B) & PortIO_mask(PIN_LIMIT_LOWER), 0U);
+    EXPECT_NE(PortIO_read(PORT_IO_D) & PortIO_mask(PIN_BUTTON_UP), 0U) << "Released button reads HIGH";
+
+    PortIO_write(PortIO_port(PIN_LED_ERROR), PortIO_mask(PIN_LED_ERROR), true);
+    EXPECT_EQ(pin_states[PIN_LED_ERROR], HIGH);
+    EXPECT_EQ(pin_states[PIN_LED_ERROR + 1], LOW) << "Only the masked bit changes";
+}
+
+// REQ-PIO-002: One snapshot reports the same levels as the individual reads
+TEST_F(PortIOIntegrationTest, SnapshotMatchesIndividualReads)
+{
+    pin_states[PIN_BUTTON_DOWN] = LOW;
+    pin_states[PIN_LIMIT_LOWER] = LOW;
+    HAL_inputChangeIsr();
+    MockClock_advanceUs(5000U);
+
+    HALInputSnapshot_t snapshot;
+    HAL_readInputs(&snapshot);
+    EXPECT_FALSE(snapshot.button[BUTTON_DOWN]) << "Still inside the debounce window";
+    EXPECT_TRUE(snapshot.button_raw[BUTTON_DOWN]);
+    EXPECT_FALSE(snapshot.button_raw[BUTTON_UP]);
+    EXPECT_TRUE(snapshot.limit[LIMIT_LOWER]);
+    EXPECT_FALSE(snapshot.limit[LIMIT_UPPER]);
+    EXPECT_EQ(snapshot.timestamp_us, HAL_getTimeUs());
+
+    MockClock_advanceUs(15000U);
+    HAL_readInputs(&snapshot);
+    EXPECT_EQ(snapshot.button[BUTTON_DOWN], HAL_readButton(BUTTON_DOWN));
+    EXPECT_TRUE(snapshot.button[BUTTON_DOWN]) << "20 ms after the edge";
+    EXPECT_EQ(snapshot.limit[LIMIT_LOWER], HAL_readLimitSensor(LIMIT_LOWER));
+}
+
+// REQ-PIO-003: Motor outputs land on the driver pins through the port and PWM registers
+TEST_F(PortIOIntegrationTest, MotorOutputsWriteDriverPins)
+{
+    HAL_setMotor(MOTOR_DOWN, 200U);
+    EXPECT_EQ(pin_states[PIN_MOTOR_EN1], LOW);
+    EXPECT_EQ(pin_states[PIN_MOTOR_EN2], HIGH);
+    EXPECT_EQ(pin_states[PIN_MOTOR_PWM], 200);
+
+    HAL_setMotor(MOTOR_STOP, 0U);
+    EXPECT_EQ(pin_states[PIN_MOTOR_EN2], LOW);
+    EXPECT_EQ(pin_states[PIN_MOTOR_PWM], 0);
+}
+
+// REQ-PIO-004: Driver policies bind per motor type at compile time and drive their own pins
+TEST_F(PortIOIntegrationTest, MotorDriverPoliciesDriveTheirPins)
+{
+    static_assert(std::is_same<MotorDriverFor<MT_BASIC>::Type, L298NDriver>::value, "MT_BASIC -> L298N");
+    static_assert(std::is_same<MotorDriverFor<MT_ROBUST>::Type, IBT2Driver>::value, "MT_ROBUST -> IBT_2");
+    static_assert(!L298NDriver::HAS_CURRENT_SENSE && IBT2Driver::HAS_CURRENT_SENSE, "Only IBT_2 senses current");
+    static_assert((L298NDriver::TYPE == MT_BASIC) && (IBT2Driver::TYPE == MT_ROBUST), "Policy TYPE");
+
+    L298NDriver::init();
+    L298NDriver::set(MOTOR_UP, 120U);
+    EXPECT_EQ(pin_states[PIN_MOTOR_EN1], HIGH);
+    EXPECT_EQ(pin_states[PIN_MOTOR_EN2], LOW);
+    EXPECT_EQ(pin_states[PIN_MOTOR_PWM], 120);
+
+    IBT2Driver::init();
+    IBT2Driver::set(MOTOR_DOWN, 55U);
+    EXPECT_EQ(pin_states[PIN_MOTOR_LPWM], 200);
+    EXPECT_EQ(pin_states[PIN_MOTOR_RPWM], 255);
+
+    for (uint8_t i = 0U; i < ADC_FILTER_LENGTH; ++i)
+    {
+        AdcSampler_conversionComplete(1023U);  // Background conversions (ISR(ADC_vect) on target)
+    }
+    EXPECT_EQ(IBT2Driver::readCurrentMa(), 10000U);
+    EXPECT_EQ(L298NDriver::readCurrentMa(), 0U);
+}
+
+// Direction actually driven by the pins after each write (pin_write_hook)
+static int driven_sign(MotorType_t motor_type)
+{
+    if (motor_type == MT_BASIC)
+    {
+        const int up = (pin_states[PIN_MOTOR_EN1] == HIGH) ? 1 : 0;
+        const int down = (pin_states[PIN_MOTOR_EN2] == HIGH) ? 1 : 0;
+        return (pin_states[PIN_MOTOR_PWM] > 0) ? (up - down) : 0;
+    }
+    const int drive = pin_states[PIN_MOTOR_LPWM] - pin_states[PIN_MOTOR_RPWM];
+    return (drive > 0) ? 1 : ((drive < 0) ? -1 : 0);
+}
+
+static thread_local MotorType_t observed_type = MT_BASIC;
+static thread_local int min_driven_sign = 0;
+static thread_local int max_driven_sign = 0;
+static thread_local bool both_enables_seen = false;
+
+static void observe_drive(int pin, int value)
+{
+    (void)pin;
+    (void)value;
+    const int sign = driven_sign(observed_type);
+    min_driven_sign = std::min(min_driven_sign, sign);
+    max_driven_sign = std::max(max_driven_sign, sign);
+    both_enables_seen = both_enables_seen ||
+                        ((pin_states[PIN_MOTOR_EN1] == HIGH) && (pin_states[PIN_MOTOR_EN2] == HIGH));
+}
+
+// REQ-PIO-005: The output shadow writes only pins whose value changes
+TEST_F(PortIOIntegrationTest, OutputShadowWritesOnlyChanges)
+{
+    pin_write_count = 0U;
+    HAL_setMotor(MOTOR_STOP, 0U);
+    HAL_setLED(LED_ERROR, LED_OFF);
+    EXPECT_EQ(pin_write_count, 0U) << "Matches the state HAL_init() applied";
+
+    HAL_setMotor(MOTOR_UP, 10U);
+    EXPECT_EQ(pin_write_count, 2U) << "PWM and EN1; EN2 stays LOW";
+    HAL_setMotor(MOTOR_UP, 11U);
+    EXPECT_EQ(pin_write_count, 3U) << "Speed change touches only PWM";
+    HAL_setMotor(MOTOR_UP, 11U);
+    HAL_setLED(LED_BT_UP, LED_ON);
+    HAL_setLED(LED_BT_UP, LED_ON);
+    EXPECT_EQ(pin_write_count, 4U);
+
+    HAL_refreshOutputs();
+    HAL_setMotor(MOTOR_UP, 11U);
+    EXPECT_EQ(pin_write_count, 7U) << "Refresh rewrites every drive pin";
+    EXPECT_EQ(pin_states[PIN_MOTOR_EN1], HIGH);
+    EXPECT_EQ(pin_states[PIN_MOTOR_PWM], 11);
+}
+
+// REQ-PIO-006: Direction changes never pass through drive opposite to both old and new direction
+TEST_F(PortIOIntegrationTest, DirectionChangeIsGlitchFree)
+{
+    const MotorType_t types[] = {MT_BASIC, MT_ROBUST};
+    for (const MotorType_t type : types)
+    {
+        HAL_setMotorType(type);
+        HAL_init();
+        observed_type = MotorConfig_effectiveType(type);  // Builds without runtime dispatch drive the build type
+        pin_write_hook = observe_drive;
+
+        HAL_setMotor(MOTOR_UP, 200U);
+        min_driven_sign = 0;
+        max_driven_sign = 0;
+        both_enables_seen = false;
+        HAL_setMotor(MOTOR_STOP, 0U);
+        EXPECT_GE(min_driven_sign, 0) << "type " << type << ": UP -> STOP drove DOWN";
+
+        HAL_setMotor(MOTOR_DOWN, 30U);
+        max_driven_sign = 0;
+        HAL_setMotor(MOTOR_DOWN, 180U);
+        HAL_setMotor(MOTOR_STOP, 0U);
+        EXPECT_LE(max_driven_sign, 0) << "type " << type << ": DOWN -> STOP drove UP";
+
+        HAL_setMotor(MOTOR_UP, 90U);
+        EXPECT_EQ(driven_sign(observed_type), 1);
+        HAL_setMotor(MOTOR_DOWN, 90U);
+        EXPECT_EQ(driven_sign(observed_type), -1);
+        EXPECT_FALSE(both_enables_seen) << "EN1 and EN2 must never be HIGH together";
+
+        pin_write_hook = nullptr;
+    }
+    HAL_setMotorType(MT_BASIC);
+}
+
+// ============================================================================
+// INTEGRATION TEST: Interrupt-Driven ADC Sampling
+// Verifies the ISR-side boxcar filter and the fixed-point mA scaling behind
+// the non-blocking HAL_readMotorCurrent()
+// ============================================================================
+
+class AdcSamplerIntegrationTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        AdcSampler_init(0U);
+    }
+
+    void TearDown() override
+    {
+        HAL_setMotorType(MT_BASIC);
+    }
+};
+
+// REQ-ADC-001: Fixed-point scaling matches the exact shunt formula within 1 mA over the full range
+TEST_F(AdcSamplerIntegrationTest, FixedPointScalingMatchesShuntFormula)
+{
+    for (uint32_t counts = 0U; counts <= ADC_FULL_SCALE_COUNTS; ++counts)
+    {
+        const uint16_t sum = static_cast<uint16_t>(counts * ADC_FILTER_LENGTH);
+        const double exact_ma = (static_cast<double>(counts) * ADC_REF_MV * 1000.0) / (1023.0 * SHUNT_MILLIOHMS);
+        EXPECT_NEAR(static_cast<double>(AdcSampler_toMilliamps(sum)), exact_ma, 1.0) << "counts " << counts;
+    }
+    EXPECT_EQ(AdcSampler_toMilliamps(0U), 0U);
+    EXPECT_EQ(AdcSampler_toMilliamps(static_cast<uint16_t>(ADC_FULL_SCALE_COUNTS * ADC_FILTER_LENGTH)),
+              (ADC_REF_MV * 1000U) / SHUNT_MILLIOHMS) << "Full scale is exact";
+}
+
+// REQ-ADC-002: The filter averages the last ADC_FILTER_LENGTH conversions and settles after one window
+TEST_F(AdcSamplerIntegrationTest, BoxcarFilterSettlesAfterOneWindow)
+{
+    EXPECT_EQ(AdcSampler_filteredSum(), 0U);
+
+    AdcSampler_conversionComplete(400U);
+    EXPECT_EQ(AdcSampler_filteredSum(), 400U) << "Partial window ramps up, no division";
+
+    for (uint8_t i = 1U; i < ADC_FILTER_LENGTH; ++i)
+    {
+        AdcSampler_conversionComplete(400U);
+    }
+    EXPECT_EQ(AdcSampler_filteredSum(), 400U * ADC_FILTER_LENGTH);
+
+    // A single spike moves the result by a quarter only, then leaves the window
+    AdcSampler_conversionComplete(1023U);
+    EXPECT_EQ(AdcSampler_filteredSum(), (400U * (ADC_FILTER_LENGTH - 1U)) + 1023U);
+    for (uint8_t i = 0U; i < ADC_FILTER_LENGTH; ++i)
+    {
+        AdcSampler_conversionComplete(400U);
+    }
+    EXPECT_EQ(AdcSampler_filteredSum(), 400U * ADC_FILTER_LENGTH);
+
+    AdcSampler_conversionComplete(0xFFFFU);
+    EXPECT_LE(AdcSampler_filteredSum(), ADC_FULL_SCALE_COUNTS * ADC_FILTER_LENGTH) << "Out-of-range result is clamped";
+    EXPECT_EQ(AdcSampler_conversionCount(), static_cast<uint16_t>((2U * ADC_FILTER_LENGTH) + 2U));
+}
+
+// REQ-ADC-003: HAL_readMotorCurrent() reports the filtered sample without touching the conversion path
+TEST_F(AdcSamplerIntegrationTest, HalReadsFilteredCurrent)
+{
+    HAL_setMotorType(MT_ROBUST);
+    HAL_init();
+    pin_states[PIN_MOTOR_SENSE] = 512;
+    if (MotorConfig_effectiveType(MT_ROBUST) == MT_ROBUST)
+    {
+        EXPECT_EQ(IBT2Driver::readCurrentMa(), 0U) << "Nothing converted yet after init";
+        EXPECT_EQ(HAL_readMotorCurrent(), AdcSampler_toMilliamps(512U * ADC_FILTER_LENGTH));
+        EXPECT_EQ(IBT2Driver::readCurrentMa(), HAL_readMotorCurrent()) << "Reading is non-destructive";
+    }
+    else
+    {
+        EXPECT_EQ(HAL_readMotorCurrent(), 0U) << "MT_BASIC build: no current sensing";
+    }
+    pin_states[PIN_MOTOR_SENSE] = 0;
+}
+
+// ============================================================================
+// INTEGRATION TEST: 1 kHz Current Statistics
+// Verifies the per-cycle peak / mean / threshold-run summary and that the
+// control loop samples the motor current at 1 kHz
+// ============================================================================
+
+class CurrentMonitorIntegrationTest : public InputEventIntegrationTest
+{
+protected:
+    void TearDown() override
+    {
+        pin_states[PIN_MOTOR_SENSE] = 0;
+        HAL_setMotorType(MT_BASIC);
+        InputEventIntegrationTest::TearDown();
+    }
+
+    // Sense pin count for a current in mA (inverse of the ADC scaling)
+    static int countsFor(uint32_t current_ma)
+    {
+        return static_cast<int>((current_ma * SHUNT_MILLIOHMS * ADC_FULL_SCALE_COUNTS) / (1000U * ADC_REF_MV));
+    }
+
+    static void runMs(uint32_t duration_ms)
+    {
+        for (uint32_t ms = 0U; ms < duration_ms; ++ms)
+        {
+            MockClock_advanceUs(1000U);
+            DeskControl_Poll(HAL_getTime());
+        }
+    }
+};
+
+// REQ-CUR-001: Summary reports peak, mean and the longest qualified runs, then starts a new cycle
+TEST_F(CurrentMonitorIntegrationTest, SummaryReportsPeakMeanAndRuns)
+{
+    CurrentMonitor_t monitor;
+    CurrentMonitor_init(&monitor);
+    CurrentSummary_t summary;
+
+    CurrentMonitor_takeSummary(&monitor, &summary);
+    EXPECT_EQ(summary.samples, 0U) << "No samples: caller falls back to the single reading";
+
+    for (uint16_t i = 0U; i < 10U; ++i)
+    {
+        CurrentMonitor_addSample(&monitor, 100U, MOTOR_UP);
+    }
+    for (uint16_t i = 0U; i < 30U; ++i)
+    {
+        CurrentMonitor_addSample(&monitor, 400U, MOTOR_UP);  // Obstruction run of 30 ms
+    }
+    CurrentMonitor_addSample(&monitor, 100U, MOTOR_UP);
+    for (uint16_t i = 0U; i < 5U; ++i)
+    {
+        CurrentMonitor_addSample(&monitor, 400U, MOTOR_UP);  // Shorter run: the longest is kept
+    }
+    for (uint16_t i = 0U; i < 4U; ++i)
+    {
+        CurrentMonitor_addSample(&monitor, 180U, MOTOR_STOP);  // Stuck-on run, drive off
+    }
+
+    CurrentMonitor_takeSummary(&monitor, &summary);
+    EXPECT_EQ(summary.samples, 50U);
+    EXPECT_EQ(summary.peak_ma, 400U);
+    EXPECT_EQ(summary.mean_ma, (11U * 100U + 35U * 400U + 4U * 180U) / 50U);
+    EXPECT_EQ(summary.obstruction_run_ms, 30U);
+    EXPECT_EQ(summary.stuck_run_ms, 4U);
+    EXPECT_EQ(CurrentMonitor_history(&monitor, 0U), 180U);
+    EXPECT_EQ(CurrentMonitor_history(&monitor, 4U), 400U);
+    EXPECT_EQ(CurrentMonitor_history(&monitor, CURRENT_MONITOR_HISTORY), 0U) << "Out of range";
+
+    // A run in progress carries into the next cycle
+    CurrentMonitor_addSample(&monitor, 180U, MOTOR_STOP);
+    CurrentMonitor_takeSummary(&monitor, &summary);
+    EXPECT_EQ(summary.samples, 1U);
+    EXPECT_EQ(summary.stuck_run_ms, 5U);
+    EXPECT_EQ(summary.obstruction_run_ms, 0U);
+    EXPECT_EQ(summary.peak_ma, 180U);
+}
+
+// REQ-CUR-002: DeskControl_Poll() samples once per millisecond; runs follow the applied drive
+TEST_F(CurrentMonitorIntegrationTest, PollSamplesEveryMillisecond)
+{
+    HAL_setMotorType(MT_ROBUST);
+    HAL_init();
+    if (MotorConfig_effectiveType(MT_ROBUST) != MT_ROBUST)
+    {
+        return;  // MT_BASIC build: HAL reports 0 mA
+    }
+    DeskControl_Init(HAL_getTime());
+    CurrentSummary_t summary;
+    HAL_takeMotorCurrentSummary(&summary);
+
+    // Drive off, all within one control cycle: 20 ms quiet, 150 ms spike, 30 ms quiet
+    pin_states[PIN_MOTOR_SENSE] = countsFor(100U);
+    runMs(20U);
+    pin_states[PIN_MOTOR_SENSE] = countsFor(300U);
+    runMs(150U);
+    pin_states[PIN_MOTOR_SENSE] = countsFor(100U);
+    runMs(30U);
+    DeskControl_Poll(HAL_getTime());  // Same millisecond: no extra sample
+
+    HAL_takeMotorCurrentSummary(&summary);
+    EXPECT_EQ(summary.samples, 200U);
+    EXPECT_EQ(summary.peak_ma, AdcSampler_toMilliamps(static_cast<uint16_t>(countsFor(300U) * ADC_FILTER_LENGTH)));
+    EXPECT_EQ(summary.stuck_run_ms, 150U) << "Drive off: the spike counts as stuck-on";
+    EXPECT_EQ(summary.obstruction_run_ms, 0U);
+
+    // Driven: the same spike counts as an obstruction run
+    HAL_setMotor(MOTOR_UP, 200U);
+    pin_states[PIN_MOTOR_SENSE] = countsFor(300U);
+    for (int ms = 0; ms < 120; ++ms)
+    {
+        HAL_sampleMotorCurrent();
+    }
+    HAL_takeMotorCurrentSummary(&summary);
+    EXPECT_EQ(summary.obstruction_run_ms, 120U);
+    EXPECT_EQ(summary.stuck_run_ms, 0U);
+}
+
+// REQ-CUR-003: Slope detector ignores inrush and slow load changes, confirms a steep rise
+TEST_F(CurrentMonitorIntegrationTest, SlopeDetectorConfirmsSteepRiseOnly)
+{
+    CurrentMonitor_t monitor;
+    CurrentMonitor_init(&monitor);
+
+    // Soft-start inrush inside the blanking time: steep, but not armed
+    uint16_t ma = 0U;
+    for (uint16_t ms = 0U; ms < MOTOR_SENSE_SLOPE_BLANK_MS; ++ms)
+    {
+        ma = (ms < 100U) ? static_cast<uint16_t>(ms * 3U) : 140U;
+        CurrentMonitor_addSample(&monitor, ma, MOTOR_UP);
+    }
+    EXPECT_FALSE(CurrentMonitor_slopeJam(&monitor)) << "Inrush is blanked";
+
+    // Load change: 2 mA/ms for 100 ms stays below the sensitivity
+    for (uint16_t ms = 0U; ms < 100U; ++ms)
+    {
+        ma = static_cast<uint16_t>(ma + 2U);
+        CurrentMonitor_addSample(&monitor, ma, MOTOR_UP);
+    }
+    EXPECT_EQ(CurrentMonitor_slopeQ4(&monitor), 2 * 16) << "2 mA/ms in Q4";
+    EXPECT_FALSE(CurrentMonitor_slopeJam(&monitor));
+
+    // Jam: current steps up by 160 mA and stays there
+    ma = static_cast<uint16_t>(ma + 160U);
+    for (uint8_t ms = 1U; ms < MOTOR_SENSE_SLOPE_CONFIRM_MS; ++ms)
+    {
+        CurrentMonitor_addSample(&monitor, ma, MOTOR_UP);
+        EXPECT_FALSE(CurrentMonitor_slopeJam(&monitor)) << "Confirmation sample " << static_cast<int>(ms);
+    }
+    CurrentMonitor_addSample(&monitor, ma, MOTOR_UP);
+    EXPECT_TRUE(CurrentMonitor_slopeJam(&monitor)) << "Confirmed after MOTOR_SENSE_SLOPE_CONFIRM_MS samples";
+    CurrentSummary_t summary;
+    CurrentMonitor_takeSummary(&monitor, &summary);
+    EXPECT_TRUE(summary.slope_jam);
+
+    // Drive removed: latch clears; a reversal blanks again
+    CurrentMonitor_addSample(&monitor, 0U, MOTOR_STOP);
+    EXPECT_FALSE(CurrentMonitor_slopeJam(&monitor));
+    CurrentMonitor_addSample(&monitor, 0U, MOTOR_UP);
+    for (uint16_t ms = 0U; ms < 50U; ++ms)
+    {
+        CurrentMonitor_addSample(&monitor, static_cast<uint16_t>(ms * 10U), MOTOR_DOWN);
+    }
+    EXPECT_FALSE(CurrentMonitor_slopeJam(&monitor)) << "Reversal restarts the blanking time";
+}
+
+// REQ-CUR-004: Baseline deviation run counts only samples above a set limit while driven
+TEST_F(CurrentMonitorIntegrationTest, DeviationRunFollowsBaselineLimit)
+{
+    CurrentMonitor_t monitor;
+    CurrentMonitor_init(&monitor);
+    CurrentSummary_t summary;
+
+    for (uint16_t i = 0U; i < 120U; ++i)
+    {
+        CurrentMonitor_addSample(&monitor, 160U, MOTOR_DOWN);  // No limit known: no run
+    }
+    CurrentMonitor_setDeviationLimit(&monitor, 110U);
+    for (uint16_t i = 0U; i < 120U; ++i)
+    {
+        CurrentMonitor_addSample(&monitor, 160U, MOTOR_DOWN);
+    }
+    for (uint16_t i = 0U; i < 10U; ++i)
+    {
+        CurrentMonitor_addSample(&monitor, 160U, MOTOR_STOP);  // Drive off: not a deviation
+    }
+    CurrentMonitor_takeSummary(&monitor, &summary);
+    EXPECT_EQ(summary.deviation_run_ms, 120U);
+    EXPECT_EQ(summary.obstruction_run_ms, 0U) << "Below the fixed threshold";
+}
+
+// REQ-CUR-007: Obstruction runs count against the soft-start envelope set for the applied drive
+TEST_F(CurrentMonitorIntegrationTest, ObstructionLimitFollowsInrushEnvelope)
+{
+    CurrentMonitor_t monitor;
+    CurrentMonitor_init(&monitor);
+    CurrentSummary_t summary;
+
+    // Ramping up at full PWM: inrush above the flat threshold is expected
+    CurrentMonitor_setObstructionLimit(&monitor, CurrentMonitor_obstructionLimitMa(MOTOR_PHASE_RAMP_UP, 255U));
+    for (uint16_t i = 0U; i < 150U; ++i)
+    {
+        CurrentMonitor_addSample(&monitor, 250U, MOTOR_UP);
+    }
+    CurrentMonitor_takeSummary(&monitor, &summary);
+    EXPECT_EQ(summary.obstruction_run_ms, 0U) << "Within the inrush envelope";
+
+    // Cruising: the same current is an obstruction
+    CurrentMonitor_setObstructionLimit(&monitor, CurrentMonitor_obstructionLimitMa(MOTOR_PHASE_CRUISE, 255U));
+    for (uint16_t i = 0U; i < 150U; ++i)
+    {
+        CurrentMonitor_addSample(&monitor, 250U, MOTOR_UP);
+    }
+    CurrentMonitor_takeSummary(&monitor, &summary);
+    EXPECT_EQ(summary.obstruction_run_ms, 150U);
+
+    // Same through the HAL monitor fed by the 1 kHz samples
+    HAL_setMotorType(MT_ROBUST);
+    HAL_init();
+    if (MotorConfig_effectiveType(MT_ROBUST) != MT_ROBUST)
+    {
+        return;  // MT_BASIC build: HAL reports 0 mA
+    }
+    HAL_takeMotorCurrentSummary(&summary);
+    pin_states[PIN_MOTOR_SENSE] = countsFor(250U);
+    HAL_setMotorCurrentObstructionLimit(CurrentMonitor_obstructionLimitMa(MOTOR_PHASE_RAMP_UP, 255U));
+    HAL_setMotor(MOTOR_UP, 255U);
+    for (int ms = 0; ms < 120; ++ms)
+    {
+        HAL_sampleMotorCurrent();
+    }
+    HAL_takeMotorCurrentSummary(&summary);
+    EXPECT_EQ(summary.obstruction_run_ms, 0U);
+    HAL_setMotorCurrentObstructionLimit(CurrentMonitor_obstructionLimitMa(MOTOR_PHASE_CRUISE, 255U));
+    for (int ms = 0; ms < 120; ++ms)
+    {
+        HAL_sampleMotorCurrent();
+    }
+    HAL_takeMotorCurrentSummary(&summary);
+    EXPECT_EQ(summary.obstruction_run_ms, 120U);
+}
+
+// ============================================================================
+// INTEGRATION TEST: Learned Current Baseline and NVM Records
+// Verifies checksummed background record writes, baseline learning from clean
+// strokes and the position-indexed limit applied by the control loop
+// ============================================================================
+
+class CurrentBaselineIntegrationTest : public CurrentMonitorIntegrationTest
+{
+protected:
+    static void serviceNvm()
+    {
+        for (int i = 0; (i < 200) && NVM_busy(); ++i)
+        {
+            NVM_service();
+        }
+    }
+
+    // One bin of samples at a constant current
+    static void addBin(CurrentBaseline_t *baseline, MotorDirection_t dir, uint8_t bin, uint16_t current_ma)
+    {
+        for (uint16_t ms = 0U; ms < CURRENT_BASELINE_BIN_MS; ++ms)
+        {
+            CurrentBaseline_addSample(baseline, dir, bin, current_ma);
+        }
+    }
+};
+
+// REQ-NVM-001: Records round-trip, reject corruption, and rewrite only changed bytes
+TEST_F(CurrentBaselineIntegrationTest, NvmRecordsAreChecksummedAndWrittenInBackground)
+{
+    uint8_t payload[8] = {1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U};
+    uint8_t readback[8] = {0U};
+    EXPECT_FALSE(NVM_readRecord(0U, 0x21U, readback, sizeof(readback))) << "Erased EEPROM holds no record";
+
+    ASSERT_TRUE(NVM_writeRecord(0U, 0x21U, payload, sizeof(payload)));
+    EXPECT_TRUE(NVM_busy());
+    EXPECT_FALSE(NVM_writeRecord(0U, 0x21U, payload, sizeof(payload))) << "One record at a time";
+    NVM_service();
+    EXPECT_EQ(NVM_mockProgramCount(), 1U) << "One byte per service call";
+    EXPECT_FALSE(NVM_readRecord(0U, 0x21U, readback, sizeof(readback))) << "Partial record is not valid";
+    serviceNvm();
+    ASSERT_TRUE(NVM_readRecord(0U, 0x21U, readback, sizeof(readback)));
+    EXPECT_EQ(0, std::memcmp(payload, readback, sizeof(payload)));
+    EXPECT_EQ(NVM_mockProgramCount(), sizeof(payload) + NVM_RECORD_OVERHEAD);
+
+    // Rewrite with one payload byte changed: payload byte + checksum bytes only
+    payload[3] = 40U;
+    ASSERT_TRUE(NVM_writeRecord(0U, 0x21U, payload, sizeof(payload)));
+    serviceNvm();
+    EXPECT_LE(NVM_mockProgramCount(), sizeof(payload) + NVM_RECORD_OVERHEAD + 3U);
+
+    EXPECT_FALSE(NVM_readRecord(0U, 0x22U, readback, sizeof(readback))) << "Other record id";
+    NVM_mockWrite(5U, static_cast<uint8_t>(NVM_mockRead(5U) ^ 0x10U));
+    EXPECT_FALSE(NVM_readRecord(0U, 0x21U, readback, sizeof(readback))) << "Checksum catches a flipped bit";
+}
+
+// REQ-CUR-005: Clean strokes teach the baseline, faulted strokes do not; the limit only tightens
+TEST_F(CurrentBaselineIntegrationTest, BaselineLearnsFromCleanStrokes)
+{
+    CurrentBaseline_t baseline;
+    CurrentBaseline_init(&baseline);
+    EXPECT_EQ(CurrentBaseline_limitMa(&baseline, MOTOR_DOWN, 0U), 0U) << "Nothing learned yet";
+
+    // First stroke sets the level; a half-visited last bin is ignored
+    addBin(&baseline, MOTOR_DOWN, 0U, 60U);
+    addBin(&baseline, MOTOR_DOWN, 1U, 80U);
+    for (uint16_t ms = 0U; ms < 100U; ++ms)
+    {
+        CurrentBaseline_addSample(&baseline, MOTOR_DOWN, 2U, 20U);
+    }
+    EXPECT_TRUE(CurrentBaseline_endStroke(&baseline, true));
+    EXPECT_EQ(CurrentBaseline_limitMa(&baseline, MOTOR_DOWN, 0U), 60U + 60U / 8U + MOTOR_SENSE_BASELINE_MARGIN_MA);
+    EXPECT_EQ(CurrentBaseline_limitMa(&baseline, MOTOR_DOWN, 1U), 80U + 80U / 8U + MOTOR_SENSE_BASELINE_MARGIN_MA);
+    EXPECT_EQ(CurrentBaseline_limitMa(&baseline, MOTOR_DOWN, 2U), 0U) << "100 ms is too little of the bin";
+    EXPECT_EQ(CurrentBaseline_limitMa(&baseline, MOTOR_UP, 0U), 0U) << "Directions learn separately";
+    EXPECT_EQ(CurrentBaseline_limitMa(&baseline, MOTOR_DOWN, CURRENT_BASELINE_NO_POSITION), 0U);
+
+    // A faulted stroke is discarded; a clean one moves the level by a quarter
+    addBin(&baseline, MOTOR_DOWN, 0U, 180U);
+    EXPECT_FALSE(CurrentBaseline_endStroke(&baseline, false));
+    EXPECT_EQ(CurrentBaseline_limitMa(&baseline, MOTOR_DOWN, 0U), 60U + 60U / 8U + MOTOR_SENSE_BASELINE_MARGIN_MA);
+    addBin(&baseline, MOTOR_DOWN, 0U, 92U);
+    EXPECT_TRUE(CurrentBaseline_endStroke(&baseline, true));
+    EXPECT_EQ(CurrentBaseline_limitMa(&baseline, MOTOR_DOWN, 0U), 68U + 68U / 8U + MOTOR_SENSE_BASELINE_MARGIN_MA);
+
+    // High normal current: the fixed threshold is tighter, so no learned limit
+    addBin(&baseline, MOTOR_UP, 0U, 180U);
+    EXPECT_TRUE(CurrentBaseline_endStroke(&baseline, true));
+    EXPECT_EQ(CurrentBaseline_limitMa(&baseline, MOTOR_UP, 0U), 0U);
+
+    // Persisted levels restore; MT_BASIC (0 mA) never learns
+    ASSERT_TRUE(CurrentBaseline_save(&baseline));
+    serviceNvm();
+    CurrentBaseline_t restored;
+    CurrentBaseline_init(&restored);
+    ASSERT_TRUE(CurrentBaseline_load(&restored));
+    EXPECT_EQ(0, std::memcmp(baseline.level, restored.level, sizeof(baseline.level)));
+    addBin(&restored, MOTOR_UP, 5U, 0U);
+    EXPECT_FALSE(CurrentBaseline_endStroke(&restored, true));
+}
+
+// REQ-CUR-006: The control loop learns strokes from a limit switch, persists them and applies the limit
+TEST_F(CurrentBaselineIntegrationTest, ControlLoopLearnsAndAppliesBaseline)
+{
+    HAL_setMotorType(MT_ROBUST);
+    HAL_init();
+    if (MotorConfig_effectiveType(MT_ROBUST) != MT_ROBUST)
+    {
+        return;  // MT_BASIC build: HAL reports 0 mA
+    }
+    const uint16_t normal_ma = AdcSampler_toMilliamps(static_cast<uint16_t>(countsFor(100U) * ADC_FILTER_LENGTH));
+
+    for (int stroke = 0; stroke < 2; ++stroke)
+    {
+        // Start at the lower limit switch, drive up and leave it
+        DeskControl_Init(HAL_getTime());
+        pin_states[PIN_MOTOR_SENSE] = countsFor(100U);
+        pin_states[PIN_LIMIT_LOWER] = LOW;
+        pin_states[PIN_BUTTON_UP] = LOW;
+        runMs(300U);
+        ASSERT_EQ(HAL_getMotorDirection(), MOTOR_UP);
+        pin_states[PIN_LIMIT_LOWER] = HIGH;
+        runMs(3300U);
+
+        if (stroke == 1)
+        {
+            // Persisted from the first stroke: 100 mA + 1/8 + margin, well below the fixed threshold
+            CurrentSummary_t summary;
+            HAL_takeMotorCurrentSummary(&summary);
+            pin_states[PIN_MOTOR_SENSE] = countsFor(165U);
+            runMs(150U);
+            HAL_takeMotorCurrentSummary(&summary);
+            EXPECT_GE(summary.deviation_run_ms, MOTOR_SENSE_FAULT_TIME_MS);
+            EXPECT_EQ(summary.obstruction_run_ms, 0U);
+            pin_states[PIN_MOTOR_SENSE] = countsFor(100U);
+        }
+
+        pin_states[PIN_BUTTON_UP] = HIGH;
+        runMs(1000U);
+        ASSERT_EQ(HAL_getMotorDirection(), MOTOR_STOP);
+        EXPECT_FALSE(NVM_busy());
+
+        CurrentBaseline_t stored;
+        CurrentBaseline_init(&stored);
+        ASSERT_TRUE(CurrentBaseline_load(&stored)) << "Stroke " << stroke;
+        for (uint8_t bin = 0U; bin < 3U; ++bin)
+        {
+            EXPECT_NEAR(stored.level[0][bin] * CURRENT_BASELINE_UNIT_MA, normal_ma, CURRENT_BASELINE_UNIT_MA) << "Bin " << static_cast<int>(bin);
+        }
+        EXPECT_EQ(stored.level[1][0], 0U) << "No down stroke yet";
+    }
+}
+
+// REQ-CUR-007: Late loop passes advance the stroke position by the time elapsed, not by the pass
+TEST_F(CurrentBaselineIntegrationTest, LateLoopPassesKeepBinsOnTravelTime)
+{
+    HAL_setMotorType(MT_ROBUST);
+    HAL_init();
+    if (MotorConfig_effectiveType(MT_ROBUST) != MT_ROBUST)
+    {
+        return;  // MT_BASIC build: HAL reports 0 mA
+    }
+    const uint16_t normal_ma = AdcSampler_toMilliamps(static_cast<uint16_t>(countsFor(100U) * ADC_FILTER_LENGTH));
+    const uint16_t heavy_ma = AdcSampler_toMilliamps(static_cast<uint16_t>(countsFor(160U) * ADC_FILTER_LENGTH));
+
+    DeskControl_Init(HAL_getTime());
+    pin_states[PIN_MOTOR_SENSE] = countsFor(100U);
+    pin_states[PIN_LIMIT_LOWER] = LOW;
+    pin_states[PIN_BUTTON_UP] = LOW;
+    runMs(300U);
+    ASSERT_EQ(HAL_getMotorDirection(), MOTOR_UP);
+    pin_states[PIN_LIMIT_LOWER] = HIGH;
+
+    // loop() passes every 2 ms: the load rises after 2 s of travel, i.e. in bin 2
+    for (uint32_t elapsed = 0U; elapsed < 3300U; elapsed += 2U)
+    {
+        if (elapsed == 2000U)
+        {
+            pin_states[PIN_MOTOR_SENSE] = countsFor(160U);
+        }
+        MockClock_advanceUs(2000U);
+        DeskControl_Poll(HAL_getTime());
+    }
+    pin_states[PIN_BUTTON_UP] = HIGH;
+    runMs(1000U);
+    ASSERT_EQ(HAL_getMotorDirection(), MOTOR_STOP);
+
+    CurrentBaseline_t stored;
+    CurrentBaseline_init(&stored);
+    ASSERT_TRUE(CurrentBaseline_load(&stored));
+    EXPECT_NEAR(stored.level[0][0] * CURRENT_BASELINE_UNIT_MA, normal_ma, CURRENT_BASELINE_UNIT_MA);
+    EXPECT_NEAR(stored.level[0][1] * CURRENT_BASELINE_UNIT_MA, normal_ma, CURRENT_BASELINE_UNIT_MA);
+    EXPECT_NEAR(stored.level[0][2] * CURRENT_BASELINE_UNIT_MA, heavy_ma, CURRENT_BASELINE_UNIT_MA);
+}
+
+// REQ-CUR-008: Under speed control travel time is no stroke position: no learning, no tightened limit
+TEST_F(CurrentBaselineIntegrationTest, SpeedControlBypassesBaseline)
+{
+    HAL_setMotorType(MT_ROBUST);
+    HAL_init();
+    if (MotorConfig_effectiveType(MT_ROBUST) != MT_ROBUST)
+    {
+        return;  // MT_BASIC build: HAL reports 0 mA
+    }
+    const uint16_t normal_ma = AdcSampler_toMilliamps(static_cast<uint16_t>(countsFor(100U) * ADC_FILTER_LENGTH));
+
+    for (int stroke = 0; stroke < 2; ++stroke)
+    {
+        DeskControl_Init(HAL_getTime());
+        if (stroke == 1)
+        {
+            DeskControl_setSpeedControl(SPEED_FEEDBACK_ESTIMATE, 20U);
+        }
+        pin_states[PIN_MOTOR_SENSE] = countsFor(100U);
+        pin_states[PIN_LIMIT_LOWER] = LOW;
+        pin_states[PIN_BUTTON_UP] = LOW;
+        runMs(300U);
+        ASSERT_EQ(HAL_getMotorDirection(), MOTOR_UP);
+        pin_states[PIN_LIMIT_LOWER] = HIGH;
+        // Above the learned limit, below the fixed threshold: only the baseline would object
+        pin_states[PIN_MOTOR_SENSE] = countsFor((stroke == 0) ? 100U : 165U);
+        CurrentSummary_t summary;
+        HAL_takeMotorCurrentSummary(&summary);
+        runMs(3300U);
+        HAL_takeMotorCurrentSummary(&summary);
+        EXPECT_EQ(summary.deviation_run_ms, 0U) << "Stroke " << stroke;
+        pin_states[PIN_BUTTON_UP] = HIGH;
+        runMs(1000U);
+        ASSERT_EQ(HAL_getMotorDirection(), MOTOR_STOP);
+    }
+
+    CurrentBaseline_t stored;
+    CurrentBaseline_init(&stored);
+    ASSERT_TRUE(CurrentBaseline_load(&stored));
+    for (uint8_t bin = 0U; bin < 3U; ++bin)
+    {
+        EXPECT_NEAR(stored.level[0][bin] * CURRENT_BASELINE_UNIT_MA, normal_ma, CURRENT_BASELINE_UNIT_MA)
+            << "Bin " << static_cast<int>(bin) << " learned from the open-loop stroke only";
+    }
+}
+
+// ============================================================================
+// INTEGRATION TEST: Quadrature Encoder Position Tracking
+// Verifies edge decoding, 16-bit count wrap, velocity and the direction check,
+// and the HAL wiring from the encoder pins to EncoderState_t
+// ============================================================================
+
+class PositionEncoderIntegrationTest : public InputEventIntegrationTest
+{
+protected:
+    // A/B levels (A in bit 0) for a count: Gray sequence 00 -> 01 -> 11 -> 10
+    static uint8_t levelsFor(int32_t count)
+    {
+        const uint8_t phase = static_cast<uint8_t>(static_cast<uint32_t>(count) & 0x03U);
+        return static_cast<uint8_t>(phase ^ (phase >> 1));
+    }
+
+    static void move(PositionEncoder_t *encoder, int32_t *count, int32_t steps)
+    {
+        const int32_t dir = (steps < 0) ? -1 : 1;
+        for (int32_t i = 0; i != steps; i += dir)
+        {
+            *count += dir;
+            PositionEncoder_edge(encoder, levelsFor(*count));
+        }
+    }
+};
+
+// REQ-ENC-001: Edges count up and down, bounces cancel, skipped states count as errors
+TEST_F(PositionEncoderIntegrationTest, DecodesStepsAndSkippedStates)
+{
+    PositionEncoder_t encoder;
+    int32_t count = 0;
+    PositionEncoder_init(&encoder, levelsFor(count), 0U);
+
+    move(&encoder, &count, 10);
+    move(&encoder, &count, -3);
+    PositionEncoder_update(&encoder, MOTOR_STOP, 1U);
+    EncoderState_t state = PositionEncoder_state(&encoder);
+    EXPECT_EQ(state.position_counts, 7);
+    EXPECT_EQ(state.decode_errors, 0U);
+
+    // Contact bounce on one channel: forward and back, no net count
+    PositionEncoder_edge(&encoder, levelsFor(count + 1));
+    PositionEncoder_edge(&encoder, levelsFor(count));
+    PositionEncoder_edge(&encoder, levelsFor(count));  // Same levels again (other channel's interrupt)
+    // Missed edge: jump two states - counted as an error, not guessed
+    count += 2;
+    PositionEncoder_edge(&encoder, levelsFor(count));
+    PositionEncoder_update(&encoder, MOTOR_STOP, 2U);
+    state = PositionEncoder_state(&encoder);
+    EXPECT_EQ(state.position_counts, 7);
+    EXPECT_EQ(state.decode_errors, 1U);
+    EXPECT_EQ(PositionEncoder_state(NULL).position_counts, 0);
+}
+
+// REQ-ENC-002: Position extends past the 16-bit ISR count in both directions
+TEST_F(PositionEncoderIntegrationTest, PositionSurvivesCountWrap)
+{
+    PositionEncoder_t encoder;
+    int32_t count = 0;
+    PositionEncoder_init(&encoder, levelsFor(count), 0U);
+
+    uint32_t now_ms = 0U;
+    for (int block = 0; block < 5; ++block)
+    {
+        move(&encoder, &count, 20000);  // 100000 counts: the 16-bit count wraps
+        PositionEncoder_update(&encoder, MOTOR_UP, ++now_ms);
+    }
+    EXPECT_EQ(PositionEncoder_state(&encoder).position_counts, 100000);
+
+    for (int block = 0; block < 6; ++block)
+    {
+        move(&encoder, &count, -30000);
+        PositionEncoder_update(&encoder, MOTOR_DOWN, ++now_ms);
+    }
+    EXPECT_EQ(PositionEncoder_state(&encoder).position_counts, -80000);
+}
+
+// REQ-ENC-003: Velocity over the slot window; travel against the drive latches a direction error
+TEST_F(PositionEncoderIntegrationTest, VelocityAndDirectionCheck)
+{
+    PositionEncoder_t encoder;
+    int32_t count = 0;
+    PositionEncoder_init(&encoder, levelsFor(count), 0U);
+
+    // 1 count every 4 ms for 200 ms = 250 counts/s up, driven up
+    for (uint32_t ms = 1U; ms <= 200U; ++ms)
+    {
+        if ((ms % 4U) == 0U)
+        {
+            move(&encoder, &count, 1);
+        }
+        PositionEncoder_update(&encoder, MOTOR_UP, ms);
+    }
+    EncoderState_t state = PositionEncoder_state(&encoder);
+    EXPECT_EQ(state.velocity_cps, 250);
+    EXPECT_FALSE(state.direction_error);
+
+    // Driven down while the desk keeps rising: error once the travel against it reaches the limit
+    PositionEncoder_update(&encoder, MOTOR_DOWN, 201U);
+    move(&encoder, &count, static_cast<int32_t>(ENCODER_DIRECTION_ERROR_COUNTS) - 1);
+    PositionEncoder_update(&encoder, MOTOR_DOWN, 202U);
+    EXPECT_FALSE(PositionEncoder_state(&encoder).direction_error) << "Within the tolerance";
+    move(&encoder, &count, 1);
+    PositionEncoder_update(&encoder, MOTOR_DOWN, 203U);
+    EXPECT_TRUE(PositionEncoder_state(&encoder).direction_error);
+    PositionEncoder_update(&encoder, MOTOR_DOWN, 204U);
+    EXPECT_TRUE(PositionEncoder_state(&encoder).direction_error) << "Latched while the drive lasts";
+    PositionEncoder_update(&encoder, MOTOR_STOP, 205U);
+    EXPECT_FALSE(PositionEncoder_state(&encoder).direction_error) << "Cleared when the drive changes";
+}
+
+// REQ-ENC-004: The HAL decodes the encoder pins and reports the travel under the drive applied
+TEST_F(PositionEncoderIntegrationTest, HalTracksEncoderPins)
+{
+    int32_t count = 0;
+    HAL_setMotor(MOTOR_UP, 200U);
+    for (int i = 0; i < 12; ++i)
+    {
+        count++;
+        const uint8_t levels = levelsFor(count);
+        pin_states[PIN_ENCODER_A] = ((levels & 0x01U) != 0U) ? HIGH : LOW;
+        pin_states[PIN_ENCODER_B] = ((levels & 0x02U) != 0U) ? HIGH : LOW;
+        HAL_encoderIsr();
+    }
+    HAL_sampleEncoder();
+    EncoderState_t state;
+    HAL_readEncoder(&state);
+    EXPECT_EQ(state.position_counts, 12);
+    EXPECT_FALSE(state.direction_error);
+    HAL_readEncoder(NULL);
+
+    HAL_setMotor(MOTOR_DOWN, 200U);
+    HAL_sampleEncoder();
+    for (int i = 0; i < static_cast<int>(ENCODER_DIRECTION_ERROR_COUNTS); ++i)
+    {
+        count++;
+        const uint8_t levels = levelsFor(count);
+        pin_states[PIN_ENCODER_A] = ((levels & 0x01U) != 0U) ? HIGH : LOW;
+        pin_states[PIN_ENCODER_B] = ((levels & 0x02U) != 0U) ? HIGH : LOW;
+        HAL_sampleEncoder();  // Host emulation: one state per access decodes without the ISR call
+    }
+    HAL_readEncoder(&state);
+    EXPECT_EQ(state.position_counts, 12 + static_cast<int32_t>(ENCODER_DIRECTION_ERROR_COUNTS));
+    EXPECT_TRUE(state.direction_error) << "Rising while driven down";
+    EXPECT_EQ(state.decode_errors, 0U);
+}
+
+// ============================================================================
+// INTEGRATION TEST: Sensorless Position Estimation
+// Verifies the speed-vs-PWM model, the limit switch references, the error
+// bound and the stroke calibration of the dead-reckoning estimator
+// ============================================================================
+
+class PositionEstimatorIntegrationTest : public ::testing::Test
+{
+protected:
+    static void drive(PositionEstimator_t *estimator, MotorDirection_t dir, uint8_t pwm, uint32_t duration_ms)
+    {
+        for (uint32_t ms = 0U; ms < duration_ms; ++ms)
+        {
+            PositionEstimator_update(estimator, dir, pwm, false, false, 1U);
+        }
+    }
+};
+
+// REQ-POS-001: The model integrates PWM and direction, references at the switches and bounds the drift
+TEST_F(PositionEstimatorIntegrationTest, IntegratesDriveBetweenLimitReferences)
+{
+    PositionEstimator_t estimator;
+    PositionEstimator_init(&estimator);
+    EXPECT_FALSE(PositionEstimator_estimate(&estimator).referenced);
+    EXPECT_FALSE(PositionEstimator_estimate(NULL).referenced);
+
+    const uint32_t up_um_s = 235U * 255U - POSITION_ESTIMATOR_LOAD_UP_UM_S;
+    const uint32_t down_um_s = 235U * 255U - POSITION_ESTIMATOR_LOAD_DOWN_UM_S;
+    EXPECT_EQ(PositionEstimator_speedUmS(&estimator, MOTOR_UP, 255U), up_um_s);
+    EXPECT_EQ(PositionEstimator_speedUmS(&estimator, MOTOR_DOWN, 255U), down_um_s);
+    EXPECT_EQ(PositionEstimator_speedUmS(&estimator, MOTOR_UP, 100U), 0U) << "Too little PWM to lift the load";
+    EXPECT_EQ(PositionEstimator_speedUmS(&estimator, MOTOR_STOP, 255U), 0U);
+
+    PositionEstimator_update(&estimator, MOTOR_STOP, 0U, true, false, 1U);
+    PositionEstimate_t estimate = PositionEstimator_estimate(&estimator);
+    EXPECT_TRUE(estimate.referenced);
+    EXPECT_EQ(estimate.height_um, 0);
+    EXPECT_EQ(estimate.error_um, 0U);
+
+    // 1 s up at full PWM: exact, the sub-um remainder carries over
+    drive(&estimator, MOTOR_UP, 255U, 1000U);
+    estimate = PositionEstimator_estimate(&estimator);
+    EXPECT_EQ(estimate.height_um, static_cast<int32_t>(up_um_s));
+    EXPECT_EQ(estimate.error_um, (up_um_s >> POSITION_ESTIMATOR_TOLERANCE_SHIFT) + POSITION_ESTIMATOR_START_ERROR_UM);
+
+    drive(&estimator, MOTOR_UP, 100U, 500U);
+    EXPECT_EQ(PositionEstimator_estimate(&estimator).height_um, static_cast<int32_t>(up_um_s));
+
+    // 0.5 s down, then the lower switch: the drift found is the estimate at the switch
+    drive(&estimator, MOTOR_DOWN, 255U, 500U);
+    const int32_t before_switch = PositionEstimator_estimate(&estimator).height_um;
+    EXPECT_EQ(before_switch, static_cast<int32_t>(up_um_s - down_um_s / 2U));
+    PositionEstimator_update(&estimator, MOTOR_STOP, 0U, true, false, 1U);
+    estimate = PositionEstimator_estimate(&estimator);
+    EXPECT_EQ(estimate.height_um, 0);
+    EXPECT_EQ(estimate.error_um, 0U);
+    EXPECT_EQ(estimator.last_correction_um, static_cast<uint32_t>(before_switch));
+
+    // The upper switch references the stroke; the estimate never leaves the switches' range
+    PositionEstimator_update(&estimator, MOTOR_STOP, 0U, false, true, 1U);
+    EXPECT_EQ(PositionEstimator_estimate(&estimator).height_um, static_cast<int32_t>(POSITION_ESTIMATOR_STROKE_UM));
+    drive(&estimator, MOTOR_UP, 255U, 100U);
+    EXPECT_EQ(PositionEstimator_estimate(&estimator).height_um, static_cast<int32_t>(POSITION_ESTIMATOR_STROKE_UM));
+    PositionEstimator_update(&estimator, MOTOR_STOP, 0U, true, true, 1U);
+    EXPECT_EQ(PositionEstimator_estimate(&estimator).height_um, static_cast<int32_t>(POSITION_ESTIMATOR_STROKE_UM))
+        << "Both switches active: no reference";
+}
+
+// REQ-POS-002: Full strokes between the switches calibrate that direction's speed; reversals do not
+TEST_F(PositionEstimatorIntegrationTest, FullStrokesCalibrateSpeed)
+{
+    PositionEstimator_t estimator;
+    PositionEstimator_init(&estimator);
+    const uint32_t up_um_s = PositionEstimator_speedUmS(&estimator, MOTOR_UP, 255U);
+
+    // A heavier load: the modelled travel reaches 700 mm before the desk covers the 640 mm stroke
+    PositionEstimator_update(&estimator, MOTOR_STOP, 0U, true, false, 1U);
+    drive(&estimator, MOTOR_UP, 255U, (700000U * 1000U) / up_um_s);
+    PositionEstimator_update(&estimator, MOTOR_STOP, 0U, false, true, 1U);
+    const uint16_t expected_scale = static_cast<uint16_t>(256U - (256U - (640000U * 256U) / 699997U) / 4U);
+    EXPECT_EQ(estimator.scale[0], expected_scale);
+    EXPECT_EQ(PositionEstimator_speedUmS(&estimator, MOTOR_UP, 255U), (up_um_s * expected_scale) / 256U);
+    EXPECT_EQ(estimator.scale[1], POSITION_ESTIMATOR_SCALE_UNITY) << "Directions calibrate separately";
+
+    // Down with a reversal on the way: discarded
+    drive(&estimator, MOTOR_DOWN, 255U, 2000U);
+    drive(&estimator, MOTOR_UP, 255U, 500U);
+    drive(&estimator, MOTOR_DOWN, 255U, 20000U);
+    PositionEstimator_update(&estimator, MOTOR_STOP, 0U, true, false, 1U);
+    EXPECT_EQ(estimator.scale[1], POSITION_ESTIMATOR_SCALE_UNITY);
+
+    // Strokes the model cannot explain (4x the modelled travel) stop at the scale limit
+    for (int stroke = 0; stroke < 20; ++stroke)
+    {
+        PositionEstimator_update(&estimator, MOTOR_STOP, 0U, true, false, 1U);
+        drive(&estimator, MOTOR_UP, 255U, 1000U);
+        PositionEstimator_update(&estimator, MOTOR_STOP, 0U, false, true, 1U);
+        drive(&estimator, MOTOR_DOWN, 255U, 1000U);
+    }
+    EXPECT_LE(estimator.scale[0], POSITION_ESTIMATOR_SCALE_MAX);
+    EXPECT_GT(estimator.scale[0], POSITION_ESTIMATOR_SCALE_MAX - (1U << POSITION_ESTIMATOR_LEARN_SHIFT));
+    EXPECT_LE(estimator.scale[1], POSITION_ESTIMATOR_SCALE_MAX);
+    EXPECT_GT(estimator.scale[1], POSITION_ESTIMATOR_SCALE_MAX - (1U << POSITION_ESTIMATOR_LEARN_SHIFT));
+}
+
+// ============================================================================
+// INTEGRATION TEST: Memory Presets and Move-to-Target Braking
+// Verifies the persisted preset slots, the braking distance of the soft stop
+// and the preset API of the control loop
+// ============================================================================
+
+class DeskPresetIntegrationTest : public CurrentMonitorIntegrationTest
+{
+protected:
+    // Estimator that has seen the lower limit switch and then driven up
+    static void referencedAt(PositionEstimator_t *estimator, uint32_t up_ms)
+    {
+        PositionEstimator_init(estimator);
+        PositionEstimator_update(estimator, MOTOR_STOP, 0U, true, false, 1U);
+        for (uint32_t ms = 0U; ms < up_ms; ++ms)
+        {
+            PositionEstimator_update(estimator, MOTOR_UP, 255U, false, false, 1U);
+        }
+    }
+};
+
+// REQ-PRE-001: Presets round to mm, reject bad slots and heights, and restore from NVM
+TEST_F(DeskPresetIntegrationTest, PresetsPersistInNvm)
+{
+    DeskPresets_t presets;
+    DeskPresets_init(&presets);
+    int32_t height_um = -1;
+    EXPECT_FALSE(DeskPresets_get(&presets, 0U, &height_um)) << "Empty slot";
+    EXPECT_EQ(height_um, -1);
+    EXPECT_FALSE(DeskPresets_load(&presets)) << "Erased EEPROM holds no presets";
+
+    EXPECT_TRUE(DeskPresets_set(&presets, 0U, 123499));
+    EXPECT_TRUE(DeskPresets_set(&presets, 3U, 640000));
+    EXPECT_FALSE(DeskPresets_set(&presets, DESK_PRESET_COUNT, 100000)) << "No such slot";
+    EXPECT_FALSE(DeskPresets_set(&presets, 1U, -1)) << "Below the lower limit switch";
+    EXPECT_FALSE(DeskPresets_set(&presets, 1U, static_cast<int32_t>(DESK_PRESET_EMPTY) * 1000)) << "Collides with empty";
+    ASSERT_TRUE(DeskPresets_get(&presets, 0U, &height_um));
+    EXPECT_EQ(height_um, 123000);
+    EXPECT_FALSE(DeskPresets_get(&presets, 1U, &height_um));
+
+    ASSERT_TRUE(DeskPresets_save(&presets));
+    for (int i = 0; (i < 200) && NVM_busy(); ++i)
+    {
+        NVM_service();
+    }
+    DeskPresets_t restored;
+    DeskPresets_init(&restored);
+    ASSERT_TRUE(DeskPresets_load(&restored));
+    ASSERT_TRUE(DeskPresets_get(&restored, 3U, &height_um));
+    EXPECT_EQ(height_um, 640000);
+    EXPECT_FALSE(DeskPresets_get(&restored, 2U, &height_um));
+}
+
+// REQ-PRE-002: The braking point leaves exactly the soft-stop travel to the target
+TEST_F(DeskPresetIntegrationTest, BrakingPointMatchesSoftStopTravel)
+{
+    PositionEstimator_t estimator;
+    referencedAt(&estimator, 5000U);
+    const int32_t height_um = PositionEstimator_estimate(&estimator).height_um;
+    const uint32_t cruise_um_s = PositionEstimator_speedUmS(&estimator, MOTOR_UP, 255U);
+
+    // Ramping from cruise covers less than cruising for the whole ramp, and slower drives brake shorter
+    const uint32_t braking_um = MotionProfile_brakingDistanceUm(&estimator, MOTOR_UP, 255U);
+    EXPECT_GT(braking_um, 0U);
+    EXPECT_LT(braking_um, cruise_um_s / 5U) << "Below cruise speed for 200 ms";
+    EXPECT_LT(MotionProfile_brakingDistanceUm(&estimator, MOTOR_UP, 200U), braking_um);
+    EXPECT_EQ(MotionProfile_brakingDistanceUm(&estimator, MOTOR_UP, 0U), 0U);
+    EXPECT_EQ(MotionProfile_brakingDistanceUm(&estimator, MOTOR_STOP, 255U), 0U);
+
+    MotionProfile_t profile;
+    MotionProfile_init(&profile);
+    const int32_t braking = static_cast<int32_t>(braking_um);
+    EXPECT_FALSE(MotionProfile_atBrakingPoint(&profile, &estimator, MOTOR_UP, 255U, height_um + 100000));
+    EXPECT_EQ(profile.dir, MOTOR_STOP) << "Far from the target: nothing summed";
+    EXPECT_FALSE(MotionProfile_atBrakingPoint(&profile, &estimator, MOTOR_UP, 255U, height_um + braking + 1));
+    EXPECT_EQ(profile.braking_um, braking_um);
+    EXPECT_TRUE(MotionProfile_atBrakingPoint(&profile, &estimator, MOTOR_UP, 255U, height_um + braking));
+    EXPECT_TRUE(MotionProfile_atBrakingPoint(&profile, &estimator, MOTOR_UP, 255U, height_um - 1000)) << "Past the target";
+    EXPECT_FALSE(MotionProfile_atBrakingPoint(&profile, &estimator, MOTOR_DOWN, 255U, height_um - 100000));
+    EXPECT_FALSE(MotionProfile_atBrakingPoint(&profile, &estimator, MOTOR_STOP, 0U, height_um));
+}
+
+// REQ-PRE-003: The control loop stores referenced heights, persists them and recalls them as targets
+TEST_F(DeskPresetIntegrationTest, ControlLoopStoresAndRecallsPresets)
+{
+    DeskControl_Init(HAL_getTime());
+    runMs(10U);
+    EXPECT_FALSE(DeskControl_storePreset(0U)) << "Height not referenced yet";
+    EXPECT_FALSE(DeskControl_recallPreset(0U)) << "Empty slot";
+
+    // Reference at the lower limit switch, drive up for 3 s and store
+    pin_states[PIN_LIMIT_LOWER] = LOW;
+    runMs(10U);
+    pin_states[PIN_LIMIT_LOWER] = HIGH;
+    pin_states[PIN_BUTTON_UP] = LOW;
+    runMs(3000U);
+    pin_states[PIN_BUTTON_UP] = HIGH;
+    runMs(1000U);
+    ASSERT_EQ(HAL_getMotorDirection(), MOTOR_STOP);
+    const PositionEstimate_t stored_at = DeskControl_getPositionEstimate();
+    ASSERT_TRUE(stored_at.referenced);
+    EXPECT_FALSE(DeskControl_storePreset(DESK_PRESET_COUNT));
+    ASSERT_TRUE(DeskControl_storePreset(1U));
+    runMs(100U);
+    EXPECT_FALSE(NVM_busy());
+
+    DeskPresets_t persisted;
+    DeskPresets_init(&persisted);
+    ASSERT_TRUE(DeskPresets_load(&persisted));
+    int32_t height_um = 0;
+    ASSERT_TRUE(DeskPresets_get(&persisted, 1U, &height_um));
+    EXPECT_NEAR(height_um, stored_at.height_um, 500);
+
+    // Down to the lower limit switch, then recall: the desk drives up on its own
+    pin_states[PIN_BUTTON_DOWN] = LOW;
+    runMs(300U);
+    pin_states[PIN_LIMIT_LOWER] = LOW;
+    pin_states[PIN_BUTTON_DOWN] = HIGH;
+    runMs(500U);
+    pin_states[PIN_LIMIT_LOWER] = HIGH;
+    ASSERT_TRUE(DeskControl_recallPreset(1U));
+    runMs(300U);
+    EXPECT_EQ(APP_GetState(), APP_STATE_MOVING_TO_TARGET);
+    EXPECT_EQ(HAL_getMotorDirection(), MOTOR_UP);
+}
+
+// ============================================================================
+// INTEGRATION TEST: Closed-Loop Speed Control
+// Verifies the inverse speed model used as feedforward and the fixed-point
+// PID with its anti-windup
+// ============================================================================
+
+class SpeedControllerIntegrationTest : public ::testing::Test
+{
+};
+
+// REQ-SPD-001: The feedforward PWM is the lowest the speed model rates at the speed wanted
+TEST_F(SpeedControllerIntegrationTest, FeedforwardInvertsSpeedModel)
+{
+    PositionEstimator_t estimator;
+    PositionEstimator_init(&estimator);
+    estimator.scale[1] = 300U;  // A learned down scale
+    const MotorDirection_t dirs[2] = {MOTOR_UP, MOTOR_DOWN};
+    for (MotorDirection_t dir : dirs)
+    {
+        for (uint32_t speed_um_s = 1000U; speed_um_s <= 30000U; speed_um_s += 977U)
+        {
+            const uint8_t pwm = PositionEstimator_pwmForSpeed(&estimator, dir, speed_um_s);
+            EXPECT_GE(PositionEstimator_speedUmS(&estimator, dir, pwm), speed_um_s) << speed_um_s;
+            EXPECT_LT(PositionEstimator_speedUmS(&estimator, dir, static_cast<uint8_t>(pwm - 1U)), speed_um_s) << speed_um_s;
+        }
+    }
+    EXPECT_EQ(PositionEstimator_pwmForSpeed(&estimator, MOTOR_UP, 0U), 0U);
+    EXPECT_EQ(PositionEstimator_pwmForSpeed(&estimator, MOTOR_STOP, 20000U), 0U);
+    EXPECT_EQ(PositionEstimator_pwmForSpeed(&estimator, MOTOR_UP, 50000U), UINT8_MAX) << "Faster than full PWM";
+    EXPECT_EQ(PositionEstimator_pwmForSpeed(NULL, MOTOR_UP, 20000U), 0U);
+}
+
+// REQ-SPD-002: PID terms, integration only when allowed, no windup at the clamp, reset on a new drive
+TEST_F(SpeedControllerIntegrationTest, PidHoldsSetpointWithoutWindup)
+{
+    SpeedController_t controller;
+    SpeedController_init(&controller);
+
+    // On the setpoint: feedforward only
+    EXPECT_EQ(SpeedController_update(&controller, MOTOR_UP, 20000U, 100U, 20000, true, 1U), 100U);
+    EXPECT_EQ(SpeedController_update(&controller, MOTOR_UP, 20000U, 100U, 20000, true, 2U), 100U);
+
+    // 1 mm/s slow: P adds KP * 1000 at once; held integral adds nothing over time
+    const uint8_t p_only = static_cast<uint8_t>(100 + ((SPEED_CONTROL_KP * 1000) >> SPEED_CONTROL_GAIN_SHIFT));
+    EXPECT_EQ(SpeedController_update(&controller, MOTOR_UP, 20000U, 100U, 19000, false, 3U), p_only);
+    EXPECT_EQ(SpeedController_update(&controller, MOTOR_UP, 20000U, 100U, 19000, false, 500U), p_only);
+    EXPECT_EQ(controller.integral, 0);
+
+    // Integrating: the PWM keeps rising while the error persists
+    uint8_t pwm = p_only;
+    for (uint32_t t = 501U; t <= 700U; ++t)
+    {
+        pwm = SpeedController_update(&controller, MOTOR_UP, 20000U, 100U, 19000, true, t);
+    }
+    EXPECT_EQ(controller.integral, SPEED_CONTROL_KI * 1000 * 200);
+    EXPECT_GT(pwm, p_only);
+    EXPECT_EQ(SpeedController_update(&controller, MOTOR_UP, 20000U, 100U, 19000, true, 700U), pwm) << "Same ms: no step";
+
+    // Stalled far below the setpoint: the output clamps at 255 and the integral stops growing
+    for (uint32_t t = 701U; t <= 5000U; ++t)
+    {
+        pwm = SpeedController_update(&controller, MOTOR_UP, 20000U, 250U, 0, true, t);
+    }
+    EXPECT_EQ(pwm, UINT8_MAX);
+    EXPECT_LT(controller.integral, static_cast<int32_t>(UINT8_MAX) << SPEED_CONTROL_GAIN_SHIFT);
+    // ...so the first sample above the setpoint leaves the clamp at once
+    EXPECT_LT(SpeedController_update(&controller, MOTOR_UP, 20000U, 250U, 40000, true, 5001U), UINT8_MAX);
+
+    // A new drive starts from the feedforward; STOP returns 0
+    EXPECT_EQ(SpeedController_update(&controller, MOTOR_DOWN, 20000U, 90U, 20000, true, 5002U), 90U);
+    EXPECT_EQ(controller.integral, 0);
+    EXPECT_EQ(SpeedController_update(&controller, MOTOR_STOP, 20000U, 90U, 0, true, 5003U), 0U);
+    EXPECT_EQ(SpeedController_update(NULL, MOTOR_UP, 20000U, 90U, 0, true, 5004U), 0U);
+}
+
+// ============================================================================
+// INTEGRATION TEST: Stroke Calibration
+// Verifies the stroke measurements and their NVM record, the estimator and
+// baseline hooks the calibration uses, and the calibration run by the
+// control loop
+// ============================================================================
+
+class DeskCalibrationIntegrationTest : public CurrentMonitorIntegrationTest
+{
+};
+
+// REQ-CAL-001: A stroke yields travel time, counts, start lag and cruise current, and persists in NVM
+TEST_F(DeskCalibrationIntegrationTest, StrokeMeasurementsPersistInNvm)
+{
+    DeskCalibrationStroke_t stroke;
+    DeskCalibration_cancelStroke(&stroke);
+    DeskCalibration_t calibration;
+    DeskCalibration_init(&calibration);
+    EXPECT_FALSE(DeskCalibration_endStroke(&stroke, &calibration, 100U, 0)) << "No stroke in progress";
+    EXPECT_FALSE(DeskCalibration_load(&calibration)) << "Erased EEPROM holds no calibration";
+    EXPECT_EQ(DeskCalibration_velocityUmS(&calibration, 100), 100 * 1000 / ENCODER_COUNTS_PER_MM) << "Nominal counts";
+
+    // 400 ms at rest behind the ramp, then 1 count per 10 ms over 1600 counts; 900 mA inrush, 100/140 mA cruise
+    const uint32_t start_ms = 1000U;
+    DeskCalibration_beginStroke(&stroke, start_ms, 100);
+    uint32_t t = 1U;
+    for (; t < 16400U; ++t)
+    {
+        const int32_t counts = (t > 400U) ? static_cast<int32_t>((t - 400U) / 10U) : 0;
+        const bool cruising = (t > 400U);
+        const uint16_t current_ma = cruising ? static_cast<uint16_t>((t % 2U == 0U) ? 100U : 140U) : 900U;
+        DeskCalibration_sample(&stroke, start_ms + t, 100 + counts, counts * 400, cruising, current_ma);
+    }
+    ASSERT_TRUE(DeskCalibration_endStroke(&stroke, &calibration, start_ms + t, 1700));
+    EXPECT_FALSE(stroke.active);
+    EXPECT_EQ(calibration.stroke_ms, 16400U);
+    EXPECT_EQ(calibration.encoder_counts, 1600U);
+    EXPECT_EQ(calibration.ramp_ms, 400U) << "Travel time minus the stroke at cruise speed";
+    EXPECT_EQ(calibration.current_mean_ma, 120U) << "Inrush excluded";
+    EXPECT_EQ(calibration.current_peak_ma, 140U);
+    EXPECT_EQ(calibration.scale[0], 0U) << "Scales are the caller's";
+
+    // 400 um per count: 100 counts/s = 40 mm/s, either way
+    EXPECT_EQ(DeskCalibration_velocityUmS(&calibration, 100), 40000);
+    EXPECT_EQ(DeskCalibration_velocityUmS(&calibration, -100), -40000);
+
+    // Persisted record
+    calibration.scale[0] = 260U;
+    calibration.scale[1] = 250U;
+    ASSERT_TRUE(DeskCalibration_save(&calibration));
+    for (int i = 0; (i < 200) && NVM_busy(); ++i)
+    {
+        NVM_service();
+    }
+    DeskCalibration_t restored;
+    DeskCalibration_init(&restored);
+    ASSERT_TRUE(DeskCalibration_load(&restored));
+    EXPECT_EQ(std::memcmp(&restored, &calibration, sizeof(calibration)), 0);
+
+    // No encoder: the counts never move, nothing to derive from them
+    DeskCalibration_beginStroke(&stroke, 0U, 5);
+    DeskCalibration_sample(&stroke, 10000U, 5, 400000, true, 120U);
+    ASSERT_TRUE(DeskCalibration_endStroke(&stroke, &calibration, 20000U, 5));
+    EXPECT_EQ(calibration.stroke_ms, 20000U);
+    EXPECT_EQ(calibration.encoder_counts, 0U);
+    EXPECT_EQ(calibration.ramp_ms, 0U);
+    EXPECT_EQ(DeskCalibration_velocityUmS(&calibration, 100), 100 * 1000 / ENCODER_COUNTS_PER_MM);
+}
+
+// REQ-CAL-002: The estimator keeps a full stroke's scale for adoption; the baseline forgets one direction
+TEST_F(DeskCalibrationIntegrationTest, EstimatorAndBaselineHooks)
+{
+    PositionEstimator_t estimator;
+    PositionEstimator_init(&estimator);
+    EXPECT_EQ(PositionEstimator_strokeScale(&estimator, MOTOR_UP), 0U) << "No full stroke yet";
+
+    // Full stroke up in 10 s: the model rates it half as long as it is
+    PositionEstimator_update(&estimator, MOTOR_STOP, 0U, true, false, 1U);
+    for (uint32_t ms = 0U; ms < 10000U; ++ms)
+    {
+        PositionEstimator_update(&estimator, MOTOR_UP, 255U, false, false, 1U);
+    }
+    const uint32_t model_um = (PositionEstimator_speedUmS(&estimator, MOTOR_UP, 255U) * 10000U) / 1000U;
+    PositionEstimator_update(&estimator, MOTOR_STOP, 0U, false, true, 1U);
+    const uint16_t measured = static_cast<uint16_t>((POSITION_ESTIMATOR_STROKE_UM * POSITION_ESTIMATOR_SCALE_UNITY) / model_um);
+    EXPECT_EQ(PositionEstimator_strokeScale(&estimator, MOTOR_UP), measured);
+    EXPECT_EQ(PositionEstimator_strokeScale(&estimator, MOTOR_DOWN), 0U);
+    EXPECT_EQ(PositionEstimator_strokeScale(&estimator, MOTOR_STOP), 0U);
+    EXPECT_LT(estimator.scale[0], measured) << "Learning moves only a quarter of the way";
+
+    PositionEstimator_setScale(&estimator, MOTOR_UP, measured);
+    EXPECT_EQ(estimator.scale[0], measured);
+    PositionEstimator_setScale(&estimator, MOTOR_DOWN, 1000U);
+    EXPECT_EQ(estimator.scale[1], POSITION_ESTIMATOR_SCALE_MAX);
+    PositionEstimator_setScale(&estimator, MOTOR_DOWN, 0U);
+    EXPECT_EQ(estimator.scale[1], POSITION_ESTIMATOR_SCALE_MIN);
+    PositionEstimator_setScale(&estimator, MOTOR_STOP, 300U);
+    EXPECT_EQ(estimator.scale[0], measured);
+
+    CurrentBaseline_t baseline;
+    CurrentBaseline_init(&baseline);
+    for (uint8_t bin = 0U; bin < CURRENT_BASELINE_BINS; ++bin)
+    {
+        baseline.level[0][bin] = 30U;
+        baseline.level[1][bin] = 20U;
+    }
+    CurrentBaseline_forget(&baseline, MOTOR_UP);
+    CurrentBaseline_forget(&baseline, MOTOR_STOP);
+    for (uint8_t bin = 0U; bin < CURRENT_BASELINE_BINS; ++bin)
+    {
+        EXPECT_EQ(baseline.level[0][bin], 0U) << "bin " << static_cast<int>(bin);
+        EXPECT_EQ(baseline.level[1][bin], 20U) << "bin " << static_cast<int>(bin);
+    }
+}
+
+// REQ-CAL-003: The control loop homes, strokes up, stores the calibration and restores it at start-up
+TEST_F(DeskCalibrationIntegrationTest, ControlLoopCalibratesAndRestores)
+{
+    DeskControl_Init(HAL_getTime());
+    runMs(10U);
+    EXPECT_EQ(DeskControl_getCalibration().stroke_ms, 0U) << "Not calibrated yet";
+    DeskControl_startCalibration();
+    runMs(300U);
+    EXPECT_EQ(APP_GetState(), APP_STATE_CALIBRATING);
+    EXPECT_EQ(HAL_getMotorDirection(), MOTOR_DOWN) << "Homing leg";
+
+    // Homed: rest one cycle at the switch, then the stroke up
+    runMs(2000U);
+    pin_states[PIN_LIMIT_LOWER] = LOW;
+    runMs(260U);
+    EXPECT_EQ(APP_GetState(), APP_STATE_CALIBRATING);
+    EXPECT_EQ(HAL_getMotorDirection(), MOTOR_STOP);
+    runMs(250U);
+    ASSERT_EQ(HAL_getMotorDirection(), MOTOR_UP);
+    runMs(500U);
+    pin_states[PIN_LIMIT_LOWER] = HIGH;
+    runMs(19500U);
+    EXPECT_EQ(HAL_getMotorDirection(), MOTOR_UP);
+    pin_states[PIN_LIMIT_UPPER] = LOW;
+    runMs(300U);
+    EXPECT_EQ(APP_GetState(), APP_STATE_IDLE);
+    EXPECT_EQ(HAL_getMotorDirection(), MOTOR_STOP);
+
+    const DeskCalibration_t calibration = DeskControl_getCalibration();
+    EXPECT_GE(calibration.stroke_ms, 20000U);
+    EXPECT_LE(calibration.stroke_ms, 20250U);
+    EXPECT_EQ(calibration.encoder_counts, 0U) << "No encoder on the mock pins";
+    // ~20 s of the default model is about the 640 mm stroke: scale near 1.0, adopted in full
+    EXPECT_NEAR(calibration.scale[0], POSITION_ESTIMATOR_SCALE_UNITY, 12);
+    EXPECT_EQ(calibration.scale[1], POSITION_ESTIMATOR_SCALE_UNITY);
+
+    runMs(100U);
+    EXPECT_FALSE(NVM_busy());
+    DeskCalibration_t persisted;
+    DeskCalibration_init(&persisted);
+    ASSERT_TRUE(DeskCalibration_load(&persisted));
+    EXPECT_EQ(std::memcmp(&persisted, &calibration, sizeof(calibration)), 0);
+
+    pin_states[PIN_LIMIT_UPPER] = HIGH;
+    DeskControl_Init(HAL_getTime());
+    const DeskCalibration_t restored = DeskControl_getCalibration();
+    EXPECT_EQ(std::memcmp(&restored, &calibration, sizeof(calibration)), 0);
+}
+
+// REQ-CAL-004: A button aborts the calibration between control cycles and nothing is stored
+TEST_F(DeskCalibrationIntegrationTest, ButtonAbortsCalibration)
+{
+    DeskControl_Init(HAL_getTime());
+    runMs(10U);
+    DeskControl_startCalibration();
+    runMs(300U);
+    ASSERT_EQ(HAL_getMotorDirection(), MOTOR_DOWN);
+
+    // The press starts the soft stop at once and never a manual move while held
+    pin_states[PIN_BUTTON_UP] = LOW;
+    runMs(25U);  // Past the 20 ms debounce (SWReq-009)
+    EXPECT_EQ(APP_GetState(), APP_STATE_CALIBRATING) << "Control cycle not due yet";
+    EXPECT_LT(pin_states[PIN_MOTOR_PWM], 255) << "Ramping down already";
+    runMs(1000U);
+    EXPECT_EQ(APP_GetState(), APP_STATE_IDLE);
+    EXPECT_EQ(HAL_getMotorDirection(), MOTOR_STOP);
+    pin_states[PIN_BUTTON_UP] = HIGH;
+    runMs(500U);
+    EXPECT_EQ(HAL_getMotorDirection(), MOTOR_STOP);
+
+    runMs(100U);
+    EXPECT_EQ(DeskControl_getCalibration().stroke_ms, 0U);
+    DeskCalibration_t persisted;
+    EXPECT_FALSE(DeskCalibration_load(&persisted));
+}
+
+// ============================================================================
+// INTEGRATION TEST: Task Profiler (execution time and start jitter)
+// Verifies the per-phase timing, jitter and overrun statistics collected
+// around DeskControl_Task() on the virtual clock
+// ============================================================================
+// Builds with DESK_ENABLE_PROFILING=0 stub the profiler out: nothing to verify
+
+#if DESK_ENABLE_PROFILING
+
+class TaskProfilerIntegrationTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        MockClock_reset();
+        pin_states[PIN_BUTTON_UP] = HIGH;
+        pin_states[PIN_BUTTON_DOWN] = HIGH;
+        pin_states[PIN_LIMIT_UPPER] = HIGH;
+        pin_states[PIN_LIMIT_LOWER] = HIGH;
+        HAL_init();
+        HAL_setMotorType(MotorConfig_getMotorType());
+        TaskProfiler_reset();
+    }
+
+    void TearDown() override
+    {
+        MockClock_reset();
+    }
+};
+
+// REQ-PROF-001: Phases tile the task; every cycle lands in each histogram
+TEST_F(TaskProfilerIntegrationTest, PhaseDurationsSumToTaskTime)
+{
+    DeskControl_Init(HAL_getTime());
+    MockClock_setMode(MOCK_CLOCK_FREE_RUN);
+    MockClock_setFreeRunStep(10U);   // Every clock read costs 10 us
+
+    for (int cycle = 0; cycle < 4; ++cycle)
+    {
+        DeskControl_Task(HAL_getTime());
+    }
+
+    const TaskProfile_t *profile = TaskProfiler_get();
+    ASSERT_NE(profile, nullptr);
+    EXPECT_EQ(profile->ticks, 4U);
+    EXPECT_EQ(profile->overruns, 0U);
+
+    uint32_t phase_sum_us = 0U;
+    for (int p = PROFILE_PHASE_INPUT; p <= PROFILE_PHASE_OUTPUT; ++p)
+    {
+        EXPECT_GT(profile->phase[p].last_us, 0U) << "phase " << p;
+        EXPECT_GE(profile->phase[p].wcet_us, profile->phase[p].last_us) << "phase " << p;
+        phase_sum_us += profile->phase[p].last_us;
+    }
+    // Task time = contiguous phases + the closing timestamp read in TaskProfiler_endTask()
+    EXPECT_GE(profile->phase[PROFILE_PHASE_TOTAL].last_us, phase_sum_us);
+    EXPECT_LE(profile->phase[PROFILE_PHASE_TOTAL].last_us, phase_sum_us + 10U);
+
+    for (int p = 0; p < PROFILE_PHASE_COUNT; ++p)
+    {
+        uint32_t samples = 0U;
+        for (uint8_t b = 0U; b < PROFILE_HISTOGRAM_BUCKETS; ++b)
+        {
+            samples += profile->phase[p].histogram[b];
+        }
+        EXPECT_EQ(samples, 4U) << "phase " << p;
+    }
+}
+
+// REQ-PROF-002: Start jitter measured against the 250 ms schedule of DeskControl_Poll()
+TEST_F(TaskProfilerIntegrationTest, PollGranularityShowsAsLateStart)
+{
+    DeskControl_Init(HAL_getTime());
+    // loop() polling every 7 ms: each cycle starts 252 ms after the previous one
+    for (uint32_t elapsed = 0U; elapsed < 2100U; elapsed += 7U)
+    {
+        MockClock_advanceMs(7U);
+        DeskControl_Poll(HAL_getTime());
+    }
+
+    const TaskProfile_t *profile = TaskProfiler_get();
+    ASSERT_NE(profile, nullptr);
+    EXPECT_EQ(profile->ticks, 8U);
+    EXPECT_EQ(profile->max_late_us, 2000U);
+    EXPECT_EQ(profile->max_early_us, 0U);
+    EXPECT_EQ(profile->late_starts, 0U) << "2 ms is within the SWReq-011 tolerance";
+}
+
+// REQ-PROF-003: Overrun and out-of-tolerance start counters, log2 histogram bucket
+TEST_F(TaskProfilerIntegrationTest, OverrunAndLateStartCounters)
+{
+    TaskProfiler_beginTask();
+    MockClock_advanceUs(12000U);   // 12 ms cycle > 10 ms budget
+    TaskProfiler_endTask();
+
+    MockClock_advanceUs(253000U);  // Starts 15 ms late
+    TaskProfiler_beginTask();
+    TaskProfiler_endTask();
+
+    MockClock_advanceUs(200000U);  // Starts 50 ms early
+    TaskProfiler_beginTask();
+    TaskProfiler_endTask();
+
+    const TaskProfile_t *profile = TaskProfiler_get();
+    ASSERT_NE(profile, nullptr);
+    EXPECT_EQ(profile->ticks, 3U);
+    EXPECT_EQ(profile->overruns, 1U);
+    EXPECT_EQ(profile->phase[PROFILE_PHASE_TOTAL].wcet_us, 12000U);
+    EXPECT_EQ(profile->phase[PROFILE_PHASE_TOTAL].histogram[14], 1U) << "12000 us is in [8192, 16384)";
+    EXPECT_EQ(profile->phase[PROFILE_PHASE_TOTAL].histogram[0], 2U);
+    EXPECT_EQ(profile->late_starts, 2U);
+    EXPECT_EQ(profile->max_late_us, 15000U);
+    EXPECT_EQ(profile->max_early_us, 50000U);
+}
+
+#endif // DESK_ENABLE_PROFILING
+
 // ============================================================================
 // INTEGRATION TEST: Full System Integration
 // Testing interaction between application, motor controller, and HAL
@@ -0,0 +1,1070 @@
+#include <gtest/gtest.h>
+#include "DeskSimulator.h"
+#include "DeskAppBatch.h"
+#include "FleetRunner.h"
+#include "desk_control.h"
+#include "desk_app.h"
+#include "hal.h"
+#include "motor_config.h"
+#include "hal_mock/HALMock.h"
+#include "pin_config.h"
+#include "position_estimator.h"
+#include "safety_config.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// ============================================================================
+// TEST CASE SPECIFICATION: Closed-Loop Simulation Tests
+// ============================================================================
+// PURPOSE: Verify system requirements end-to-end by running the production
+//          control chain (HAL -> DeskApp -> MotorController -> HAL) against a
+//          physics model of the desk instead of hand-crafted inputs.
+//
+// SCOPE:
+//   - Stroke time and limit protection (SysReq-004, SysReq-007)
+//   - Motion halt on button release (SysReq-003), soft stop vs. immediate stop
+//   - Fast-path safety stop latency (dual button, limit switch)
+//   - Soft-start ramp continuity at the 1 kHz motor sub-task (SysReq-006)
+//   - Load-dependent travel speed (worm gear, gravity)
+//   - Current slope jam detection latency and false positives (MT_ROBUST)
+//   - Encoder position and velocity against the plant height
+//   - Equivalence of the batch (struct-of-arrays) APP_Task kernel
+//   - Isolation of parallel fleet runs (per-thread HAL mock / module state)
+//
+// METHOD: DeskSimulator steps DeskPlant, the virtual clock and DeskControl_Poll()
+//   every simulated millisecond. No wall-clock time is consumed.
+// ============================================================================
+
+class DeskSimulationTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        params = DeskPlant_defaultParams(MT_BASIC);
+    }
+
+    void TearDown() override
+    {
+        MockClock_reset();
+    }
+
+    DeskPlantParams params;
+};
+
+// ============================================================================
+// TEST CASE: TC-SIM-STROKE-001 - Full Upward Stroke Stops at Upper Limit
+// ============================================================================
+// Requirement: SysReq-004 (full stroke < 30 s), SysReq-007 (limit protection)
+//
+// Test Steps:
+//   1. Start just above the lower limit, hold UP
+//   2. Run until the upper limit switch trips
+//   3. Keep holding UP for 2 s more
+//
+// Expected Results:
+//   - Upper limit reached in < 30 s
+//   - Motor drive removed; desk never reaches the mechanical end stop
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_STROKE_001_FullStrokeUpStopsAtUpperLimit)
+{
+    params.start_height_mm = 10.0;
+    DeskSimulator sim(params);
+    sim.reset();
+
+    sim.setButton(BUTTON_UP, true);
+    const bool reached = sim.runUntil([&sim]() { return sim.plant().upperLimitActive(); }, 40000U);
+    ASSERT_TRUE(reached) << "Upper limit not reached within 40 s";
+    EXPECT_LT(sim.nowMs(), 30000U) << "SysReq-004: full stroke must complete in < 30 s";
+
+    sim.runForMs(2000U);
+    EXPECT_EQ(pin_states[PIN_MOTOR_EN1], LOW) << "Drive must be removed at the upper limit";
+    EXPECT_NEAR(sim.plant().velocityMmS(), 0.0, 1e-9);
+    EXPECT_LT(sim.plant().heightMm(), params.stroke_mm) << "Limit must stop travel before the end stop";
+    EXPECT_EQ(APP_GetState(), APP_STATE_IDLE);
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-HALT-001 - Button Release Halt Latency
+// ============================================================================
+// Requirement: SysReq-003 (motion halt < 500 ms after release)
+//
+// Test Steps:
+//   1. Hold DOWN for 3 s from mid-stroke (release lands right after a control cycle)
+//   2. Release and measure time until drive is removed and the desk is at rest
+//
+// Expected Results:
+//   - Desk moved while the button was held
+//   - Halt within debounce (20 ms) + soft stop (200 ms) + one plant step: the
+//     1 kHz motor sub-task sees the debounced release without waiting for the
+//     next 250 ms cycle, which used to put this case at two control periods
+//
+// Rationale:
+//   - Release lands right after a control cycle, the former worst case
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_HALT_001_ReleaseHaltLatency)
+{
+    DeskSimulator sim(params);
+    sim.reset();
+
+    sim.setButton(BUTTON_DOWN, true);
+    sim.runForMs(3000U);
+    EXPECT_LT(sim.plant().heightMm(), params.start_height_mm - 50.0) << "Desk should travel down";
+
+    sim.setButton(BUTTON_DOWN, false);
+    const uint32_t release_ms = sim.nowMs();
+    const bool stopped = sim.runUntil([&sim]() {
+        return (std::fabs(sim.plant().appliedDuty()) < 1e-9) && (std::fabs(sim.plant().velocityMmS()) < 1e-9);
+    }, 1000U);
+
+    ASSERT_TRUE(stopped);
+    EXPECT_LE(sim.nowMs() - release_ms, 20U + 200U + 2U)
+        << "Halt must follow within debounce + soft stop of release";
+    EXPECT_LT(sim.nowMs() - release_ms, 500U) << "SysReq-003";
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-STOP-001 - Soft Stop Latency and Distance Statistics
+// ============================================================================
+// Requirement: SysReq-003 (halt < 500 ms), SysReq-006 (smooth motion)
+//
+// Test Steps:
+//   1. For both directions and 36 release instants spread over one 250 ms
+//      control period: hold the button 2 s (full speed), then release
+//   2. Record release -> rest latency, run-out distance and the largest
+//      1 ms velocity step while stopping (a proxy for mechanical shock)
+//
+// Expected Results:
+//   - Worst-case latency < 500 ms, independent of the control cycle phase
+//   - Run-out bounded (< 10 mm)
+//   - Largest velocity step < 25 % of the travel speed at release: the
+//     drive is ramped down, not cut (an immediate stop steps 100 %)
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_STOP_001_SoftStopLatencyAndDistance)
+{
+    uint32_t max_latency_ms = 0U;
+    uint32_t min_latency_ms = UINT32_MAX;
+    uint64_t latency_sum_ms = 0U;
+    double max_distance_mm = 0.0;
+    double max_step_ratio = 0.0;
+    uint32_t samples = 0U;
+
+    for (ButtonID_t button : {BUTTON_UP, BUTTON_DOWN})
+    {
+        for (uint32_t phase_ms = 0U; phase_ms < DESK_CONTROL_APP_PERIOD_MS; phase_ms += 7U)
+        {
+            DeskSimulator sim(params);
+            sim.reset();
+            sim.setButton(button, true);
+            sim.runForMs(2000U + phase_ms);
+
+            const double release_height_mm = sim.plant().heightMm();
+            const double release_speed = std::fabs(sim.plant().velocityMmS());
+            ASSERT_GT(release_speed, 10.0);
+            sim.setButton(button, false);
+            const uint32_t release_ms = sim.nowMs();
+
+            double previous_v = sim.plant().velocityMmS();
+            double max_step = 0.0;
+            const bool stopped = sim.runUntil([&sim, &previous_v, &max_step]() {
+                const double v = sim.plant().velocityMmS();
+                max_step = std::max(max_step, std::fabs(v - previous_v));
+                previous_v = v;
+                return (std::fabs(sim.plant().appliedDuty()) < 1e-9) && (std::fabs(v) < 1e-9);
+            }, 1000U);
+            ASSERT_TRUE(stopped) << "phase " << phase_ms;
+
+            const uint32_t latency_ms = sim.nowMs() - release_ms;
+            max_latency_ms = std::max(max_latency_ms, latency_ms);
+            min_latency_ms = std::min(min_latency_ms, latency_ms);
+            latency_sum_ms += latency_ms;
+            max_distance_mm = std::max(max_distance_mm, std::fabs(sim.plant().heightMm() - release_height_mm));
+            max_step_ratio = std::max(max_step_ratio, max_step / release_speed);
+            ++samples;
+        }
+    }
+
+    RecordProperty("stop_latency_max_ms", static_cast<int>(max_latency_ms));
+    RecordProperty("stop_latency_mean_ms", static_cast<int>(latency_sum_ms / samples));
+    RecordProperty("stop_distance_max_um", static_cast<int>(std::lround(max_distance_mm * 1000.0)));
+    EXPECT_LT(max_latency_ms, 500U) << "SysReq-003";
+    EXPECT_LE(max_latency_ms - min_latency_ms, 5U) << "Latency must not depend on the control cycle phase";
+    EXPECT_LT(max_distance_mm, 10.0);
+    EXPECT_LT(max_step_ratio, 0.25) << "Stop must ramp the drive down";
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-STOP-002 - Faults and Limits Stop Without Ramp-Down
+// ============================================================================
+// Requirement: SysReq-003, SysReq-007 (limit protection), SysReq-010
+//
+// Test Steps:
+//   1. Move DOWN at full speed, then press UP as well (dual-button fault)
+//   2. Move UP towards the upper limit and release 1 mm before it, so the
+//      limit switch trips while the soft stop is still driving
+//
+// Expected Results:
+//   - Step 1: drive goes from full duty to 0 in one step (no soft stop)
+//   - Step 2: drive removed on the first step the limit switch is active
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_STOP_002_FaultAndLimitStopImmediately)
+{
+    {
+        DeskSimulator sim(params);
+        sim.reset();
+        sim.setButton(BUTTON_DOWN, true);
+        sim.runForMs(2000U);
+        sim.setButton(BUTTON_UP, true);
+
+        double previous_duty = sim.plant().appliedDuty();
+        const bool stopped = sim.runUntil([&sim, &previous_duty]() {
+            const double duty = sim.plant().appliedDuty();
+            const bool off = std::fabs(duty) < 1e-9;
+            if (!off)
+            {
+                previous_duty = duty;
+            }
+            return off;
+        }, 1000U);
+        ASSERT_TRUE(stopped);
+        EXPECT_NEAR(previous_duty, -1.0, 1e-9) << "Fault must cut full drive without ramp-down";
+    }
+
+    {
+        params.start_height_mm = params.stroke_mm - params.limit_switch_margin_mm - 40.0;
+        DeskSimulator sim(params);
+        sim.reset();
+        sim.setButton(BUTTON_UP, true);
+        const double release_at_mm = params.stroke_mm - params.limit_switch_margin_mm - 1.0;
+        ASSERT_TRUE(sim.runUntil([&sim, release_at_mm]() { return sim.plant().heightMm() >= release_at_mm; }, 5000U));
+        sim.setButton(BUTTON_UP, false);
+
+        ASSERT_TRUE(sim.runUntil([&sim]() { return sim.plant().upperLimitActive(); }, 1000U))
+            << "Soft stop run-out should reach the limit switch in this setup";
+        EXPECT_GT(sim.plant().appliedDuty(), 0.0) << "Soft stop still driving when the limit trips";
+        sim.runForMs(1U);
+        EXPECT_NEAR(sim.plant().appliedDuty(), 0.0, 1e-9) << "Limit must cut the soft stop immediately";
+        EXPECT_LT(sim.plant().heightMm(), params.stroke_mm);
+    }
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-SAFETY-001 - Fast-Path Safety Stop Latency
+// ============================================================================
+// Requirement: SWReq-004 (conflicting buttons), SysReq-007 (limit protection)
+//
+// Test Steps:
+//   1. Move DOWN at full speed; press UP as well at 25 phases spread over one
+//      250 ms control cycle; measure press -> drive removed
+//   2. Keep both pressed until the control cycle latches the fault
+//   3. Move UP into the upper limit at the same phases; measure trip -> drive removed
+//
+// Expected Results:
+//   - Driver enable pins released within one 1 ms loop pass at every phase
+//     (previously up to debounce + one control period for the dual-button case)
+//   - No drive pulse between the safety stop and the latched APP fault
+//   - DeskControl_getLastSafetyStop() reports the rule that acted
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_SAFETY_001_FastPathStopLatency)
+{
+    // Measured at the L298N enable pins: the plant samples them one step later
+    const auto drive_off = []() {
+        return (pin_states[PIN_MOTOR_EN1] == LOW) && (pin_states[PIN_MOTOR_EN2] == LOW);
+    };
+    uint32_t max_button_latency_ms = 0U;
+    uint32_t max_limit_latency_ms = 0U;
+
+    for (uint32_t phase_ms = 0U; phase_ms < DESK_CONTROL_APP_PERIOD_MS; phase_ms += 10U)
+    {
+        {
+            DeskSimulator sim(params);
+            sim.reset();
+            sim.setButton(BUTTON_DOWN, true);
+            sim.runForMs(1000U + phase_ms);
+            ASSERT_LT(sim.plant().appliedDuty(), 0.0);
+
+            sim.setButton(BUTTON_UP, true);
+            const uint32_t press_ms = sim.nowMs();
+            ASSERT_TRUE(sim.runUntil(drive_off, 1000U));
+            max_button_latency_ms = std::max(max_button_latency_ms, sim.nowMs() - press_ms);
+            EXPECT_EQ(DeskControl_getLastSafetyStop(), APP_SAFETY_DUAL_BUTTON);
+
+            bool pulse = false;
+            ASSERT_TRUE(sim.runUntil([&pulse, &drive_off]() {
+                pulse = pulse || !drive_off();
+                return APP_GetState() == APP_STATE_FAULT;
+            }, 1000U));
+            EXPECT_FALSE(pulse) << "phase " << phase_ms << ": drive resumed before the fault latched";
+        }
+
+        {
+            DeskPlantParams limit_params = params;
+            limit_params.start_height_mm = params.stroke_mm - params.limit_switch_margin_mm - 60.0;
+            DeskSimulator sim(limit_params);
+            sim.reset();
+            sim.runForMs(phase_ms);
+            sim.setButton(BUTTON_UP, true);
+            ASSERT_TRUE(sim.runUntil([&sim]() { return sim.plant().upperLimitActive(); }, 5000U));
+            const uint32_t trip_ms = sim.nowMs();
+            ASSERT_TRUE(sim.runUntil(drive_off, 1000U));
+            max_limit_latency_ms = std::max(max_limit_latency_ms, sim.nowMs() - trip_ms);
+            EXPECT_EQ(DeskControl_getLastSafetyStop(), APP_SAFETY_LIMIT);
+        }
+    }
+
+    RecordProperty("dual_button_stop_latency_max_ms", static_cast<int>(max_button_latency_ms));
+    RecordProperty("limit_stop_latency_max_ms", static_cast<int>(max_limit_latency_ms));
+    EXPECT_LE(max_button_latency_ms, 1U) << "Dual-button stop must not wait for debounce or the control cycle";
+    EXPECT_LE(max_limit_latency_ms, 1U) << "Limit stop must act in the loop pass that sees the edge";
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-RAMP-001 - Soft-Start Ramp is Continuous
+// ============================================================================
+// Requirement: SysReq-006 (smooth motion), RAMP_TIME_MS = 500 ms
+//
+// Test Steps:
+//   1. Hold UP from mid-stroke until drive first appears on the PWM pin
+//   2. Sample the applied duty every simulated millisecond for 510 ms
+//
+// Expected Results:
+//   - Duty never decreases and never jumps by more than one PWM count per ms
+//   - More than 200 distinct PWM levels during the ramp (250 ms steps gave 3)
+//   - Full duty reached within RAMP_TIME_MS of the first drive
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_RAMP_001_SoftStartRampIsContinuous)
+{
+    DeskSimulator sim(params);
+    sim.reset();
+
+    sim.setButton(BUTTON_UP, true);
+    ASSERT_TRUE(sim.runUntil([&sim]() { return sim.plant().appliedDuty() > 0.0; }, 1000U));
+
+    const double one_count = 1.0 / 255.0;
+    double previous = sim.plant().appliedDuty();
+    int levels = 1;
+    uint32_t full_after_ms = UINT32_MAX;
+    for (uint32_t ms = 1U; ms <= 510U; ++ms)
+    {
+        sim.runForMs(1U);
+        const double duty = sim.plant().appliedDuty();
+        EXPECT_GE(duty, previous - 1e-12) << "at " << ms << " ms";
+        EXPECT_LE(duty - previous, one_count + 1e-12) << "at " << ms << " ms";
+        if (duty > previous + 1e-12)
+        {
+            ++levels;
+        }
+        if ((duty >= 1.0 - 1e-12) && (full_after_ms == UINT32_MAX))
+        {
+            full_after_ms = ms;
+        }
+        previous = duty;
+    }
+
+    EXPECT_GT(levels, 200);
+    EXPECT_LE(full_after_ms, 500U);
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-LOAD-001 - Load and Gravity Shape Travel Speed
+// ============================================================================
+// Requirement: Plant fidelity (worm gear + gravity) for closed-loop studies
+//
+// Expected Results:
+//   - Heavier payload travels up slower and draws more current
+//   - Downward travel (gravity assisted) is faster than upward travel
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_LOAD_001_LoadAndGravityShapeSpeed)
+{
+    params.load_kg = 0.0;
+    DeskSimulator light(params);
+    light.reset();
+    light.setButton(BUTTON_UP, true);
+    light.runForMs(5000U);
+    const double light_up_speed = light.plant().velocityMmS();
+    const double light_current = light.plant().senseCurrentMa();
+
+    params.load_kg = 20.0;
+    DeskSimulator heavy(params);
+    heavy.reset();
+    heavy.setButton(BUTTON_UP, true);
+    heavy.runForMs(5000U);
+    const double heavy_up_speed = heavy.plant().velocityMmS();
+    EXPECT_LT(heavy_up_speed, light_up_speed);
+    EXPECT_GT(heavy.plant().senseCurrentMa(), light_current);
+
+    heavy.setButton(BUTTON_UP, false);
+    heavy.runForMs(1000U);
+    heavy.setButton(BUTTON_DOWN, true);
+    heavy.runForMs(5000U);
+    EXPECT_GT(-heavy.plant().velocityMmS(), heavy_up_speed) << "Gravity assists downward travel";
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-OBST-001 - Hard Obstruction Stalls the Plant
+// ============================================================================
+// Requirement: Plant fidelity for obstruction studies (SysReq-013)
+//
+// Expected Results:
+//   - Desk stops at the obstruction height
+//   - Sense current rises to the stall value (V / R scaled by sense gain)
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_OBST_001_ObstructionStallsMotor)
+{
+    params.obstruction_up_mm = 350.0;
+    DeskSimulator sim(params);
+    sim.reset();
+
+    sim.setButton(BUTTON_UP, true);
+    sim.runForMs(5000U);
+
+    EXPECT_NEAR(sim.plant().heightMm(), 350.0, 1e-6);
+    EXPECT_TRUE(sim.plant().stalled());
+    const double stall_ma = params.supply_v / params.resistance_ohm * params.sense_gain * 1000.0;
+    EXPECT_NEAR(sim.plant().senseCurrentMa(), stall_ma, 1.0);
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-JAM-001 - Current Slope Detector Latency and False Positives
+// ============================================================================
+// Requirement: SysReq-013 (Jam/obstruction detection - FSR-007)
+//
+// Test Steps:
+//   1. MT_ROBUST (IBT_2 current sense): move UP into a hard obstruction, for
+//      several loads and obstruction heights; measure stall -> drive removed
+//   2. Move UP a full stroke without obstruction for several loads, with and
+//      without 10 kg added mid-stroke; count slope jam detections
+//
+// Expected Results:
+//   - Every jam stopped by the slope detector well within MOTOR_SENSE_FAULT_TIME_MS
+//   - No slope jam on any unobstructed stroke (false-positive rate 0)
+//   - Strokes whose cruise current stays below the fixed obstruction threshold
+//     reach the upper limit
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_JAM_001_SlopeDetectorLatencyAndFalsePositives)
+{
+    if (MotorConfig_effectiveType(MT_ROBUST) != MT_ROBUST)
+    {
+        return;  // Build without MT_ROBUST: no current sense in the loop
+    }
+    params = DeskPlant_defaultParams(MT_ROBUST);
+
+    const double loads_kg[] = {0.0, 10.0, 20.0};
+    const double jam_offsets_mm[] = {40.0, 120.0, 250.0};
+    uint32_t max_latency_ms = 0U;
+    int jams = 0;
+    for (const double load_kg : loads_kg)
+    {
+        for (const double offset_mm : jam_offsets_mm)
+        {
+            params.load_kg = load_kg;
+            params.obstruction_up_mm = params.start_height_mm + offset_mm;
+            DeskSimulator sim(params);
+            sim.reset();
+            sim.setButton(BUTTON_UP, true);
+            ASSERT_TRUE(sim.runUntil([&sim]() { return sim.plant().stalled(); }, 20000U))
+                << "load " << load_kg << " kg, jam at +" << offset_mm << " mm";
+
+            const uint32_t stall_ms = sim.nowMs();
+            ASSERT_TRUE(sim.runUntil([]() { return pin_states[PIN_MOTOR_LPWM] == 0; }, 1000U))
+                << "load " << load_kg << " kg, jam at +" << offset_mm << " mm: drive not removed";
+            const uint32_t latency_ms = sim.nowMs() - stall_ms;
+            max_latency_ms = std::max(max_latency_ms, latency_ms);
+            EXPECT_EQ(pin_states[PIN_LED_ERROR], HIGH) << "Jam latches the fault";
+            jams++;
+        }
+    }
+
+    const double stroke_loads_kg[] = {0.0, 10.0, 20.0};
+    int false_positives = 0;
+    int strokes = 0;
+    for (const double load_kg : stroke_loads_kg)
+    {
+        for (int add_load = 0; add_load < 2; ++add_load)
+        {
+            params.load_kg = load_kg;
+            params.obstruction_up_mm = -1.0;
+            DeskSimulator sim(params);
+            sim.reset();
+            sim.setButton(BUTTON_UP, true);
+            bool faulted = false;
+            bool above_fixed_threshold = false;  // The application's own obstruction stop may end the stroke
+            for (uint32_t ms = 0U; (ms < 40000U) && !sim.plant().upperLimitActive(); ++ms)
+            {
+                if ((add_load != 0) && (ms == 4000U))
+                {
+                    sim.plant().params().load_kg += 10.0;  // Someone leans on the desk mid-stroke
+                }
+                sim.runForMs(1U);
+                faulted = faulted || HAL_motorCurrentSlopeJam();
+                above_fixed_threshold = above_fixed_threshold ||
+                    ((ms >= 1000U) && (sim.plant().senseCurrentMa() >= MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA));
+                if (pin_states[PIN_LED_ERROR] == HIGH)
+                {
+                    break;  // Stroke ended by a fault
+                }
+            }
+            if (!above_fixed_threshold)
+            {
+                EXPECT_TRUE(sim.plant().upperLimitActive()) << "load " << load_kg << " kg: stroke not completed";
+            }
+            false_positives += faulted ? 1 : 0;
+            strokes++;
+        }
+    }
+
+    RecordProperty("jam_latency_max_ms", static_cast<int>(max_latency_ms));
+    RecordProperty("false_positive_strokes", false_positives);
+    EXPECT_EQ(jams, 9);
+    EXPECT_LT(max_latency_ms, 20U) << "Slope detector must beat the " << MOTOR_SENSE_FAULT_TIME_MS << " ms threshold timer";
+    EXPECT_EQ(false_positives, 0) << "of " << strokes << " unobstructed strokes";
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-ENC-001 - Encoder Position Tracks the Desk Height
+// ============================================================================
+// Requirement: Position tracking foundation (presets, speed control)
+//
+// Test Steps:
+//   1. Move UP for 3 s, then DOWN for 3 s, sampling the HAL encoder state
+//
+// Expected Results:
+//   - Position equals the plant's count change since HAL_init() (exact)
+//   - Velocity follows the plant speed within one window of lag
+//   - No decode errors, no direction error
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_ENC_001_EncoderTracksHeight)
+{
+    DeskSimulator sim(params);
+    sim.reset();
+    const int32_t start_count = sim.plant().encoderCount();
+    EncoderState_t encoder;
+
+    sim.setButton(BUTTON_UP, true);
+    sim.runForMs(3000U);
+    HAL_readEncoder(&encoder);
+    EXPECT_EQ(encoder.position_counts, sim.plant().encoderCount() - start_count);
+    const double up_cps = sim.plant().velocityMmS() * params.encoder_counts_per_mm;
+    EXPECT_GT(up_cps, 0.0);
+    EXPECT_NEAR(encoder.velocity_cps, up_cps, up_cps * 0.15);
+
+    sim.setButton(BUTTON_UP, false);
+    sim.runForMs(500U);
+    sim.setButton(BUTTON_DOWN, true);
+    sim.runForMs(3000U);
+    HAL_readEncoder(&encoder);
+    EXPECT_EQ(encoder.position_counts, sim.plant().encoderCount() - start_count);
+    const double down_cps = sim.plant().velocityMmS() * params.encoder_counts_per_mm;
+    EXPECT_LT(down_cps, 0.0);
+    EXPECT_NEAR(encoder.velocity_cps, down_cps, -down_cps * 0.15);
+    EXPECT_EQ(encoder.decode_errors, 0U);
+    EXPECT_FALSE(encoder.direction_error);
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-POS-001 - Sensorless Height Estimate Tracks the Desk
+// ============================================================================
+// Requirement: Approximate positioning without an encoder
+//
+// Test Steps:
+//   1. Start mid-stroke; drive DOWN onto the lower limit switch
+//   2. Move UP for 6 s with a stop half-way, then DOWN for 2 s
+//   3. Drive UP onto the upper limit switch
+//
+// Expected Results:
+//   - Unreferenced until the first limit switch, then 0 at the lower switch
+//   - Estimate within its error bound of the plant height above the lower switch
+//   - The upper switch finds a drift below the bound; the estimate re-references
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_POS_001_EstimateTracksHeight)
+{
+    DeskSimulator sim(params);
+    sim.reset();
+    EXPECT_FALSE(DeskControl_getPositionEstimate().referenced);
+
+    sim.setButton(BUTTON_DOWN, true);
+    ASSERT_TRUE(sim.runUntil([&] { return DeskControl_getPositionEstimate().referenced; }, 10000U));
+    sim.setButton(BUTTON_DOWN, false);
+    sim.runForMs(500U);
+    EXPECT_EQ(DeskControl_getPositionEstimate().height_um, 0);
+
+    const auto expect_tracks = [&](const char *step) {
+        const PositionEstimate_t estimate = DeskControl_getPositionEstimate();
+        const double actual_um = (sim.plant().heightMm() - params.limit_switch_margin_mm) * 1000.0;
+        EXPECT_NEAR(static_cast<double>(estimate.height_um), actual_um, static_cast<double>(estimate.error_um)) << step;
+    };
+
+    sim.setButton(BUTTON_UP, true);
+    sim.runForMs(3000U);
+    sim.setButton(BUTTON_UP, false);
+    sim.runForMs(500U);
+    expect_tracks("up 3 s");
+    sim.setButton(BUTTON_UP, true);
+    sim.runForMs(3000U);
+    sim.setButton(BUTTON_UP, false);
+    sim.runForMs(500U);
+    expect_tracks("up 6 s");
+    sim.setButton(BUTTON_DOWN, true);
+    sim.runForMs(2000U);
+    sim.setButton(BUTTON_DOWN, false);
+    sim.runForMs(500U);
+    expect_tracks("down 2 s");
+
+    // Estimate one step before the switch trips: its drift against the stroke is within the bound
+    PositionEstimate_t previous = DeskControl_getPositionEstimate();
+    PositionEstimate_t before_switch = previous;
+    sim.setButton(BUTTON_UP, true);
+    ASSERT_TRUE(sim.runUntil([&] {
+        before_switch = previous;
+        previous = DeskControl_getPositionEstimate();
+        return sim.plant().upperLimitActive();
+    }, 30000U));
+    sim.setButton(BUTTON_UP, false);
+    sim.runForMs(500U);
+    const int32_t drift_um = static_cast<int32_t>(POSITION_ESTIMATOR_STROKE_UM) - before_switch.height_um;
+    EXPECT_LE(std::abs(drift_um), static_cast<int32_t>(before_switch.error_um));
+    const PositionEstimate_t at_top = DeskControl_getPositionEstimate();
+    EXPECT_EQ(at_top.height_um, static_cast<int32_t>(POSITION_ESTIMATOR_STROKE_UM));
+    EXPECT_EQ(at_top.error_um, 0U);
+    RecordProperty("stroke_drift_um", drift_um);
+    RecordProperty("stroke_error_bound_um", static_cast<int>(before_switch.error_um));
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-PRESET-001 - Preset Recall Stops On Target
+// ============================================================================
+// Requirement: Memory presets; SysReq-006 (acceleration < 0.5 g)
+//
+// Test Steps:
+//   1. Reference at the lower limit switch; move UP 8 s and store preset 0,
+//      UP another 4 s and store preset 1
+//   2. Recall preset 0 (down), then preset 1 (up), sampling the plant each ms
+//   3. Recall preset 0 and press UP after 1 s, holding it for 1 s
+//
+// Expected Results:
+//   - Each recall ends within APP_TARGET_TOLERANCE_UM plus the estimator
+//     error bound of the stored height, without reversing
+//   - Peak acceleration of the desk stays below 0.5 g while driven; the
+//     self-locking gear (the plant stops the desk within one step when drive
+//     is removed) only catches a desk slower than 10 mm/s
+//   - The press in step 3 stops the desk and does not drive it up
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_PRESET_001_RecallStopsOnTarget)
+{
+    DeskSimulator sim(params);
+    sim.reset();
+
+    sim.setButton(BUTTON_DOWN, true);
+    ASSERT_TRUE(sim.runUntil([&] { return DeskControl_getPositionEstimate().referenced; }, 20000U));
+    sim.setButton(BUTTON_DOWN, false);
+    sim.runForMs(500U);
+
+    double stored_mm[2] = {0.0, 0.0};
+    for (uint8_t slot = 0U; slot < 2U; ++slot)
+    {
+        sim.setButton(BUTTON_UP, true);
+        sim.runForMs((slot == 0U) ? 8000U : 4000U);
+        sim.setButton(BUTTON_UP, false);
+        sim.runForMs(500U);
+        ASSERT_TRUE(DeskControl_storePreset(slot));
+        stored_mm[slot] = sim.plant().heightMm();
+    }
+
+    double peak_accel_mm_s2 = 0.0;
+    double drive_off_mm_s = 0.0;
+    const uint8_t order[2] = {0U, 1U};
+    for (uint8_t slot : order)
+    {
+        const double start_mm = sim.plant().heightMm();
+        const double sign = (stored_mm[slot] > start_mm) ? 1.0 : -1.0;
+        ASSERT_TRUE(DeskControl_recallPreset(slot));
+        double previous_v = sim.plant().velocityMmS();
+        bool reversed = false;
+        bool started = false;
+        ASSERT_TRUE(sim.runUntil([&] {
+            const double v = sim.plant().velocityMmS();
+            if (sim.plant().appliedDuty() != 0.0)
+            {
+                peak_accel_mm_s2 = std::max(peak_accel_mm_s2, std::abs(v - previous_v) * 1000.0);
+            }
+            else if (previous_v != 0.0)
+            {
+                drive_off_mm_s = std::max(drive_off_mm_s, std::abs(previous_v));
+            }
+            previous_v = v;
+            reversed = reversed || ((v * sign) < -0.5);
+            started = started || (APP_GetState() == APP_STATE_MOVING_TO_TARGET);
+            return started && (APP_GetState() == APP_STATE_IDLE) && (v == 0.0);
+        }, 30000U)) << "Preset " << static_cast<int>(slot);
+
+        const PositionEstimate_t estimate = DeskControl_getPositionEstimate();
+        const double bound_mm = (APP_TARGET_TOLERANCE_UM + 500 + static_cast<double>(estimate.error_um)) / 1000.0;
+        EXPECT_NEAR(sim.plant().heightMm(), stored_mm[slot], bound_mm) << "Preset " << static_cast<int>(slot);
+        EXPECT_FALSE(reversed) << "Preset " << static_cast<int>(slot);
+        RecordProperty(slot == 0U ? "preset0_error_mm_x1000" : "preset1_error_mm_x1000",
+                       static_cast<int>((sim.plant().heightMm() - stored_mm[slot]) * 1000.0));
+    }
+    EXPECT_LT(peak_accel_mm_s2, 4900.0) << "SysReq-006: < 0.5 g";
+    EXPECT_LT(drive_off_mm_s, 10.0);
+    RecordProperty("peak_accel_mm_s2", static_cast<int>(peak_accel_mm_s2));
+    RecordProperty("drive_off_mm_s_x1000", static_cast<int>(drive_off_mm_s * 1000.0));
+
+    // Any button aborts; holding it does not start a manual move
+    ASSERT_TRUE(DeskControl_recallPreset(0U));
+    sim.runForMs(1000U);
+    ASSERT_EQ(APP_GetState(), APP_STATE_MOVING_TO_TARGET);
+    sim.setButton(BUTTON_UP, true);
+    sim.runForMs(500U);
+    EXPECT_EQ(APP_GetState(), APP_STATE_IDLE);
+    EXPECT_EQ(sim.plant().velocityMmS(), 0.0);
+    const double aborted_mm = sim.plant().heightMm();
+    sim.runForMs(500U);
+    EXPECT_EQ(sim.plant().heightMm(), aborted_mm);
+    sim.setButton(BUTTON_UP, false);
+    sim.runForMs(500U);
+    EXPECT_GT(aborted_mm, stored_mm[0] + 5.0) << "Stopped short of the preset";
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-SPEED-001 - Closed-Loop Speed Holds Under Load
+// ============================================================================
+// Requirement: Predictable stroke time; equal speed up and down
+//
+// Test Steps:
+//   1. For 0 kg and 20 kg on the desk: move UP 4 s and DOWN 4 s open loop,
+//      then again with SPEED_FEEDBACK_ENCODER at 20 mm/s
+//   2. Repeat with SPEED_FEEDBACK_ESTIMATE at the load the speed model is set for
+//   3. Measure the travel over the last 2 s of each move (after the ramp and
+//      the controller settle), sampling the plant velocity each ms
+//
+// Expected Results:
+//   - Open loop: down more than 10 mm/s faster than up; up slows with load
+//   - Encoder feedback: every move within 5 % of 20 mm/s at any load, no ms
+//     faster than 25 mm/s
+//   - Estimate feedback: within 10 % of 20 mm/s both ways at the model load
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_SPEED_001_ClosedLoopHoldsSpeedUnderLoad)
+{
+    struct Speeds
+    {
+        double up_mm_s;
+        double down_mm_s;
+        double peak_mm_s;
+    };
+    const auto measure = [&](SpeedFeedback_t feedback) {
+        DeskSimulator sim(params);
+        sim.reset();
+        DeskControl_setSpeedControl(feedback, 20U);
+
+        Speeds speeds = {0.0, 0.0, 0.0};
+        for (int move = 0; move < 2; ++move)
+        {
+            const ButtonID_t button = (move == 0) ? BUTTON_UP : BUTTON_DOWN;
+            sim.setButton(button, true);
+            sim.runForMs(2000U);
+            const double start_mm = sim.plant().heightMm();
+            for (uint32_t ms = 0U; ms < 2000U; ++ms)
+            {
+                sim.runForMs(1U);
+                speeds.peak_mm_s = std::max(speeds.peak_mm_s, std::abs(sim.plant().velocityMmS()));
+            }
+            double &speed_mm_s = (move == 0) ? speeds.up_mm_s : speeds.down_mm_s;
+            speed_mm_s = std::abs(sim.plant().heightMm() - start_mm) / 2.0;
+            sim.setButton(button, false);
+            sim.runForMs(1000U);
+        }
+        return speeds;
+    };
+
+    params.load_kg = 0.0;
+    const Speeds open_light = measure(SPEED_FEEDBACK_OFF);
+    const Speeds closed_light = measure(SPEED_FEEDBACK_ENCODER);
+    params.load_kg = 20.0;
+    const Speeds open_heavy = measure(SPEED_FEEDBACK_OFF);
+    const Speeds closed_heavy = measure(SPEED_FEEDBACK_ENCODER);
+
+    EXPECT_GT(open_light.down_mm_s - open_light.up_mm_s, 10.0);
+    EXPECT_GT(open_heavy.down_mm_s - open_heavy.up_mm_s, 10.0);
+    EXPECT_GT(open_light.up_mm_s - open_heavy.up_mm_s, 10.0) << "Open loop, load slows the lift";
+    for (const Speeds &closed : {closed_light, closed_heavy})
+    {
+        EXPECT_NEAR(closed.up_mm_s, 20.0, 1.0);
+        EXPECT_NEAR(closed.down_mm_s, 20.0, 1.0);
+        EXPECT_LT(closed.peak_mm_s, 25.0);
+    }
+
+    params.load_kg = DeskPlant_defaultParams(params.motor_type).load_kg;
+    const Speeds estimated = measure(SPEED_FEEDBACK_ESTIMATE);
+    EXPECT_NEAR(estimated.up_mm_s, 20.0, 2.0);
+    EXPECT_NEAR(estimated.down_mm_s, 20.0, 2.0);
+
+    RecordProperty("open_up_0kg_mm_s_x100", static_cast<int>(open_light.up_mm_s * 100.0));
+    RecordProperty("open_up_20kg_mm_s_x100", static_cast<int>(open_heavy.up_mm_s * 100.0));
+    RecordProperty("closed_up_20kg_mm_s_x100", static_cast<int>(closed_heavy.up_mm_s * 100.0));
+    RecordProperty("closed_down_20kg_mm_s_x100", static_cast<int>(closed_heavy.down_mm_s * 100.0));
+    RecordProperty("estimate_up_mm_s_x100", static_cast<int>(estimated.up_mm_s * 100.0));
+    RecordProperty("estimate_down_mm_s_x100", static_cast<int>(estimated.down_mm_s * 100.0));
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-CAL-001 - Stroke Calibration Measures The Desk
+// ============================================================================
+// Requirement: Stroke calibration; SysReq-007 (limit protection)
+//
+// Test Steps:
+//   1. 20 kg on the desk (the speed model assumes 10 kg): reference at the
+//      lower limit switch, move UP 8 s and note the estimate error
+//   2. Calibrate from there; sample the plant each ms
+//   3. Back to the lower limit switch, move UP 8 s again
+//
+// Expected Results:
+//   - Step 2 homes down, strokes up and ends at the upper limit switch in IDLE
+//     without reversing on the way up
+//   - Travel time within 50 ms of the plant's, from drive start at the lower
+//     switch to the upper switch; encoder
+//     counts within 1 % of the stroke, start lag between half the soft-start
+//     ramp and the whole ramp plus 100 ms
+//   - Step 3 estimates the height at least 4 times closer than step 1
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_CAL_001_CalibrationMeasuresTheDesk)
+{
+    params.load_kg = 20.0;
+    DeskSimulator sim(params);
+    sim.reset();
+
+    const auto up_error_mm = [&]() {
+        sim.setButton(BUTTON_DOWN, true);
+        EXPECT_TRUE(sim.runUntil([&] { return sim.plant().lowerLimitActive(); }, 30000U));
+        sim.setButton(BUTTON_DOWN, false);
+        sim.runForMs(500U);
+        sim.setButton(BUTTON_UP, true);
+        sim.runForMs(8000U);
+        sim.setButton(BUTTON_UP, false);
+        sim.runForMs(500U);
+        const double estimate_mm = DeskControl_getPositionEstimate().height_um / 1000.0;
+        // The estimate counts from the lower limit switch, the plant from the end stop
+        return std::abs(estimate_mm - (sim.plant().heightMm() - params.limit_switch_margin_mm));
+    };
+    const double uncalibrated_mm = up_error_mm();
+
+    DeskControl_startCalibration();
+    bool started = false;
+    bool reversed = false;
+    uint32_t drive_up_ms = 0U;
+    uint32_t reached_upper_ms = 0U;
+    ASSERT_TRUE(sim.runUntil([&] {
+        if ((drive_up_ms == 0U) && sim.plant().lowerLimitActive() && (sim.plant().appliedDuty() > 0.0))
+        {
+            drive_up_ms = sim.nowMs();
+        }
+        if ((reached_upper_ms == 0U) && sim.plant().upperLimitActive())
+        {
+            reached_upper_ms = sim.nowMs();
+        }
+        reversed = reversed || ((drive_up_ms != 0U) && (sim.plant().velocityMmS() < -0.5));
+        started = started || (APP_GetState() == APP_STATE_CALIBRATING);
+        return started && (APP_GetState() == APP_STATE_IDLE);
+    }, 90000U));
+    sim.runForMs(10U);
+    EXPECT_TRUE(sim.plant().upperLimitActive());
+    EXPECT_FALSE(reversed);
+
+    const DeskCalibration_t calibration = DeskControl_getCalibration();
+    ASSERT_NE(drive_up_ms, 0U);
+    const int32_t plant_stroke_ms = static_cast<int32_t>(reached_upper_ms - drive_up_ms);
+    const double stroke_counts = (params.stroke_mm - (2.0 * params.limit_switch_margin_mm)) * params.encoder_counts_per_mm;
+    EXPECT_NEAR(static_cast<int32_t>(calibration.stroke_ms), plant_stroke_ms, 50);
+    EXPECT_NEAR(calibration.encoder_counts, stroke_counts, stroke_counts / 100.0);
+    const uint16_t soft_start_ms = 500U;  // RAMP_TIME_MS (motor_controller.cpp)
+    EXPECT_GE(calibration.ramp_ms, soft_start_ms / 2U);
+    EXPECT_LE(calibration.ramp_ms, soft_start_ms + 100U);
+    EXPECT_LT(calibration.scale[0], POSITION_ESTIMATOR_SCALE_UNITY) << "Heavier than the model: slower up";
+    RecordProperty("stroke_ms", calibration.stroke_ms);
+    RecordProperty("plant_stroke_ms", plant_stroke_ms);
+    RecordProperty("ramp_ms", calibration.ramp_ms);
+    RecordProperty("scale_up", calibration.scale[0]);
+
+    const double calibrated_mm = up_error_mm();
+    EXPECT_LT(calibrated_mm * 4.0, uncalibrated_mm);
+    RecordProperty("uncalibrated_error_um", static_cast<int>(uncalibrated_mm * 1000.0));
+    RecordProperty("calibrated_error_um", static_cast<int>(calibrated_mm * 1000.0));
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-BATCH-001 - Batch Kernel Matches Scalar APP_Task
+// ============================================================================
+// Requirement: Fleet-scale runs must reproduce the production state machine
+//
+// Test Steps:
+//   1. Step 512 desks for 4000 ticks with random inputs, both through
+//      DeskAppBatch_step() and through one AppContext_t per desk
+//   2. Tick spacing is random (0..300 ms) and starts just before the 32-bit
+//      millisecond wrap; currents straddle both sense thresholds, and half of
+//      the inputs carry 1 kHz summaries with runs around the fault time
+//   3. Move-to-target requests, heights and targets are random; every fourth
+//      desk rarely sees a button so its moves to target run for several ticks
+//
+// Expected Results:
+//   - Every output field and every context field identical on every tick
+//   - All states, including FAULT recovery, are exercised
+// ============================================================================
+TEST(DeskAppBatchTest, TC_SIM_BATCH_001_MatchesScalarAppTask)
+{
+    const size_t desks = 512U;
+    const int ticks = 4000;
+    std::mt19937 rng(0xDE5CU);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<uint32_t> tick_ms(0U, 300U);
+    std::uniform_int_distribution<int> current_ma(0, 400);
+    std::uniform_int_distribution<int> run_ms(0, 120);
+    std::uniform_int_distribution<int32_t> height_um(0, 640000);
+
+    DeskAppBatch batch;
+    DeskAppBatch_init(batch, desks);
+    std::vector<AppContext_t> contexts(desks);
+    for (size_t d = 0U; d < desks; ++d)
+    {
+        APP_InitCtx(&contexts[d]);
+    }
+
+    bool visited[6] = {false, false, false, false, false, false};
+    uint32_t now_ms = UINT32_MAX - 20000U;
+    for (int t = 0; t < ticks; ++t)
+    {
+        now_ms += tick_ms(rng);
+        std::vector<AppInput_t> inputs(desks);
+        for (size_t d = 0U; d < desks; ++d)
+        {
+            AppInput_t &in = inputs[d];
+            const bool quiet = (d % 4U == 3U);
+            in.button_up = percent(rng) < (quiet ? 2 : 40);
+            in.button_down = percent(rng) < (quiet ? 2 : 30);
+            in.limit_upper = percent(rng) < 10;
+            in.limit_lower = percent(rng) < 10;
+            in.fault_in = percent(rng) < 3;
+            in.motor_type = (d % 2U == 0U) ? MT_ROBUST : MT_BASIC;
+            in.motor_current_ma = static_cast<uint16_t>(current_ma(rng));
+            in.motor_phase = static_cast<MotorRampPhase_t>(percent(rng) % 4);
+            in.motor_pwm = static_cast<uint8_t>(current_ma(rng) % 256);
+            if (percent(rng) < 50)
+            {
+                in.current_summary.samples = static_cast<uint16_t>(tick_ms(rng));
+                in.current_summary.stuck_run_ms = static_cast<uint16_t>(run_ms(rng));
+                in.current_summary.obstruction_run_ms = static_cast<uint16_t>(run_ms(rng));
+                in.current_summary.deviation_run_ms = static_cast<uint16_t>(run_ms(rng));
+                in.current_summary.slope_jam = percent(rng) < 5;
+            }
+            in.position_estimate.height_um = height_um(rng);
+            in.position_estimate.referenced = percent(rng) < 95;
+            in.move_to_target = percent(rng) < 30;
+            in.target_height_um = height_um(rng);
+            in.target_reached = percent(rng) < 5;
+            in.calibrate = percent(rng) < 5;
+            in.timestamp_ms = now_ms;
+            DeskAppBatch_setInput(batch, d, in);
+        }
+
+        DeskAppBatch_step(batch, now_ms);
+
+        for (size_t d = 0U; d < desks; ++d)
+        {
+            AppOutput_t expected;
+            APP_TaskCtx(&contexts[d], &inputs[d], &expected);
+            AppOutput_t actual;
+            DeskAppBatch_getOutput(batch, d, actual);
+            AppContext_t lane;
+            DeskAppBatch_storeContext(batch, d, lane);
+
+            ASSERT_EQ(actual.motor_cmd, expected.motor_cmd) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.motor_speed, expected.motor_speed) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.led_bt_up, expected.led_bt_up) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.led_bt_down, expected.led_bt_down) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.led_error, expected.led_error) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.fault_out, expected.fault_out) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.soft_stop, expected.soft_stop) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.moving_to_target, expected.moving_to_target) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.target_height_um, expected.target_height_um) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.calibrating, expected.calibrating) << "desk " << d << " tick " << t;
+            ASSERT_EQ(actual.calibration_done, expected.calibration_done) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.current_state, contexts[d].current_state) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.state_entry_time, contexts[d].state_entry_time) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.button_fault_latched, contexts[d].button_fault_latched) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.external_fault_latched, contexts[d].external_fault_latched) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.current_fault_latched, contexts[d].current_fault_latched) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.stuck_on_timer_start_ms, contexts[d].stuck_on_timer_start_ms) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.obstruction_timer_start_ms, contexts[d].obstruction_timer_start_ms) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.target_height_um, contexts[d].target_height_um) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.target_dir, contexts[d].target_dir) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.button_release_pending, contexts[d].button_release_pending) << "desk " << d << " tick " << t;
+            ASSERT_EQ(lane.calibration_dir, contexts[d].calibration_dir) << "desk " << d << " tick " << t;
+            visited[static_cast<int>(lane.current_state)] = true;
+        }
+    }
+
+    EXPECT_TRUE(visited[APP_STATE_IDLE]);
+    EXPECT_TRUE(visited[APP_STATE_MOVING_UP]);
+    EXPECT_TRUE(visited[APP_STATE_MOVING_DOWN]);
+    EXPECT_TRUE(visited[APP_STATE_MOVING_TO_TARGET]);
+    EXPECT_TRUE(visited[APP_STATE_CALIBRATING]);
+    EXPECT_TRUE(visited[APP_STATE_FAULT]);
+}
+
+// ============================================================================
+// TEST CASE: TC-SIM-FLEET-001 - Parallel Fleet Run Matches Serial Run
+// ============================================================================
+// Requirement: Fleet runner workers must not share HAL mock or module state
+//
+// Test Steps:
+//   1. Run 24 seeded scenarios on the calling thread, one after another
+//   2. Run the same scenarios on 4 work-stealing workers
+//   3. Mark a pin on the test thread before the parallel run
+//
+// Expected Results:
+//   - Every per-scenario result is identical between the two runs
+//   - Aggregate counters equal the sums over the per-scenario results
+//   - The test thread's pin state is untouched by the workers
+// ============================================================================
+TEST_F(DeskSimulationTest, TC_SIM_FLEET_001_ParallelRunMatchesSerial)
+{
+    const std::vector<FleetScenario> scenarios = FleetRunner_makeScenarios(24U, 7U);
+
+    std::vector<FleetScenarioResult> serial;
+    for (const FleetScenario &scenario : scenarios)
+    {
+        serial.push_back(FleetRunner_runScenario(scenario));
+    }
+
+    pin_states[PIN_LED_ERROR] = 42;
+    std::vector<FleetScenarioResult> parallel;
+    FleetAggregate aggregate;
+    FleetAggregate_reset(aggregate);
+    const WorkStealingStats stats = FleetRunner_run(scenarios, 4U, parallel, aggregate);
+    EXPECT_EQ(pin_states[PIN_LED_ERROR], 42) << "Workers must use their own pin state";
+
+    ASSERT_EQ(parallel.size(), serial.size());
+    uint32_t faults = 0U;
+    uint32_t reached = 0U;
+    for (size_t i = 0U; i < serial.size(); ++i)
+    {
+        EXPECT_EQ(parallel[i].id, serial[i].id);
+        EXPECT_EQ(parallel[i].stroke_ms, serial[i].stroke_ms) << "scenario " << i;
+        EXPECT_EQ(parallel[i].stop_latency_ms, serial[i].stop_latency_ms) << "scenario " << i;
+        EXPECT_NEAR(parallel[i].stop_distance_mm, serial[i].stop_distance_mm, 1e-9) << "scenario " << i;
+        EXPECT_EQ(parallel[i].max_current_ma, serial[i].max_current_ma) << "scenario " << i;
+        EXPECT_EQ(parallel[i].fault_latched, serial[i].fault_latched) << "scenario " << i;
+        EXPECT_NEAR(parallel[i].travel_mm, serial[i].travel_mm, 1e-9) << "scenario " << i;
+        faults += serial[i].fault_latched ? 1U : 0U;
+        reached += (serial[i].stroke_ms != UINT32_MAX) ? 1U : 0U;
+    }
+
+    EXPECT_EQ(aggregate.scenarios.load(), 24U);
+    EXPECT_EQ(aggregate.faults_latched.load(), faults);
+    EXPECT_EQ(aggregate.limit_reached.load(), reached);
+    uint32_t executed = 0U;
+    for (uint32_t count : stats.executed)
+    {
+        executed += count;
+    }
+    EXPECT_EQ(executed, 24U);
+}
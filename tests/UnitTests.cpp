@@ -2,6 +2,8 @@
 #include "motor_controller.h"
 #include "hal.h"
 #include "desk_types.h"
+#include <algorithm>
+#include <cstdlib>
 
 // ============================================================================
 // TEST CASE SPECIFICATION: Motor Controller Unit Tests
@@ -313,4 +315,268 @@ TEST_F(MotorControllerUnitTest, TC_MC_SAFETY_001_ZeroPWMProducesNoMotion)
     MotorControllerOutput_t out2 = MotorController_update(MOTOR_DOWN, 0U, now + 100U);
     EXPECT_EQ(out2.pwm, 0U) 
         << "PWM must remain zero for DOWN with zero target";
-}
\ No newline at end of file
+}
+// ============================================================================
+// TEST CASE: TC-MC-CTX-001 - Independent Motor Controller Contexts
+// ============================================================================
+// Requirement: Re-entrant motor controller instances (many desks per process)
+//
+// Test Objective:
+//   Verify that ramp and direction state of caller-owned contexts do not
+//   interfere with each other or with the default instance.
+//
+// Test Steps:
+//   1. Start an UP ramp on context A at t=0 and a DOWN ramp on context B at t=250
+//   2. Sample both at t=500
+//
+// Expected Results:
+//   - A has completed its ramp (PWM=255), B is halfway (≈127)
+//   - Default instance still reports a stopped motor
+// ============================================================================
+TEST_F(MotorControllerUnitTest, TC_MC_CTX_001_IndependentContexts)
+{
+    MotorControllerContext_t ctx_a;
+    MotorControllerContext_t ctx_b;
+    MotorController_initCtx(&ctx_a);
+    MotorController_initCtx(&ctx_b);
+
+    (void)MotorController_updateCtx(&ctx_a, MOTOR_UP, 255U, 0U);
+    (void)MotorController_updateCtx(&ctx_b, MOTOR_DOWN, 255U, 250U);
+
+    const MotorControllerOutput_t out_a = MotorController_updateCtx(&ctx_a, MOTOR_UP, 255U, 500U);
+    const MotorControllerOutput_t out_b = MotorController_updateCtx(&ctx_b, MOTOR_DOWN, 255U, 500U);
+
+    EXPECT_EQ(out_a.dir, MOTOR_UP);
+    EXPECT_EQ(out_a.pwm, 255U) << "Context A ramp complete after 500 ms";
+    EXPECT_EQ(out_b.dir, MOTOR_DOWN);
+    EXPECT_GE(out_b.pwm, 120U) << "Context B halfway through its own ramp";
+    EXPECT_LE(out_b.pwm, 135U);
+
+    const MotorControllerOutput_t out_default = MotorController_update(MOTOR_STOP, 0U, 500U);
+    EXPECT_EQ(out_default.pwm, 0U) << "Default instance unaffected by context calls";
+}
+
+// ============================================================================
+// TEST CASE: TC-MC-RAMP-003 - Ramp Profiles Span 0..Target Monotonically
+// ============================================================================
+// Requirement: SysReq-006 (smooth motion), selectable ramp shapes
+//
+// Test Objective:
+//   Verify every table-driven ramp profile starts at 0, reaches the target at
+//   RAMP_TIME_MS, never decreases and never exceeds the target.
+//
+// Expected Results:
+//   - Linear profile matches the exact linear ramp within 1 PWM count
+//   - S-curve is symmetric: slower than linear early, equal at the midpoint
+//   - Exponential is ahead of linear for the whole ramp
+// ============================================================================
+TEST_F(MotorControllerUnitTest, TC_MC_RAMP_003_ProfilesSpanZeroToTarget)
+{
+    const RampProfile_t profiles[] = {RAMP_PROFILE_LINEAR, RAMP_PROFILE_SCURVE, RAMP_PROFILE_EXPONENTIAL};
+    for (RampProfile_t profile : profiles)
+    {
+        MotorController_setRampProfile(profile);
+        EXPECT_EQ(MotorController_getRampProfile(), profile);
+        EXPECT_EQ(MotorController_rampPwm(255U, 0U), 0U) << "profile " << profile;
+        EXPECT_EQ(MotorController_rampPwm(255U, 500U), 255U) << "profile " << profile;
+
+        uint8_t previous = 0U;
+        for (uint32_t t = 0U; t <= 600U; ++t)
+        {
+            const uint8_t pwm = MotorController_rampPwm(200U, t);
+            EXPECT_GE(pwm, previous) << "profile " << profile << " at " << t << " ms";
+            EXPECT_LE(pwm, 200U) << "profile " << profile << " at " << t << " ms";
+            previous = pwm;
+        }
+    }
+
+    MotorController_setRampProfile(RAMP_PROFILE_LINEAR);
+    for (uint32_t t = 0U; t < 500U; ++t)
+    {
+        const int exact = static_cast<int>((255U * t) / 500U);
+        const int pwm = MotorController_rampPwm(255U, t);
+        EXPECT_LE(std::abs(pwm - exact), 1) << "linear at " << t << " ms";
+    }
+
+    MotorController_setRampProfile(RAMP_PROFILE_SCURVE);
+    const uint8_t scurve_early = MotorController_rampPwm(255U, 100U);
+    const uint8_t scurve_mid = MotorController_rampPwm(255U, 250U);
+    MotorController_setRampProfile(RAMP_PROFILE_EXPONENTIAL);
+    const uint8_t exponential_early = MotorController_rampPwm(255U, 100U);
+    MotorController_setRampProfile(RAMP_PROFILE_LINEAR);
+    const uint8_t linear_early = MotorController_rampPwm(255U, 100U);
+
+    EXPECT_LT(scurve_early, linear_early);
+    EXPECT_NEAR(scurve_mid, 127, 1);
+    EXPECT_GT(exponential_early, linear_early);
+}
+
+// ============================================================================
+// TEST CASE: TC-MC-RAMP-004 - S-Curve Lowers Peak Jerk
+// ============================================================================
+// Requirement: SysReq-006 (smooth motion)
+//
+// Test Objective:
+//   Compare the largest change in PWM slope (a proxy for jerk) between
+//   consecutive 20 ms windows, including the step into the ramp from rest
+//   and the step out of it at full speed.
+//
+// Expected Results:
+//   - S-curve peak slope change is less than half of the linear profile's
+//   - Both reach the target at the same time (same stroke time)
+// ============================================================================
+TEST_F(MotorControllerUnitTest, TC_MC_RAMP_004_SCurveLowersPeakJerk)
+{
+    const auto peak_slope_change = [](RampProfile_t profile) {
+        MotorController_setRampProfile(profile);
+        const int window_ms = 20;
+        int previous_slope = 0;  // At rest before the ramp
+        int peak = 0;
+        for (int t = 0; t <= 520; t += window_ms)
+        {
+            const int slope = MotorController_rampPwm(255U, static_cast<uint32_t>(t + window_ms)) -
+                              MotorController_rampPwm(255U, static_cast<uint32_t>(t));
+            peak = std::max(peak, std::abs(slope - previous_slope));
+            previous_slope = slope;
+        }
+        return peak;
+    };
+
+    const int linear_peak = peak_slope_change(RAMP_PROFILE_LINEAR);
+    const int scurve_peak = peak_slope_change(RAMP_PROFILE_SCURVE);
+    MotorController_setRampProfile(RAMP_PROFILE_DEFAULT);
+
+    EXPECT_LT(scurve_peak * 2, linear_peak);
+}
+
+// ============================================================================
+// TEST CASE: TC-MC-STOP-002 - Soft Stop Ramps PWM Down Within 200 ms
+// ============================================================================
+// Requirement: SysReq-006 (smooth motion), SysReq-003 (bounded halt)
+//
+// Test Objective:
+//   Verify that MOTOR_STOP with MOTOR_STOP_SOFT after full-speed motion keeps
+//   the direction of travel while PWM falls monotonically to 0.
+//
+// Test Steps:
+//   1. Run MOTOR_UP at full speed (ramp complete)
+//   2. Command MOTOR_STOP / MOTOR_STOP_SOFT every 1 ms
+//
+// Expected Results:
+//   - First stop update still drives UP at the previous PWM
+//   - PWM never rises, direction stays UP until PWM is 0, then STOP
+//   - Drive removed within STOP_RAMP_TIME_MS (200 ms); no stall fault
+// ============================================================================
+TEST_F(MotorControllerUnitTest, TC_MC_STOP_002_SoftStopRampsDownWithinBound)
+{
+    MotorController_update(MOTOR_UP, 255U, 0U);
+    MotorControllerOutput_t out = MotorController_update(MOTOR_UP, 255U, 600U);
+    ASSERT_EQ(out.pwm, 255U);
+
+    uint8_t previous_pwm = 255U;
+    uint32_t stopped_at = UINT32_MAX;
+    for (uint32_t t = 601U; t <= 900U; ++t)
+    {
+        out = MotorController_updateStop(MOTOR_STOP, 0U, MOTOR_STOP_SOFT, t);
+        EXPECT_FALSE(out.fault) << "t=" << t;
+        EXPECT_LE(out.pwm, previous_pwm) << "t=" << t;
+        if (t == 601U)
+        {
+            EXPECT_EQ(out.dir, MOTOR_UP);
+            EXPECT_EQ(out.pwm, 255U);
+        }
+        if ((out.pwm == 0U) && (stopped_at == UINT32_MAX))
+        {
+            stopped_at = t;
+        }
+        if (out.pwm == 0U)
+        {
+            EXPECT_EQ(out.dir, MOTOR_STOP) << "t=" << t;
+        }
+        else
+        {
+            EXPECT_EQ(out.dir, MOTOR_UP) << "t=" << t;
+        }
+        previous_pwm = out.pwm;
+    }
+
+    ASSERT_NE(stopped_at, UINT32_MAX);
+    EXPECT_LE(stopped_at - 601U, 200U) << "Soft stop must end within STOP_RAMP_TIME_MS";
+    EXPECT_GT(stopped_at - 601U, 100U) << "Soft stop must actually ramp";
+    EXPECT_EQ(MotorController_stopPwm(200U, 0U), 200U);
+    EXPECT_EQ(MotorController_stopPwm(200U, 200U), 0U);
+}
+
+// ============================================================================
+// TEST CASE: TC-MC-STOP-003 - Immediate Stop Overrides a Soft Stop
+// ============================================================================
+// Requirement: SysReq-003, SysReq-007 (faults and limits halt at once)
+//
+// Test Steps:
+//   1. Start a soft stop from full speed DOWN
+//   2. 50 ms in, command MOTOR_STOP / MOTOR_STOP_IMMEDIATE
+//   3. Command MOTOR_STOP / MOTOR_STOP_SOFT again
+//   4. Soft stop from rest (no previous motion)
+//
+// Expected Results:
+//   - Step 2 and 3: PWM=0, dir STOP (cancelled ramp-down does not resume)
+//   - Step 4: PWM=0 (nothing to ramp down)
+// ============================================================================
+TEST_F(MotorControllerUnitTest, TC_MC_STOP_003_ImmediateStopOverridesSoftStop)
+{
+    MotorController_update(MOTOR_DOWN, 255U, 0U);
+    MotorController_update(MOTOR_DOWN, 255U, 600U);
+    MotorControllerOutput_t out = MotorController_updateStop(MOTOR_STOP, 0U, MOTOR_STOP_SOFT, 601U);
+    ASSERT_EQ(out.dir, MOTOR_DOWN);
+
+    out = MotorController_updateStop(MOTOR_STOP, 0U, MOTOR_STOP_SOFT, 650U);
+    EXPECT_EQ(out.dir, MOTOR_DOWN);
+    EXPECT_GT(out.pwm, 0U);
+
+    out = MotorController_updateStop(MOTOR_STOP, 0U, MOTOR_STOP_IMMEDIATE, 651U);
+    EXPECT_EQ(out.dir, MOTOR_STOP);
+    EXPECT_EQ(out.pwm, 0U);
+
+    out = MotorController_updateStop(MOTOR_STOP, 0U, MOTOR_STOP_SOFT, 652U);
+    EXPECT_EQ(out.dir, MOTOR_STOP);
+    EXPECT_EQ(out.pwm, 0U);
+
+    MotorController_init();
+    out = MotorController_updateStop(MOTOR_STOP, 0U, MOTOR_STOP_SOFT, 1000U);
+    EXPECT_EQ(out.dir, MOTOR_STOP);
+    EXPECT_EQ(out.pwm, 0U);
+}
+
+// ============================================================================
+// TEST CASE: TC-MC-RAMP-005 - Output Reports the Ramp Phase
+// ============================================================================
+// Requirement: SysReq-013 (obstruction detection expects soft-start inrush)
+//
+// Test Steps:
+//   1. Start MOTOR_UP at full speed, sample before and after RAMP_TIME_MS
+//   2. Soft stop, then wait for it to finish
+//
+// Expected Results:
+//   - MOTOR_PHASE_RAMP_UP while ramping, MOTOR_PHASE_CRUISE once at target
+//   - MOTOR_PHASE_RAMP_DOWN during the soft stop, MOTOR_PHASE_IDLE at PWM 0
+// ============================================================================
+TEST_F(MotorControllerUnitTest, TC_MC_RAMP_005_OutputReportsRampPhase)
+{
+    MotorControllerOutput_t out = MotorController_update(MOTOR_UP, 255U, 0U);
+    EXPECT_EQ(out.phase, (out.pwm == 0U) ? MOTOR_PHASE_IDLE : MOTOR_PHASE_RAMP_UP);
+
+    out = MotorController_update(MOTOR_UP, 255U, 250U);
+    EXPECT_GT(out.pwm, 0U);
+    EXPECT_EQ(out.phase, MOTOR_PHASE_RAMP_UP);
+
+    out = MotorController_update(MOTOR_UP, 255U, 600U);
+    EXPECT_EQ(out.pwm, 255U);
+    EXPECT_EQ(out.phase, MOTOR_PHASE_CRUISE);
+
+    out = MotorController_updateStop(MOTOR_STOP, 0U, MOTOR_STOP_SOFT, 601U);
+    EXPECT_EQ(out.phase, MOTOR_PHASE_RAMP_DOWN);
+
+    out = MotorController_updateStop(MOTOR_STOP, 0U, MOTOR_STOP_SOFT, 900U);
+    EXPECT_EQ(out.pwm, 0U);
+    EXPECT_EQ(out.phase, MOTOR_PHASE_IDLE);
+}
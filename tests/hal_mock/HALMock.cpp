@@ -5,14 +5,24 @@
 /* define Serial instance (matches extern in headers) */
 SerialMock Serial;
 
-/* Simple in-memory pin state (exposed for test verification) */
-int pin_states[64] = {0};
+/* Simple in-memory pin state (exposed for test verification), one board per thread */
+thread_local int pin_states[64] = {0};
+
+thread_local uint32_t pin_write_count = 0U;
+thread_local void (*pin_write_hook)(int pin, int value) = nullptr;
+
+static void record_write(int pin, int value) {
+    ++pin_write_count;
+    if (pin_write_hook != nullptr) {
+        pin_write_hook(pin, value);
+    }
+}
 
 /* basic implementations used by host tests */
 void pinMode(int pin, int mode) { (void)pin; (void)mode; }
-void digitalWrite(int pin, int value) { if (pin >= 0 && pin < 64) pin_states[pin] = value ? 1 : 0; (void)pin; (void)value; }
+void digitalWrite(int pin, int value) { if (pin >= 0 && pin < 64) pin_states[pin] = value ? 1 : 0; record_write(pin, value); }
 int digitalRead(int pin) { if (pin >= 0 && pin < 64) return pin_states[pin]; return LOW; }
-void analogWrite(int pin, int value) { if (pin >= 0 && pin < 64) pin_states[pin] = value; (void)pin; (void)value; }
+void analogWrite(int pin, int value) { if (pin >= 0 && pin < 64) pin_states[pin] = value; record_write(pin, value); }
 int analogRead(int pin) { 
     // Return mock ADC value from pin_states array
     // For testing, can be pre-set via pin_states[pin] = adc_value
@@ -20,12 +30,48 @@ int analogRead(int pin) {
     return 0; // Default to 0 if pin out of range
 }
 
-/* millis using steady_clock for monotonic time in host tests */
+/* First pin number of each mocked port (port_io.h PortIOPort_t order: B, C, D) */
+static int port_first_pin(uint8_t port)
+{
+    return (port == 0U) ? 8 : ((port == 1U) ? 14 : 0);
+}
+
+uint8_t MockPort_read(uint8_t port) {
+    const int first = port_first_pin(port);
+    uint8_t levels = 0U;
+    for (int bit = 0; bit < 8; ++bit) {
+        if (pin_states[first + bit] != LOW) {
+            levels = static_cast<uint8_t>(levels | (1U << bit));
+        }
+    }
+    return levels;
+}
+
+void MockPort_write(uint8_t port, uint8_t mask, bool high) {
+    const int first = port_first_pin(port);
+    for (int bit = 0; bit < 8; ++bit) {
+        if ((mask & (1U << bit)) != 0U) {
+            pin_states[first + bit] = high ? HIGH : LOW;
+            record_write(first + bit, pin_states[first + bit]);
+        }
+    }
+}
+
+void MockPort_writePwm(int pin, uint8_t duty) { analogWrite(pin, duty); }
+
+/* Time functions read the virtual clock (MockClock.h); 32-bit wrap like the AVR core */
 unsigned long millis(void) {
-    using namespace std::chrono;
-    static const steady_clock::time_point start = steady_clock::now();
-    auto delta = duration_cast<milliseconds>(steady_clock::now() - start);
-    return static_cast<unsigned long>(delta.count());
+    return static_cast<unsigned long>(static_cast<uint32_t>(MockClock_nowUs() / 1000U));
 }
 
-void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
\ No newline at end of file
+unsigned long micros(void) {
+    return static_cast<unsigned long>(static_cast<uint32_t>(MockClock_nowUs()));
+}
+
+void delay(unsigned long ms) {
+    if (MockClock_getMode() == MOCK_CLOCK_REAL_TIME) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    } else {
+        MockClock_advanceMs(static_cast<uint32_t>(ms));
+    }
+}
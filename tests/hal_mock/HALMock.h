@@ -1,5 +1,6 @@
 #pragma once
 #include "SerialMock.h"
+#include "MockClock.h"
 #include <cstdint>
 
 /* Arduino-like constants */
@@ -23,7 +24,12 @@
 extern SerialMock Serial;
 
 /* Expose pin states for test verification */
-extern int pin_states[64];
+extern thread_local int pin_states[64];
+
+/* Output write instrumentation: every digitalWrite / analogWrite / port bit write
+ * counts once and is reported to the hook (if set) after pin_states[] is updated */
+extern thread_local uint32_t pin_write_count;
+extern thread_local void (*pin_write_hook)(int pin, int value);
 
 /* Minimal Arduino-like API for host unit tests */
 void pinMode(int pin, int mode);
@@ -32,4 +38,11 @@ int  digitalRead(int pin);
 void analogWrite(int pin, int value);
 int  analogRead(int pin);
 unsigned long millis(void);
-void delay(unsigned long ms);
\ No newline at end of file
+unsigned long micros(void);
+void delay(unsigned long ms);
+
+/* Port register model for port_io.h (UNO: port 0 = B pins 8-13, 1 = C pins 14-19, 2 = D pins 0-7).
+ * Reads and writes go through pin_states[], so tests see no difference to the pin API. */
+uint8_t MockPort_read(uint8_t port);
+void MockPort_write(uint8_t port, uint8_t mask, bool high);
+void MockPort_writePwm(int pin, uint8_t duty);
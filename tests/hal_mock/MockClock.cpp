@@ -0,0 +1,137 @@
+#include "MockClock.h"
+#include <chrono>
+#include <map>
+#include <utility>
+
+namespace
+{
+struct PendingEvent
+{
+    MockClockEvent_t callback;
+    void *context;
+};
+
+thread_local MockClockMode_t clock_mode = MOCK_CLOCK_MANUAL;
+thread_local uint64_t virtual_now_us = 0U;
+thread_local uint32_t free_run_step_us = 1000U;
+
+/* Ordered by due time; equal times keep insertion order (multimap guarantee) */
+thread_local std::multimap<uint64_t, PendingEvent> pending_events;
+
+/* Real-time mode anchors wall time to the virtual counter at the switch */
+thread_local std::chrono::steady_clock::time_point real_time_anchor = std::chrono::steady_clock::now();
+thread_local uint64_t real_time_anchor_us = 0U;
+
+uint64_t real_time_now_us()
+{
+    using namespace std::chrono;
+    const auto elapsed = duration_cast<microseconds>(steady_clock::now() - real_time_anchor);
+    return real_time_anchor_us + static_cast<uint64_t>(elapsed.count());
+}
+
+/* Fire events due at or before target_us, then settle the clock at target_us */
+void run_until(uint64_t target_us)
+{
+    while (!pending_events.empty() && pending_events.begin()->first <= target_us)
+    {
+        const auto next = pending_events.begin();
+        const PendingEvent event = next->second;
+        if (next->first > virtual_now_us)
+        {
+            virtual_now_us = next->first;
+        }
+        pending_events.erase(next);
+        event.callback(event.context);
+    }
+    if (target_us > virtual_now_us)
+    {
+        virtual_now_us = target_us;
+    }
+}
+} // namespace
+
+void MockClock_reset(uint64_t start_us)
+{
+    clock_mode = MOCK_CLOCK_MANUAL;
+    virtual_now_us = start_us;
+    free_run_step_us = 1000U;
+    pending_events.clear();
+}
+
+void MockClock_setMode(MockClockMode_t mode)
+{
+    if (mode == MOCK_CLOCK_REAL_TIME)
+    {
+        real_time_anchor = std::chrono::steady_clock::now();
+        real_time_anchor_us = virtual_now_us;
+    }
+    else if (clock_mode == MOCK_CLOCK_REAL_TIME)
+    {
+        // Freeze virtual time where the wall clock left it
+        virtual_now_us = real_time_now_us();
+    }
+    clock_mode = mode;
+}
+
+MockClockMode_t MockClock_getMode(void)
+{
+    return clock_mode;
+}
+
+void MockClock_setFreeRunStep(uint32_t step_us)
+{
+    free_run_step_us = step_us;
+}
+
+uint64_t MockClock_nowUs(void)
+{
+    if (clock_mode == MOCK_CLOCK_REAL_TIME)
+    {
+        return real_time_now_us();
+    }
+
+    const uint64_t now_us = virtual_now_us;
+    if (clock_mode == MOCK_CLOCK_FREE_RUN)
+    {
+        run_until(virtual_now_us + free_run_step_us);
+    }
+    return now_us;
+}
+
+void MockClock_advanceUs(uint64_t delta_us)
+{
+    if (clock_mode == MOCK_CLOCK_REAL_TIME)
+    {
+        return;  // Wall time cannot be advanced
+    }
+    run_until(virtual_now_us + delta_us);
+}
+
+void MockClock_advanceMs(uint32_t delta_ms)
+{
+    MockClock_advanceUs(static_cast<uint64_t>(delta_ms) * 1000U);
+}
+
+void MockClock_schedule(uint64_t at_us, MockClockEvent_t callback, void *context)
+{
+    if (callback != nullptr)
+    {
+        pending_events.insert(std::make_pair(at_us, PendingEvent{callback, context}));
+    }
+}
+
+bool MockClock_stepToNextEvent(void)
+{
+    if (pending_events.empty() || clock_mode == MOCK_CLOCK_REAL_TIME)
+    {
+        return false;
+    }
+    const uint64_t due_us = pending_events.begin()->first;
+    run_until((due_us > virtual_now_us) ? due_us : virtual_now_us);
+    return true;
+}
+
+size_t MockClock_pendingEvents(void)
+{
+    return pending_events.size();
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Deterministic virtual time source for host builds.
+ *
+ * millis(), micros() and delay() in HALMock.cpp read this clock, so every
+ * consumer above them (HAL_getTime(), HAL_readButton() debouncing, the
+ * DeskControl schedule) runs on harness-controlled time instead of wall time.
+ *
+ * Modes:
+ *   MOCK_CLOCK_MANUAL    - time only moves via MockClock_advance*() / delay() /
+ *                          MockClock_stepToNextEvent() (default)
+ *   MOCK_CLOCK_FREE_RUN  - every millis()/micros() read advances the clock by
+ *                          a fixed step, so polling loops terminate without a driver
+ *   MOCK_CLOCK_REAL_TIME - legacy behaviour, time follows std::chrono::steady_clock
+ *
+ * Time is kept as a 64-bit microsecond counter; millis()/micros() truncate it
+ * to 32 bits exactly like the AVR core, so wraparound can be reached instantly
+ * with MockClock_reset(start_us).
+ *
+ * Clock state is thread-local: each fleet simulation worker runs its own clock.
+ */
+
+typedef enum
+{
+    MOCK_CLOCK_MANUAL = 0,
+    MOCK_CLOCK_FREE_RUN = 1,
+    MOCK_CLOCK_REAL_TIME = 2
+} MockClockMode_t;
+
+/* Scheduled event callback; the clock already reads the event time when it runs */
+typedef void (*MockClockEvent_t)(void *context);
+
+/* Reset to start_us, MANUAL mode, 1 ms free-run step, no pending events */
+void MockClock_reset(uint64_t start_us = 0U);
+
+void MockClock_setMode(MockClockMode_t mode);
+MockClockMode_t MockClock_getMode(void);
+
+/* Increment applied on each read in MOCK_CLOCK_FREE_RUN mode */
+void MockClock_setFreeRunStep(uint32_t step_us);
+
+uint64_t MockClock_nowUs(void);
+
+/* Move time forward, firing every scheduled event due on the way in time order */
+void MockClock_advanceUs(uint64_t delta_us);
+void MockClock_advanceMs(uint32_t delta_ms);
+
+/* Register a one-shot event at an absolute time (events in the past fire on the next advance) */
+void MockClock_schedule(uint64_t at_us, MockClockEvent_t callback, void *context);
+
+/* Jump to the earliest pending event and fire it; false if nothing is pending */
+bool MockClock_stepToNextEvent(void);
+
+size_t MockClock_pendingEvents(void);
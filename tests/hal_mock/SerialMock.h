@@ -6,9 +6,11 @@ public:
     void begin(unsigned long baud);
     void print(const std::string& s);
     void print(int val);
+    void print(unsigned long val);
     void print(const char* s);
     void println(const std::string& s);
     void println(int val);
+    void println(unsigned long val);
     void println(const char* s);
 };
  
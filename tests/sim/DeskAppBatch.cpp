@@ -0,0 +1,330 @@
+#include "DeskAppBatch.h"
+#include "safety_config.h"
+#include "current_monitor.h"
+
+namespace
+{
+/* All-ones when flag is non-zero, zero otherwise (flag must be 0 or 1) */
+inline uint32_t mask_of(uint32_t flag)
+{
+    return 0U - flag;
+}
+
+inline uint32_t select_u32(uint32_t mask, uint32_t if_set, uint32_t if_clear)
+{
+    return (if_set & mask) | (if_clear & ~mask);
+}
+} // namespace
+
+void DeskAppBatch_init(DeskAppBatch &batch, size_t count)
+{
+    batch.state.assign(count, static_cast<uint8_t>(APP_STATE_IDLE));
+    batch.latches.assign(count, 0U);
+    batch.state_entry_ms.assign(count, 0U);
+    batch.stuck_on_start_ms.assign(count, UINT32_MAX);
+    batch.obstruction_start_ms.assign(count, UINT32_MAX);
+    batch.target_um.assign(count, 0);
+    batch.target_dir.assign(count, static_cast<uint8_t>(MOTOR_STOP));
+    batch.release_pending.assign(count, 0U);
+    batch.calibration_dir.assign(count, static_cast<uint8_t>(MOTOR_STOP));
+    batch.input_bits.assign(count, 0U);
+    batch.motor_current_ma.assign(count, 0U);
+    batch.obstruction_limit_ma.assign(count, MOTOR_SENSE_OBSTRUCTION_THRESHOLD_MA);
+    batch.target_bits.assign(count, 0U);
+    batch.height_um.assign(count, 0);
+    batch.request_um.assign(count, 0);
+    batch.motor_cmd.assign(count, static_cast<uint8_t>(MOTOR_STOP));
+    batch.motor_speed.assign(count, 0U);
+    batch.output_bits.assign(count, 0U);
+    batch.target_out_um.assign(count, 0);
+}
+
+size_t DeskAppBatch_size(const DeskAppBatch &batch)
+{
+    return batch.state.size();
+}
+
+/*
+ * Branch-free transcription of APP_TaskCtx(). Every condition is a 0/1 value
+ * or an all-ones/all-zeros mask, and every assignment is a select, so one
+ * iteration has no data-dependent control flow. Step numbers follow the
+ * scalar implementation in desk_app.cpp. The lanes are passed as restrict
+ * parameters so the compiler can vectorize without run-time alias checks.
+ */
+static void step_lanes(size_t count, uint32_t now_ms,
+                       uint8_t *__restrict state, uint8_t *__restrict latches,
+                       uint32_t *__restrict entry, uint32_t *__restrict stuck,
+                       uint32_t *__restrict obstruction,
+                       int32_t *__restrict target, uint8_t *__restrict target_dir,
+                       uint8_t *__restrict release_pending, uint8_t *__restrict calibration_dir,
+                       const uint8_t *__restrict input_bits, const uint16_t *__restrict current,
+                       const uint16_t *__restrict obstruction_limit,
+                       const uint8_t *__restrict target_bits, const int32_t *__restrict height,
+                       const int32_t *__restrict request,
+                       uint8_t *__restrict motor_cmd, uint8_t *__restrict motor_speed,
+                       uint8_t *__restrict output_bits, int32_t *__restrict target_out)
+{
+    const uint32_t dir_up = static_cast<uint32_t>(MOTOR_UP);
+    const uint32_t dir_down = static_cast<uint32_t>(MOTOR_DOWN);
+    const uint32_t dir_stop = static_cast<uint32_t>(MOTOR_STOP);
+    const uint32_t latch_button = DESK_BATCH_LATCH_BUTTON;
+    const uint32_t latch_external = DESK_BATCH_LATCH_EXTERNAL;
+    const uint32_t latch_current = DESK_BATCH_LATCH_CURRENT;
+
+    for (size_t i = 0U; i < count; ++i)
+    {
+        const uint32_t in = input_bits[i];
+        const uint32_t bu = in & 1U;
+        const uint32_t bd = (in >> 1U) & 1U;
+        const uint32_t lu = (in >> 2U) & 1U;
+        const uint32_t ll = (in >> 3U) & 1U;
+        const uint32_t fin = (in >> 4U) & 1U;
+        const uint32_t sense = (in >> 5U) & 1U;
+        const uint32_t summary = (in >> 6U) & 1U;
+        const uint32_t run_trip = (in >> 7U) & 1U;
+        const uint32_t tin = target_bits[i];
+        const uint32_t req = tin & 1U;
+        const uint32_t ref = (tin >> 1U) & 1U;
+        const uint32_t reached = (tin >> 2U) & 1U;
+        const uint32_t cal_req = (tin >> 3U) & 1U;
+        const int32_t h = height[i];
+        uint32_t tgt = static_cast<uint32_t>(target[i]);
+        uint32_t tdir = target_dir[i];
+        uint32_t pend = release_pending[i];
+        uint32_t cdir = calibration_dir[i];
+        const uint32_t st = state[i];
+        uint32_t lat = latches[i];
+        uint32_t stuck_ms = stuck[i];
+        uint32_t obst_ms = obstruction[i];
+        uint32_t entry_ms = entry[i];
+
+        // Step 1: fault recovery while in FAULT
+        const uint32_t in_fault = static_cast<uint32_t>(st == static_cast<uint32_t>(APP_STATE_FAULT));
+        const uint32_t released = (bu | bd) ^ 1U;
+        const uint32_t current_cleared = in_fault & released & ((lat & latch_current) >> 2U);
+        const uint32_t clear_bits = mask_of(in_fault) &
+            ((mask_of(released) & (latch_button | latch_current)) | (mask_of(fin ^ 1U) & latch_external));
+        lat &= ~clear_bits;
+        stuck_ms = select_u32(mask_of(current_cleared), UINT32_MAX, stuck_ms);
+        obst_ms = select_u32(mask_of(current_cleared), UINT32_MAX, obst_ms);
+
+        // Step 2: latch dual-button and external faults; transient dual-limit fault
+        lat |= mask_of(bu & bd) & latch_button;
+        lat |= mask_of(fin) & latch_external;
+        const uint32_t dual_limit = lu & ll;
+
+        // Step 3: state machine (IDLE / MOVING_UP / MOVING_DOWN / MOVING_TO_TARGET / CALIBRATING / FAULT)
+        const uint32_t is_idle = static_cast<uint32_t>(st == static_cast<uint32_t>(APP_STATE_IDLE));
+        const uint32_t is_up = static_cast<uint32_t>(st == static_cast<uint32_t>(APP_STATE_MOVING_UP));
+        const uint32_t is_down = static_cast<uint32_t>(st == static_cast<uint32_t>(APP_STATE_MOVING_DOWN));
+        const uint32_t is_target = static_cast<uint32_t>(st == static_cast<uint32_t>(APP_STATE_MOVING_TO_TARGET));
+        const uint32_t is_cal = static_cast<uint32_t>(st == static_cast<uint32_t>(APP_STATE_CALIBRATING));
+        const uint32_t any_button = bu | bd;
+        pend &= ~(is_idle & released);
+        const uint32_t usable = pend ^ 1U;
+        const uint32_t go_up = is_idle & usable & bu & (lu ^ 1U);
+        const uint32_t go_down = is_idle & (go_up ^ 1U) & usable & bd & (ll ^ 1U);
+        const uint32_t stay_up = is_up & bu & (lu ^ 1U);
+        const uint32_t stay_down = is_down & bd & (ll ^ 1U);
+
+        // Calibration: start from IDLE on a request (homing leg unless at the lower limit); each leg ends on
+        // its limit switch, the lower one starts the stroke up; any button or an overrun leg aborts
+        const uint32_t go_cal = is_idle & (go_up ^ 1U) & (go_down ^ 1U) & cal_req & released;
+        const uint32_t cal_up = static_cast<uint32_t>(cdir == dir_up);
+        const uint32_t cal_at_limit = select_u32(mask_of(cal_up), lu, ll);
+        const uint32_t cal_timed_out = static_cast<uint32_t>((now_ms - entry_ms) >= APP_CALIBRATION_LEG_TIMEOUT_MS);
+        const uint32_t cal_abort = is_cal & (any_button | cal_timed_out);
+        const uint32_t cal_stop = cal_abort | (is_cal & cal_at_limit);
+        const uint32_t next_leg = cal_stop & (cal_abort ^ 1U) & (cal_up ^ 1U);
+        const uint32_t end_cal = cal_stop & (next_leg ^ 1U);
+        const uint32_t cal_done = end_cal & (cal_abort ^ 1U);
+        const uint32_t stay_cal = is_cal & (cal_stop ^ 1U);
+        pend |= cal_stop & any_button;
+        cdir = select_u32(mask_of(go_cal), select_u32(mask_of(ll), dir_up, dir_down),
+                          select_u32(mask_of(next_leg), dir_up, select_u32(mask_of(end_cal), dir_stop, cdir)));
+        const uint32_t drive_cal = go_cal | stay_cal;
+        const uint32_t calibrating = drive_cal | next_leg;
+
+        // Move to target: start from IDLE on a request, end on any button, the limit, the braking point,
+        // a lost reference or arrival within the tolerance
+        const int32_t distance = request[i] - h;
+        const uint32_t start = is_idle & (go_up ^ 1U) & (go_down ^ 1U) & (go_cal ^ 1U) & req & released & ref;
+        const uint32_t start_up = start & static_cast<uint32_t>(distance > APP_TARGET_TOLERANCE_UM) & (lu ^ 1U);
+        const uint32_t start_down = start & (start_up ^ 1U) &
+            static_cast<uint32_t>(distance < -APP_TARGET_TOLERANCE_UM) & (ll ^ 1U);
+        const uint32_t go_target = start_up | start_down;
+        const uint32_t target_up = static_cast<uint32_t>(tdir == dir_up);
+        const uint32_t at_limit = select_u32(mask_of(target_up), lu, ll);
+        const int32_t remaining = static_cast<int32_t>(select_u32(mask_of(target_up), tgt - static_cast<uint32_t>(h),
+                                                                  static_cast<uint32_t>(h) - tgt));
+        const uint32_t end_target = is_target & (any_button | at_limit | reached | (ref ^ 1U) |
+                                                 static_cast<uint32_t>(remaining <= APP_TARGET_TOLERANCE_UM));
+        const uint32_t stay_target = is_target & (end_target ^ 1U);
+        pend |= end_target & any_button;
+        tgt = select_u32(mask_of(go_target), static_cast<uint32_t>(request[i]), tgt);
+        tdir = select_u32(mask_of(go_target), select_u32(mask_of(start_up), dir_up, dir_down),
+                          select_u32(mask_of(end_target), dir_stop, tdir));
+        const uint32_t drive_target = go_target | stay_target;
+
+        const uint32_t drive_up = go_up | stay_up | (drive_target & static_cast<uint32_t>(tdir == dir_up)) |
+                                  (drive_cal & static_cast<uint32_t>(cdir == dir_up));
+        const uint32_t drive_down = go_down | stay_down | (drive_target & static_cast<uint32_t>(tdir == dir_down)) |
+                                    (drive_cal & static_cast<uint32_t>(cdir == dir_down));
+        const uint32_t stopped_moving = (is_up & (stay_up ^ 1U)) | (is_down & (stay_down ^ 1U)) | end_target | cal_stop;
+
+        const uint32_t cmd = select_u32(mask_of(drive_up), dir_up, select_u32(mask_of(drive_down), dir_down, dir_stop));
+        const uint32_t next_st = select_u32(mask_of(calibrating), static_cast<uint32_t>(APP_STATE_CALIBRATING),
+                                 select_u32(mask_of(drive_target), static_cast<uint32_t>(APP_STATE_MOVING_TO_TARGET),
+                                 select_u32(mask_of(go_up | stay_up), static_cast<uint32_t>(APP_STATE_MOVING_UP),
+                                 select_u32(mask_of(go_down | stay_down), static_cast<uint32_t>(APP_STATE_MOVING_DOWN),
+                                 select_u32(mask_of(in_fault), static_cast<uint32_t>(APP_STATE_FAULT),
+                                            static_cast<uint32_t>(APP_STATE_IDLE))))));
+        entry_ms = select_u32(mask_of(go_up | go_down | go_target | go_cal | stopped_moving), now_ms, entry_ms);
+
+        // Step 4: current sensing (1 kHz runs if summarized, else stuck-on while STOP, obstruction while moving)
+        const uint32_t moving = drive_up | drive_down;
+        const uint32_t cur = current[i];
+        const uint32_t stuck_high = static_cast<uint32_t>(cur > MOTOR_SENSE_THRESHOLD_MA) & (moving ^ 1U);
+        const uint32_t obst_high = static_cast<uint32_t>(cur > obstruction_limit[i]) & moving;
+        const uint32_t stuck_running = static_cast<uint32_t>(stuck_ms != UINT32_MAX);
+        const uint32_t obst_running = static_cast<uint32_t>(obst_ms != UINT32_MAX);
+        const uint32_t stuck_trip = stuck_high & stuck_running &
+            static_cast<uint32_t>((now_ms - stuck_ms) >= MOTOR_SENSE_FAULT_TIME_MS);
+        const uint32_t obst_trip = obst_high & obst_running &
+            static_cast<uint32_t>((now_ms - obst_ms) >= MOTOR_SENSE_FAULT_TIME_MS);
+
+        const uint32_t next_stuck = select_u32(mask_of(stuck_high), select_u32(mask_of(stuck_running), stuck_ms, now_ms), UINT32_MAX);
+        const uint32_t next_obst = select_u32(mask_of(obst_high), select_u32(mask_of(obst_running), obst_ms, now_ms), UINT32_MAX);
+        const uint32_t timed = sense & (summary ^ 1U);
+        stuck_ms = select_u32(mask_of(timed), next_stuck, UINT32_MAX);
+        obst_ms = select_u32(mask_of(timed), next_obst, UINT32_MAX);
+        lat |= mask_of((timed & (stuck_trip | obst_trip)) | (sense & summary & run_trip)) & latch_current;
+
+        // Step 5: consolidated fault handling
+        const uint32_t any_fault = static_cast<uint32_t>(lat != 0U) | dual_limit;
+        const uint32_t fault_mask = mask_of(any_fault);
+        const uint32_t recovered = (any_fault ^ 1U) & static_cast<uint32_t>(next_st == static_cast<uint32_t>(APP_STATE_FAULT));
+        const uint32_t final_st = select_u32(fault_mask, static_cast<uint32_t>(APP_STATE_FAULT),
+                                             select_u32(mask_of(recovered), static_cast<uint32_t>(APP_STATE_IDLE), next_st));
+        entry_ms = select_u32(mask_of(recovered), now_ms, entry_ms);
+
+        tdir = select_u32(fault_mask, dir_stop, tdir);
+        cdir = select_u32(fault_mask, dir_stop, cdir);
+
+        // Soft stop: idle, or released / ended without reaching the limit in the direction of travel
+        const uint32_t released_stop = (is_up & (stay_up ^ 1U) & (lu ^ 1U)) | (is_down & (stay_down ^ 1U) & (ll ^ 1U)) |
+                                       (end_target & (at_limit ^ 1U)) | (cal_stop & (cal_at_limit ^ 1U) & (cal_timed_out ^ 1U));
+        const uint32_t soft_stop = ((is_idle & (moving ^ 1U)) | released_stop) & (any_fault ^ 1U);
+        const uint32_t led_bits = (drive_up * DESK_BATCH_OUT_LED_BT_UP) | (drive_down * DESK_BATCH_OUT_LED_BT_DOWN) |
+                                  (soft_stop * DESK_BATCH_OUT_SOFT_STOP) |
+                                  (drive_target * DESK_BATCH_OUT_MOVING_TO_TARGET) |
+                                  (calibrating * DESK_BATCH_OUT_CALIBRATING) | (cal_done * DESK_BATCH_OUT_CALIBRATION_DONE);
+        const uint32_t fault_bits = static_cast<uint32_t>(DESK_BATCH_OUT_LED_ERROR) | DESK_BATCH_OUT_FAULT;
+
+        state[i] = static_cast<uint8_t>(final_st);
+        latches[i] = static_cast<uint8_t>(lat);
+        entry[i] = entry_ms;
+        stuck[i] = stuck_ms;
+        obstruction[i] = obst_ms;
+        target[i] = static_cast<int32_t>(tgt);
+        target_dir[i] = static_cast<uint8_t>(tdir);
+        release_pending[i] = static_cast<uint8_t>(pend);
+        calibration_dir[i] = static_cast<uint8_t>(cdir);
+        motor_cmd[i] = static_cast<uint8_t>(select_u32(fault_mask, static_cast<uint32_t>(MOTOR_STOP), cmd));
+        motor_speed[i] = static_cast<uint8_t>(~fault_mask & mask_of(moving) & 255U);
+        output_bits[i] = static_cast<uint8_t>(select_u32(fault_mask, fault_bits, led_bits));
+        target_out[i] = static_cast<int32_t>(~fault_mask & mask_of(drive_target) & tgt);
+    }
+}
+
+void DeskAppBatch_step(DeskAppBatch &batch, uint32_t now_ms)
+{
+    step_lanes(DeskAppBatch_size(batch), now_ms,
+               batch.state.data(), batch.latches.data(),
+               batch.state_entry_ms.data(), batch.stuck_on_start_ms.data(),
+               batch.obstruction_start_ms.data(),
+               batch.target_um.data(), batch.target_dir.data(), batch.release_pending.data(),
+               batch.calibration_dir.data(),
+               batch.input_bits.data(), batch.motor_current_ma.data(), batch.obstruction_limit_ma.data(),
+               batch.target_bits.data(), batch.height_um.data(), batch.request_um.data(),
+               batch.motor_cmd.data(), batch.motor_speed.data(), batch.output_bits.data(),
+               batch.target_out_um.data());
+}
+
+void DeskAppBatch_setInput(DeskAppBatch &batch, size_t lane, const AppInput_t &input)
+{
+    uint8_t bits = 0U;
+    bits = static_cast<uint8_t>(bits | (input.button_up ? DESK_BATCH_IN_BUTTON_UP : 0U));
+    bits = static_cast<uint8_t>(bits | (input.button_down ? DESK_BATCH_IN_BUTTON_DOWN : 0U));
+    bits = static_cast<uint8_t>(bits | (input.limit_upper ? DESK_BATCH_IN_LIMIT_UPPER : 0U));
+    bits = static_cast<uint8_t>(bits | (input.limit_lower ? DESK_BATCH_IN_LIMIT_LOWER : 0U));
+    bits = static_cast<uint8_t>(bits | (input.fault_in ? DESK_BATCH_IN_FAULT : 0U));
+    bits = static_cast<uint8_t>(bits | ((MotorConfig_effectiveType(input.motor_type) == MT_ROBUST) ? DESK_BATCH_IN_CURRENT_SENSE : 0U));
+    bits = static_cast<uint8_t>(bits | ((input.current_summary.samples > 0U) ? DESK_BATCH_IN_SUMMARY : 0U));
+    bits = static_cast<uint8_t>(bits | (((input.current_summary.stuck_run_ms >= MOTOR_SENSE_FAULT_TIME_MS) ||
+                                         (input.current_summary.obstruction_run_ms >= MOTOR_SENSE_FAULT_TIME_MS) ||
+                                         (input.current_summary.deviation_run_ms >= MOTOR_SENSE_FAULT_TIME_MS) ||
+                                         input.current_summary.slope_jam)
+                                            ? DESK_BATCH_IN_RUN_TRIP : 0U));
+    batch.input_bits[lane] = bits;
+    batch.motor_current_ma[lane] = input.motor_current_ma;
+    batch.obstruction_limit_ma[lane] = CurrentMonitor_obstructionLimitMa(input.motor_phase, input.motor_pwm);
+
+    uint8_t target_bits = 0U;
+    target_bits = static_cast<uint8_t>(target_bits | (input.move_to_target ? DESK_BATCH_TARGET_REQUEST : 0U));
+    target_bits = static_cast<uint8_t>(target_bits | (input.position_estimate.referenced ? DESK_BATCH_TARGET_REFERENCED : 0U));
+    target_bits = static_cast<uint8_t>(target_bits | (input.target_reached ? DESK_BATCH_TARGET_REACHED : 0U));
+    target_bits = static_cast<uint8_t>(target_bits | (input.calibrate ? DESK_BATCH_TARGET_CALIBRATE : 0U));
+    batch.target_bits[lane] = target_bits;
+    batch.height_um[lane] = input.position_estimate.height_um;
+    batch.request_um[lane] = input.target_height_um;
+}
+
+void DeskAppBatch_getOutput(const DeskAppBatch &batch, size_t lane, AppOutput_t &output)
+{
+    const uint8_t bits = batch.output_bits[lane];
+    output.motor_cmd = static_cast<MotorDirection_t>(batch.motor_cmd[lane]);
+    output.motor_speed = batch.motor_speed[lane];
+    output.led_bt_up = ((bits & DESK_BATCH_OUT_LED_BT_UP) != 0U) ? LED_ON : LED_OFF;
+    output.led_bt_down = ((bits & DESK_BATCH_OUT_LED_BT_DOWN) != 0U) ? LED_ON : LED_OFF;
+    output.led_error = ((bits & DESK_BATCH_OUT_LED_ERROR) != 0U) ? LED_ON : LED_OFF;
+    output.fault_out = ((bits & DESK_BATCH_OUT_FAULT) != 0U);
+    output.soft_stop = ((bits & DESK_BATCH_OUT_SOFT_STOP) != 0U);
+    output.moving_to_target = ((bits & DESK_BATCH_OUT_MOVING_TO_TARGET) != 0U);
+    output.target_height_um = batch.target_out_um[lane];
+    output.calibrating = ((bits & DESK_BATCH_OUT_CALIBRATING) != 0U);
+    output.calibration_done = ((bits & DESK_BATCH_OUT_CALIBRATION_DONE) != 0U);
+}
+
+void DeskAppBatch_loadContext(DeskAppBatch &batch, size_t lane, const AppContext_t &ctx)
+{
+    uint8_t lat = 0U;
+    lat = static_cast<uint8_t>(lat | (ctx.button_fault_latched ? DESK_BATCH_LATCH_BUTTON : 0U));
+    lat = static_cast<uint8_t>(lat | (ctx.external_fault_latched ? DESK_BATCH_LATCH_EXTERNAL : 0U));
+    lat = static_cast<uint8_t>(lat | (ctx.current_fault_latched ? DESK_BATCH_LATCH_CURRENT : 0U));
+    batch.state[lane] = static_cast<uint8_t>(ctx.current_state);
+    batch.latches[lane] = lat;
+    batch.state_entry_ms[lane] = ctx.state_entry_time;
+    batch.stuck_on_start_ms[lane] = ctx.stuck_on_timer_start_ms;
+    batch.obstruction_start_ms[lane] = ctx.obstruction_timer_start_ms;
+    batch.target_um[lane] = ctx.target_height_um;
+    batch.target_dir[lane] = static_cast<uint8_t>(ctx.target_dir);
+    batch.release_pending[lane] = ctx.button_release_pending ? 1U : 0U;
+    batch.calibration_dir[lane] = static_cast<uint8_t>(ctx.calibration_dir);
+}
+
+void DeskAppBatch_storeContext(const DeskAppBatch &batch, size_t lane, AppContext_t &ctx)
+{
+    const uint8_t lat = batch.latches[lane];
+    ctx.current_state = static_cast<AppState_t>(batch.state[lane]);
+    ctx.state_entry_time = batch.state_entry_ms[lane];
+    ctx.button_fault_latched = ((lat & DESK_BATCH_LATCH_BUTTON) != 0U);
+    ctx.external_fault_latched = ((lat & DESK_BATCH_LATCH_EXTERNAL) != 0U);
+    ctx.current_fault_latched = ((lat & DESK_BATCH_LATCH_CURRENT) != 0U);
+    ctx.stuck_on_timer_start_ms = batch.stuck_on_start_ms[lane];
+    ctx.obstruction_timer_start_ms = batch.obstruction_start_ms[lane];
+    ctx.target_height_um = batch.target_um[lane];
+    ctx.target_dir = static_cast<MotorDirection_t>(batch.target_dir[lane]);
+    ctx.button_release_pending = (batch.release_pending[lane] != 0U);
+    ctx.calibration_dir = static_cast<MotorDirection_t>(batch.calibration_dir[lane]);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "desk_app.h"
+
+/*
+ * Struct-of-arrays batch evaluation of the APP_Task() state machine.
+ *
+ * Each lane is one desk. Booleans are packed into per-lane bitmasks, timers
+ * and currents are plain uint32_t/uint16_t lanes, and DeskAppBatch_step()
+ * evaluates every lane with branch-free selects so the compiler can
+ * vectorize the loop. Results are bit-identical to APP_TaskCtx() for the
+ * same inputs (verified by a differential test in SimulationTests.cpp).
+ *
+ * All lanes share the tick timestamp, as they do when a fleet is stepped in
+ * lock-step.
+ */
+
+/* Per-lane input bits (input_bits[]) */
+static const uint8_t DESK_BATCH_IN_BUTTON_UP = 0x01U;
+static const uint8_t DESK_BATCH_IN_BUTTON_DOWN = 0x02U;
+static const uint8_t DESK_BATCH_IN_LIMIT_UPPER = 0x04U;
+static const uint8_t DESK_BATCH_IN_LIMIT_LOWER = 0x08U;
+static const uint8_t DESK_BATCH_IN_FAULT = 0x10U;
+static const uint8_t DESK_BATCH_IN_CURRENT_SENSE = 0x20U;  // MotorConfig_effectiveType(motor_type) == MT_ROBUST
+static const uint8_t DESK_BATCH_IN_SUMMARY = 0x40U;        // current_summary.samples > 0 (1 kHz statistics)
+static const uint8_t DESK_BATCH_IN_RUN_TRIP = 0x80U;       // A current_summary run reached MOTOR_SENSE_FAULT_TIME_MS, or slope_jam
+
+/* Per-lane move-to-target and calibration input bits (target_bits[]) */
+static const uint8_t DESK_BATCH_TARGET_REQUEST = 0x01U;     // move_to_target
+static const uint8_t DESK_BATCH_TARGET_REFERENCED = 0x02U;  // position_estimate.referenced
+static const uint8_t DESK_BATCH_TARGET_REACHED = 0x04U;     // target_reached
+static const uint8_t DESK_BATCH_TARGET_CALIBRATE = 0x08U;   // calibrate
+
+/* Per-lane latched fault bits (latches[]) */
+static const uint8_t DESK_BATCH_LATCH_BUTTON = 0x01U;
+static const uint8_t DESK_BATCH_LATCH_EXTERNAL = 0x02U;
+static const uint8_t DESK_BATCH_LATCH_CURRENT = 0x04U;
+
+/* Per-lane output bits (output_bits[]) */
+static const uint8_t DESK_BATCH_OUT_LED_BT_UP = 0x01U;
+static const uint8_t DESK_BATCH_OUT_LED_BT_DOWN = 0x02U;
+static const uint8_t DESK_BATCH_OUT_LED_ERROR = 0x04U;
+static const uint8_t DESK_BATCH_OUT_FAULT = 0x08U;
+static const uint8_t DESK_BATCH_OUT_SOFT_STOP = 0x10U;
+static const uint8_t DESK_BATCH_OUT_MOVING_TO_TARGET = 0x20U;
+static const uint8_t DESK_BATCH_OUT_CALIBRATING = 0x40U;
+static const uint8_t DESK_BATCH_OUT_CALIBRATION_DONE = 0x80U;
+
+struct DeskAppBatch
+{
+    /* State (equivalent of AppContext_t) */
+    std::vector<uint8_t> state;                  // AppState_t
+    std::vector<uint8_t> latches;                // DESK_BATCH_LATCH_*
+    std::vector<uint32_t> state_entry_ms;
+    std::vector<uint32_t> stuck_on_start_ms;     // UINT32_MAX = not running
+    std::vector<uint32_t> obstruction_start_ms;  // UINT32_MAX = not running
+    std::vector<int32_t> target_um;
+    std::vector<uint8_t> target_dir;             // MotorDirection_t
+    std::vector<uint8_t> release_pending;        // 0/1
+    std::vector<uint8_t> calibration_dir;        // MotorDirection_t
+
+    /* Inputs (equivalent of AppInput_t minus the shared timestamp) */
+    std::vector<uint8_t> input_bits;             // DESK_BATCH_IN_*
+    std::vector<uint16_t> motor_current_ma;
+    std::vector<uint16_t> obstruction_limit_ma;  // CurrentMonitor_obstructionLimitMa(motor_phase, motor_pwm)
+    std::vector<uint8_t> target_bits;            // DESK_BATCH_TARGET_*
+    std::vector<int32_t> height_um;              // position_estimate.height_um
+    std::vector<int32_t> request_um;             // target_height_um
+
+    /* Outputs (equivalent of AppOutput_t) */
+    std::vector<uint8_t> motor_cmd;              // MotorDirection_t
+    std::vector<uint8_t> motor_speed;
+    std::vector<uint8_t> output_bits;            // DESK_BATCH_OUT_*
+    std::vector<int32_t> target_out_um;
+};
+
+/* Allocate count lanes, all in the APP_Init() state with zero inputs */
+void DeskAppBatch_init(DeskAppBatch &batch, size_t count);
+
+size_t DeskAppBatch_size(const DeskAppBatch &batch);
+
+/* One APP_Task() tick for every lane at timestamp now_ms */
+void DeskAppBatch_step(DeskAppBatch &batch, uint32_t now_ms);
+
+/* Lane <-> scalar conversions (for seeding, inspection and equivalence checks) */
+void DeskAppBatch_setInput(DeskAppBatch &batch, size_t lane, const AppInput_t &input);
+void DeskAppBatch_getOutput(const DeskAppBatch &batch, size_t lane, AppOutput_t &output);
+void DeskAppBatch_loadContext(DeskAppBatch &batch, size_t lane, const AppContext_t &ctx);
+void DeskAppBatch_storeContext(const DeskAppBatch &batch, size_t lane, AppContext_t &ctx);
@@ -0,0 +1,200 @@
+#include "DeskPlant.h"
+#include "hal_mock/HALMock.h"
+#include "pin_config.h"
+#include "safety_config.h"
+#include "position_encoder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+const double GRAVITY_M_S2 = 9.81;
+const uint32_t MAX_SUBSTEP_US = 100U;   // Keeps explicit integration stable (mechanical tau ~20 ms)
+const int ADC_FULL_SCALE = 1023;
+
+int sign_of(double value)
+{
+    return (value > 0.0) ? 1 : ((value < 0.0) ? -1 : 0);
+}
+
+double pwm_fraction(int pin)
+{
+    const int raw = std::min(std::max(pin_states[pin], 0), 255);
+    return static_cast<double>(raw) / 255.0;
+}
+} // namespace
+
+DeskPlantParams DeskPlant_defaultParams(MotorType_t motor_type)
+{
+    DeskPlantParams params;
+    params.motor_type = motor_type;
+    params.stroke_mm = 650.0;
+    params.limit_switch_margin_mm = 5.0;
+    params.supply_v = 24.0;
+    params.resistance_ohm = 8.0;           // 3 A stall at 24 V
+    params.ke_v_per_mm_s = 0.4;            // 60 mm/s no-load speed
+    params.frame_mass_kg = 15.0;
+    params.load_kg = 10.0;
+    params.worm_friction_ratio = 1.05;     // > 1: gravity alone cannot back-drive the gear
+    params.coulomb_friction_n = 50.0;
+    params.effective_mass_kg = 400.0;
+    params.sense_gain = 0.1;
+    params.encoder_counts_per_mm = static_cast<double>(ENCODER_COUNTS_PER_MM);
+    params.start_height_mm = 300.0;
+    params.obstruction_up_mm = -1.0;
+    params.obstruction_down_mm = -1.0;
+    return params;
+}
+
+DeskPlant::DeskPlant(const DeskPlantParams &params)
+    : params_(params),
+      height_mm_(params.start_height_mm),
+      velocity_mm_s_(0.0),
+      current_a_(0.0),
+      duty_(0.0),
+      stalled_(false)
+{
+}
+
+void DeskPlant::reset()
+{
+    height_mm_ = params_.start_height_mm;
+    velocity_mm_s_ = 0.0;
+    current_a_ = 0.0;
+    duty_ = 0.0;
+    stalled_ = false;
+    writeSensorPins();
+}
+
+double DeskPlant::readDriveDuty() const
+{
+    if (params_.motor_type == MT_ROBUST)
+    {
+        // IBT_2: net drive is the LPWM/RPWM difference (both high = brake)
+        return pwm_fraction(PIN_MOTOR_LPWM) - pwm_fraction(PIN_MOTOR_RPWM);
+    }
+
+    // L298N: EN1/EN2 select direction, PWM sets magnitude
+    const bool en1 = (pin_states[PIN_MOTOR_EN1] != LOW);
+    const bool en2 = (pin_states[PIN_MOTOR_EN2] != LOW);
+    if (en1 == en2)
+    {
+        return 0.0;
+    }
+    return en1 ? pwm_fraction(PIN_MOTOR_PWM) : -pwm_fraction(PIN_MOTOR_PWM);
+}
+
+void DeskPlant::step(uint32_t dt_us)
+{
+    duty_ = readDriveDuty();
+    const double drive_v = duty_ * params_.supply_v;
+    const int drive_sign = sign_of(duty_);
+    const double drive_dir = static_cast<double>(drive_sign);
+    const double weight_n = (params_.frame_mass_kg + params_.load_kg) * GRAVITY_M_S2;
+    const double friction_n = params_.worm_friction_ratio * weight_n + params_.coulomb_friction_n;
+
+    uint32_t remaining_us = dt_us;
+    while (remaining_us > 0U)
+    {
+        const uint32_t h_us = std::min(remaining_us, MAX_SUBSTEP_US);
+        const double h_s = static_cast<double>(h_us) * 1e-6;
+        remaining_us -= h_us;
+
+        current_a_ = (drive_v - params_.ke_v_per_mm_s * velocity_mm_s_) / params_.resistance_ohm;
+        const double prev_height_mm = height_mm_;
+        const double motor_n = 1000.0 * params_.ke_v_per_mm_s * current_a_;
+        const double driving_n = motor_n - weight_n;
+
+        if (drive_sign == 0)
+        {
+            // Self-locking worm gear holds the load once drive is removed
+            velocity_mm_s_ = 0.0;
+        }
+        else if (sign_of(velocity_mm_s_) == 0)
+        {
+            // Break-away only in the driven direction and only once static friction is overcome
+            if ((driving_n * drive_dir) > friction_n)
+            {
+                velocity_mm_s_ = drive_dir * ((driving_n * drive_dir) - friction_n) / params_.effective_mass_kg * h_s * 1000.0;
+            }
+        }
+        else
+        {
+            const double net_n = driving_n - friction_n * static_cast<double>(sign_of(velocity_mm_s_));
+            const double next_v = velocity_mm_s_ + (net_n / params_.effective_mass_kg) * h_s * 1000.0;
+            // Friction and the worm gear stop the desk; they never reverse it
+            velocity_mm_s_ = (sign_of(next_v) == sign_of(velocity_mm_s_)) ? next_v : 0.0;
+        }
+
+        height_mm_ += velocity_mm_s_ * h_s;
+
+        // Hard stops: mechanical end stops and injected obstructions
+        double upper_stop = params_.stroke_mm;
+        if ((params_.obstruction_up_mm >= 0.0) && (prev_height_mm <= params_.obstruction_up_mm))
+        {
+            upper_stop = std::min(upper_stop, params_.obstruction_up_mm);
+        }
+        double lower_stop = 0.0;
+        if ((params_.obstruction_down_mm >= 0.0) && (prev_height_mm >= params_.obstruction_down_mm))
+        {
+            lower_stop = std::max(lower_stop, params_.obstruction_down_mm);
+        }
+
+        stalled_ = false;
+        if ((height_mm_ >= upper_stop) && (drive_sign > 0))
+        {
+            height_mm_ = upper_stop;
+            velocity_mm_s_ = 0.0;
+            stalled_ = true;
+        }
+        else if ((height_mm_ <= lower_stop) && (drive_sign < 0))
+        {
+            height_mm_ = lower_stop;
+            velocity_mm_s_ = 0.0;
+            stalled_ = true;
+        }
+    }
+
+    current_a_ = (drive_v - params_.ke_v_per_mm_s * velocity_mm_s_) / params_.resistance_ohm;
+    writeSensorPins();
+}
+
+double DeskPlant::senseCurrentMa() const
+{
+    // The high-side sense mirror only reports current flowing in the driven direction
+    const double driven_a = current_a_ * static_cast<double>(sign_of(duty_));
+    return (driven_a > 0.0) ? driven_a * params_.sense_gain * 1000.0 : 0.0;
+}
+
+int32_t DeskPlant::encoderCount() const
+{
+    return static_cast<int32_t>(std::floor(height_mm_ * params_.encoder_counts_per_mm));
+}
+
+bool DeskPlant::upperLimitActive() const
+{
+    return height_mm_ >= (params_.stroke_mm - params_.limit_switch_margin_mm);
+}
+
+bool DeskPlant::lowerLimitActive() const
+{
+    return height_mm_ <= params_.limit_switch_margin_mm;
+}
+
+void DeskPlant::writeSensorPins() const
+{
+    // Limit switches are active LOW with pull-ups
+    pin_states[PIN_LIMIT_UPPER] = upperLimitActive() ? LOW : HIGH;
+    pin_states[PIN_LIMIT_LOWER] = lowerLimitActive() ? LOW : HIGH;
+
+    // Quadrature Gray code of the count: 00 -> 01 -> 11 -> 10 (B:A) moving up
+    const uint32_t phase = static_cast<uint32_t>(encoderCount()) & 0x03U;
+    const uint32_t gray = phase ^ (phase >> 1);
+    pin_states[PIN_ENCODER_A] = ((gray & 0x01U) != 0U) ? HIGH : LOW;
+    pin_states[PIN_ENCODER_B] = ((gray & 0x02U) != 0U) ? HIGH : LOW;
+
+    // mA -> shunt mV -> 10-bit ADC count, the inverse of HAL_readMotorCurrent()
+    const double sense_mv = senseCurrentMa() * static_cast<double>(SHUNT_MILLIOHMS) / 1000.0;
+    const double counts = std::round(sense_mv * ADC_FULL_SCALE / static_cast<double>(ADC_REF_MV));
+    pin_states[PIN_MOTOR_SENSE] = std::min(static_cast<int>(counts), ADC_FULL_SCALE);
+}
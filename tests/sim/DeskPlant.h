@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include "motor_config.h"
+
+/*
+ * Physics model of the desk lift, coupled to the HAL mock pins.
+ *
+ * Each step() reads the motor driver pins written by HAL_setMotor()
+ * (EN1/EN2/PWM for L298N, LPWM/RPWM for IBT_2), integrates a DC motor +
+ * worm-gear + desk model, and writes back:
+ *   - PIN_LIMIT_UPPER / PIN_LIMIT_LOWER (active LOW, like the real switches)
+ *   - PIN_MOTOR_SENSE as the ADC count HAL_readMotorCurrent() converts to mA
+ *   - PIN_ENCODER_A / PIN_ENCODER_B as the quadrature state of the height
+ *     (encoder_counts_per_mm, counting up with height)
+ *
+ * Model (desk-side units, gear ratio and efficiency folded into the constants):
+ *   V     = duty * supply_v                     (signed by direction)
+ *   I     = (V - ke * v) / resistance_ohm       (electrical time constant neglected)
+ *   F_m   = 1000 * ke * I                       (N; ke in V per mm/s)
+ *   F_res = m*g (against up) + friction(m*g) + coulomb, opposing motion
+ *   m_eff * dv/dt = F_m - F_res
+ * The worm gear is self-locking: with no drive the desk holds position, and
+ * the model never lets gravity back-drive the motor.
+ *
+ * Mechanical end stops at 0 and stroke_mm, plus an optional injected
+ * obstruction, clamp the height and stall the motor (I = V / R).
+ *
+ * Pins are read exactly as written. Note that pin_config.h assigns pin 10 to
+ * both PIN_MOTOR_RPWM and PIN_LED_BT_DOWN, so under MT_ROBUST the DOWN LED
+ * write overrides RPWM just as it would on the board.
+ */
+
+struct DeskPlantParams
+{
+    MotorType_t motor_type;        // Pin mapping to read (L298N or IBT_2)
+    double stroke_mm;              // Travel between mechanical end stops
+    double limit_switch_margin_mm; // Limit switches trip this far before each end stop
+    double supply_v;               // Motor supply voltage
+    double resistance_ohm;         // Armature resistance (sets stall current)
+    double ke_v_per_mm_s;          // Back-EMF constant at the desk (sets no-load speed)
+    double frame_mass_kg;          // Moving desk top and frame
+    double load_kg;                // User payload
+    double worm_friction_ratio;    // Worm-gear friction as a fraction of the gravity load
+    double coulomb_friction_n;     // Load-independent friction (seals, guides)
+    double effective_mass_kg;      // Reflected inertia of motor + gearbox + desk
+    double sense_gain;             // Motor amps -> mA seen on the sense channel (IS current mirror)
+    double encoder_counts_per_mm;  // Quadrature counts per mm of travel (keep below 1 count per step)
+    double start_height_mm;        // Initial height above the lower end stop
+    double obstruction_up_mm;      // Hard obstruction while moving up (< 0 = none)
+    double obstruction_down_mm;    // Hard obstruction while moving down (< 0 = none)
+};
+
+/* Defaults: 25 kg moving mass, ~32 mm/s up / ~57 mm/s down, ~140 mA sense current going up */
+DeskPlantParams DeskPlant_defaultParams(MotorType_t motor_type);
+
+class DeskPlant
+{
+public:
+    explicit DeskPlant(const DeskPlantParams &params);
+
+    /* Restore the initial height and rest state, and publish the sensor pins */
+    void reset();
+
+    /* Advance the model by dt_us using the motor pins as currently driven */
+    void step(uint32_t dt_us);
+
+    /* Re-publish limit switch, current sense and encoder pins from the current state */
+    void writeSensorPins() const;
+
+    double heightMm() const { return height_mm_; }
+    double velocityMmS() const { return velocity_mm_s_; }
+    double motorCurrentA() const { return current_a_; }
+    double senseCurrentMa() const;
+    int32_t encoderCount() const;                   // Quadrature counts from the lower end stop
+    double appliedDuty() const { return duty_; }    // Signed: + up, - down
+    bool upperLimitActive() const;
+    bool lowerLimitActive() const;
+    bool stalled() const { return stalled_; }
+
+    DeskPlantParams &params() { return params_; }
+    const DeskPlantParams &params() const { return params_; }
+
+private:
+    double readDriveDuty() const;
+
+    DeskPlantParams params_;
+    double height_mm_;
+    double velocity_mm_s_;
+    double current_a_;
+    double duty_;
+    bool stalled_;
+};
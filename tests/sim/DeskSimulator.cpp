@@ -0,0 +1,77 @@
+#include "DeskSimulator.h"
+#include "desk_control.h"
+#include "hal.h"
+#include "hal_mock/HALMock.h"
+#include "pin_config.h"
+#include <algorithm>
+
+namespace
+{
+const uint32_t SIM_STEP_US = 1000U;
+} // namespace
+
+DeskSimulator::DeskSimulator(const DeskPlantParams &params)
+    : plant_(params),
+      max_sense_current_ma_(0.0)
+{
+}
+
+void DeskSimulator::reset()
+{
+    MockClock_reset();
+    for (int pin = 0; pin < 64; ++pin)
+    {
+        pin_states[pin] = LOW;
+    }
+    pin_states[PIN_BUTTON_UP] = HIGH;     // Released (active LOW with pull-up)
+    pin_states[PIN_BUTTON_DOWN] = HIGH;
+    plant_.reset();
+    max_sense_current_ma_ = 0.0;
+
+    HAL_setMotorType(plant_.params().motor_type);
+    HAL_init();
+    DeskControl_Init(HAL_getTime());
+}
+
+void DeskSimulator::setButton(ButtonID_t button, bool pressed)
+{
+    const uint8_t pin = (button == BUTTON_UP) ? PIN_BUTTON_UP : PIN_BUTTON_DOWN;
+    pin_states[pin] = pressed ? LOW : HIGH;
+    HAL_inputChangeIsr();  // Pin-change interrupt fires on the edge itself
+}
+
+void DeskSimulator::stepOneMs()
+{
+    plant_.step(SIM_STEP_US);
+    HAL_inputChangeIsr();  // Limit switch edges written by the plant
+    HAL_encoderIsr();      // Encoder edges: at most one count per step at the default resolution
+    max_sense_current_ma_ = std::max(max_sense_current_ma_, plant_.senseCurrentMa());
+    MockClock_advanceUs(SIM_STEP_US);
+    DeskControl_Poll(HAL_getTime());
+}
+
+void DeskSimulator::runForMs(uint32_t duration_ms)
+{
+    for (uint32_t elapsed = 0U; elapsed < duration_ms; ++elapsed)
+    {
+        stepOneMs();
+    }
+}
+
+bool DeskSimulator::runUntil(const std::function<bool()> &condition, uint32_t timeout_ms)
+{
+    for (uint32_t elapsed = 0U; elapsed < timeout_ms; ++elapsed)
+    {
+        if (condition())
+        {
+            return true;
+        }
+        stepOneMs();
+    }
+    return condition();
+}
+
+uint32_t DeskSimulator::nowMs() const
+{
+    return HAL_getTime();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include "DeskPlant.h"
+#include "desk_types.h"
+
+/*
+ * Closed-loop harness: DeskPlant <-> HAL mock pins <-> production control code.
+ *
+ * Every simulated millisecond the plant integrates against the motor pins,
+ * the virtual clock (MockClock) advances and DeskControl_Poll() runs, so the
+ * real APP_Task + MotorController_update + HAL chain executes at its normal
+ * 250 ms cadence without any wall-clock waiting.
+ */
+class DeskSimulator
+{
+public:
+    explicit DeskSimulator(const DeskPlantParams &params);
+
+    /* Reset clock, pins, plant, HAL and control task to power-on state */
+    void reset();
+
+    /* Drive a button input pin (active LOW, debounced by the HAL) */
+    void setButton(ButtonID_t button, bool pressed);
+
+    /* Advance the closed loop by duration_ms */
+    void runForMs(uint32_t duration_ms);
+
+    /* Advance until condition() holds or timeout_ms elapses; true if the condition was met */
+    bool runUntil(const std::function<bool()> &condition, uint32_t timeout_ms);
+
+    uint32_t nowMs() const;
+    DeskPlant &plant() { return plant_; }
+    const DeskPlant &plant() const { return plant_; }
+
+    /* Peak sense current observed since reset() */
+    double maxSenseCurrentMa() const { return max_sense_current_ma_; }
+
+private:
+    void stepOneMs();
+
+    DeskPlant plant_;
+    double max_sense_current_ma_;
+};
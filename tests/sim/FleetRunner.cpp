@@ -0,0 +1,187 @@
+#include "FleetRunner.h"
+#include "DeskSimulator.h"
+#include "hal_mock/HALMock.h"
+#include "pin_config.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+const uint32_t STOP_TIMEOUT_MS = 2000U;
+
+void atomic_max(std::atomic<uint32_t> &target, uint32_t value)
+{
+    uint32_t seen = target.load(std::memory_order_relaxed);
+    while ((value > seen) &&
+           !target.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+ButtonID_t other_button(ButtonID_t button)
+{
+    return (button == BUTTON_UP) ? BUTTON_DOWN : BUTTON_UP;
+}
+} // namespace
+
+void FleetAggregate_reset(FleetAggregate &aggregate)
+{
+    aggregate.scenarios.store(0U);
+    aggregate.limit_reached.store(0U);
+    aggregate.faults_latched.store(0U);
+    aggregate.stroke_ms_sum.store(0U);
+    aggregate.stroke_ms_max.store(0U);
+    aggregate.stop_samples.store(0U);
+    aggregate.stop_latency_sum_ms.store(0U);
+    aggregate.stop_latency_max_ms.store(0U);
+    aggregate.stop_distance_sum_um.store(0U);
+    aggregate.stop_distance_max_um.store(0U);
+    aggregate.max_current_ma.store(0U);
+    for (size_t bucket = 0U; bucket < FLEET_LATENCY_BUCKETS; ++bucket)
+    {
+        aggregate.stop_latency_histogram[bucket].store(0U);
+    }
+}
+
+void FleetAggregate_merge(FleetAggregate &aggregate, const FleetScenarioResult &result)
+{
+    aggregate.scenarios.fetch_add(1U, std::memory_order_relaxed);
+    if (result.stroke_ms != UINT32_MAX)
+    {
+        aggregate.limit_reached.fetch_add(1U, std::memory_order_relaxed);
+        aggregate.stroke_ms_sum.fetch_add(result.stroke_ms, std::memory_order_relaxed);
+        atomic_max(aggregate.stroke_ms_max, result.stroke_ms);
+    }
+    if (result.fault_latched)
+    {
+        aggregate.faults_latched.fetch_add(1U, std::memory_order_relaxed);
+    }
+    if (result.stop_latency_ms != UINT32_MAX)
+    {
+        const size_t bucket = std::min(static_cast<size_t>(result.stop_latency_ms / FLEET_LATENCY_BUCKET_MS),
+                                       FLEET_LATENCY_BUCKETS - 1U);
+        aggregate.stop_samples.fetch_add(1U, std::memory_order_relaxed);
+        aggregate.stop_latency_sum_ms.fetch_add(result.stop_latency_ms, std::memory_order_relaxed);
+        atomic_max(aggregate.stop_latency_max_ms, result.stop_latency_ms);
+        const uint32_t distance_um = static_cast<uint32_t>(std::lround(result.stop_distance_mm * 1000.0));
+        aggregate.stop_distance_sum_um.fetch_add(distance_um, std::memory_order_relaxed);
+        atomic_max(aggregate.stop_distance_max_um, distance_um);
+        aggregate.stop_latency_histogram[bucket].fetch_add(1U, std::memory_order_relaxed);
+    }
+    atomic_max(aggregate.max_current_ma, result.max_current_ma);
+}
+
+std::vector<FleetScenario> FleetRunner_makeScenarios(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> load_kg(0.0, 40.0);
+    std::uniform_real_distribution<double> start_mm(20.0, 630.0);
+    std::uniform_real_distribution<double> obstruction_gap_mm(20.0, 150.0);
+    std::uniform_int_distribution<uint32_t> press_delay_ms(0U, 1000U);
+    std::uniform_int_distribution<uint32_t> hold_ms(500U, 15000U);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::vector<FleetScenario> scenarios(count);
+    for (size_t i = 0U; i < count; ++i)
+    {
+        FleetScenario &scenario = scenarios[i];
+        // MT_BASIC only: under MT_ROBUST pin 10 is shared by RPWM and the DOWN LED (see DeskPlant.h)
+        scenario.id = static_cast<uint32_t>(i);
+        scenario.params = DeskPlant_defaultParams(MT_BASIC);
+        scenario.params.load_kg = load_kg(rng);
+        scenario.params.start_height_mm = start_mm(rng);
+        scenario.button = (percent(rng) < 50) ? BUTTON_UP : BUTTON_DOWN;
+        scenario.press_delay_ms = press_delay_ms(rng);
+        scenario.hold_ms = hold_ms(rng);
+
+        const int fault_roll = percent(rng);
+        scenario.fault = (fault_roll < 70) ? FLEET_FAULT_NONE
+                       : ((fault_roll < 85) ? FLEET_FAULT_OBSTRUCTION : FLEET_FAULT_DUAL_BUTTON);
+        std::uniform_int_distribution<uint32_t> fault_at_ms(100U, scenario.hold_ms - 1U);
+        scenario.fault_at_ms = fault_at_ms(rng);
+
+        if (scenario.fault == FLEET_FAULT_OBSTRUCTION)
+        {
+            const double gap_mm = obstruction_gap_mm(rng);
+            if (scenario.button == BUTTON_UP)
+            {
+                scenario.params.obstruction_up_mm = scenario.params.start_height_mm + gap_mm;
+            }
+            else
+            {
+                scenario.params.obstruction_down_mm = std::max(scenario.params.start_height_mm - gap_mm, 0.0);
+            }
+        }
+    }
+    return scenarios;
+}
+
+FleetScenarioResult FleetRunner_runScenario(const FleetScenario &scenario)
+{
+    DeskSimulator sim(scenario.params);
+    sim.reset();
+
+    FleetScenarioResult result;
+    result.id = scenario.id;
+    result.stroke_ms = UINT32_MAX;
+    result.stop_latency_ms = UINT32_MAX;
+    result.stop_distance_mm = 0.0;
+    result.fault_latched = false;
+
+    sim.runForMs(scenario.press_delay_ms);
+    const double start_height_mm = sim.plant().heightMm();
+    sim.setButton(scenario.button, true);
+    const uint32_t press_ms = sim.nowMs();
+
+    const auto observe = [&sim, &scenario, &result, press_ms]() {
+        const bool at_target = (scenario.button == BUTTON_UP) ? sim.plant().upperLimitActive()
+                                                              : sim.plant().lowerLimitActive();
+        if (at_target && (result.stroke_ms == UINT32_MAX))
+        {
+            result.stroke_ms = sim.nowMs() - press_ms;
+        }
+        if (pin_states[PIN_LED_ERROR] == HIGH)
+        {
+            result.fault_latched = true;
+        }
+    };
+
+    for (uint32_t elapsed = 0U; elapsed < scenario.hold_ms; ++elapsed)
+    {
+        if ((scenario.fault == FLEET_FAULT_DUAL_BUTTON) && (elapsed == scenario.fault_at_ms))
+        {
+            sim.setButton(other_button(scenario.button), true);
+        }
+        sim.runForMs(1U);
+        observe();
+    }
+
+    sim.setButton(BUTTON_UP, false);
+    sim.setButton(BUTTON_DOWN, false);
+    const uint32_t release_ms = sim.nowMs();
+    const double release_height_mm = sim.plant().heightMm();
+    const bool stopped = sim.runUntil([&sim, &observe]() {
+        observe();
+        return (std::fabs(sim.plant().appliedDuty()) < 1e-9) && (std::fabs(sim.plant().velocityMmS()) < 1e-9);
+    }, STOP_TIMEOUT_MS);
+    if (stopped)
+    {
+        result.stop_latency_ms = sim.nowMs() - release_ms;
+        result.stop_distance_mm = std::fabs(sim.plant().heightMm() - release_height_mm);
+    }
+
+    result.max_current_ma = static_cast<uint32_t>(std::lround(sim.maxSenseCurrentMa()));
+    result.travel_mm = sim.plant().heightMm() - start_height_mm;
+    return result;
+}
+
+WorkStealingStats FleetRunner_run(const std::vector<FleetScenario> &scenarios, unsigned workers,
+                                  std::vector<FleetScenarioResult> &results, FleetAggregate &aggregate)
+{
+    results.resize(scenarios.size());
+    return WorkStealing_run(scenarios.size(), workers, [&scenarios, &results, &aggregate](size_t index) {
+        results[index] = FleetRunner_runScenario(scenarios[index]);
+        FleetAggregate_merge(aggregate, results[index]);
+    });
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DeskPlant.h"
+#include "WorkStealingPool.h"
+#include "desk_types.h"
+
+/*
+ * Fleet-scale closed-loop simulation: many independent desk scenarios run
+ * through DeskSimulator on a work-stealing thread pool.
+ *
+ * Every worker thread has its own HAL mock pins, virtual clock and
+ * DeskApp/MotorController/DeskControl state (thread-local in host builds),
+ * so scenarios never observe each other. Per-scenario results land in a
+ * pre-sized vector (one writer per slot) and are merged into FleetAggregate
+ * with relaxed atomics only - no locks on the result path.
+ */
+
+typedef enum
+{
+    FLEET_FAULT_NONE = 0,
+    FLEET_FAULT_OBSTRUCTION = 1,   // Hard obstruction in the direction of travel
+    FLEET_FAULT_DUAL_BUTTON = 2    // Second button pressed while moving
+} FleetFault_t;
+
+struct FleetScenario
+{
+    uint32_t id;
+    DeskPlantParams params;
+    ButtonID_t button;           // Button held for the move
+    uint32_t press_delay_ms;     // Idle time before the press
+    uint32_t hold_ms;            // How long the button is held
+    FleetFault_t fault;
+    uint32_t fault_at_ms;        // Dual-button press time after the first press
+};
+
+struct FleetScenarioResult
+{
+    uint32_t id;
+    uint32_t stroke_ms;          // Press -> target limit switch; UINT32_MAX if not reached
+    uint32_t stop_latency_ms;    // Release -> drive removed and desk at rest; UINT32_MAX if it never stopped
+    double stop_distance_mm;     // Travel between release and rest (soft stop run-out); 0 if it never stopped
+    uint32_t max_current_ma;     // Peak sense current
+    bool fault_latched;          // Error LED seen on at any time
+    double travel_mm;            // Net height change
+};
+
+static const uint32_t FLEET_LATENCY_BUCKET_MS = 50U;
+static const size_t FLEET_LATENCY_BUCKETS = 12U;  // Last bucket collects everything >= 550 ms
+
+struct FleetAggregate
+{
+    std::atomic<uint32_t> scenarios;
+    std::atomic<uint32_t> limit_reached;
+    std::atomic<uint32_t> faults_latched;
+    std::atomic<uint64_t> stroke_ms_sum;
+    std::atomic<uint32_t> stroke_ms_max;
+    std::atomic<uint32_t> stop_samples;
+    std::atomic<uint64_t> stop_latency_sum_ms;
+    std::atomic<uint32_t> stop_latency_max_ms;
+    std::atomic<uint64_t> stop_distance_sum_um;
+    std::atomic<uint32_t> stop_distance_max_um;
+    std::atomic<uint32_t> max_current_ma;
+    std::atomic<uint32_t> stop_latency_histogram[FLEET_LATENCY_BUCKETS];
+};
+
+void FleetAggregate_reset(FleetAggregate &aggregate);
+
+/* Lock-free merge; safe to call concurrently from any number of workers */
+void FleetAggregate_merge(FleetAggregate &aggregate, const FleetScenarioResult &result);
+
+/* Deterministic scenario mix (loads, start heights, timings, faults) for a seed */
+std::vector<FleetScenario> FleetRunner_makeScenarios(size_t count, uint32_t seed);
+
+/* Run one scenario on the calling thread */
+FleetScenarioResult FleetRunner_runScenario(const FleetScenario &scenario);
+
+/* Run all scenarios on `workers` threads; results[i] belongs to scenarios[i] */
+WorkStealingStats FleetRunner_run(const std::vector<FleetScenario> &scenarios, unsigned workers,
+                                  std::vector<FleetScenarioResult> &results, FleetAggregate &aggregate);
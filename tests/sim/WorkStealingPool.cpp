@@ -0,0 +1,95 @@
+#include "WorkStealingPool.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+struct WorkerQueue
+{
+    std::mutex lock;
+    std::deque<size_t> tasks;
+};
+
+bool pop_own(WorkerQueue &queue, size_t &index)
+{
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+    index = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool steal(WorkerQueue &queue, size_t &index)
+{
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+    index = queue.tasks.front();
+    queue.tasks.pop_front();
+    return true;
+}
+} // namespace
+
+WorkStealingStats WorkStealing_run(size_t task_count, unsigned workers,
+                                   const std::function<void(size_t)> &task)
+{
+    if (workers == 0U)
+    {
+        workers = 1U;
+    }
+
+    std::unique_ptr<WorkerQueue[]> queues(new WorkerQueue[workers]);
+    for (size_t index = 0U; index < task_count; ++index)
+    {
+        // Contiguous blocks: neighbouring scenarios start on the same worker
+        queues[(index * workers) / task_count].tasks.push_back(index);
+    }
+
+    WorkStealingStats stats;
+    stats.executed.assign(workers, 0U);
+    stats.stolen.assign(workers, 0U);
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (unsigned self = 0U; self < workers; ++self)
+    {
+        threads.emplace_back([&queues, &stats, &task, self, workers]() {
+            size_t index = 0U;
+            for (;;)
+            {
+                if (pop_own(queues[self], index))
+                {
+                    task(index);
+                    ++stats.executed[self];
+                    continue;
+                }
+
+                bool found = false;
+                for (unsigned offset = 1U; (offset < workers) && !found; ++offset)
+                {
+                    found = steal(queues[(self + offset) % workers], index);
+                }
+                if (!found)
+                {
+                    return;  // Every deque is empty and no task creates new work
+                }
+                task(index);
+                ++stats.executed[self];
+                ++stats.stolen[self];
+            }
+        });
+    }
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    return stats;
+}
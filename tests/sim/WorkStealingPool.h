@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/*
+ * Work-stealing execution of a fixed set of independent tasks.
+ *
+ * Task indices 0..task_count-1 are dealt out as contiguous blocks, one deque
+ * per worker. A worker pops from the back of its own deque and, once that is
+ * empty, steals from the front of the other workers' deques, so long-running
+ * tasks (full strokes) and short ones (early faults) balance out without a
+ * central queue. No task spawns new tasks, so a worker exits once every
+ * deque is empty.
+ *
+ * Each worker is a fresh std::thread, which gives it a fresh set of the
+ * thread-local HAL mock / module state (see DESK_THREAD_LOCAL).
+ */
+
+struct WorkStealingStats
+{
+    std::vector<uint32_t> executed;  // Tasks run by each worker
+    std::vector<uint32_t> stolen;    // Of those, tasks taken from another worker's deque
+};
+
+/* Run task(index) for every index; returns once all tasks have completed */
+WorkStealingStats WorkStealing_run(size_t task_count, unsigned workers,
+                                   const std::function<void(size_t)> &task);